@@ -0,0 +1,680 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSBoundingSphere.h"
+#include "TSMemory.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum : uint32
+	{
+		kExtremeDirectionCount		= 7
+	};
+
+
+	// The coordinate axes and the four diagonals of a cube. These are not normalized because only the ordering
+	// of the projections along each direction matters.
+
+	const float extremeDirection[kExtremeDirectionCount][3] =
+	{
+		{1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F}, {0.0F, 0.0F, 1.0F},
+		{1.0F, 1.0F, 1.0F}, {1.0F, 1.0F, -1.0F}, {1.0F, -1.0F, 1.0F}, {1.0F, -1.0F, -1.0F}
+	};
+
+
+	// The squared distances to the points are calculated with a relative error of a few units in the last place,
+	// so the final squared radius is enlarged by this factor to make sure that the sphere contains every point.
+
+	const float kDistanceRoundingScale = 1.000001F;
+
+
+	struct Ball
+	{
+		Point3D		center;
+		float		radius2;
+	};
+
+
+	Sphere3D EncodeSphere(const Point3D& center, float radius2)
+	{
+		// The antiscalar coordinate holds half the difference between the squared radius and the squared distance from the origin
+		// to the center, so it cancels badly when the center is far from the origin. It is rounded upward until the squared radius
+		// recovered from the sphere is at least the requested value, both exactly and as calculated by SquaredRadiusNorm(), so the
+		// sphere never shrinks. The exact value is found in double precision, where the squares of the coordinates have no error.
+
+		Sphere3D s(-1.0F, center.x, center.y, center.z, (radius2 - (center.x * center.x + center.y * center.y + center.z * center.z)) * 0.5F);
+		double c2 = double(center.x) * double(center.x) + double(center.y) * double(center.y) + double(center.z) * double(center.z);
+
+		for (;;)
+		{
+			float deficit = Fmax(float(double(radius2) - (c2 + double(s.w) * 2.0)), radius2 - SquaredRadiusNorm(s));
+			if (!(deficit > 0.0F))
+			{
+				break;
+			}
+
+			float w = Fabs(s.w);
+			s.w += Fmax(deficit * 0.5F, asfloat(asuint(w) + 1) - w);
+		}
+
+		return (s);
+	}
+
+
+	float RoundUpward(double x)
+	{
+		float f = float(x);
+		if (double(f) < x)
+		{
+			f = asfloat(asuint(f) + 1);
+		}
+
+		return (f);
+	}
+
+	float RoundUpwardSqrt(double x)
+	{
+		// The library square root has a relative error of a few units in the last place, or much more when SIMD is disabled.
+		// One Newton step in double precision makes the result nearly exact, and it is then nudged upward until its square
+		// is at least x, so the result is never smaller than the true square root.
+
+		float r = Sqrt(float(x));
+		if (r > 0.0F)
+		{
+			double e = r;
+			r = float(e + (x - e * e) / (e * 2.0));
+			while (double(r) * double(r) < x)
+			{
+				r = asfloat(asuint(r) + 1);
+			}
+		}
+
+		return (r);
+	}
+
+	void DecodeSphere(const Sphere3D& s, double *center, double *radius2)
+	{
+		// The center and squared radius are recovered in double precision, where the squares of the coordinates have no error
+		// and the cancellation in the squared radius norm is harmless.
+
+		double u = s.u;
+		double x = s.x;
+		double y = s.y;
+		double z = s.z;
+		double f = -1.0 / u;
+
+		center[0] = x * f;
+		center[1] = y * f;
+		center[2] = z * f;
+
+		double r2 = (x * x + y * y + z * z - double(s.w) * u * 2.0) * (f * f);
+		*radius2 = (r2 > 0.0) ? r2 : 0.0;
+	}
+
+	float CalculateEnclosingRadius(const Point3D& center, const double *c, double radius2)
+	{
+		// Returns a radius, rounded upward, for which a sphere centered at the given point contains the sphere
+		// having the center c and squared radius radius2.
+
+		double dx = double(center.x) - c[0];
+		double dy = double(center.y) - c[1];
+		double dz = double(center.z) - c[2];
+		return (RoundUpward(double(RoundUpwardSqrt(dx * dx + dy * dy + dz * dz)) + double(RoundUpwardSqrt(radius2))));
+	}
+
+	inline bool BallContains(const Ball& ball, const Point3D& p, float tolerance = 1.0e-5F)
+	{
+		return (SquaredMag(p - ball.center) <= ball.radius2 * (1.0F + tolerance));
+	}
+
+	bool ConvertSphere(const Sphere3D& s, Ball *ball)
+	{
+		if (!(Fabs(s.u) > Math::min_float))
+		{
+			return (false);
+		}
+
+		float f = -1.0F / s.u;
+		float r2 = SquaredRadiusNorm(s) * (f * f);
+		if (!((r2 >= 0.0F) && (r2 < Math::max_float)))
+		{
+			return (false);
+		}
+
+		ball->center.Set(s.x * f, s.y * f, s.z * f);
+		ball->radius2 = r2;
+		return (true);
+	}
+
+	Ball MakeBall(const Point3D& a, const Point3D& b)
+	{
+		Ball	ball;
+
+		ball.center = (a + b) * 0.5F;
+		ball.radius2 = SquaredMag(b - a) * 0.25F;
+		return (ball);
+	}
+
+	Ball MakeBall(const Point3D& a, const Point3D& b, const Point3D& c)
+	{
+		Ball	ball;
+
+		// The smallest sphere passing through three points is the container of the circle a ^ b ^ c.
+		// When the points are nearly collinear, the circle degenerates, and the sphere whose diameter
+		// is the longest of the three edges is used instead.
+
+		Sphere3D s = Container(Wedge(Wedge(RoundPoint3D(a), RoundPoint3D(b)), RoundPoint3D(c)));
+		if ((ConvertSphere(s, &ball)) && (BallContains(ball, a, 1.0e-3F)) && (BallContains(ball, b, 1.0e-3F)) && (BallContains(ball, c, 1.0e-3F)))
+		{
+			return (ball);
+		}
+
+		float ab = SquaredMag(b - a);
+		float bc = SquaredMag(c - b);
+		float ca = SquaredMag(a - c);
+
+		if ((ab >= bc) && (ab >= ca))
+		{
+			return (MakeBall(a, b));
+		}
+
+		return ((bc >= ca) ? MakeBall(b, c) : MakeBall(c, a));
+	}
+
+	Ball MakeBall(const Point3D& a, const Point3D& b, const Point3D& c, const Point3D& d)
+	{
+		Ball	ball;
+
+		// The sphere passing through four points is the wedge product of the circle through three of them
+		// with the fourth. When the points are nearly coplanar, the sphere degenerates, and the smallest
+		// circumscribed sphere of a triangle containing d that also contains the remaining point is used instead.
+
+		Sphere3D s = Wedge(Wedge(Wedge(RoundPoint3D(a), RoundPoint3D(b)), RoundPoint3D(c)), RoundPoint3D(d));
+		if ((ConvertSphere(s, &ball)) && (BallContains(ball, a, 1.0e-3F)) && (BallContains(ball, b, 1.0e-3F)) && (BallContains(ball, c, 1.0e-3F)) && (BallContains(ball, d, 1.0e-3F)))
+		{
+			return (ball);
+		}
+
+		Ball candidate[3] = {MakeBall(a, b, d), MakeBall(b, c, d), MakeBall(c, a, d)};
+		const Point3D *remaining[3] = {&c, &a, &b};
+
+		ball.radius2 = Math::infinity;
+		for (machine k = 0; k < 3; k++)
+		{
+			if ((candidate[k].radius2 < ball.radius2) && (BallContains(candidate[k], *remaining[k], 1.0e-3F)))
+			{
+				ball = candidate[k];
+			}
+		}
+
+		if (ball.radius2 == Math::infinity)
+		{
+			ball = candidate[0];
+			ball.radius2 = Fmax(ball.radius2, SquaredMag(c - ball.center));
+		}
+
+		return (ball);
+	}
+
+	void FindExtremePoints(int32 count, const Point3D *point, int32 *minIndex, int32 *maxIndex)
+	{
+		float	minValue[kExtremeDirectionCount];
+		float	maxValue[kExtremeDirectionCount];
+
+		for (machine d = 0; d < kExtremeDirectionCount; d++)
+		{
+			minValue[d] = Math::infinity;
+			maxValue[d] = Math::minus_infinity;
+			minIndex[d] = 0;
+			maxIndex[d] = 0;
+		}
+
+		machine i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			if (count >= 4)
+			{
+				alignas(16) static const int32 laneIndex[4] = {0, 1, 2, 3};
+
+				vec_float	vmin[kExtremeDirectionCount];
+				vec_float	vmax[kExtremeDirectionCount];
+				vec_int32	imin[kExtremeDirectionCount];
+				vec_int32	imax[kExtremeDirectionCount];
+				vec_float	proj[kExtremeDirectionCount];
+
+				vec_int32 index = VecInt32Load(laneIndex);
+				const vec_int32 four = VecInt32LoadConstant<4>();
+
+				for (machine d = 0; d < kExtremeDirectionCount; d++)
+				{
+					vmin[d] = VecLoadSmearScalar(&Math::infinity);
+					vmax[d] = VecLoadSmearScalar(&Math::minus_infinity);
+					imin[d] = index;
+					imax[d] = index;
+				}
+
+				for (; i + 4 <= count; i += 4)
+				{
+					vec_float	x, y, z;
+
+					VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+
+					vec_float xpy = VecAdd(x, y);
+					vec_float xmy = VecSub(x, y);
+					proj[0] = x;
+					proj[1] = y;
+					proj[2] = z;
+					proj[3] = VecAdd(xpy, z);
+					proj[4] = VecSub(xpy, z);
+					proj[5] = VecAdd(xmy, z);
+					proj[6] = VecSub(xmy, z);
+
+					for (machine d = 0; d < kExtremeDirectionCount; d++)
+					{
+						vec_float less = VecMaskCmplt(proj[d], vmin[d]);
+						vec_float greater = VecMaskCmpgt(proj[d], vmax[d]);
+						vmin[d] = VecSelect(vmin[d], proj[d], less);
+						vmax[d] = VecSelect(vmax[d], proj[d], greater);
+						imin[d] = VecInt32Select(imin[d], index, VecCastInt32(less));
+						imax[d] = VecInt32Select(imax[d], index, VecCastInt32(greater));
+					}
+
+					index = VecInt32Add(index, four);
+				}
+
+				// Reduce the four lanes for each direction.
+
+				alignas(16) float	value[2][4];
+				alignas(16) int32	lane[2][4];
+
+				for (machine d = 0; d < kExtremeDirectionCount; d++)
+				{
+					VecStore(vmin[d], value[0]);
+					VecStore(vmax[d], value[1]);
+					VecInt32Store(imin[d], lane[0]);
+					VecInt32Store(imax[d], lane[1]);
+
+					for (machine k = 0; k < 4; k++)
+					{
+						if (value[0][k] < minValue[d])
+						{
+							minValue[d] = value[0][k];
+							minIndex[d] = lane[0][k];
+						}
+
+						if (value[1][k] > maxValue[d])
+						{
+							maxValue[d] = value[1][k];
+							maxIndex[d] = lane[1][k];
+						}
+					}
+				}
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			const Point3D& p = point[i];
+			for (machine d = 0; d < kExtremeDirectionCount; d++)
+			{
+				const float *v = extremeDirection[d];
+				float f = p.x * v[0] + p.y * v[1] + p.z * v[2];
+
+				if (f < minValue[d])
+				{
+					minValue[d] = f;
+					minIndex[d] = int32(i);
+				}
+
+				if (f > maxValue[d])
+				{
+					maxValue[d] = f;
+					maxIndex[d] = int32(i);
+				}
+			}
+		}
+	}
+
+	float CalculateMaxSquaredDistance(int32 count, const Point3D *point, const Point3D& center)
+	{
+		float result = 0.0F;
+		machine i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float cx = VecLoadSmearScalar(&center.x);
+			vec_float cy = VecLoadSmearScalar(&center.y);
+			vec_float cz = VecLoadSmearScalar(&center.z);
+			vec_float dmax = VecFloatGetZero();
+
+			for (; i + 4 <= count; i += 4)
+			{
+				vec_float	x, y, z;
+
+				VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+				x = VecSub(x, cx);
+				y = VecSub(y, cy);
+				z = VecSub(z, cz);
+				dmax = VecMax(dmax, VecMadd(x, x, VecMadd(y, y, VecMul(z, z))));
+			}
+
+			alignas(16) float	value[4];
+
+			VecStore(dmax, value);
+			result = Fmax(Fmax(value[0], value[1]), Fmax(value[2], value[3]));
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			result = Fmax(result, SquaredMag(point[i] - center));
+		}
+
+		return (result);
+	}
+
+	void GrowBall(const Point3D& p, Point3D *center, float *radius)
+	{
+		Vector3D v = p - *center;
+		float d = Magnitude(v);
+		if (d > *radius)
+		{
+			float r = (*radius + d) * 0.5F;
+			*center += v * ((r - *radius) / d);
+			*radius = r;
+		}
+	}
+
+	void CalculateApproximateBall(int32 count, const Point3D *point, Point3D *center, float *radius)
+	{
+		int32	minIndex[kExtremeDirectionCount];
+		int32	maxIndex[kExtremeDirectionCount];
+
+		// Start with the sphere whose diameter is the most widely separated pair of extreme points.
+
+		FindExtremePoints(count, point, minIndex, maxIndex);
+
+		int32 best = 0;
+		float bestDistance = -1.0F;
+		for (machine d = 0; d < kExtremeDirectionCount; d++)
+		{
+			float f = SquaredMag(point[maxIndex[d]] - point[minIndex[d]]);
+			if (f > bestDistance)
+			{
+				bestDistance = f;
+				best = int32(d);
+			}
+		}
+
+		const Point3D& a = point[minIndex[best]];
+		const Point3D& b = point[maxIndex[best]];
+		Point3D c = (a + b) * 0.5F;
+		float r = Sqrt(bestDistance) * 0.5F;
+
+		// Grow the sphere to include every point outside it. Four points are tested at a time,
+		// and the scalar update runs only for groups containing a point outside the sphere.
+
+		machine i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			for (; i + 4 <= count; i += 4)
+			{
+				vec_float	x, y, z;
+
+				float r2 = r * r;
+				VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+				x = VecSub(x, VecLoadSmearScalar(&c.x));
+				y = VecSub(y, VecLoadSmearScalar(&c.y));
+				z = VecSub(z, VecLoadSmearScalar(&c.z));
+
+				uint32 outside = VecMaskGetBits(VecMaskCmpgt(VecMadd(x, x, VecMadd(y, y, VecMul(z, z))), VecLoadSmearScalar(&r2)));
+				if (outside != 0)
+				{
+					for (machine k = 0; k < 4; k++)
+					{
+						if (outside & (1 << k))
+						{
+							GrowBall(point[i + k], &c, &r);
+						}
+					}
+				}
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			GrowBall(point[i], &c, &r);
+		}
+
+		*center = c;
+		*radius = r;
+	}
+}
+
+
+/// @brief Returns the unitized 3D sphere having a given center and radius.
+/// @param center	The center of the sphere.
+/// @param radius	The radius of the sphere.
+///
+/// The sphere stores half the difference between the squared radius and the squared distance from the origin to the center, so the
+/// precision of the radius is limited by the distance of the center from the origin. The stored value is rounded so that the squared radius
+/// of the sphere is never smaller than the square of \c radius. When the radius is small compared to that distance, the sphere can
+/// be larger than requested by roughly 0.0004 times the distance, so small spheres far from the origin should be kept as a center and radius.
+///
+/// @relatedalso Sphere3D
+
+Sphere3D Terathon::MakeSphere3D(const Point3D& center, float radius)
+{
+	return (EncodeSphere(center, radius * radius));
+}
+
+
+/// @brief Calculates a sphere that tightly bounds an array of points.
+///
+/// The initial sphere is determined by the most widely separated pair of extreme points along the coordinate axes and
+/// the four diagonals of a cube, and it is then grown to include each point outside it in a single pass, as in Ritter's method.
+/// The extreme points and the containment tests are calculated for four points at a time with SIMD instructions.
+/// The result is typically within several percent of the minimum bounding sphere, and it always contains every point.
+/// See \c MakeSphere3D() for the precision of spheres far from the origin.
+///
+/// @param count	The number of points.
+/// @param point	A pointer to an array of \c count points.
+/// @return The bounding sphere, unitized so that its weight is &minus;1. If \c count is zero, then the result has zero radius and is centered at the origin.
+/// @relatedalso Sphere3D
+
+Sphere3D Terathon::CalculateBoundingSphere(int32 count, const Point3D *point)
+{
+	if (count <= 0)
+	{
+		return (MakeSphere3D(Point3D(0.0F, 0.0F, 0.0F), 0.0F));
+	}
+
+	Point3D		center;
+	float		radius;
+
+	CalculateApproximateBall(count, point, &center, &radius);
+	return (EncodeSphere(center, Fmax(radius * radius, CalculateMaxSquaredDistance(count, point, center)) * kDistanceRoundingScale));
+}
+
+/// @brief Calculates the minimum sphere bounding an array of points.
+///
+/// The minimum bounding sphere is calculated with the incremental form of Welzl's algorithm, which runs in expected linear time
+/// when the points are visited in random order. The points are shuffled with a fixed pseudorandom sequence, so the result is
+/// always the same for the same input. The spheres passing through two, three, or four support points are calculated exactly by
+/// wedging round points together in conformal geometric algebra, and the coordinates are taken relative to the center of an
+/// approximate bounding sphere to preserve precision.
+///
+/// Because of floating-point rounding, the radius is finally increased if necessary so that the sphere contains every point.
+///
+/// The shuffled copy of the points is temporary storage taken from \c arena when one is supplied, so bounds can be recalculated
+/// every frame without allocating memory. If the temporary storage cannot be allocated at all, then the result is the sphere
+/// calculated by the \c CalculateBoundingSphere() function.
+///
+/// @param count	The number of points.
+/// @param point	A pointer to an array of \c count points.
+/// @param arena	A memory arena from which temporary storage is allocated. This can be \c nullptr.
+/// @return The bounding sphere, unitized so that its weight is &minus;1. If \c count is zero, then the result has zero radius and is centered at the origin.
+/// @relatedalso Sphere3D
+
+Sphere3D Terathon::CalculateMinimumBoundingSphere(int32 count, const Point3D *point, MemoryArena *arena)
+{
+	if (count <= 0)
+	{
+		return (MakeSphere3D(Point3D(0.0F, 0.0F, 0.0F), 0.0F));
+	}
+
+	Point3D		base;
+	float		radius;
+
+	CalculateApproximateBall(count, point, &base, &radius);
+
+	ScratchStorage scratch(count * sizeof(Point3D), arena);
+	Point3D *p = static_cast<Point3D *>(scratch.GetStorage());
+	if (!p)
+	{
+		return (EncodeSphere(base, Fmax(radius * radius, CalculateMaxSquaredDistance(count, point, base)) * kDistanceRoundingScale));
+	}
+
+	for (machine i = 0; i < count; i++)
+	{
+		p[i] = Point3D::origin + (point[i] - base);
+	}
+
+	uint32 random = 0x9E3779B9;
+	for (machine i = count - 1; i > 0; i--)
+	{
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+
+		machine j = random % uint32(i + 1);
+		Point3D t = p[i];
+		p[i] = p[j];
+		p[j] = t;
+	}
+
+	Ball	ball;
+
+	ball.center = p[0];
+	ball.radius2 = 0.0F;
+
+	for (machine i = 1; i < count; i++)
+	{
+		if (!BallContains(ball, p[i]))
+		{
+			ball.center = p[i];
+			ball.radius2 = 0.0F;
+
+			for (machine j = 0; j < i; j++)
+			{
+				if (!BallContains(ball, p[j]))
+				{
+					ball = MakeBall(p[i], p[j]);
+
+					for (machine k = 0; k < j; k++)
+					{
+						if (!BallContains(ball, p[k]))
+						{
+							ball = MakeBall(p[i], p[j], p[k]);
+
+							for (machine l = 0; l < k; l++)
+							{
+								if (!BallContains(ball, p[l]))
+								{
+									ball = MakeBall(p[i], p[j], p[k], p[l]);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	Point3D center(base.x + ball.center.x, base.y + ball.center.y, base.z + ball.center.z);
+	return (EncodeSphere(center, Fmax(ball.radius2, CalculateMaxSquaredDistance(count, point, center)) * kDistanceRoundingScale));
+}
+
+/// @brief Calculates the smallest sphere that bounds two spheres.
+/// @param s,t		The spheres to merge. Both must have nonzero weights.
+///
+/// The input spheres are decoded in double precision, and the radius of the result is rounded upward so that it
+/// always contains both spheres exactly.
+///
+/// @return The bounding sphere, unitized so that its weight is &minus;1. If either sphere contains the other, then the result is the larger sphere.
+/// @relatedalso Sphere3D
+
+Sphere3D Terathon::MergeBoundingSpheres(const Sphere3D& s, const Sphere3D& t)
+{
+	double		c1[3], c2[3];
+	double		r1sq, r2sq;
+
+	DecodeSphere(s, c1, &r1sq);
+	DecodeSphere(t, c2, &r2sq);
+
+	double dx = c2[0] - c1[0];
+	double dy = c2[1] - c1[1];
+	double dz = c2[2] - c1[2];
+	double d = RoundUpwardSqrt(dx * dx + dy * dy + dz * dz);
+	double r1 = RoundUpwardSqrt(r1sq);
+	double r2 = RoundUpwardSqrt(r2sq);
+
+	Point3D center;
+	if (d + r2 <= r1)
+	{
+		center.Set(float(c1[0]), float(c1[1]), float(c1[2]));
+	}
+	else if (d + r1 <= r2)
+	{
+		center.Set(float(c2[0]), float(c2[1]), float(c2[2]));
+	}
+	else
+	{
+		double f = (d + r2 - r1) * 0.5 / d;
+		center.Set(float(c1[0] + dx * f), float(c1[1] + dy * f), float(c1[2] + dz * f));
+	}
+
+	// The center is rounded to single precision, so the radius is measured from the rounded center to each input sphere.
+
+	float radius = Fmax(CalculateEnclosingRadius(center, c1, r1sq), CalculateEnclosingRadius(center, c2, r2sq));
+	return (EncodeSphere(center, RoundUpward(double(radius) * double(radius))));
+}
+
+/// @brief Calculates a sphere that bounds an array of spheres.
+///
+/// The spheres are merged one at a time, so the result bounds all of the spheres but is not necessarily the smallest such sphere.
+///
+/// @param count	The number of spheres.
+/// @param sphere	A pointer to an array of \c count spheres. Each sphere must have a nonzero weight.
+/// @return The bounding sphere, unitized so that its weight is &minus;1. If \c count is zero, then the result has zero radius and is centered at the origin.
+/// @relatedalso Sphere3D
+
+Sphere3D Terathon::MergeBoundingSpheres(int32 count, const Sphere3D *sphere)
+{
+	if (count <= 0)
+	{
+		return (MakeSphere3D(Point3D(0.0F, 0.0F, 0.0F), 0.0F));
+	}
+
+	Sphere3D result = MergeBoundingSpheres(sphere[0], sphere[0]);
+	for (machine i = 1; i < count; i++)
+	{
+		result = MergeBoundingSpheres(result, sphere[i]);
+	}
+
+	return (result);
+}
@@ -0,0 +1,53 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSBoundingSphere_h
+#define TSBoundingSphere_h
+
+
+#include "TSConformal3D.h"
+#include "TSMemory.h"
+
+
+#define TERATHON_BOUNDINGSPHERE 1
+
+
+namespace Terathon
+{
+	/// @brief Returns the Euclidean center of a 3D sphere.
+	/// @param s	The sphere, which must have a nonzero weight.
+	/// @relatedalso Sphere3D
+
+	inline Point3D GetSphereCenter(const Sphere3D& s)
+	{
+		float f = -1.0F / s.u;
+		return (Point3D(s.x * f, s.y * f, s.z * f));
+	}
+
+	/// @brief Returns the radius of a 3D sphere.
+	/// @param s	The sphere, which must have a nonzero weight.
+	/// @relatedalso Sphere3D
+
+	inline float GetSphereRadius(const Sphere3D& s)
+	{
+		return (Sqrt(FmaxZero(SquaredRadiusNorm(s))) / Fabs(s.u));
+	}
+
+
+	TERATHON_API Sphere3D MakeSphere3D(const Point3D& center, float radius);
+
+	TERATHON_API Sphere3D CalculateBoundingSphere(int32 count, const Point3D *point);
+	TERATHON_API Sphere3D CalculateMinimumBoundingSphere(int32 count, const Point3D *point, MemoryArena *arena = nullptr);
+
+	TERATHON_API Sphere3D MergeBoundingSpheres(const Sphere3D& s, const Sphere3D& t);
+	TERATHON_API Sphere3D MergeBoundingSpheres(int32 count, const Sphere3D *sphere);
+}
+
+
+#endif
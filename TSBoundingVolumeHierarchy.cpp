@@ -0,0 +1,1191 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSBoundingVolumeHierarchy.h"
+#include "TSConformal3D.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum : int32
+	{
+		kMaxSurfaceAreaDepth	= 32,
+		kTraversalStackSize		= BoundingVolumeHierarchy::kMaxTreeDepth * 3 + 1
+	};
+
+
+	typedef BoundingVolumeHierarchy::Node HierarchyNode;
+
+
+	struct SurfaceAreaBin
+	{
+		Box3D		bounds;
+		int32		count;
+	};
+
+
+	struct RayStackEntry
+	{
+		int32		nodeIndex;
+		float		param;
+	};
+
+
+	inline Box3D MakeSphereBox(const Point3D& center, float radius)
+	{
+		return (Box3D(Point3D(center.x - radius, center.y - radius, center.z - radius), Point3D(center.x + radius, center.y + radius, center.z + radius)));
+	}
+
+	Box3D MakeSphereBox(const Sphere3D& sphere)
+	{
+		// The flat center of a sphere is (x, y, z, -u), and its squared radius is the
+		// squared radius norm divided by the square of the weight.
+
+		float f = -1.0F / sphere.u;
+		float r2 = SquaredRadiusNorm(sphere) * (f * f);
+		return (MakeSphereBox(Point3D(sphere.x * f, sphere.y * f, sphere.z * f), Sqrt(FmaxZero(r2))));
+	}
+
+	inline int32 GetBinIndex(float coord, float base, float scale)
+	{
+		int32 bin = int32((coord - base) * scale);
+		return ((bin < int32(BoundingVolumeHierarchy::kSurfaceAreaBinCount)) ? bin : BoundingVolumeHierarchy::kSurfaceAreaBinCount - 1);
+	}
+
+	void SelectMedian(const Point3D *centroid, int32 *index, int32 axis, int32 left, int32 right, int32 median)
+	{
+		// Rearrange the primitives in the range [left, right] so that the primitive at the median
+		// position has the centroid coordinate it would have if the range were sorted.
+
+		while (left < right)
+		{
+			float pivot = centroid[index[(left + right) >> 1]][axis];
+			int32 i = left;
+			int32 j = right;
+
+			do
+			{
+				while (centroid[index[i]][axis] < pivot)
+				{
+					i++;
+				}
+
+				while (pivot < centroid[index[j]][axis])
+				{
+					j--;
+				}
+
+				if (i <= j)
+				{
+					int32 k = index[i];
+					index[i] = index[j];
+					index[j] = k;
+					i++;
+					j--;
+				}
+			} while (i <= j);
+
+			if (median <= j)
+			{
+				right = j;
+			}
+			else if (median >= i)
+			{
+				left = i;
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+
+	// A ray is stored with the reciprocals of its direction components and the products of the origin
+	// and reciprocals so that each slab distance is a single multiply-add. Zero direction components are
+	// replaced by a tiny value with the same sign so that no product of zero and infinity occurs.
+
+	struct RayData
+	{
+		float		inverse[3];
+		float		offset[3];
+		float		minParam;
+		float		maxParam;
+		bool		negative[3];
+
+		RayData(const Point3D& p, const Vector3D& v, float tmin, float tmax)
+		{
+			for (machine a = 0; a < 3; a++)
+			{
+				float d = v[a];
+				negative[a] = (d < 0.0F);
+				if (Fabs(d) < 1.0e-30F)
+				{
+					d = (negative[a]) ? -1.0e-30F : 1.0e-30F;
+				}
+
+				inverse[a] = 1.0F / d;
+				offset[a] = -p[a] * inverse[a];
+			}
+
+			minParam = tmin;
+			maxParam = tmax;
+		}
+
+		float IntersectBox(const Box3D& box, float tmax) const
+		{
+			float entry = minParam;
+			float leave = tmax;
+
+			for (machine a = 0; a < 3; a++)
+			{
+				float t1 = box.min[a] * inverse[a] + offset[a];
+				float t2 = box.max[a] * inverse[a] + offset[a];
+				if (negative[a])
+				{
+					float t = t1;
+					t1 = t2;
+					t2 = t;
+				}
+
+				entry = Fmax(entry, t1);
+				leave = Fmin(leave, t2);
+			}
+
+			return ((entry <= leave) ? entry : Math::infinity);
+		}
+	};
+
+
+	void CalculateRayNodeParams(const HierarchyNode *node, const RayData& ray, float tmax, float *param)
+	{
+		// For each of the four children, store the parameter at which the ray enters the bounding box,
+		// or infinity if the ray misses the box within the range [ray.minParam, tmax].
+
+		const float *nearX = (ray.negative[0]) ? node->maxX : node->minX;
+		const float *nearY = (ray.negative[1]) ? node->maxY : node->minY;
+		const float *nearZ = (ray.negative[2]) ? node->maxZ : node->minZ;
+		const float *farX = (ray.negative[0]) ? node->minX : node->maxX;
+		const float *farY = (ray.negative[1]) ? node->minY : node->maxY;
+		const float *farZ = (ray.negative[2]) ? node->minZ : node->maxZ;
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float ix = VecLoadSmearScalar(&ray.inverse[0]);
+			vec_float iy = VecLoadSmearScalar(&ray.inverse[1]);
+			vec_float iz = VecLoadSmearScalar(&ray.inverse[2]);
+			vec_float ox = VecLoadSmearScalar(&ray.offset[0]);
+			vec_float oy = VecLoadSmearScalar(&ray.offset[1]);
+			vec_float oz = VecLoadSmearScalar(&ray.offset[2]);
+
+			vec_float entry = VecMax(VecMax(VecMadd(VecLoad(nearX), ix, ox), VecMadd(VecLoad(nearY), iy, oy)), VecMax(VecMadd(VecLoad(nearZ), iz, oz), VecLoadSmearScalar(&ray.minParam)));
+			vec_float leave = VecMin(VecMin(VecMadd(VecLoad(farX), ix, ox), VecMadd(VecLoad(farY), iy, oy)), VecMin(VecMadd(VecLoad(farZ), iz, oz), VecLoadSmearScalar(&tmax)));
+			VecStore(VecSelect(entry, VecLoadSmearScalar(&Math::infinity), VecMaskCmpgt(entry, leave)), param);
+
+		#else
+
+			for (machine i = 0; i < 4; i++)
+			{
+				float entry = Fmax(Fmax(nearX[i] * ray.inverse[0] + ray.offset[0], nearY[i] * ray.inverse[1] + ray.offset[1]), Fmax(nearZ[i] * ray.inverse[2] + ray.offset[2], ray.minParam));
+				float leave = Fmin(Fmin(farX[i] * ray.inverse[0] + ray.offset[0], farY[i] * ray.inverse[1] + ray.offset[1]), Fmin(farZ[i] * ray.inverse[2] + ray.offset[2], tmax));
+				param[i] = (entry <= leave) ? entry : Math::infinity;
+			}
+
+		#endif
+	}
+
+
+	// Each query type classifies the four children of a node by storing 0.0 in the result array for
+	// a child that is rejected, 1.0 for a child that must be examined further, and 2.0 for a child
+	// whose entire subtree is accepted without further tests. It also tests individual primitive boxes.
+
+	struct BoxQuery
+	{
+		const Box3D&	box;
+
+		BoxQuery(const Box3D& b) : box(b) {}
+
+		void ClassifyNode(const HierarchyNode *node, float *result) const
+		{
+			#ifndef TERATHON_NO_SIMD
+
+				float bminX = box.min.x, bminY = box.min.y, bminZ = box.min.z;
+				float bmaxX = box.max.x, bmaxY = box.max.y, bmaxZ = box.max.z;
+
+				vec_float miss = VecOr(VecMaskCmpgt(VecLoad(node->minX), VecLoadSmearScalar(&bmaxX)), VecMaskCmplt(VecLoad(node->maxX), VecLoadSmearScalar(&bminX)));
+				miss = VecOr(miss, VecOr(VecMaskCmpgt(VecLoad(node->minY), VecLoadSmearScalar(&bmaxY)), VecMaskCmplt(VecLoad(node->maxY), VecLoadSmearScalar(&bminY))));
+				miss = VecOr(miss, VecOr(VecMaskCmpgt(VecLoad(node->minZ), VecLoadSmearScalar(&bmaxZ)), VecMaskCmplt(VecLoad(node->maxZ), VecLoadSmearScalar(&bminZ))));
+				VecStore(VecAndc(VecLoadVectorConstant<0x3F800000>(), miss), result);
+
+			#else
+
+				for (machine i = 0; i < 4; i++)
+				{
+					bool hit = (node->minX[i] <= box.max.x) && (node->maxX[i] >= box.min.x) && (node->minY[i] <= box.max.y) && (node->maxY[i] >= box.min.y) && (node->minZ[i] <= box.max.z) && (node->maxZ[i] >= box.min.z);
+					result[i] = (hit) ? 1.0F : 0.0F;
+				}
+
+			#endif
+		}
+
+		bool TestPrimitive(const Box3D& primitiveBox) const
+		{
+			return (Overlap(primitiveBox, box));
+		}
+	};
+
+	struct RayQuery
+	{
+		const RayData&	ray;
+
+		RayQuery(const RayData& r) : ray(r) {}
+
+		void ClassifyNode(const HierarchyNode *node, float *result) const
+		{
+			CalculateRayNodeParams(node, ray, ray.maxParam, result);
+			for (machine i = 0; i < 4; i++)
+			{
+				result[i] = (result[i] < Math::infinity) ? 1.0F : 0.0F;
+			}
+		}
+
+		bool TestPrimitive(const Box3D& primitiveBox) const
+		{
+			return (ray.IntersectBox(primitiveBox, ray.maxParam) < Math::infinity);
+		}
+	};
+
+	struct FrustumQuery
+	{
+		int32				planeCount;
+		const Plane3D		*plane;
+
+		FrustumQuery(int32 count, const Plane3D *p)
+		{
+			planeCount = count;
+			plane = p;
+		}
+
+		void ClassifyNode(const HierarchyNode *node, float *result) const
+		{
+			// For each plane, the box corner farthest along the plane normal determines whether the box
+			// lies entirely outside, and the opposite corner determines whether it lies entirely inside.
+
+			#ifndef TERATHON_NO_SIMD
+
+				vec_float outside = VecFloatGetZero();
+				vec_float crossing = VecFloatGetZero();
+
+				for (machine j = 0; j < planeCount; j++)
+				{
+					const Plane3D& g = plane[j];
+					float a = g.x, b = g.y, c = g.z, d = g.w;
+
+					vec_float va = VecLoadSmearScalar(&a);
+					vec_float vb = VecLoadSmearScalar(&b);
+					vec_float vc = VecLoadSmearScalar(&c);
+					vec_float vd = VecLoadSmearScalar(&d);
+
+					vec_float outer = VecMadd(VecLoad((a < 0.0F) ? node->minX : node->maxX), va, vd);
+					outer = VecMadd(VecLoad((b < 0.0F) ? node->minY : node->maxY), vb, outer);
+					outer = VecMadd(VecLoad((c < 0.0F) ? node->minZ : node->maxZ), vc, outer);
+
+					vec_float inner = VecMadd(VecLoad((a < 0.0F) ? node->maxX : node->minX), va, vd);
+					inner = VecMadd(VecLoad((b < 0.0F) ? node->maxY : node->minY), vb, inner);
+					inner = VecMadd(VecLoad((c < 0.0F) ? node->maxZ : node->minZ), vc, inner);
+
+					outside = VecOr(outside, VecMaskCmplt(outer, VecFloatGetZero()));
+					crossing = VecOr(crossing, VecMaskCmplt(inner, VecFloatGetZero()));
+				}
+
+				const vec_float one = VecLoadVectorConstant<0x3F800000>();
+				VecStore(VecAndc(VecAdd(one, VecAndc(one, crossing)), outside), result);
+
+			#else
+
+				for (machine i = 0; i < 4; i++)
+				{
+					float value = 2.0F;
+					for (machine j = 0; j < planeCount; j++)
+					{
+						const Plane3D& g = plane[j];
+						float outer = g.w, inner = g.w;
+
+						outer += g.x * ((g.x < 0.0F) ? node->minX[i] : node->maxX[i]);
+						outer += g.y * ((g.y < 0.0F) ? node->minY[i] : node->maxY[i]);
+						outer += g.z * ((g.z < 0.0F) ? node->minZ[i] : node->maxZ[i]);
+						inner += g.x * ((g.x < 0.0F) ? node->maxX[i] : node->minX[i]);
+						inner += g.y * ((g.y < 0.0F) ? node->maxY[i] : node->minY[i]);
+						inner += g.z * ((g.z < 0.0F) ? node->maxZ[i] : node->minZ[i]);
+
+						if (outer < 0.0F)
+						{
+							value = 0.0F;
+							break;
+						}
+
+						if (inner < 0.0F)
+						{
+							value = 1.0F;
+						}
+					}
+
+					result[i] = value;
+				}
+
+			#endif
+		}
+
+		bool TestPrimitive(const Box3D& primitiveBox) const
+		{
+			for (machine j = 0; j < planeCount; j++)
+			{
+				const Plane3D& g = plane[j];
+				float x = (g.x < 0.0F) ? primitiveBox.min.x : primitiveBox.max.x;
+				float y = (g.y < 0.0F) ? primitiveBox.min.y : primitiveBox.max.y;
+				float z = (g.z < 0.0F) ? primitiveBox.min.z : primitiveBox.max.z;
+				if (g.x * x + g.y * y + g.z * z + g.w < 0.0F)
+				{
+					return (false);
+				}
+			}
+
+			return (true);
+		}
+	};
+
+
+	template <class query_type>
+	int32 FindPrimitives(const BoundingVolumeHierarchy *hierarchy, const query_type& query, int32 maxCount, int32 *index)
+	{
+		int32 nodeCount = hierarchy->GetNodeCount();
+		if (nodeCount == 0)
+		{
+			return (0);
+		}
+
+		const HierarchyNode *nodeArray = hierarchy->GetNodeArray();
+
+		int32				stack[kTraversalStackSize];
+		alignas(16) float	result[4];
+
+		int32 resultCount = 0;
+		int32 stackCount = 1;
+		stack[0] = 0;
+
+		do
+		{
+			const HierarchyNode *node = &nodeArray[stack[--stackCount]];
+			query.ClassifyNode(node, result);
+
+			for (machine i = 0; i < 4; i++)
+			{
+				int32 count = node->count[i];
+				if ((result[i] == 0.0F) || (count == 0))
+				{
+					continue;
+				}
+
+				int32 start = node->start[i];
+				if (result[i] > 1.0F)
+				{
+					// The entire subtree is accepted, and its primitives occupy a contiguous range.
+
+					for (machine k = 0; k < count; k++)
+					{
+						if (resultCount < maxCount)
+						{
+							index[resultCount] = hierarchy->GetPrimitiveIndex(int32(start + k));
+						}
+
+						resultCount++;
+					}
+				}
+				else if (node->child[i] >= 0)
+				{
+					stack[stackCount++] = node->child[i];
+				}
+				else
+				{
+					for (machine k = start; k < start + count; k++)
+					{
+						if (query.TestPrimitive(hierarchy->GetPrimitiveBox(int32(k))))
+						{
+							if (resultCount < maxCount)
+							{
+								index[resultCount] = hierarchy->GetPrimitiveIndex(int32(k));
+							}
+
+							resultCount++;
+						}
+					}
+				}
+			}
+		} while (stackCount != 0);
+
+		return (resultCount);
+	}
+}
+
+
+struct BoundingVolumeHierarchy::BuildRange
+{
+	int32		start;
+	int32		count;
+	int32		depth;
+	int32		splitCount;
+
+	Box3D		bounds;
+	Box3D		leftBounds;
+	Box3D		rightBounds;
+};
+
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+{
+	primitiveCount = 0;
+	nodeCount = 0;
+	primitiveCapacity = 0;
+	nodeArray = nullptr;
+	primitiveIndex = nullptr;
+	primitiveBox = nullptr;
+	treeStorage = nullptr;
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(int32 count, const Box3D *box)
+{
+	primitiveCount = 0;
+	nodeCount = 0;
+	primitiveCapacity = 0;
+	nodeArray = nullptr;
+	primitiveIndex = nullptr;
+	primitiveBox = nullptr;
+	treeStorage = nullptr;
+
+	Build(count, box);
+}
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+{
+	ReleaseAligned(treeStorage);
+}
+
+void BoundingVolumeHierarchy::Release(void)
+{
+	ReleaseAligned(treeStorage);
+	treeStorage = nullptr;
+	nodeArray = nullptr;
+	primitiveIndex = nullptr;
+	primitiveBox = nullptr;
+	primitiveCount = 0;
+	nodeCount = 0;
+	primitiveCapacity = 0;
+}
+
+bool BoundingVolumeHierarchy::Prepare(int32 count)
+{
+	nodeCount = 0;
+	if (count <= 0)
+	{
+		primitiveCount = 0;
+		return (false);
+	}
+
+	// Every node other than a root leaf consumes at least one binary split, and there are
+	// fewer splits than primitives, so the number of nodes never exceeds the number of primitives.
+	// The primitive boxes are followed by an equal amount of scratch space used while building.
+
+	if (count > primitiveCapacity)
+	{
+		Release();
+
+		treeStorage = AllocateAligned(AlignSize(count * sizeof(Node)) + AlignSize(count * sizeof(int32)) + count * sizeof(Box3D) * 2);
+		if (!treeStorage)
+		{
+			return (false);
+		}
+
+		primitiveCapacity = count;
+	}
+
+	char *storage = static_cast<char *>(treeStorage);
+	nodeArray = reinterpret_cast<Node *>(storage);
+	primitiveIndex = reinterpret_cast<int32 *>(storage + AlignSize(primitiveCapacity * sizeof(Node)));
+	primitiveBox = reinterpret_cast<Box3D *>(reinterpret_cast<char *>(primitiveIndex) + AlignSize(primitiveCapacity * sizeof(int32)));
+
+	primitiveCount = count;
+	return (true);
+}
+
+void BoundingVolumeHierarchy::SplitRange(BuildRange *range, const Point3D *centroid) const
+{
+	// Choose a partition of the primitives in the range and reorder their indices so that the left
+	// part comes first. If the range should become a leaf, then splitCount is set to zero.
+
+	int32 count = range->count;
+	range->splitCount = 0;
+	if (count <= 1)
+	{
+		return;
+	}
+
+	int32 *index = primitiveIndex + range->start;
+
+	Box3D centroidBounds;
+	centroidBounds.SetEmpty();
+	for (machine k = 0; k < count; k++)
+	{
+		centroidBounds.Include(centroid[index[k]]);
+	}
+
+	Vector3D extent = centroidBounds.GetSize();
+	int32 largestAxis = (extent.x > extent.y) ? ((extent.x > extent.z) ? 0 : 2) : ((extent.y > extent.z) ? 1 : 2);
+
+	int32 split = 0;
+	if (!(extent[largestAxis] > 0.0F))
+	{
+		// All centroids coincide, so no partition is better than any other.
+
+		if (count <= int32(kMaxLeafPrimitiveCount))
+		{
+			return;
+		}
+
+		split = count >> 1;
+	}
+	else if (range->depth >= kMaxSurfaceAreaDepth)
+	{
+		// Splitting at the median bounds the depth of the tree in degenerate cases.
+
+		split = count >> 1;
+		SelectMedian(centroid, index, largestAxis, 0, count - 1, split);
+	}
+	else
+	{
+		SurfaceAreaBin		bin[3][kSurfaceAreaBinCount];
+		float				scale[3];
+		float				rightArea[kSurfaceAreaBinCount];
+		int32				rightCount[kSurfaceAreaBinCount];
+
+		for (machine a = 0; a < 3; a++)
+		{
+			scale[a] = float(kSurfaceAreaBinCount) / extent[a];
+			if (!(scale[a] < Math::infinity))
+			{
+				scale[a] = 0.0F;
+			}
+
+			for (machine b = 0; b < kSurfaceAreaBinCount; b++)
+			{
+				bin[a][b].bounds.SetEmpty();
+				bin[a][b].count = 0;
+			}
+		}
+
+		for (machine k = 0; k < count; k++)
+		{
+			const Point3D& c = centroid[index[k]];
+			const Box3D& box = primitiveBox[index[k]];
+			for (machine a = 0; a < 3; a++)
+			{
+				SurfaceAreaBin *b = &bin[a][GetBinIndex(c[a], centroidBounds.min[a], scale[a])];
+				b->bounds.Include(box);
+				b->count++;
+			}
+		}
+
+		float bestCost = Math::infinity;
+		int32 bestAxis = 0;
+		int32 bestBin = 0;
+
+		for (machine a = 0; a < 3; a++)
+		{
+			if (scale[a] == 0.0F)
+			{
+				continue;
+			}
+
+			Box3D bounds = bin[a][kSurfaceAreaBinCount - 1].bounds;
+			int32 n = bin[a][kSurfaceAreaBinCount - 1].count;
+			for (machine b = kSurfaceAreaBinCount - 2; b >= 0; b--)
+			{
+				rightArea[b] = bounds.GetSurfaceArea();
+				rightCount[b] = n;
+				bounds.Include(bin[a][b].bounds);
+				n += bin[a][b].count;
+			}
+
+			bounds.SetEmpty();
+			n = 0;
+			for (machine b = 0; b < kSurfaceAreaBinCount - 1; b++)
+			{
+				bounds.Include(bin[a][b].bounds);
+				n += bin[a][b].count;
+
+				if ((n != 0) && (rightCount[b] != 0))
+				{
+					float cost = bounds.GetSurfaceArea() * float(n) + rightArea[b] * float(rightCount[b]);
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestAxis = int32(a);
+						bestBin = int32(b);
+					}
+				}
+			}
+		}
+
+		if (count <= int32(kMaxLeafPrimitiveCount))
+		{
+			// The cost of a split, relative to the cost of intersecting one primitive, is the cost of
+			// one node traversal plus the expected number of primitives intersected in the two parts.
+
+			if (!(bestCost < range->bounds.GetSurfaceArea() * float(count - 1)))
+			{
+				return;
+			}
+		}
+
+		if (bestCost < Math::infinity)
+		{
+			int32 i = 0;
+			int32 j = count - 1;
+			float base = centroidBounds.min[bestAxis];
+			float s = scale[bestAxis];
+
+			for (;;)
+			{
+				while ((i <= j) && (GetBinIndex(centroid[index[i]][bestAxis], base, s) <= bestBin))
+				{
+					i++;
+				}
+
+				while ((i <= j) && (GetBinIndex(centroid[index[j]][bestAxis], base, s) > bestBin))
+				{
+					j--;
+				}
+
+				if (i >= j)
+				{
+					break;
+				}
+
+				int32 t = index[i];
+				index[i] = index[j];
+				index[j] = t;
+			}
+
+			split = i;
+		}
+		else
+		{
+			split = count >> 1;
+			SelectMedian(centroid, index, largestAxis, 0, count - 1, split);
+		}
+	}
+
+	range->leftBounds.SetEmpty();
+	for (machine k = 0; k < split; k++)
+	{
+		range->leftBounds.Include(primitiveBox[index[k]]);
+	}
+
+	range->rightBounds.SetEmpty();
+	for (machine k = split; k < count; k++)
+	{
+		range->rightBounds.Include(primitiveBox[index[k]]);
+	}
+
+	range->splitCount = split;
+}
+
+int32 BoundingVolumeHierarchy::BuildNode(const BuildRange *range, const Point3D *centroid)
+{
+	int32 nodeIndex = nodeCount++;
+
+	BuildRange		slot[4];
+	int32			slotCount = 1;
+
+	slot[0] = *range;
+
+	// Repeatedly replace the child with the largest surface area by the two parts of its partition
+	// until the node has four children or no child can be split further.
+
+	for (;;)
+	{
+		int32 k = -1;
+		float largestArea = -1.0F;
+		for (machine i = 0; i < slotCount; i++)
+		{
+			if (slot[i].splitCount != 0)
+			{
+				float area = slot[i].bounds.GetSurfaceArea();
+				if (area > largestArea)
+				{
+					largestArea = area;
+					k = int32(i);
+				}
+			}
+		}
+
+		if ((k < 0) || (slotCount == 4))
+		{
+			break;
+		}
+
+		const BuildRange parent = slot[k];
+		BuildRange *left = &slot[k];
+		BuildRange *right = &slot[slotCount++];
+
+		left->start = parent.start;
+		left->count = parent.splitCount;
+		left->depth = parent.depth + 1;
+		left->bounds = parent.leftBounds;
+		SplitRange(left, centroid);
+
+		right->start = parent.start + parent.splitCount;
+		right->count = parent.count - parent.splitCount;
+		right->depth = parent.depth + 1;
+		right->bounds = parent.rightBounds;
+		SplitRange(right, centroid);
+	}
+
+	for (machine i = 0; i < 4; i++)
+	{
+		if (i < slotCount)
+		{
+			const BuildRange& s = slot[i];
+			nodeArray[nodeIndex].minX[i] = s.bounds.min.x;
+			nodeArray[nodeIndex].minY[i] = s.bounds.min.y;
+			nodeArray[nodeIndex].minZ[i] = s.bounds.min.z;
+			nodeArray[nodeIndex].maxX[i] = s.bounds.max.x;
+			nodeArray[nodeIndex].maxY[i] = s.bounds.max.y;
+			nodeArray[nodeIndex].maxZ[i] = s.bounds.max.z;
+			nodeArray[nodeIndex].start[i] = s.start;
+			nodeArray[nodeIndex].count[i] = s.count;
+			nodeArray[nodeIndex].child[i] = (s.splitCount != 0) ? BuildNode(&s, centroid) : -1;
+		}
+		else
+		{
+			nodeArray[nodeIndex].minX[i] = Math::infinity;
+			nodeArray[nodeIndex].minY[i] = Math::infinity;
+			nodeArray[nodeIndex].minZ[i] = Math::infinity;
+			nodeArray[nodeIndex].maxX[i] = Math::minus_infinity;
+			nodeArray[nodeIndex].maxY[i] = Math::minus_infinity;
+			nodeArray[nodeIndex].maxZ[i] = Math::minus_infinity;
+			nodeArray[nodeIndex].start[i] = 0;
+			nodeArray[nodeIndex].count[i] = 0;
+			nodeArray[nodeIndex].child[i] = -1;
+		}
+	}
+
+	return (nodeIndex);
+}
+
+void BoundingVolumeHierarchy::BuildTree(void)
+{
+	// On entry, the primitive box array holds the boxes in their original order. The nodes are built
+	// with the boxes in place, and the boxes are then reordered to match the leaves. The scratch space
+	// following the primitive boxes holds the centroids and then the reordered boxes.
+
+	int32 count = primitiveCount;
+	Box3D *temp = primitiveBox + primitiveCapacity;
+	Point3D *centroid = reinterpret_cast<Point3D *>(temp);
+
+	BuildRange		root;
+
+	root.bounds.SetEmpty();
+	for (machine k = 0; k < count; k++)
+	{
+		const Box3D& box = primitiveBox[k];
+		root.bounds.Include(box);
+		centroid[k] = box.GetCenter();
+		primitiveIndex[k] = int32(k);
+	}
+
+	root.start = 0;
+	root.count = count;
+	root.depth = 0;
+	SplitRange(&root, centroid);
+
+	nodeCount = 0;
+	BuildNode(&root, centroid);
+
+	for (machine k = 0; k < count; k++)
+	{
+		temp[k] = primitiveBox[primitiveIndex[k]];
+	}
+
+	CopyMemory(temp, primitiveBox, count * sizeof(Box3D));
+}
+
+void BoundingVolumeHierarchy::RefitNodes(void)
+{
+	// Children always have larger indices than their parents, so visiting the nodes in reverse
+	// order updates every child before the node that contains it.
+
+	for (machine n = nodeCount - 1; n >= 0; n--)
+	{
+		Node *node = &nodeArray[n];
+		for (machine i = 0; i < 4; i++)
+		{
+			int32 count = node->count[i];
+			if (count == 0)
+			{
+				continue;
+			}
+
+			Box3D	bounds;
+
+			int32 child = node->child[i];
+			if (child >= 0)
+			{
+				const Node *subnode = &nodeArray[child];
+				bounds.min.Set(Fmin(subnode->minX[0], subnode->minX[1], subnode->minX[2], subnode->minX[3]), Fmin(subnode->minY[0], subnode->minY[1], subnode->minY[2], subnode->minY[3]), Fmin(subnode->minZ[0], subnode->minZ[1], subnode->minZ[2], subnode->minZ[3]));
+				bounds.max.Set(Fmax(subnode->maxX[0], subnode->maxX[1], subnode->maxX[2], subnode->maxX[3]), Fmax(subnode->maxY[0], subnode->maxY[1], subnode->maxY[2], subnode->maxY[3]), Fmax(subnode->maxZ[0], subnode->maxZ[1], subnode->maxZ[2], subnode->maxZ[3]));
+			}
+			else
+			{
+				int32 start = node->start[i];
+				bounds = primitiveBox[start];
+				for (machine k = 1; k < count; k++)
+				{
+					bounds.Include(primitiveBox[start + k]);
+				}
+			}
+
+			node->minX[i] = bounds.min.x;
+			node->minY[i] = bounds.min.y;
+			node->minZ[i] = bounds.min.z;
+			node->maxX[i] = bounds.max.x;
+			node->maxY[i] = bounds.max.y;
+			node->maxZ[i] = bounds.max.z;
+		}
+	}
+}
+
+/// @brief Returns the bounding box of all primitives in the hierarchy.
+///
+/// If the hierarchy is empty, then an empty box is returned.
+
+Box3D BoundingVolumeHierarchy::GetBounds(void) const
+{
+	Box3D	bounds;
+
+	bounds.SetEmpty();
+	if (nodeCount != 0)
+	{
+		const Node *node = nodeArray;
+		bounds.min.Set(Fmin(node->minX[0], node->minX[1], node->minX[2], node->minX[3]), Fmin(node->minY[0], node->minY[1], node->minY[2], node->minY[3]), Fmin(node->minZ[0], node->minZ[1], node->minZ[2], node->minZ[3]));
+		bounds.max.Set(Fmax(node->maxX[0], node->maxX[1], node->maxX[2], node->maxX[3]), Fmax(node->maxY[0], node->maxY[1], node->maxY[2], node->maxY[3]), Fmax(node->maxZ[0], node->maxZ[1], node->maxZ[2], node->maxZ[3]));
+	}
+
+	return (bounds);
+}
+
+/// @brief Builds the hierarchy for a set of boxes.
+/// @param count	The number of primitives.
+/// @param box		A pointer to an array of \c count bounding boxes, one for each primitive.
+
+void BoundingVolumeHierarchy::Build(int32 count, const Box3D *box)
+{
+	if (Prepare(count))
+	{
+		CopyMemory(box, primitiveBox, count * sizeof(Box3D));
+		BuildTree();
+	}
+}
+
+/// @brief Builds the hierarchy for a set of spheres given by centers and radii.
+/// @param count	The number of primitives.
+/// @param center	A pointer to an array of \c count sphere centers.
+/// @param radius	A pointer to an array of \c count sphere radii.
+
+void BoundingVolumeHierarchy::Build(int32 count, const Point3D *center, const float *radius)
+{
+	if (Prepare(count))
+	{
+		for (machine k = 0; k < count; k++)
+		{
+			primitiveBox[k] = MakeSphereBox(center[k], radius[k]);
+		}
+
+		BuildTree();
+	}
+}
+
+/// @brief Builds the hierarchy for a set of conformal spheres.
+/// @param count	The number of primitives.
+/// @param sphere	A pointer to an array of \c count spheres. Each sphere must have a nonzero weight.
+
+void BoundingVolumeHierarchy::Build(int32 count, const Sphere3D *sphere)
+{
+	if (Prepare(count))
+	{
+		for (machine k = 0; k < count; k++)
+		{
+			primitiveBox[k] = MakeSphereBox(sphere[k]);
+		}
+
+		BuildTree();
+	}
+}
+
+/// @brief Updates the bounds of all nodes for new primitive boxes without changing the structure of the hierarchy.
+/// @param box		A pointer to an array of bounding boxes, one for each primitive in the original order.
+
+void BoundingVolumeHierarchy::Refit(const Box3D *box)
+{
+	for (machine k = 0; k < primitiveCount; k++)
+	{
+		primitiveBox[k] = box[primitiveIndex[k]];
+	}
+
+	RefitNodes();
+}
+
+/// @brief Updates the bounds of all nodes for new sphere centers and radii without changing the structure of the hierarchy.
+/// @param center	A pointer to an array of sphere centers, one for each primitive in the original order.
+/// @param radius	A pointer to an array of sphere radii, one for each primitive in the original order.
+
+void BoundingVolumeHierarchy::Refit(const Point3D *center, const float *radius)
+{
+	for (machine k = 0; k < primitiveCount; k++)
+	{
+		int32 i = primitiveIndex[k];
+		primitiveBox[k] = MakeSphereBox(center[i], radius[i]);
+	}
+
+	RefitNodes();
+}
+
+/// @brief Updates the bounds of all nodes for new conformal spheres without changing the structure of the hierarchy.
+/// @param sphere	A pointer to an array of spheres, one for each primitive in the original order.
+
+void BoundingVolumeHierarchy::Refit(const Sphere3D *sphere)
+{
+	for (machine k = 0; k < primitiveCount; k++)
+	{
+		primitiveBox[k] = MakeSphereBox(sphere[primitiveIndex[k]]);
+	}
+
+	RefitNodes();
+}
+
+/// @brief Updates the bounds of all nodes for boxes transformed by motors without changing the structure of the hierarchy.
+///
+/// Each box is specified in local coordinates and transformed by the corresponding motor, and the primitive is bounded
+/// by the smallest axis-aligned box containing the transformed box.
+///
+/// @param box		A pointer to an array of local bounding boxes, one for each primitive in the original order.
+/// @param motor	A pointer to an array of motors, one for each primitive in the original order.
+
+void BoundingVolumeHierarchy::Refit(const Box3D *box, const Motor3D *motor)
+{
+	for (machine k = 0; k < primitiveCount; k++)
+	{
+		int32 i = primitiveIndex[k];
+		primitiveBox[k] = Transform(box[i], motor[i]);
+	}
+
+	RefitNodes();
+}
+
+/// @brief Updates the bounds of all nodes for spheres transformed by motors without changing the structure of the hierarchy.
+/// @param center	A pointer to an array of sphere centers in local coordinates, one for each primitive in the original order.
+/// @param radius	A pointer to an array of sphere radii, one for each primitive in the original order.
+/// @param motor	A pointer to an array of motors, one for each primitive in the original order.
+
+void BoundingVolumeHierarchy::Refit(const Point3D *center, const float *radius, const Motor3D *motor)
+{
+	for (machine k = 0; k < primitiveCount; k++)
+	{
+		int32 i = primitiveIndex[k];
+		primitiveBox[k] = MakeSphereBox(Transform(center[i], motor[i]), radius[i]);
+	}
+
+	RefitNodes();
+}
+
+/// @brief Finds all primitives whose bounding boxes overlap a box.
+/// @param box			The query box.
+/// @param maxCount		The maximum number of primitive indices to store.
+/// @param index		A pointer to an array of at least \c maxCount integers that receives the original indices of the primitives.
+/// @return The total number of primitives found, which can be greater than \c maxCount.
+
+int32 BoundingVolumeHierarchy::FindBoxPrimitives(const Box3D& box, int32 maxCount, int32 *index) const
+{
+	return (FindPrimitives(this, BoxQuery(box), maxCount, index));
+}
+
+/// @brief Finds all primitives whose bounding boxes are hit by a ray.
+///
+/// The ray consists of the points <b>p</b>&nbsp;+&nbsp;<i>t</i><b>v</b> for 0&nbsp;&le;&nbsp;<i>t</i>&nbsp;&le;&nbsp;\c maxParam.
+///
+/// @param p			The origin of the ray.
+/// @param v			The direction of the ray.
+/// @param maxParam		The maximum parameter along the ray.
+/// @param maxCount		The maximum number of primitive indices to store.
+/// @param index		A pointer to an array of at least \c maxCount integers that receives the original indices of the primitives.
+/// @return The total number of primitives found, which can be greater than \c maxCount.
+
+int32 BoundingVolumeHierarchy::FindRayPrimitives(const Point3D& p, const Vector3D& v, float maxParam, int32 maxCount, int32 *index) const
+{
+	RayData ray(p, v, 0.0F, maxParam);
+	return (FindPrimitives(this, RayQuery(ray), maxCount, index));
+}
+
+/// @brief Finds all primitives whose bounding boxes are intersected by an infinite line.
+/// @param line			The query line. Its direction must not be zero, but it does not need to be unitized.
+/// @param maxCount		The maximum number of primitive indices to store.
+/// @param index		A pointer to an array of at least \c maxCount integers that receives the original indices of the primitives.
+/// @return The total number of primitives found, which can be greater than \c maxCount.
+
+int32 BoundingVolumeHierarchy::FindLinePrimitives(const Line3D& line, int32 maxCount, int32 *index) const
+{
+	// The point on the line closest to the origin is v x m / v^2.
+
+	const Vector3D& v = line.v;
+	const Bivector3D& m = line.m;
+	float f = 1.0F / (v.x * v.x + v.y * v.y + v.z * v.z);
+	Point3D p((v.y * m.z - v.z * m.y) * f, (v.z * m.x - v.x * m.z) * f, (v.x * m.y - v.y * m.x) * f);
+
+	RayData ray(p, v, -Math::max_float, Math::max_float);
+	return (FindPrimitives(this, RayQuery(ray), maxCount, index));
+}
+
+/// @brief Finds all primitives whose bounding boxes are not entirely outside a convex region bounded by planes.
+///
+/// The region is typically a view frustum, and it consists of the points <b>q</b> for which <b>q</b>&nbsp;&and;&nbsp;<b>g</b>
+/// is not negative for every plane <b>g</b>, meaning that the planes face inward. A primitive is reported if its bounding box
+/// is not entirely on the negative side of any single plane, so some primitives outside the region near its corners can be
+/// included. Subtrees lying entirely inside the region are accepted without testing their primitives.
+///
+/// @param planeCount	The number of planes.
+/// @param plane		A pointer to an array of \c planeCount planes.
+/// @param maxCount		The maximum number of primitive indices to store.
+/// @param index		A pointer to an array of at least \c maxCount integers that receives the original indices of the primitives.
+/// @return The total number of primitives found, which can be greater than \c maxCount.
+
+int32 BoundingVolumeHierarchy::FindFrustumPrimitives(int32 planeCount, const Plane3D *plane, int32 maxCount, int32 *index) const
+{
+	return (FindPrimitives(this, FrustumQuery(planeCount, plane), maxCount, index));
+}
+
+/// @brief Finds the first primitive hit by a ray.
+///
+/// The ray consists of the points <b>p</b>&nbsp;+&nbsp;<i>t</i><b>v</b> for 0&nbsp;&le;&nbsp;<i>t</i>&nbsp;&le;&nbsp;\c maxParam.
+/// Nodes are visited in front-to-back order, and subtrees that the ray enters beyond the closest hit found so far are skipped.
+/// For each primitive whose bounding box is hit, the function \c proc is called to intersect the ray with the primitive itself.
+/// If \c proc is \c nullptr, then the ray is intersected with the bounding boxes of the primitives.
+///
+/// @param p			The origin of the ray.
+/// @param v			The direction of the ray.
+/// @param maxParam		The maximum parameter along the ray.
+/// @param proc			The function that intersects the ray with a primitive, or \c nullptr to use the bounding boxes.
+/// @param cookie		A user-defined pointer passed to the \c proc function.
+/// @param param		A pointer to a location that receives the parameter at the hit. This can be \c nullptr.
+/// @return The original index of the primitive that is hit first, or &minus;1 if no primitive is hit.
+
+int32 BoundingVolumeHierarchy::CastRay(const Point3D& p, const Vector3D& v, float maxParam, BoundingVolumeRayProc *proc, void *cookie, float *param) const
+{
+	int32 hitIndex = -1;
+	float bestParam = maxParam;
+
+	if (nodeCount != 0)
+	{
+		RayData ray(p, v, 0.0F, maxParam);
+
+		RayStackEntry		stack[kTraversalStackSize];
+		alignas(16) float	entry[4];
+
+		int32 stackCount = 1;
+		stack[0].nodeIndex = 0;
+		stack[0].param = 0.0F;
+
+		do
+		{
+			RayStackEntry top = stack[--stackCount];
+			if (!(top.param <= bestParam))
+			{
+				continue;
+			}
+
+			const Node *node = &nodeArray[top.nodeIndex];
+			CalculateRayNodeParams(node, ray, bestParam, entry);
+
+			// Sort the children that are hit by decreasing entry parameter. Leaves are intersected
+			// immediately, and interior nodes are pushed so that the nearest is visited next.
+
+			int32 order[4];
+			int32 hitCount = 0;
+			for (machine i = 0; i < 4; i++)
+			{
+				if ((entry[i] < Math::infinity) && (node->count[i] != 0))
+				{
+					int32 j = hitCount++;
+					for (; (j > 0) && (entry[order[j - 1]] < entry[i]); j--)
+					{
+						order[j] = order[j - 1];
+					}
+
+					order[j] = int32(i);
+				}
+			}
+
+			for (machine h = hitCount - 1; h >= 0; h--)
+			{
+				int32 i = order[h];
+				if ((node->child[i] < 0) && (entry[i] <= bestParam))
+				{
+					int32 start = node->start[i];
+					int32 end = start + node->count[i];
+					for (machine k = start; k < end; k++)
+					{
+						float t = ray.IntersectBox(primitiveBox[k], bestParam);
+						if (t < Math::infinity)
+						{
+							if (proc)
+							{
+								t = proc(primitiveIndex[k], p, v, bestParam, cookie);
+							}
+
+							if (t < bestParam)
+							{
+								bestParam = t;
+								hitIndex = primitiveIndex[k];
+							}
+						}
+					}
+				}
+			}
+
+			for (machine h = 0; h < hitCount; h++)
+			{
+				int32 i = order[h];
+				if ((node->child[i] >= 0) && (entry[i] <= bestParam))
+				{
+					stack[stackCount].nodeIndex = node->child[i];
+					stack[stackCount].param = entry[i];
+					stackCount++;
+				}
+			}
+		} while (stackCount != 0);
+	}
+
+	if (param)
+	{
+		*param = bestParam;
+	}
+
+	return (hitIndex);
+}
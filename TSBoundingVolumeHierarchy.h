@@ -0,0 +1,186 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSBoundingVolumeHierarchy_h
+#define TSBoundingVolumeHierarchy_h
+
+
+#include "TSBox3D.h"
+#include "TSMemory.h"
+
+
+#define TERATHON_BOUNDINGVOLUMEHIERARCHY 1
+
+
+namespace Terathon
+{
+	class Sphere3D;
+
+
+	/// @brief Callback function that intersects a ray with a single primitive during a ray cast.
+	///
+	/// The function is called for each primitive whose bounding box is hit by the ray. It should return the parameter
+	/// <i>t</i> at which the ray <b>p</b>&nbsp;+&nbsp;<i>t</i><b>v</b> first hits the primitive, or any value not less than
+	/// \c maxParam if the primitive is missed or is hit only beyond \c maxParam.
+	///
+	/// @param index		The original index of the primitive.
+	/// @param p			The origin of the ray.
+	/// @param v			The direction of the ray.
+	/// @param maxParam		The parameter of the closest hit found so far.
+	/// @param cookie		The cookie passed to the \c BoundingVolumeHierarchy::CastRay() function.
+
+	typedef float BoundingVolumeRayProc(int32 index, const Point3D& p, const Vector3D& v, float maxParam, void *cookie);
+
+
+	// ==============================================
+	//	BoundingVolumeHierarchy
+	// ==============================================
+
+	/// @brief Four-wide bounding volume hierarchy over a set of boxes or spheres.
+	///
+	/// The \c BoundingVolumeHierarchy class organizes a set of primitives, each represented by an axis-aligned bounding box,
+	/// into a tree of nodes having up to four children apiece. The tree is built top-down with the surface area heuristic
+	/// evaluated over a fixed number of bins along each axis. Every node collapses up to three levels of binary splits,
+	/// always splitting the child with the largest surface area next, so most nodes are full. The bounding boxes of the four
+	/// children of a node are stored in structure-of-arrays layout, and all four are tested against a query together with
+	/// SIMD instructions.
+	///
+	/// Primitives can be specified as boxes, as center points with radii, or as conformal spheres. When primitives move,
+	/// the \c Refit() functions recalculate the bounding boxes of all nodes without changing the structure of the tree. This is
+	/// much faster than rebuilding, but the quality of the tree degrades as primitives move far from where they were when
+	/// the tree was built. The \c Refit() functions that take an array of motors transform primitives specified in local
+	/// coordinates, as for rigid bodies driven by a physics simulation.
+	///
+	/// The nodes, primitive indices, primitive boxes, and the scratch space used while building share a single allocation that
+	/// is reused when the hierarchy is rebuilt for no more primitives than before, so rebuilding does not allocate memory. The query functions do not modify the hierarchy, so any number of
+	/// threads can query it at the same time, but it must not be refit or rebuilt while queries are in progress.
+
+	class BoundingVolumeHierarchy
+	{
+		public:
+
+			enum : uint32
+			{
+				kMaxLeafPrimitiveCount	= 4,
+				kMaxTreeDepth			= 64,
+				kSurfaceAreaBinCount	= 16
+			};
+
+			/// @brief A single node in a bounding volume hierarchy.
+			///
+			/// Each node has four child slots, and the bounds of slot <i>i</i> are given by the <i>i</i>-th entries of the six
+			/// bounds arrays. Each slot references the \c count primitives beginning at \c start in the primitive index array,
+			/// which includes all primitives in the subtree below the slot. If \c child is not negative, then the slot is an
+			/// interior node having the index \c child in the node array. Otherwise, the slot is a leaf if \c count is not zero,
+			/// and it is empty if \c count is zero. The bounds of an empty slot have a minimum of positive infinity and a maximum
+			/// of negative infinity.
+
+			struct Node
+			{
+				float			minX[4];
+				float			minY[4];
+				float			minZ[4];
+				float			maxX[4];
+				float			maxY[4];
+				float			maxZ[4];
+
+				int32			child[4];
+				int32			start[4];
+				int32			count[4];
+			};
+
+		private:
+
+			int32				primitiveCount;
+			int32				nodeCount;
+			int32				primitiveCapacity;
+
+			Node				*nodeArray;
+			int32				*primitiveIndex;
+			Box3D				*primitiveBox;
+			void				*treeStorage;
+
+			struct BuildRange;
+
+			void Release(void);
+			bool Prepare(int32 count);
+			void BuildTree(void);
+			void SplitRange(BuildRange *range, const Point3D *centroid) const;
+			int32 BuildNode(const BuildRange *range, const Point3D *centroid);
+			void RefitNodes(void);
+
+		public:
+
+			TERATHON_API BoundingVolumeHierarchy();
+			TERATHON_API BoundingVolumeHierarchy(int32 count, const Box3D *box);
+			TERATHON_API ~BoundingVolumeHierarchy();
+
+			BoundingVolumeHierarchy(const BoundingVolumeHierarchy&) = delete;
+			BoundingVolumeHierarchy& operator =(const BoundingVolumeHierarchy&) = delete;
+
+			/// @brief Returns the number of primitives stored in the hierarchy.
+
+			int32 GetPrimitiveCount(void) const
+			{
+				return (primitiveCount);
+			}
+
+			/// @brief Returns the number of nodes in the hierarchy.
+
+			int32 GetNodeCount(void) const
+			{
+				return (nodeCount);
+			}
+
+			/// @brief Returns a pointer to the array of nodes. The root node is the first node in the array.
+
+			const Node *GetNodeArray(void) const
+			{
+				return (nodeArray);
+			}
+
+			/// @brief Returns the original index of a primitive stored in the hierarchy.
+			/// @param index	The leaf-order index of the primitive.
+
+			int32 GetPrimitiveIndex(int32 index) const
+			{
+				return (primitiveIndex[index]);
+			}
+
+			/// @brief Returns the bounding box of a primitive stored in the hierarchy.
+			/// @param index	The leaf-order index of the primitive.
+
+			const Box3D& GetPrimitiveBox(int32 index) const
+			{
+				return (primitiveBox[index]);
+			}
+
+			TERATHON_API Box3D GetBounds(void) const;
+
+			TERATHON_API void Build(int32 count, const Box3D *box);
+			TERATHON_API void Build(int32 count, const Point3D *center, const float *radius);
+			TERATHON_API void Build(int32 count, const Sphere3D *sphere);
+
+			TERATHON_API void Refit(const Box3D *box);
+			TERATHON_API void Refit(const Point3D *center, const float *radius);
+			TERATHON_API void Refit(const Sphere3D *sphere);
+			TERATHON_API void Refit(const Box3D *box, const Motor3D *motor);
+			TERATHON_API void Refit(const Point3D *center, const float *radius, const Motor3D *motor);
+
+			TERATHON_API int32 FindBoxPrimitives(const Box3D& box, int32 maxCount, int32 *index) const;
+			TERATHON_API int32 FindRayPrimitives(const Point3D& p, const Vector3D& v, float maxParam, int32 maxCount, int32 *index) const;
+			TERATHON_API int32 FindLinePrimitives(const Line3D& line, int32 maxCount, int32 *index) const;
+			TERATHON_API int32 FindFrustumPrimitives(int32 planeCount, const Plane3D *plane, int32 maxCount, int32 *index) const;
+
+			TERATHON_API int32 CastRay(const Point3D& p, const Vector3D& v, float maxParam, BoundingVolumeRayProc *proc, void *cookie, float *param = nullptr) const;
+	};
+}
+
+
+#endif
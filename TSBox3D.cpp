@@ -0,0 +1,75 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSBox3D.h"
+#include "TSSpatialOrder.h"
+
+
+using namespace Terathon;
+
+
+/// @brief Calculates the smallest box containing a set of points.
+/// @param count	The number of points. If this is zero, then an empty box is returned.
+/// @param point	A pointer to an array of \c count points.
+/// @relatedalso Box3D
+
+Box3D Terathon::CalculateBox(int32 count, const Point3D *point)
+{
+	Box3D	box;
+
+	if (count > 0)
+	{
+		CalculatePointBounds(count, point, &box.min, &box.max);
+	}
+	else
+	{
+		box.SetEmpty();
+	}
+
+	return (box);
+}
+
+/// @brief Returns the smallest axis-aligned box containing the transformed box.
+///
+/// The center of the box is transformed by the matrix \c M, and the extent along each axis is the sum of the
+/// original half-extents weighted by the absolute values of the entries in the corresponding row of \c M.
+/// An empty box is returned unchanged.
+///
+/// @param box		The box to transform.
+/// @param M		The transform to apply.
+/// @relatedalso Box3D
+
+Box3D Terathon::Transform(const Box3D& box, const Transform3D& M)
+{
+	if (box.Empty())
+	{
+		return (box);
+	}
+
+	Point3D center = M * box.GetCenter();
+	float hx = (box.max.x - box.min.x) * 0.5F;
+	float hy = (box.max.y - box.min.y) * 0.5F;
+	float hz = (box.max.z - box.min.z) * 0.5F;
+
+	float ex = Fabs(M(0,0)) * hx + Fabs(M(0,1)) * hy + Fabs(M(0,2)) * hz;
+	float ey = Fabs(M(1,0)) * hx + Fabs(M(1,1)) * hy + Fabs(M(1,2)) * hz;
+	float ez = Fabs(M(2,0)) * hx + Fabs(M(2,1)) * hy + Fabs(M(2,2)) * hz;
+
+	return (Box3D(Point3D(center.x - ex, center.y - ey, center.z - ez), Point3D(center.x + ex, center.y + ey, center.z + ez)));
+}
+
+/// @brief Returns the smallest axis-aligned box containing the box transformed by a motor.
+/// @param box		The box to transform.
+/// @param Q		The motor to apply.
+/// @relatedalso Box3D
+
+Box3D Terathon::Transform(const Box3D& box, const Motor3D& Q)
+{
+	return (Transform(box, Q.GetTransformMatrix()));
+}
@@ -0,0 +1,181 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSBox3D_h
+#define TSBox3D_h
+
+
+#include "TSMotor3D.h"
+
+
+#define TERATHON_BOX3D 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	Box3D
+	// ==============================================
+
+	/// @brief Encapsulates a 3D axis-aligned box.
+	///
+	/// The \c Box3D class stores an axis-aligned box as its minimum and maximum corners. A box whose minimum coordinate
+	/// exceeds its maximum coordinate along any axis is empty, and the \c SetEmpty() function initializes a box so that
+	/// including any point or other box in it produces the bounds of that point or box alone.
+
+	class Box3D
+	{
+		public:
+
+			Point3D		min;
+			Point3D		max;
+
+			/// @brief Default constructor that leaves the components uninitialized.
+
+			inline Box3D() = default;
+
+			/// @brief Constructor that sets the corners of the box.
+			/// @param pmin		The minimum corner of the box.
+			/// @param pmax		The maximum corner of the box.
+
+			Box3D(const Point3D& pmin, const Point3D& pmax)
+			{
+				min = pmin;
+				max = pmax;
+			}
+
+			/// @brief Sets the corners of the box.
+			/// @param pmin		The minimum corner of the box.
+			/// @param pmax		The maximum corner of the box.
+
+			Box3D& Set(const Point3D& pmin, const Point3D& pmax)
+			{
+				min = pmin;
+				max = pmax;
+				return (*this);
+			}
+
+			/// @brief Sets the box to the empty state.
+			///
+			/// The minimum corner is set to positive infinity, and the maximum corner is set to negative infinity.
+
+			Box3D& SetEmpty(void)
+			{
+				min.Set(Math::infinity, Math::infinity, Math::infinity);
+				max.Set(Math::minus_infinity, Math::minus_infinity, Math::minus_infinity);
+				return (*this);
+			}
+
+			/// @brief Returns a boolean value indicating whether the box is empty.
+
+			bool Empty(void) const
+			{
+				return ((min.x > max.x) || (min.y > max.y) || (min.z > max.z));
+			}
+
+			/// @brief Expands the box to include a point.
+			/// @param p	The point to include.
+
+			Box3D& Include(const Point3D& p)
+			{
+				min.Set(Fmin(min.x, p.x), Fmin(min.y, p.y), Fmin(min.z, p.z));
+				max.Set(Fmax(max.x, p.x), Fmax(max.y, p.y), Fmax(max.z, p.z));
+				return (*this);
+			}
+
+			/// @brief Expands the box to include another box.
+			/// @param box	The box to include.
+
+			Box3D& Include(const Box3D& box)
+			{
+				min.Set(Fmin(min.x, box.min.x), Fmin(min.y, box.min.y), Fmin(min.z, box.min.z));
+				max.Set(Fmax(max.x, box.max.x), Fmax(max.y, box.max.y), Fmax(max.z, box.max.z));
+				return (*this);
+			}
+
+			/// @brief Returns the center of the box.
+
+			Point3D GetCenter(void) const
+			{
+				return (Point3D((min.x + max.x) * 0.5F, (min.y + max.y) * 0.5F, (min.z + max.z) * 0.5F));
+			}
+
+			/// @brief Returns the vector from the minimum corner to the maximum corner of the box.
+
+			Vector3D GetSize(void) const
+			{
+				return (max - min);
+			}
+
+			/// @brief Returns the surface area of the box.
+			///
+			/// The surface area of an empty box is zero.
+
+			float GetSurfaceArea(void) const
+			{
+				float dx = FmaxZero(max.x - min.x);
+				float dy = FmaxZero(max.y - min.y);
+				float dz = FmaxZero(max.z - min.z);
+				return ((dx * dy + dy * dz + dz * dx) * 2.0F);
+			}
+
+			/// @brief Returns a boolean value indicating whether the box contains a point.
+			/// @param p	The point to test.
+
+			bool Contains(const Point3D& p) const
+			{
+				return ((p.x >= min.x) && (p.x <= max.x) && (p.y >= min.y) && (p.y <= max.y) && (p.z >= min.z) && (p.z <= max.z));
+			}
+	};
+
+
+	/// @brief Returns a boolean value indicating whether the two boxes \c a and \c b are equal.
+	/// @related Box3D
+
+	inline bool operator ==(const Box3D& a, const Box3D& b)
+	{
+		return ((a.min == b.min) && (a.max == b.max));
+	}
+
+	/// @brief Returns a boolean value indicating whether the two boxes \c a and \c b are not equal.
+	/// @related Box3D
+
+	inline bool operator !=(const Box3D& a, const Box3D& b)
+	{
+		return ((a.min != b.min) || (a.max != b.max));
+	}
+
+	/// @brief Returns the smallest box containing both of the boxes \c a and \c b.
+	/// @related Box3D
+
+	inline Box3D Union(const Box3D& a, const Box3D& b)
+	{
+		return (Box3D(Point3D(Fmin(a.min.x, b.min.x), Fmin(a.min.y, b.min.y), Fmin(a.min.z, b.min.z)), Point3D(Fmax(a.max.x, b.max.x), Fmax(a.max.y, b.max.y), Fmax(a.max.z, b.max.z))));
+	}
+
+	/// @brief Returns a boolean value indicating whether the boxes \c a and \c b overlap.
+	///
+	/// Boxes that touch at their boundaries are considered to overlap.
+	///
+	/// @related Box3D
+
+	inline bool Overlap(const Box3D& a, const Box3D& b)
+	{
+		return ((a.min.x <= b.max.x) && (a.max.x >= b.min.x) && (a.min.y <= b.max.y) && (a.max.y >= b.min.y) && (a.min.z <= b.max.z) && (a.max.z >= b.min.z));
+	}
+
+
+	TERATHON_API Box3D CalculateBox(int32 count, const Point3D *point);
+
+	TERATHON_API Box3D Transform(const Box3D& box, const Transform3D& M);
+	TERATHON_API Box3D Transform(const Box3D& box, const Motor3D& Q);
+}
+
+
+#endif
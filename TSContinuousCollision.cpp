@@ -0,0 +1,619 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSContinuousCollision.h"
+#include "TSBoundingSphere.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum : uint32
+	{
+		kMaxSphereIterationCount	= 64
+	};
+
+
+	// Below this angle, trajectories are replaced by the line segments between their endpoints.
+	// The largest distance between a segment and the true path is less than 1e-7 times the length of the segment.
+
+	const float kMinScrewAngle = 1.0e-6F;
+
+
+	void GetHalfAngleCosSin(float x, float *c, float *s)
+	{
+		// Calculates the cosine and sine of an angle in the range [-tau/4, tau/4] with Taylor series. Unlike the table-based
+		// CosSin() function, the sine is accurate relative to its own size for small angles, which matters because it is
+		// multiplied by radial offsets that grow without bound as the rotation of a screw motion vanishes.
+
+		float x2 = x * x;
+		*s = x * (1.0F - x2 * (0.16666667F - x2 * (0.0083333333F - x2 * (1.9841270e-4F - x2 * (2.7557319e-6F - x2 * (2.5052108e-8F - x2 * (1.6059044e-10F - x2 * 7.6471637e-13F)))))));
+		*c = 1.0F - x2 * (0.5F - x2 * (0.041666667F - x2 * (0.0013888889F - x2 * (2.4801587e-5F - x2 * (2.7557319e-7F - x2 * (2.0876757e-9F - x2 * 1.1470746e-11F))))));
+	}
+
+	float GetShapeBoundingRadius(const ConvexShape& shape)
+	{
+		float r2 = 0.0F;
+
+		if (shape.shapeType == kConvexShapePoints)
+		{
+			const Point3D *point = shape.pointArray;
+			for (machine i = 0; i < shape.pointCount; i++)
+			{
+				r2 = Fmax(r2, SquaredMag(point[i] - Point3D::origin));
+			}
+		}
+		else if (shape.shapeType == kConvexShapeBox)
+		{
+			r2 = SquaredMag(shape.halfExtent);
+		}
+		else if (shape.shapeType == kConvexShapeCapsule)
+		{
+			r2 = shape.halfExtent.z * shape.halfExtent.z;
+		}
+
+		return (Sqrt(r2) + shape.radius);
+	}
+
+
+	// Each primitive provides the distance from a point to its surface and a bound on the rate at which that
+	// distance can change along a trajectory. The distance is negative or zero inside the primitive.
+
+	struct PlanePrimitive
+	{
+		float		nx, ny, nz, d;
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float	vnx, vny, vnz, vd;
+
+		#endif
+
+		PlanePrimitive(const Plane3D& plane)
+		{
+			float f = InverseSqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+			nx = plane.x * f;
+			ny = plane.y * f;
+			nz = plane.z * f;
+			d = plane.w * f;
+
+			#ifndef TERATHON_NO_SIMD
+
+				vnx = VecLoadSmearScalar(&nx);
+				vny = VecLoadSmearScalar(&ny);
+				vnz = VecLoadSmearScalar(&nz);
+				vd = VecLoadSmearScalar(&d);
+
+			#endif
+		}
+
+		float GetDistance(const Point3D& p) const
+		{
+			return (nx * p.x + ny * p.y + nz * p.z + d);
+		}
+
+		float GetRate(const ScrewTrajectory& trajectory) const
+		{
+			// Only the components of the radial and tangent offsets and the drift along the normal move the point toward the plane.
+
+			float a = nx * trajectory.radial.x + ny * trajectory.radial.y + nz * trajectory.radial.z;
+			float b = nx * trajectory.tangent.x + ny * trajectory.tangent.y + nz * trajectory.tangent.z;
+			float e = nx * trajectory.drift.x + ny * trajectory.drift.y + nz * trajectory.drift.z;
+			return (trajectory.angle * Sqrt(a * a + b * b) + Fabs(e));
+		}
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float GetDistance(const vec_float& x, const vec_float& y, const vec_float& z) const
+			{
+				return (VecMadd(vnx, x, VecMadd(vny, y, VecMadd(vnz, z, vd))));
+			}
+
+		#endif
+	};
+
+	struct SpherePrimitive
+	{
+		Point3D		center;
+		float		radius;
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float	vcx, vcy, vcz, vr;
+
+		#endif
+
+		SpherePrimitive(const Sphere3D& sphere)
+		{
+			center = GetSphereCenter(sphere);
+			radius = GetSphereRadius(sphere);
+
+			#ifndef TERATHON_NO_SIMD
+
+				vcx = VecLoadSmearScalar(&center.x);
+				vcy = VecLoadSmearScalar(&center.y);
+				vcz = VecLoadSmearScalar(&center.z);
+				vr = VecLoadSmearScalar(&radius);
+
+			#endif
+		}
+
+		float GetDistance(const Point3D& p) const
+		{
+			return (Magnitude(p - center) - radius);
+		}
+
+		float GetRate(const ScrewTrajectory& trajectory) const
+		{
+			return (trajectory.GetSpeed());
+		}
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float GetDistance(const vec_float& x, const vec_float& y, const vec_float& z) const
+			{
+				vec_float dx = VecSub(x, vcx);
+				vec_float dy = VecSub(y, vcy);
+				vec_float dz = VecSub(z, vcz);
+				return (VecSub(VecSqrt(VecMadd(dx, dx, VecMadd(dy, dy, VecMul(dz, dz)))), vr));
+			}
+
+		#endif
+	};
+
+	struct BoxPrimitive
+	{
+		Box3D		box;
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float	vminX, vminY, vminZ, vmaxX, vmaxY, vmaxZ;
+
+		#endif
+
+		BoxPrimitive(const Box3D& b)
+		{
+			box = b;
+
+			#ifndef TERATHON_NO_SIMD
+
+				vminX = VecLoadSmearScalar(&box.min.x);
+				vminY = VecLoadSmearScalar(&box.min.y);
+				vminZ = VecLoadSmearScalar(&box.min.z);
+				vmaxX = VecLoadSmearScalar(&box.max.x);
+				vmaxY = VecLoadSmearScalar(&box.max.y);
+				vmaxZ = VecLoadSmearScalar(&box.max.z);
+
+			#endif
+		}
+
+		float GetDistance(const Point3D& p) const
+		{
+			float dx = Fmax(box.min.x - p.x, p.x - box.max.x, 0.0F);
+			float dy = Fmax(box.min.y - p.y, p.y - box.max.y, 0.0F);
+			float dz = Fmax(box.min.z - p.z, p.z - box.max.z, 0.0F);
+			return (Sqrt(dx * dx + dy * dy + dz * dz));
+		}
+
+		float GetRate(const ScrewTrajectory& trajectory) const
+		{
+			return (trajectory.GetSpeed());
+		}
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float GetDistance(const vec_float& x, const vec_float& y, const vec_float& z) const
+			{
+				vec_float zero = VecFloatGetZero();
+				vec_float dx = VecMax(VecMax(VecSub(vminX, x), VecSub(x, vmaxX)), zero);
+				vec_float dy = VecMax(VecMax(VecSub(vminY, y), VecSub(y, vmaxY)), zero);
+				vec_float dz = VecMax(VecMax(VecSub(vminZ, z), VecSub(z, vmaxZ)), zero);
+				return (VecSqrt(VecMadd(dx, dx, VecMadd(dy, dy, VecMul(dz, dz)))));
+			}
+
+		#endif
+	};
+
+
+	template <class primitive_type> float AdvanceSphere(const ScrewTrajectory& trajectory, float radius, const primitive_type& primitive, float tolerance)
+	{
+		// Conservative advancement moves forward by the distance to the primitive divided by the bound on the rate at which
+		// the distance can shrink, so the sphere can never pass through the primitive between two steps. Each step stops half
+		// the tolerance short of the conservative estimate so that the number of steps is finite.
+
+		float rate = primitive.GetRate(trajectory);
+		float t = 0.0F;
+
+		for (machine iteration = 0; iteration < kMaxSphereIterationCount; iteration++)
+		{
+			float f = primitive.GetDistance(trajectory.GetPosition(t)) - radius;
+			if (f <= tolerance)
+			{
+				return (t);
+			}
+
+			t += (f - tolerance * 0.5F) / rate;
+			if (!(t <= 1.0F))
+			{
+				return (Math::infinity);
+			}
+		}
+
+		return (t);
+	}
+
+	template <class primitive_type> int32 AdvanceSpheres(int32 count, const ScrewTrajectory *trajectory, const float *radius, const primitive_type& primitive, float tolerance, float *time)
+	{
+		machine i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			enum
+			{
+				kLaneStartX, kLaneStartY, kLaneStartZ,
+				kLaneRadialX, kLaneRadialY, kLaneRadialZ,
+				kLaneTangentX, kLaneTangentY, kLaneTangentZ,
+				kLaneDriftX, kLaneDriftY, kLaneDriftZ,
+				kLaneHalfAngle, kLaneRadius, kLaneInverseRate,
+				kLaneComponentCount
+			};
+
+			float halfTolerance = tolerance * 0.5F;
+			const vec_float vtol = VecLoadSmearScalar(&tolerance);
+			const vec_float vhalf = VecLoadSmearScalar(&halfTolerance);
+			const vec_float one = VecLoadVectorConstant<0x3F800000>();
+			const vec_float inf = VecLoadSmearScalar(&Math::infinity);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				alignas(16) float	lane[kLaneComponentCount][4];
+
+				// Transpose four trajectories into lanes, scaling the radial and tangent offsets so that they multiply the
+				// squared sine and the product of the sine and cosine of the half angle. The rate bound is calculated once
+				// per sphere, and its reciprocal turns each step into a multiply.
+
+				for (machine k = 0; k < 4; k++)
+				{
+					const ScrewTrajectory& s = trajectory[i + k];
+					lane[kLaneStartX][k] = s.startPosition.x;
+					lane[kLaneStartY][k] = s.startPosition.y;
+					lane[kLaneStartZ][k] = s.startPosition.z;
+					lane[kLaneRadialX][k] = s.radial.x * -2.0F;
+					lane[kLaneRadialY][k] = s.radial.y * -2.0F;
+					lane[kLaneRadialZ][k] = s.radial.z * -2.0F;
+					lane[kLaneTangentX][k] = s.tangent.x * 2.0F;
+					lane[kLaneTangentY][k] = s.tangent.y * 2.0F;
+					lane[kLaneTangentZ][k] = s.tangent.z * 2.0F;
+					lane[kLaneDriftX][k] = s.drift.x;
+					lane[kLaneDriftY][k] = s.drift.y;
+					lane[kLaneDriftZ][k] = s.drift.z;
+					lane[kLaneHalfAngle][k] = s.angle * 0.5F;
+					lane[kLaneRadius][k] = radius[i + k];
+
+					float rate = primitive.GetRate(s);
+					lane[kLaneInverseRate][k] = (rate > Math::min_float) ? 1.0F / rate : Math::max_float;
+				}
+
+				vec_float px = VecLoad(lane[kLaneStartX]);
+				vec_float py = VecLoad(lane[kLaneStartY]);
+				vec_float pz = VecLoad(lane[kLaneStartZ]);
+				vec_float ux = VecLoad(lane[kLaneRadialX]);
+				vec_float uy = VecLoad(lane[kLaneRadialY]);
+				vec_float uz = VecLoad(lane[kLaneRadialZ]);
+				vec_float wx = VecLoad(lane[kLaneTangentX]);
+				vec_float wy = VecLoad(lane[kLaneTangentY]);
+				vec_float wz = VecLoad(lane[kLaneTangentZ]);
+				vec_float ex = VecLoad(lane[kLaneDriftX]);
+				vec_float ey = VecLoad(lane[kLaneDriftY]);
+				vec_float ez = VecLoad(lane[kLaneDriftZ]);
+				vec_float halfAngle = VecLoad(lane[kLaneHalfAngle]);
+				vec_float r = VecLoad(lane[kLaneRadius]);
+				vec_float inverseRate = VecLoad(lane[kLaneInverseRate]);
+
+				vec_float t = VecFloatGetZero();
+				vec_float result = inf;
+				vec_float active = VecMaskCmplt(t, one);
+
+				for (machine iteration = 0; iteration < kMaxSphereIterationCount; iteration++)
+				{
+					vec_float	c, s;
+
+					VecCosSin(VecMul(halfAngle, t), &c, &s);
+					vec_float s2 = VecMul(s, s);
+					vec_float sc = VecMul(s, c);
+
+					vec_float x = VecMadd(ux, s2, VecMadd(wx, sc, VecMadd(ex, t, px)));
+					vec_float y = VecMadd(uy, s2, VecMadd(wy, sc, VecMadd(ey, t, py)));
+					vec_float z = VecMadd(uz, s2, VecMadd(wz, sc, VecMadd(ez, t, pz)));
+					vec_float f = VecSub(primitive.GetDistance(x, y, z), r);
+
+					vec_float hit = VecAndc(active, VecMaskCmpgt(f, vtol));
+					result = VecSelect(result, t, hit);
+					active = VecAndc(active, hit);
+
+					t = VecMadd(VecSub(f, vhalf), inverseRate, t);
+					active = VecAndc(active, VecMaskCmpgt(t, one));
+					if (VecMaskGetBits(active) == 0)
+					{
+						break;
+					}
+				}
+
+				// Lanes still active after the last iteration report the time reached, which is never later than the impact.
+
+				VecStoreUnaligned(VecSelect(result, t, active), &time[i]);
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			time[i] = AdvanceSphere(trajectory[i], radius[i], primitive, tolerance);
+		}
+
+		int32 hitCount = 0;
+		for (machine k = 0; k < count; k++)
+		{
+			hitCount += (time[k] <= 1.0F);
+		}
+
+		return (hitCount);
+	}
+}
+
+
+/// @brief Returns the position at time \c t along the trajectory.
+/// @param t	The time, which is normally in the range [0,&nbsp;1].
+
+Point3D ScrewTrajectory::GetPosition(float t) const
+{
+	float	c, s;
+
+	// With the half-angle sine s and cosine c, cos(angle * t) - 1 = -2s^2 and sin(angle * t) = 2sc.
+
+	GetHalfAngleCosSin(angle * t * 0.5F, &c, &s);
+	return (startPosition + radial * (s * s * -2.0F) + tangent * (s * c * 2.0F) + drift * t);
+}
+
+/// @brief Returns the constant speed of a point following the trajectory, in distance per unit time.
+
+float ScrewTrajectory::GetSpeed(void) const
+{
+	return (Sqrt(angle * angle * SquaredMag(radial) + SquaredMag(drift)));
+}
+
+
+/// @brief Sets the start and end poses of the motion.
+/// @param start	The unitized motor giving the pose at time 0.
+/// @param end		The unitized motor giving the pose at time 1.
+///
+/// The motion is the logarithm of the motor <b>Q</b><sub>1</sub>&#x202F;<b>Q</b><sub>0</sub><sup>&minus;1</sup>. Its direction
+/// is the axis direction scaled by half the angle of rotation.
+
+void ScrewMotion::Set(const Motor3D& start, const Motor3D& end)
+{
+	startPose = start;
+	endPose = end;
+	screwLine = Log(end * ~start);
+
+	const Vector3D& v = screwLine.v;
+	float phi2 = SquaredMag(v);
+
+	if (phi2 > Math::min_float)
+	{
+		float r = InverseSqrt(phi2);
+		axisDirection = v * r;
+		angle = phi2 * r * 2.0F;
+	}
+	else
+	{
+		// A pure translation has no axis. The direction of translation is used as the axis direction.
+
+		Vector3D m(screwLine.m.x, screwLine.m.y, screwLine.m.z);
+		float f = SquaredMag(m);
+		axisDirection = (f > Math::min_float) ? m * InverseSqrt(f) : Vector3D(0.0F, 0.0F, 1.0F);
+		angle = 0.0F;
+	}
+}
+
+/// @brief Returns the pose at time \c t.
+/// @param t	The time, which is normally in the range [0,&nbsp;1].
+
+Motor3D ScrewMotion::GetPose(float t) const
+{
+	return (Exp(screwLine * t) * startPose);
+}
+
+/// @brief Returns the trajectory of a point fixed in the moving body.
+/// @param p	The position of the point in the local coordinate system of the body.
+///
+/// The trajectory is fitted to the exact start and end positions of the point. The displacement along the axis is the component of the
+/// total movement parallel to the axis, and the remaining component <b>q</b> is the chord of the rotation, from which the radial offset
+/// is <b>u</b>&nbsp;=&nbsp;&minus;(<b>q</b>&nbsp;+&nbsp;cot(&theta;/2)&#x202F;<b>a</b>&nbsp;&times;&nbsp;<b>q</b>)&#x202F;/&#x202F;2.
+/// This does not require the position of the axis, which is poorly determined for small angles.
+
+ScrewTrajectory ScrewMotion::GetTrajectory(const Point3D& p) const
+{
+	ScrewTrajectory		trajectory;
+
+	Point3D p0 = Transform(p, startPose);
+	Vector3D d = Transform(p, endPose) - p0;
+
+	trajectory.startPosition = p0;
+
+	if (angle > kMinScrewAngle)
+	{
+		float	c, s;
+
+		GetHalfAngleCosSin(angle * 0.5F, &c, &s);
+		Vector3D e = axisDirection * Dot(d, axisDirection);
+		Vector3D q = d - e;
+		Vector3D u = (q + Cross(axisDirection, q) * (c / s)) * -0.5F;
+
+		trajectory.radial = u;
+		trajectory.tangent = Cross(axisDirection, u);
+		trajectory.drift = e;
+		trajectory.angle = angle;
+	}
+	else
+	{
+		trajectory.radial.Set(0.0F, 0.0F, 0.0F);
+		trajectory.tangent.Set(0.0F, 0.0F, 0.0F);
+		trajectory.drift = d;
+		trajectory.angle = 0.0F;
+	}
+
+	return (trajectory);
+}
+
+/// @brief Returns an upper bound on the speed of every point of the body within a given distance of its origin.
+/// @param radius	The distance from the origin of the body's local coordinate system.
+///
+/// A point at distance &rho; from the screw axis moves with the constant speed
+/// sqrt(&theta;<sup>2</sup>&rho;<sup>2</sup>&nbsp;+&nbsp;<i>d</i><sup>2</sup>), where &theta; is the angle and <i>d</i> is the displacement along the axis.
+
+float ScrewMotion::GetSpeedBound(float radius) const
+{
+	ScrewTrajectory trajectory = GetTrajectory(Point3D::origin);
+
+	float rho = Magnitude(trajectory.radial) + radius;
+	return (Sqrt(angle * angle * rho * rho + SquaredMag(trajectory.drift)));
+}
+
+
+/// @brief Calculates the earliest time at which two convex shapes moving along screw motions come into contact.
+///
+/// The time of impact is found by conservative advancement. At each step, the distance between the shapes is calculated with GJK,
+/// and the time is advanced by that distance divided by a bound on the rate at which the distance can shrink. The bound is the sum of
+/// the greatest speeds of the points of each shape, so the shapes can never pass through each other between steps, no matter how fast they
+/// move or rotate. The shapes are evaluated at the exact poses of their screw motions.
+///
+/// Contact is reported when the distance falls to \c tolerance. If the iteration limit is reached first, then contact has not been
+/// established, and the function returns \c false, but the time reached is still written to \c time. That time is never later than the
+/// actual impact, so the shapes can safely be advanced to it. If the shapes do not come into contact during the time interval, then
+/// \c time receives \c Math::infinity, so a finite time accompanying a return value of \c false indicates that the iteration limit was reached.
+///
+/// @param shapeA				The first shape.
+/// @param motionA				The motion of the first shape over the time interval [0,&nbsp;1].
+/// @param shapeB				The second shape.
+/// @param motionB				The motion of the second shape over the time interval [0,&nbsp;1].
+/// @param tolerance			The distance at which the shapes are considered to be in contact. This must be greater than zero.
+/// @param time					A pointer to the location that receives the time of impact, the last safe time, or \c Math::infinity.
+/// @param contact				A pointer to a structure that receives the contact information at the time of impact. This can be \c nullptr. It is written only when the function returns \c true.
+/// @param maxIterationCount	The maximum number of advancement steps.
+/// @return	Returns \c true if the shapes come into contact during the time interval [0,&nbsp;1], and \c false if they do not or if the iteration limit is reached before contact is established.
+/// @relatedalso ScrewMotion
+
+bool Terathon::CalculateTimeOfImpact(const ConvexShape& shapeA, const ScrewMotion& motionA, const ConvexShape& shapeB, const ScrewMotion& motionB, float tolerance, float *time, ConvexContact *contact, int32 maxIterationCount)
+{
+	float rate = motionA.GetSpeedBound(GetShapeBoundingRadius(shapeA)) + motionB.GetSpeedBound(GetShapeBoundingRadius(shapeB));
+	float t = 0.0F;
+
+	for (machine iteration = 0;; iteration++)
+	{
+		ConvexContact	c;
+
+		Motor3D poseA = motionA.GetPose(t);
+		Motor3D poseB = motionB.GetPose(t);
+
+		bool separate = CalculateConvexDistance(shapeA, poseA, shapeB, poseB, &c);
+		if ((!separate) || (c.distance <= tolerance))
+		{
+			if (contact)
+			{
+				if (!separate)
+				{
+					CalculateConvexContact(shapeA, poseA, shapeB, poseB, &c);
+				}
+
+				*contact = c;
+			}
+
+			*time = t;
+			return (true);
+		}
+
+		if (iteration == machine(maxIterationCount))
+		{
+			*time = t;
+			return (false);
+		}
+
+		t += (c.distance - tolerance * 0.5F) / rate;
+		if (!(t <= 1.0F))
+		{
+			break;
+		}
+	}
+
+	*time = Math::infinity;
+	return (false);
+}
+
+/// @brief Calculates the times at which moving spheres first touch a plane.
+///
+/// Each sphere moves along a screw trajectory, and the earliest time at which it touches the plane is found by conservative
+/// advancement. The plane is treated as the boundary of a solid half-space lying on its negative side, so a sphere that starts
+/// behind the plane has a time of impact of zero. Four spheres are processed at once with SIMD instructions.
+///
+/// @param count		The number of spheres.
+/// @param trajectory	A pointer to an array of \c count trajectories followed by the sphere centers, typically obtained with the \c ScrewMotion::GetTrajectory() function.
+/// @param radius		A pointer to an array of \c count sphere radii.
+/// @param plane		The plane, which does not need to be unitized.
+/// @param tolerance	The distance at which a sphere is considered to touch the plane. This must be greater than zero.
+/// @param time			A pointer to an array of \c count values that receive the times of impact. The value is \c Math::infinity for a sphere that does not touch the plane during the time interval [0,&nbsp;1].
+/// @return	Returns the number of spheres that touch the plane.
+/// @relatedalso ScrewTrajectory
+
+int32 Terathon::CalculateSpherePlaneImpacts(int32 count, const ScrewTrajectory *trajectory, const float *radius, const Plane3D& plane, float tolerance, float *time)
+{
+	return (AdvanceSpheres(count, trajectory, radius, PlanePrimitive(plane), tolerance, time));
+}
+
+/// @brief Calculates the times at which moving spheres first touch a stationary sphere.
+///
+/// Each moving sphere follows a screw trajectory, and the earliest time at which it touches the stationary sphere is found by conservative
+/// advancement. A moving sphere that starts in contact with the stationary sphere has a time of impact of zero. Four spheres are processed
+/// at once with SIMD instructions.
+///
+/// @param count		The number of moving spheres.
+/// @param trajectory	A pointer to an array of \c count trajectories followed by the sphere centers, typically obtained with the \c ScrewMotion::GetTrajectory() function.
+/// @param radius		A pointer to an array of \c count sphere radii.
+/// @param sphere		The stationary sphere, which must have a nonzero weight.
+/// @param tolerance	The distance at which the spheres are considered to touch. This must be greater than zero.
+/// @param time			A pointer to an array of \c count values that receive the times of impact. The value is \c Math::infinity for a sphere that does not touch the stationary sphere during the time interval [0,&nbsp;1].
+/// @return	Returns the number of moving spheres that touch the stationary sphere.
+/// @relatedalso ScrewTrajectory
+
+int32 Terathon::CalculateSphereSphereImpacts(int32 count, const ScrewTrajectory *trajectory, const float *radius, const Sphere3D& sphere, float tolerance, float *time)
+{
+	return (AdvanceSpheres(count, trajectory, radius, SpherePrimitive(sphere), tolerance, time));
+}
+
+/// @brief Calculates the times at which moving spheres first touch a stationary axis-aligned box.
+///
+/// Each sphere follows a screw trajectory, and the earliest time at which it touches the box is found by conservative advancement.
+/// The box is solid, so a sphere that starts in contact with the box or inside it has a time of impact of zero. Four spheres are processed
+/// at once with SIMD instructions.
+///
+/// @param count		The number of spheres.
+/// @param trajectory	A pointer to an array of \c count trajectories followed by the sphere centers, typically obtained with the \c ScrewMotion::GetTrajectory() function.
+/// @param radius		A pointer to an array of \c count sphere radii.
+/// @param box			The box.
+/// @param tolerance	The distance at which a sphere is considered to touch the box. This must be greater than zero.
+/// @param time			A pointer to an array of \c count values that receive the times of impact. The value is \c Math::infinity for a sphere that does not touch the box during the time interval [0,&nbsp;1].
+/// @return	Returns the number of spheres that touch the box.
+/// @relatedalso ScrewTrajectory
+
+int32 Terathon::CalculateSphereBoxImpacts(int32 count, const ScrewTrajectory *trajectory, const float *radius, const Box3D& box, float tolerance, float *time)
+{
+	return (AdvanceSpheres(count, trajectory, radius, BoxPrimitive(box), tolerance, time));
+}
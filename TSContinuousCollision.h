@@ -0,0 +1,141 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSContinuousCollision_h
+#define TSContinuousCollision_h
+
+
+#include "TSConvexCollision.h"
+#include "TSConformal3D.h"
+#include "TSBox3D.h"
+
+
+#define TERATHON_CONTINUOUSCOLLISION 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	ScrewTrajectory
+	// ==============================================
+
+	/// @brief Describes the helical path followed by a point under a screw motion.
+	///
+	/// The position of the point at time <i>t</i> in the range [0,&nbsp;1] is
+	/// <b>p</b>&nbsp;+&nbsp;<b>u</b>&#x202F;(cos&#x202F;&theta;<i>t</i>&nbsp;&minus;&nbsp;1)&nbsp;+&nbsp;<b>w</b>&#x202F;sin&#x202F;&theta;<i>t</i>&nbsp;+&nbsp;<b>e</b><i>t</i>,
+	/// where <b>p</b> is the starting position, <b>u</b> is the offset from the screw axis to the starting position, <b>w</b> is <b>u</b> rotated
+	/// a quarter turn about the axis, and <b>e</b> is the displacement along the axis. The speed of the point is constant. Measuring from the
+	/// starting position keeps the path accurate for small angles, where the axis can be very far away. When there is no rotation,
+	/// <b>u</b> and <b>w</b> are zero and the path is a line segment.
+
+	struct ScrewTrajectory
+	{
+		Point3D		startPosition;		///< The position at time 0.
+		Vector3D	radial;				///< The offset from the screw axis to the starting position.
+		Vector3D	tangent;			///< The radial offset rotated a quarter turn about the screw axis.
+		Vector3D	drift;				///< The displacement along the screw axis over the whole motion.
+		float		angle;				///< The angle of rotation over the whole motion, in radians.
+
+		TERATHON_API Point3D GetPosition(float t) const;
+		TERATHON_API float GetSpeed(void) const;
+	};
+
+
+	// ==============================================
+	//	ScrewMotion
+	// ==============================================
+
+	/// @brief Interpolates between two poses along the screw motion connecting them.
+	///
+	/// The \c ScrewMotion class stores the logarithm of the motor that carries a start pose to an end pose, expressed in world space.
+	/// The pose at time <i>t</i> is exp(<i>t</i>&#x202F;<b>L</b>)&#x202F;<b>Q</b><sub>0</sub>, which is a rotation about a fixed axis
+	/// combined with a translation along that axis, each proportional to <i>t</i>. This is the motion of a rigid body moving
+	/// with constant linear and angular velocity along the screw axis, so every point of the body follows a helix, and the poses
+	/// at <i>t</i>&nbsp;=&nbsp;0 and <i>t</i>&nbsp;=&nbsp;1 are exactly the start and end poses. Linear interpolation of positions,
+	/// by contrast, lets points of a rotating body cut corners that the rigid motion does not.
+	///
+	/// The rotation through the smaller angle is chosen, so the angle of rotation never exceeds &pi;.
+
+	class ScrewMotion
+	{
+		private:
+
+			Motor3D			startPose;
+			Motor3D			endPose;
+			Line3D			screwLine;
+
+			Vector3D		axisDirection;
+			float			angle;
+
+		public:
+
+			/// @brief Default constructor that leaves the components uninitialized.
+
+			inline ScrewMotion() = default;
+
+			/// @brief Constructor that sets the start and end poses.
+			/// @param start	The unitized motor giving the pose at time 0.
+			/// @param end		The unitized motor giving the pose at time 1.
+
+			ScrewMotion(const Motor3D& start, const Motor3D& end)
+			{
+				Set(start, end);
+			}
+
+			/// @brief Returns the pose at time 0.
+
+			const Motor3D& GetStartPose(void) const
+			{
+				return (startPose);
+			}
+
+			/// @brief Returns the pose at time 1.
+
+			const Motor3D& GetEndPose(void) const
+			{
+				return (endPose);
+			}
+
+			/// @brief Returns the world-space logarithm of the motion, whose direction is half the angle of rotation.
+
+			const Line3D& GetScrewLine(void) const
+			{
+				return (screwLine);
+			}
+
+			/// @brief Returns the unit direction of the screw axis. For a pure translation, this is the direction of the translation.
+
+			const Vector3D& GetAxisDirection(void) const
+			{
+				return (axisDirection);
+			}
+
+			/// @brief Returns the angle of rotation over the whole motion, in radians.
+
+			float GetAngle(void) const
+			{
+				return (angle);
+			}
+
+			TERATHON_API void Set(const Motor3D& start, const Motor3D& end);
+			TERATHON_API Motor3D GetPose(float t) const;
+			TERATHON_API ScrewTrajectory GetTrajectory(const Point3D& p) const;
+			TERATHON_API float GetSpeedBound(float radius) const;
+	};
+
+
+	TERATHON_API bool CalculateTimeOfImpact(const ConvexShape& shapeA, const ScrewMotion& motionA, const ConvexShape& shapeB, const ScrewMotion& motionB, float tolerance, float *time, ConvexContact *contact = nullptr, int32 maxIterationCount = 32);
+
+	TERATHON_API int32 CalculateSpherePlaneImpacts(int32 count, const ScrewTrajectory *trajectory, const float *radius, const Plane3D& plane, float tolerance, float *time);
+	TERATHON_API int32 CalculateSphereSphereImpacts(int32 count, const ScrewTrajectory *trajectory, const float *radius, const Sphere3D& sphere, float tolerance, float *time);
+	TERATHON_API int32 CalculateSphereBoxImpacts(int32 count, const ScrewTrajectory *trajectory, const float *radius, const Box3D& box, float tolerance, float *time);
+}
+
+
+#endif
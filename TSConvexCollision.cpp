@@ -0,0 +1,985 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSConvexCollision.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum : uint32
+	{
+		kMaxGjkIterationCount		= 64,
+		kMaxEpaIterationCount		= 64,
+		kMaxEpaVertexCount			= 80,
+		kMaxEpaFaceCount			= 160,
+		kMaxEpaEdgeCount			= 80
+	};
+
+	enum : uint32
+	{
+		kGjkSeparated,
+		kGjkDistance,
+		kGjkOverlap
+	};
+
+
+	// GJK terminates when the squared distance improves by less than this fraction, and the cores are considered to be
+	// touching when the squared distance is less than the second fraction of the squared size of the Minkowski difference.
+
+	const float kGjkRelativeTolerance = 1.0e-5F;
+	const float kGjkOverlapTolerance = 1.0e-10F;
+	const float kEpaRelativeTolerance = 1.0e-4F;
+
+
+	// A shape placed in the world by a transform and its inverse. The search direction is taken into the local coordinate system
+	// of the shape, and the support point is taken back out to world space.
+
+	struct PosedShape
+	{
+		const ConvexShape	*shape;
+		const Transform3D	*transform;
+		const Transform3D	*inverseTransform;
+
+		Point3D GetSupportPoint(const Vector3D& direction) const
+		{
+			return ((*transform) * shape->GetCoreSupportPoint((*inverseTransform) * direction));
+		}
+	};
+
+
+	// A vertex of the Minkowski difference A - B, and the support points on A and B that produced it.
+
+	struct SimplexVertex
+	{
+		Vector3D	w;
+		Point3D		a;
+		Point3D		b;
+	};
+
+	struct Simplex
+	{
+		int32			count;
+		SimplexVertex	vertex[4];
+		float			lambda[4];
+		Vector3D		v;
+	};
+
+
+	void GetMinkowskiSupport(const PosedShape& shapeA, const PosedShape& shapeB, const Vector3D& direction, SimplexVertex *sv)
+	{
+		sv->a = shapeA.GetSupportPoint(direction);
+		sv->b = shapeB.GetSupportPoint(-direction);
+		sv->w = sv->a - sv->b;
+	}
+
+	float SolveSegment(const Vector3D& a, const Vector3D& b, float *lambda)
+	{
+		// Calculates the barycentric coordinates of the point on the segment ab closest to the origin.
+
+		Vector3D ab = b - a;
+		float t = -Dot(a, ab);
+		float m = SquaredMag(ab);
+
+		if (t <= 0.0F)
+		{
+			lambda[0] = 1.0F;
+			lambda[1] = 0.0F;
+			return (SquaredMag(a));
+		}
+
+		if (t >= m)
+		{
+			lambda[0] = 0.0F;
+			lambda[1] = 1.0F;
+			return (SquaredMag(b));
+		}
+
+		t /= m;
+		lambda[0] = 1.0F - t;
+		lambda[1] = t;
+		return (SquaredMag(a + ab * t));
+	}
+
+	float SolveTriangle(const Vector3D& a, const Vector3D& b, const Vector3D& c, float *lambda)
+	{
+		// Calculates the barycentric coordinates of the point on the triangle abc closest to the origin
+		// by determining which Voronoi region of the triangle contains the origin.
+
+		Vector3D ab = b - a;
+		Vector3D ac = c - a;
+
+		float d1 = -Dot(ab, a);
+		float d2 = -Dot(ac, a);
+		if ((d1 <= 0.0F) && (d2 <= 0.0F))
+		{
+			lambda[0] = 1.0F;
+			lambda[1] = 0.0F;
+			lambda[2] = 0.0F;
+			return (SquaredMag(a));
+		}
+
+		float d3 = -Dot(ab, b);
+		float d4 = -Dot(ac, b);
+		if ((d3 >= 0.0F) && (d4 <= d3))
+		{
+			lambda[0] = 0.0F;
+			lambda[1] = 1.0F;
+			lambda[2] = 0.0F;
+			return (SquaredMag(b));
+		}
+
+		float vc = d1 * d4 - d3 * d2;
+		if ((vc <= 0.0F) && (d1 >= 0.0F) && (d3 <= 0.0F))
+		{
+			float t = d1 / (d1 - d3);
+			lambda[0] = 1.0F - t;
+			lambda[1] = t;
+			lambda[2] = 0.0F;
+			return (SquaredMag(a + ab * t));
+		}
+
+		float d5 = -Dot(ab, c);
+		float d6 = -Dot(ac, c);
+		if ((d6 >= 0.0F) && (d5 <= d6))
+		{
+			lambda[0] = 0.0F;
+			lambda[1] = 0.0F;
+			lambda[2] = 1.0F;
+			return (SquaredMag(c));
+		}
+
+		float vb = d5 * d2 - d1 * d6;
+		if ((vb <= 0.0F) && (d2 >= 0.0F) && (d6 <= 0.0F))
+		{
+			float t = d2 / (d2 - d6);
+			lambda[0] = 1.0F - t;
+			lambda[1] = 0.0F;
+			lambda[2] = t;
+			return (SquaredMag(a + ac * t));
+		}
+
+		float va = d3 * d6 - d5 * d4;
+		float e = d4 - d3;
+		float f = d5 - d6;
+		if ((va <= 0.0F) && (e >= 0.0F) && (f >= 0.0F))
+		{
+			float t = e / (e + f);
+			lambda[0] = 0.0F;
+			lambda[1] = 1.0F - t;
+			lambda[2] = t;
+			return (SquaredMag(b + (c - b) * t));
+		}
+
+		float denom = 1.0F / (va + vb + vc);
+		float v = vb * denom;
+		float w = vc * denom;
+		lambda[0] = 1.0F - v - w;
+		lambda[1] = v;
+		lambda[2] = w;
+		return (SquaredMag(a + ab * v + ac * w));
+	}
+
+	bool SolveTetrahedron(const Vector3D *w, float *lambda)
+	{
+		// Calculates the barycentric coordinates of the point on the tetrahedron closest to the origin. Each face having the origin
+		// on its outer side is solved as a triangle, and the closest result is kept. If the origin is inside the tetrahedron,
+		// then the return value is false. A flat tetrahedron has no inside, so all of its faces are solved.
+
+		static const int8 faceIndex[4][4] =
+		{
+			{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}
+		};
+
+		float volume = Dot(w[1] - w[0], Cross(w[2] - w[0], w[3] - w[0]));
+		float scale = SquaredMag(w[1] - w[0]) + SquaredMag(w[2] - w[0]) + SquaredMag(w[3] - w[0]);
+		bool flat = (Fabs(volume) <= scale * Sqrt(scale) * 1.0e-6F);
+
+		float bestDistance = Math::infinity;
+		bool outside = false;
+
+		for (machine k = 0; k < 4; k++)
+		{
+			const int8 *index = faceIndex[k];
+			const Vector3D& a = w[index[0]];
+			const Vector3D& b = w[index[1]];
+			const Vector3D& c = w[index[2]];
+
+			Vector3D n = Cross(b - a, c - a);
+			float sp = -Dot(n, a);
+			float sd = Dot(n, w[index[3]] - a);
+
+			if ((flat) || (sp * sd < 0.0F))
+			{
+				float	t[3];
+
+				outside = true;
+				float d = SolveTriangle(a, b, c, t);
+				if (d < bestDistance)
+				{
+					bestDistance = d;
+					lambda[index[0]] = t[0];
+					lambda[index[1]] = t[1];
+					lambda[index[2]] = t[2];
+					lambda[index[3]] = 0.0F;
+				}
+			}
+		}
+
+		return (outside);
+	}
+
+	bool SolveSimplex(Simplex *simplex)
+	{
+		// Finds the point on the simplex closest to the origin, and removes the vertices that do not contribute to it.
+		// If the origin is inside a tetrahedron, then the return value is false.
+
+		int32 count = simplex->count;
+		SimplexVertex *vertex = simplex->vertex;
+		float *lambda = simplex->lambda;
+
+		if (count == 1)
+		{
+			lambda[0] = 1.0F;
+		}
+		else if (count == 2)
+		{
+			SolveSegment(vertex[0].w, vertex[1].w, lambda);
+		}
+		else if (count == 3)
+		{
+			SolveTriangle(vertex[0].w, vertex[1].w, vertex[2].w, lambda);
+		}
+		else
+		{
+			Vector3D	w[4];
+
+			for (machine k = 0; k < 4; k++)
+			{
+				w[k] = vertex[k].w;
+			}
+
+			if (!SolveTetrahedron(w, lambda))
+			{
+				return (false);
+			}
+		}
+
+		int32 kept = 0;
+		Vector3D v(0.0F, 0.0F, 0.0F);
+		for (machine k = 0; k < count; k++)
+		{
+			float t = lambda[k];
+			if (t > 0.0F)
+			{
+				v += vertex[k].w * t;
+				vertex[kept] = vertex[k];
+				lambda[kept] = t;
+				kept++;
+			}
+		}
+
+		simplex->count = kept;
+		simplex->v = v;
+		return (true);
+	}
+
+	void GetWitnessPoints(const Simplex& simplex, Point3D *pa, Point3D *pb)
+	{
+		Point3D a = simplex.vertex[0].a;
+		Point3D b = simplex.vertex[0].b;
+		for (machine k = 1; k < simplex.count; k++)
+		{
+			float t = simplex.lambda[k];
+			a += (simplex.vertex[k].a - simplex.vertex[0].a) * t;
+			b += (simplex.vertex[k].b - simplex.vertex[0].b) * t;
+		}
+
+		*pa = a;
+		*pb = b;
+	}
+
+	uint32 RunGjk(const PosedShape& shapeA, const PosedShape& shapeB, const Vector3D& direction, float bound, Simplex *simplex)
+	{
+		// Runs GJK on the cores of two shapes, starting with the given estimate of the closest point of the Minkowski difference.
+		// If a separating plane shows that the distance exceeds the bound, then the function returns early. When the function returns
+		// kGjkDistance, the simplex holds the closest features, and its vector v is the closest point of the Minkowski difference.
+
+		Vector3D v = direction;
+		if (!(SquaredMag(v) > Math::min_float))
+		{
+			v.Set(1.0F, 0.0F, 0.0F);
+		}
+
+		simplex->count = 0;
+		simplex->v = v;
+
+		float squaredDistance = Math::max_float;
+		float squaredBound = bound * bound;
+		float squaredSize = 0.0F;
+
+		for (machine iteration = 0; iteration < kMaxGjkIterationCount; iteration++)
+		{
+			SimplexVertex	sv;
+
+			GetMinkowskiSupport(shapeA, shapeB, -v, &sv);
+			float vw = Dot(v, sv.w);
+
+			if ((vw > 0.0F) && (vw * vw > squaredBound * SquaredMag(v)))
+			{
+				simplex->v = v;
+				return (kGjkSeparated);
+			}
+
+			if (squaredDistance - vw <= squaredDistance * kGjkRelativeTolerance)
+			{
+				break;
+			}
+
+			bool duplicate = false;
+			for (machine k = 0; k < simplex->count; k++)
+			{
+				if (SquaredMag(simplex->vertex[k].w - sv.w) <= squaredSize * kGjkOverlapTolerance)
+				{
+					duplicate = true;
+				}
+			}
+
+			if (duplicate)
+			{
+				break;
+			}
+
+			squaredSize = Fmax(squaredSize, SquaredMag(sv.w));
+			simplex->vertex[simplex->count++] = sv;
+
+			if (!SolveSimplex(simplex))
+			{
+				return (kGjkOverlap);
+			}
+
+			v = simplex->v;
+			float d = SquaredMag(v);
+			if (d <= squaredSize * kGjkOverlapTolerance)
+			{
+				return (kGjkOverlap);
+			}
+
+			if (d >= squaredDistance)
+			{
+				break;
+			}
+
+			squaredDistance = d;
+		}
+
+		return (kGjkDistance);
+	}
+
+	struct EpaFace
+	{
+		int32		index[3];
+		Vector3D	normal;
+		float		distance;
+	};
+
+	bool MakeEpaFace(const SimplexVertex *vertex, int32 a, int32 b, int32 c, EpaFace *face)
+	{
+		Vector3D n = Cross(vertex[b].w - vertex[a].w, vertex[c].w - vertex[a].w);
+		float m = SquaredMag(n);
+		if (!(m > Math::min_float))
+		{
+			return (false);
+		}
+
+		n *= InverseSqrt(m);
+		face->index[0] = a;
+		face->index[1] = b;
+		face->index[2] = c;
+		face->normal = n;
+		face->distance = Dot(n, vertex[a].w);
+		return (true);
+	}
+
+	bool ExpandSimplex(const PosedShape& shapeA, const PosedShape& shapeB, Simplex *simplex, float tolerance)
+	{
+		// When GJK finds that the cores touch before it has built a tetrahedron, the simplex is expanded to a tetrahedron
+		// containing the origin by searching in directions away from the lower-dimensional simplex.
+
+		static const ConstVector3D axis[6] =
+		{
+			{1.0F, 0.0F, 0.0F}, {-1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F}, {0.0F, -1.0F, 0.0F}, {0.0F, 0.0F, 1.0F}, {0.0F, 0.0F, -1.0F}
+		};
+
+		SimplexVertex *vertex = simplex->vertex;
+
+		if (simplex->count == 1)
+		{
+			for (machine k = 0; k < 6; k++)
+			{
+				GetMinkowskiSupport(shapeA, shapeB, axis[k], &vertex[1]);
+				if (SquaredMag(vertex[1].w - vertex[0].w) > tolerance * tolerance)
+				{
+					simplex->count = 2;
+					break;
+				}
+			}
+		}
+
+		if (simplex->count == 2)
+		{
+			Vector3D d = Normalize(vertex[1].w - vertex[0].w);
+			Vector3D u = (Fabs(d.x) < 0.57735F) ? Vector3D(0.0F, d.z, -d.y) : Vector3D(d.y, -d.x, 0.0F);
+			u.Normalize();
+
+			Vector3D search[4] = {u, -u, Cross(d, u), -Cross(d, u)};
+			for (machine k = 0; k < 4; k++)
+			{
+				GetMinkowskiSupport(shapeA, shapeB, search[k], &vertex[2]);
+				if (SquaredMag(Cross(vertex[2].w - vertex[0].w, d)) > tolerance * tolerance)
+				{
+					simplex->count = 3;
+					break;
+				}
+			}
+		}
+
+		if (simplex->count == 3)
+		{
+			Vector3D n = Normalize(Cross(vertex[1].w - vertex[0].w, vertex[2].w - vertex[0].w));
+			GetMinkowskiSupport(shapeA, shapeB, n, &vertex[3]);
+			if (Fabs(Dot(vertex[3].w - vertex[0].w, n)) <= tolerance)
+			{
+				GetMinkowskiSupport(shapeA, shapeB, -n, &vertex[3]);
+			}
+
+			if (Fabs(Dot(vertex[3].w - vertex[0].w, n)) > tolerance)
+			{
+				simplex->count = 4;
+			}
+		}
+
+		return (simplex->count == 4);
+	}
+
+	bool RunEpa(const PosedShape& shapeA, const PosedShape& shapeB, Simplex *simplex, float scale, ConvexContact *contact)
+	{
+		// Expands a polytope inside the Minkowski difference, starting with a tetrahedron containing the origin, until the face
+		// closest to the origin lies on the boundary of the Minkowski difference. The distance to that face is the penetration depth
+		// of the cores, and its normal is the direction from the first shape to the second shape.
+
+		SimplexVertex	vertex[kMaxEpaVertexCount];
+		EpaFace			face[kMaxEpaFaceCount];
+		int32			edge[kMaxEpaEdgeCount][2];
+
+		float tolerance = scale * kEpaRelativeTolerance;
+		if (!ExpandSimplex(shapeA, shapeB, simplex, tolerance))
+		{
+			return (false);
+		}
+
+		for (machine k = 0; k < 4; k++)
+		{
+			vertex[k] = simplex->vertex[k];
+		}
+
+		if (Dot(Cross(vertex[1].w - vertex[0].w, vertex[2].w - vertex[0].w), vertex[3].w - vertex[0].w) > 0.0F)
+		{
+			SimplexVertex t = vertex[1];
+			vertex[1] = vertex[2];
+			vertex[2] = t;
+		}
+
+		int32 vertexCount = 4;
+		int32 faceCount = 0;
+
+		static const int8 tetrahedronFace[4][3] = {{0, 1, 2}, {0, 3, 1}, {1, 3, 2}, {2, 3, 0}};
+		for (machine k = 0; k < 4; k++)
+		{
+			if (!MakeEpaFace(vertex, tetrahedronFace[k][0], tetrahedronFace[k][1], tetrahedronFace[k][2], &face[faceCount]))
+			{
+				return (false);
+			}
+
+			faceCount++;
+		}
+
+		int32 closest = 0;
+		for (machine iteration = 0; iteration < kMaxEpaIterationCount; iteration++)
+		{
+			closest = 0;
+			for (machine k = 1; k < faceCount; k++)
+			{
+				if (face[k].distance < face[closest].distance)
+				{
+					closest = int32(k);
+				}
+			}
+
+			const EpaFace& f = face[closest];
+			SimplexVertex& sv = vertex[vertexCount];
+			GetMinkowskiSupport(shapeA, shapeB, f.normal, &sv);
+
+			if ((Dot(sv.w, f.normal) - f.distance <= tolerance) || (vertexCount == int32(kMaxEpaVertexCount - 1)))
+			{
+				break;
+			}
+
+			// Remove the faces that can see the new vertex, and collect the boundary of the removed region. An edge shared by
+			// two removed faces appears once in each direction, and the two occurrences cancel.
+
+			int32 newIndex = vertexCount++;
+			int32 edgeCount = 0;
+			int32 liveCount = 0;
+			bool overflow = false;
+
+			for (machine k = 0; k < faceCount; k++)
+			{
+				const EpaFace& g = face[k];
+				if (Dot(g.normal, sv.w - vertex[g.index[0]].w) > 0.0F)
+				{
+					for (machine e = 0; e < 3; e++)
+					{
+						int32 a = g.index[e];
+						int32 b = g.index[(e < 2) ? e + 1 : 0];
+
+						machine j = 0;
+						for (; j < edgeCount; j++)
+						{
+							if ((edge[j][0] == b) && (edge[j][1] == a))
+							{
+								break;
+							}
+						}
+
+						if (j < edgeCount)
+						{
+							edgeCount--;
+							edge[j][0] = edge[edgeCount][0];
+							edge[j][1] = edge[edgeCount][1];
+						}
+						else if (edgeCount < int32(kMaxEpaEdgeCount))
+						{
+							edge[edgeCount][0] = a;
+							edge[edgeCount][1] = b;
+							edgeCount++;
+						}
+						else
+						{
+							overflow = true;
+						}
+					}
+				}
+				else
+				{
+					face[liveCount++] = g;
+				}
+			}
+
+			if ((overflow) || (liveCount + edgeCount > int32(kMaxEpaFaceCount)))
+			{
+				return (false);
+			}
+
+			faceCount = liveCount;
+			for (machine j = 0; j < edgeCount; j++)
+			{
+				if (MakeEpaFace(vertex, edge[j][0], edge[j][1], newIndex, &face[faceCount]))
+				{
+					faceCount++;
+				}
+			}
+
+			if (faceCount == 0)
+			{
+				return (false);
+			}
+		}
+
+		// Find the barycentric coordinates of the projection of the origin onto the closest face, and use them to combine
+		// the support points on the two shapes.
+
+		const EpaFace& f = face[closest];
+		const SimplexVertex& v0 = vertex[f.index[0]];
+		const SimplexVertex& v1 = vertex[f.index[1]];
+		const SimplexVertex& v2 = vertex[f.index[2]];
+
+		Vector3D e1 = v1.w - v0.w;
+		Vector3D e2 = v2.w - v0.w;
+		Vector3D p = f.normal * f.distance - v0.w;
+
+		float d11 = Dot(e1, e1);
+		float d12 = Dot(e1, e2);
+		float d22 = Dot(e2, e2);
+		float dp1 = Dot(p, e1);
+		float dp2 = Dot(p, e2);
+
+		float det = d11 * d22 - d12 * d12;
+		float s = 0.0F;
+		float t = 0.0F;
+		if (det > Math::min_float)
+		{
+			det = 1.0F / det;
+			s = (d22 * dp1 - d12 * dp2) * det;
+			t = (d11 * dp2 - d12 * dp1) * det;
+		}
+
+		contact->distance = -f.distance;
+		contact->normal = f.normal;
+		contact->pointA = v0.a + (v1.a - v0.a) * s + (v2.a - v0.a) * t;
+		contact->pointB = v0.b + (v1.b - v0.b) * s + (v2.b - v0.b) * t;
+		return (true);
+	}
+
+	void GetInitialDirection(const PosedShape& shapeA, const PosedShape& shapeB, Vector3D *direction)
+	{
+		const Transform3D& ma = *shapeA.transform;
+		const Transform3D& mb = *shapeB.transform;
+		direction->Set(ma(0,3) - mb(0,3), ma(1,3) - mb(1,3), ma(2,3) - mb(2,3));
+	}
+
+	void FinishContact(const ConvexShape& shapeA, const ConvexShape& shapeB, ConvexContact *contact)
+	{
+		// Move the closest points of the cores outward to the surfaces of the shapes.
+
+		float ra = shapeA.radius;
+		float rb = shapeB.radius;
+		contact->distance -= ra + rb;
+		contact->pointA += contact->normal * ra;
+		contact->pointB -= contact->normal * rb;
+	}
+
+	bool GetDistanceContact(const Simplex& simplex, ConvexContact *contact)
+	{
+		float d = SquaredMag(simplex.v);
+		if (!(d > Math::min_float))
+		{
+			return (false);
+		}
+
+		float f = InverseSqrt(d);
+		contact->distance = d * f;
+		contact->normal = simplex.v * -f;
+		GetWitnessPoints(simplex, &contact->pointA, &contact->pointB);
+		return (true);
+	}
+
+	void CalculateContact(const PosedShape& shapeA, const PosedShape& shapeB, const Vector3D& direction, ConvexContact *contact)
+	{
+		Simplex		simplex;
+
+		uint32 result = RunGjk(shapeA, shapeB, direction, Math::max_float, &simplex);
+		if ((result != kGjkOverlap) && (GetDistanceContact(simplex, contact)))
+		{
+			FinishContact(*shapeA.shape, *shapeB.shape, contact);
+			return;
+		}
+
+		float scale = 0.0F;
+		for (machine k = 0; k < simplex.count; k++)
+		{
+			scale = Fmax(scale, SquaredMag(simplex.vertex[k].w));
+		}
+
+		scale = Sqrt(scale);
+		if (!RunEpa(shapeA, shapeB, &simplex, Fmax(scale, Math::min_float), contact))
+		{
+			// The Minkowski difference of the cores is flat, as for two capsules with coincident axes. The penetration depth
+			// of the cores is zero, and the normal is any direction perpendicular to the flat region.
+
+			Vector3D n = direction;
+			if (simplex.count >= 3)
+			{
+				n = Cross(simplex.vertex[1].w - simplex.vertex[0].w, simplex.vertex[2].w - simplex.vertex[0].w);
+			}
+			else if (simplex.count == 2)
+			{
+				Vector3D d = simplex.vertex[1].w - simplex.vertex[0].w;
+				n = (Fabs(d.x) < Fabs(d.y)) ? Cross(d, Vector3D(1.0F, 0.0F, 0.0F)) : Cross(d, Vector3D(0.0F, 1.0F, 0.0F));
+			}
+
+			float m = SquaredMag(n);
+			contact->normal = (m > Math::min_float) ? n * -InverseSqrt(m) : Vector3D(-1.0F, 0.0F, 0.0F);
+			contact->distance = 0.0F;
+			GetWitnessPoints(simplex, &contact->pointA, &contact->pointB);
+		}
+
+		FinishContact(*shapeA.shape, *shapeB.shape, contact);
+	}
+}
+
+
+/// @brief Returns the support point of the core of a convex shape in a given direction.
+///
+/// The support point is a point of the core that lies farthest in the direction \c direction. The radius of the shape is not included.
+/// The points of a point set shape are examined four at a time with SIMD instructions.
+///
+/// @param direction	The direction in the local coordinate system of the shape. It does not need to have unit length.
+
+Point3D ConvexShape::GetCoreSupportPoint(const Vector3D& direction) const
+{
+	if (shapeType == kConvexShapeBox)
+	{
+		const Vector3D& h = halfExtent;
+		return (Point3D((direction.x < 0.0F) ? -h.x : h.x, (direction.y < 0.0F) ? -h.y : h.y, (direction.z < 0.0F) ? -h.z : h.z));
+	}
+
+	if (shapeType == kConvexShapeCapsule)
+	{
+		return (Point3D(0.0F, 0.0F, (direction.z < 0.0F) ? -halfExtent.z : halfExtent.z));
+	}
+
+	if (shapeType == kConvexShapeSphere)
+	{
+		return (Point3D(0.0F, 0.0F, 0.0F));
+	}
+
+	const Point3D *point = pointArray;
+	int32 count = pointCount;
+
+	int32 best = 0;
+	float bestDot = Dot(point[0] - Point3D::origin, direction);
+	machine i = 1;
+
+	#ifndef TERATHON_NO_SIMD
+
+		if (count >= 8)
+		{
+			alignas(16) static const int32 laneIndex[4] = {0, 1, 2, 3};
+
+			vec_float dx = VecLoadSmearScalar(&direction.x);
+			vec_float dy = VecLoadSmearScalar(&direction.y);
+			vec_float dz = VecLoadSmearScalar(&direction.z);
+
+			vec_int32 index = VecInt32Load(laneIndex);
+			vec_int32 bestIndex = index;
+			vec_float bestValue = VecLoadSmearScalar(&Math::minus_infinity);
+			const vec_int32 four = VecInt32LoadConstant<4>();
+
+			for (i = 0; i + 4 <= count; i += 4)
+			{
+				vec_float	x, y, z;
+
+				VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+				vec_float d = VecMadd(x, dx, VecMadd(y, dy, VecMul(z, dz)));
+
+				vec_float mask = VecMaskCmpgt(d, bestValue);
+				bestValue = VecSelect(bestValue, d, mask);
+				bestIndex = VecInt32Select(bestIndex, index, VecCastInt32(mask));
+				index = VecInt32Add(index, four);
+			}
+
+			alignas(16) float	value[4];
+			alignas(16) int32	lane[4];
+
+			VecStore(bestValue, value);
+			VecInt32Store(bestIndex, lane);
+			for (machine k = 0; k < 4; k++)
+			{
+				if (value[k] > bestDot)
+				{
+					bestDot = value[k];
+					best = lane[k];
+				}
+			}
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		float d = Dot(point[i] - Point3D::origin, direction);
+		if (d > bestDot)
+		{
+			bestDot = d;
+			best = int32(i);
+		}
+	}
+
+	return (point[best]);
+}
+
+/// @brief Returns a boolean value indicating whether two convex shapes intersect.
+///
+/// GJK is run on the cores of the shapes, and it stops as soon as it finds a separating plane showing that the distance between
+/// the cores exceeds the sum of the radii. Shapes that touch are considered to intersect.
+///
+/// @param shapeA	The first shape.
+/// @param poseA	The motor that transforms the first shape from its local coordinate system into world space.
+/// @param shapeB	The second shape.
+/// @param poseB	The motor that transforms the second shape from its local coordinate system into world space.
+/// @relatedalso ConvexShape
+
+bool Terathon::IntersectConvexShapes(const ConvexShape& shapeA, const Motor3D& poseA, const ConvexShape& shapeB, const Motor3D& poseB)
+{
+	Transform3D		transform[4];
+	Simplex			simplex;
+	Vector3D		direction;
+
+	poseA.GetTransformMatrices(&transform[0], &transform[1]);
+	poseB.GetTransformMatrices(&transform[2], &transform[3]);
+
+	PosedShape a = {&shapeA, &transform[0], &transform[1]};
+	PosedShape b = {&shapeB, &transform[2], &transform[3]};
+	GetInitialDirection(a, b, &direction);
+
+	float bound = shapeA.radius + shapeB.radius;
+	uint32 result = RunGjk(a, b, direction, bound, &simplex);
+	if (result == kGjkSeparated)
+	{
+		return (false);
+	}
+
+	return ((result == kGjkOverlap) || (SquaredMag(simplex.v) <= bound * bound));
+}
+
+/// @brief Calculates the distance between two convex shapes whose cores do not intersect.
+///
+/// GJK is run on the cores of the shapes to find their closest points, and the radii are then subtracted from the distance. The distance
+/// stored in the \c contact parameter is negative if the shapes intersect only within their radii. If the cores themselves intersect,
+/// then the return value is \c false, and the contents of the \c contact parameter are undefined. The \c CalculateConvexContact()
+/// function handles that case by running EPA.
+///
+/// @param shapeA	The first shape.
+/// @param poseA	The motor that transforms the first shape from its local coordinate system into world space.
+/// @param shapeB	The second shape.
+/// @param poseB	The motor that transforms the second shape from its local coordinate system into world space.
+/// @param contact	A pointer to the structure that receives the distance, normal, and closest points.
+/// @relatedalso ConvexShape
+
+bool Terathon::CalculateConvexDistance(const ConvexShape& shapeA, const Motor3D& poseA, const ConvexShape& shapeB, const Motor3D& poseB, ConvexContact *contact)
+{
+	Transform3D		transform[4];
+	Simplex			simplex;
+	Vector3D		direction;
+
+	poseA.GetTransformMatrices(&transform[0], &transform[1]);
+	poseB.GetTransformMatrices(&transform[2], &transform[3]);
+
+	PosedShape a = {&shapeA, &transform[0], &transform[1]};
+	PosedShape b = {&shapeB, &transform[2], &transform[3]};
+	GetInitialDirection(a, b, &direction);
+
+	if ((RunGjk(a, b, direction, Math::max_float, &simplex) == kGjkOverlap) || (!GetDistanceContact(simplex, contact)))
+	{
+		return (false);
+	}
+
+	FinishContact(shapeA, shapeB, contact);
+	return (true);
+}
+
+/// @brief Calculates the signed distance between two convex shapes.
+///
+/// GJK is run on the cores of the shapes. If the cores do not intersect, then the result is the same as that produced by the
+/// \c CalculateConvexDistance() function. Otherwise, EPA is run to find the penetration depth of the cores and the direction of
+/// minimum penetration, and the radii are added to the depth.
+///
+/// @param shapeA	The first shape.
+/// @param poseA	The motor that transforms the first shape from its local coordinate system into world space.
+/// @param shapeB	The second shape.
+/// @param poseB	The motor that transforms the second shape from its local coordinate system into world space.
+/// @param contact	A pointer to the structure that receives the signed distance, normal, and closest or deepest points.
+/// @relatedalso ConvexShape
+
+void Terathon::CalculateConvexContact(const ConvexShape& shapeA, const Motor3D& poseA, const ConvexShape& shapeB, const Motor3D& poseB, ConvexContact *contact)
+{
+	Transform3D		transform[4];
+	Vector3D		direction;
+
+	poseA.GetTransformMatrices(&transform[0], &transform[1]);
+	poseB.GetTransformMatrices(&transform[2], &transform[3]);
+
+	PosedShape a = {&shapeA, &transform[0], &transform[1]};
+	PosedShape b = {&shapeB, &transform[2], &transform[3]};
+	GetInitialDirection(a, b, &direction);
+
+	CalculateContact(a, b, direction, contact);
+}
+
+/// @brief Calculates the signed distances for many pairs of convex shapes.
+///
+/// This function performs the same calculation as the \c CalculateConvexContact() function for each pair of shapes in the
+/// array specified by the \c pair parameter. The motors for all of the shapes are first converted to transforms and their inverses
+/// in a single pass, so the conversion is not repeated for shapes appearing in several pairs. Pairs sorted by their first shape
+/// make the best use of the cache.
+///
+/// If the \c direction parameter is not \c nullptr, then it points to an array holding an initial search direction for each pair,
+/// and the array receives a direction for the next query when the function returns. The directions from one frame of a simulation
+/// are good starting points for the next frame, and they usually reduce GJK to one or two iterations. Each direction should be
+/// initialized to zero before the first query, in which case the search starts along the line between the shape origins.
+///
+/// @param shapeCount	The number of shapes.
+/// @param shape		A pointer to an array of \c shapeCount shapes.
+/// @param pose			A pointer to an array of \c shapeCount motors that transform the shapes into world space.
+/// @param pairCount	The number of pairs of shapes.
+/// @param pair			A pointer to an array of \c pairCount pairs of shape indices.
+/// @param contact		A pointer to an array of \c pairCount structures that receive the results.
+/// @param direction	A pointer to an array of \c pairCount search directions, or \c nullptr.
+/// @param arena		A memory arena from which temporary storage for the transforms is allocated. This can be \c nullptr.
+/// @relatedalso ConvexShape
+
+void Terathon::CalculateConvexContacts(int32 shapeCount, const ConvexShape *shape, const Motor3D *pose, int32 pairCount, const ConvexPair *pair, ConvexContact *contact, Vector3D *direction, MemoryArena *arena)
+{
+	ScratchStorage scratch(shapeCount * sizeof(Transform3D) * 2, arena);
+	Transform3D *transform = static_cast<Transform3D *>(scratch.GetStorage());
+
+	if (transform)
+	{
+		for (machine i = 0; i < shapeCount; i++)
+		{
+			pose[i].GetTransformMatrices(&transform[i * 2], &transform[i * 2 + 1]);
+		}
+	}
+
+	for (machine k = 0; k < pairCount; k++)
+	{
+		Transform3D		local[4];
+		Vector3D		initial;
+
+		int32 ia = pair[k].shapeA;
+		int32 ib = pair[k].shapeB;
+
+		const Transform3D *ta = local;
+		const Transform3D *tb = local + 2;
+		if (transform)
+		{
+			ta = &transform[ia * 2];
+			tb = &transform[ib * 2];
+		}
+		else
+		{
+			// Without storage for the shared transforms, they are calculated separately for each pair.
+
+			pose[ia].GetTransformMatrices(&local[0], &local[1]);
+			pose[ib].GetTransformMatrices(&local[2], &local[3]);
+		}
+
+		PosedShape a = {&shape[ia], &ta[0], &ta[1]};
+		PosedShape b = {&shape[ib], &tb[0], &tb[1]};
+
+		if ((direction) && (SquaredMag(direction[k]) > Math::min_float))
+		{
+			initial = direction[k];
+		}
+		else
+		{
+			GetInitialDirection(a, b, &initial);
+		}
+
+		CalculateContact(a, b, initial, &contact[k]);
+
+		if (direction)
+		{
+			direction[k] = -contact[k].normal;
+		}
+	}
+}
@@ -0,0 +1,147 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSConvexCollision_h
+#define TSConvexCollision_h
+
+
+#include "TSMotor3D.h"
+#include "TSMemory.h"
+
+
+#define TERATHON_CONVEXCOLLISION 1
+
+
+namespace Terathon
+{
+	/// @brief Identifies the core of a convex shape.
+
+	enum : uint32
+	{
+		kConvexShapePoints,			///< The core is the convex hull of a set of points.
+		kConvexShapeSphere,			///< The core is a single point at the origin.
+		kConvexShapeBox,			///< The core is a box centered at the origin and aligned to the coordinate axes.
+		kConvexShapeCapsule			///< The core is a line segment along the <i>z</i> axis centered at the origin.
+	};
+
+
+	// ==============================================
+	//	ConvexShape
+	// ==============================================
+
+	/// @brief Describes a convex shape through its support mapping.
+	///
+	/// The \c ConvexShape class describes a convex shape in its local coordinate system as a core shape expanded by a radius.
+	/// The collision functions run GJK on the cores and account for the radii afterward, so a sphere is a point with a radius,
+	/// a capsule is a line segment with a radius, and boxes and point sets can be given a radius to round them. This keeps the
+	/// penetration of rounded shapes in the range handled by GJK alone, and the more expensive EPA stage runs only when the cores
+	/// themselves overlap.
+	///
+	/// A point set shape stores a pointer to its points and does not copy them, so the points must remain valid while the shape is used.
+	/// The points would typically be the vertices of a convex hull.
+
+	class ConvexShape
+	{
+		public:
+
+			uint32				shapeType;			///< The type of the core shape.
+			int32				pointCount;			///< The number of points in a point set shape.
+			const Point3D		*pointArray;		///< A pointer to the points of a point set shape.
+			Vector3D			halfExtent;			///< The half-extents of a box shape. The <i>z</i> component is the half-length of a capsule shape.
+			float				radius;				///< The radius by which the core is expanded.
+
+			/// @brief Default constructor that leaves the components uninitialized.
+
+			inline ConvexShape() = default;
+
+			/// @brief Sets the shape to the convex hull of a set of points.
+			/// @param count	The number of points, which must be at least one.
+			/// @param point	A pointer to an array of \c count points.
+			/// @param r		The radius by which the hull is expanded.
+
+			void SetPoints(int32 count, const Point3D *point, float r = 0.0F)
+			{
+				shapeType = kConvexShapePoints;
+				pointCount = count;
+				pointArray = point;
+				halfExtent.Set(0.0F, 0.0F, 0.0F);
+				radius = r;
+			}
+
+			/// @brief Sets the shape to a sphere centered at the origin.
+			/// @param r	The radius of the sphere.
+
+			void SetSphere(float r)
+			{
+				shapeType = kConvexShapeSphere;
+				pointCount = 0;
+				pointArray = nullptr;
+				halfExtent.Set(0.0F, 0.0F, 0.0F);
+				radius = r;
+			}
+
+			/// @brief Sets the shape to a box centered at the origin and aligned to the coordinate axes.
+			/// @param h	The half-extents of the box.
+			/// @param r	The radius by which the box is expanded.
+
+			void SetBox(const Vector3D& h, float r = 0.0F)
+			{
+				shapeType = kConvexShapeBox;
+				pointCount = 0;
+				pointArray = nullptr;
+				halfExtent = h;
+				radius = r;
+			}
+
+			/// @brief Sets the shape to a capsule whose axis is the <i>z</i> axis, centered at the origin.
+			/// @param halfLength	The half-length of the line segment between the centers of the capsule's hemispherical caps.
+			/// @param r			The radius of the capsule.
+
+			void SetCapsule(float halfLength, float r)
+			{
+				shapeType = kConvexShapeCapsule;
+				pointCount = 0;
+				pointArray = nullptr;
+				halfExtent.Set(0.0F, 0.0F, halfLength);
+				radius = r;
+			}
+
+			TERATHON_API Point3D GetCoreSupportPoint(const Vector3D& direction) const;
+	};
+
+
+	/// @brief Holds the result of a query for the distance or penetration between two convex shapes.
+
+	struct ConvexContact
+	{
+		float		distance;		///< The signed distance between the shapes. A negative value is the penetration depth.
+		Vector3D	normal;			///< The unit direction from the first shape toward the second shape.
+		Point3D		pointA;			///< The point on the surface of the first shape closest to, or deepest inside, the second shape.
+		Point3D		pointB;			///< The point on the surface of the second shape closest to, or deepest inside, the first shape.
+	};
+
+
+	/// @brief Identifies two shapes in an array for the batched collision functions.
+
+	struct ConvexPair
+	{
+		int32		shapeA;			///< The index of the first shape.
+		int32		shapeB;			///< The index of the second shape.
+	};
+
+
+	TERATHON_API bool IntersectConvexShapes(const ConvexShape& shapeA, const Motor3D& poseA, const ConvexShape& shapeB, const Motor3D& poseB);
+	TERATHON_API bool CalculateConvexDistance(const ConvexShape& shapeA, const Motor3D& poseA, const ConvexShape& shapeB, const Motor3D& poseB, ConvexContact *contact);
+	TERATHON_API void CalculateConvexContact(const ConvexShape& shapeA, const Motor3D& poseA, const ConvexShape& shapeB, const Motor3D& poseB, ConvexContact *contact);
+
+	TERATHON_API void CalculateConvexContacts(int32 shapeCount, const ConvexShape *shape, const Motor3D *pose, int32 pairCount, const ConvexPair *pair, ConvexContact *contact, Vector3D *direction = nullptr, MemoryArena *arena = nullptr);
+}
+
+
+#endif
@@ -0,0 +1,1476 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSConvexHull.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum
+	{
+		kMaxHullPassCount = 4,
+		kMaxHullSeedCount = 16
+	};
+
+
+	// These functions return the index of the point farthest from a line or plane, and they process four points at a time.
+	// The squared distance to the line and the absolute distance to the plane are returned in the distance parameter.
+
+	int32 FindFarthestFromLine(int32 count, const Point3D *point, const Point3D& p0, const Vector3D& dir, float *distance)
+	{
+		int32 farthest = -1;
+		float bestDistance = 0.0F;
+		machine i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			alignas(16) static const int32 laneIndex[4] = {0, 1, 2, 3};
+
+			vec_float ox = VecLoadSmearScalar(&p0.x);
+			vec_float oy = VecLoadSmearScalar(&p0.y);
+			vec_float oz = VecLoadSmearScalar(&p0.z);
+			vec_float dx = VecLoadSmearScalar(&dir.x);
+			vec_float dy = VecLoadSmearScalar(&dir.y);
+			vec_float dz = VecLoadSmearScalar(&dir.z);
+
+			vec_int32 index = VecInt32Load(laneIndex);
+			vec_int32 bestIndex = index;
+			vec_float best = VecLoadSmearScalar(&Math::minus_infinity);
+			const vec_int32 four = VecInt32LoadConstant<4>();
+
+			for (; i + 4 <= count; i += 4)
+			{
+				vec_float	x, y, z;
+
+				VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+				x = VecSub(x, ox);
+				y = VecSub(y, oy);
+				z = VecSub(z, oz);
+
+				vec_float cx = VecNmsub(z, dy, VecMul(y, dz));
+				vec_float cy = VecNmsub(x, dz, VecMul(z, dx));
+				vec_float cz = VecNmsub(y, dx, VecMul(x, dy));
+				vec_float d = VecMadd(cx, cx, VecMadd(cy, cy, VecMul(cz, cz)));
+
+				vec_float mask = VecMaskCmpgt(d, best);
+				best = VecSelect(best, d, mask);
+				bestIndex = VecInt32Select(bestIndex, index, VecCastInt32(mask));
+				index = VecInt32Add(index, four);
+			}
+
+			alignas(16) float	value[4];
+			alignas(16) int32	lane[4];
+
+			VecStore(best, value);
+			VecInt32Store(bestIndex, lane);
+			for (machine k = 0; k < 4; k++)
+			{
+				if (value[k] > bestDistance)
+				{
+					bestDistance = value[k];
+					farthest = lane[k];
+				}
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			float d = SquaredMag(Cross(point[i] - p0, dir));
+			if (d > bestDistance)
+			{
+				bestDistance = d;
+				farthest = int32(i);
+			}
+		}
+
+		*distance = bestDistance;
+		return (farthest);
+	}
+
+	int32 FindFarthestFromPlane(int32 count, const Point3D *point, const Plane3D& plane, float *distance)
+	{
+		int32 farthest = -1;
+		float bestDistance = 0.0F;
+		machine i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			alignas(16) static const int32 laneIndex[4] = {0, 1, 2, 3};
+
+			vec_float gx = VecLoadSmearScalar(&plane.x);
+			vec_float gy = VecLoadSmearScalar(&plane.y);
+			vec_float gz = VecLoadSmearScalar(&plane.z);
+			vec_float gw = VecLoadSmearScalar(&plane.w);
+
+			vec_int32 index = VecInt32Load(laneIndex);
+			vec_int32 bestIndex = index;
+			vec_float best = VecLoadSmearScalar(&Math::minus_infinity);
+			const vec_int32 four = VecInt32LoadConstant<4>();
+
+			for (; i + 4 <= count; i += 4)
+			{
+				vec_float	x, y, z;
+
+				VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+				vec_float d = VecMadd(gx, x, VecMadd(gy, y, VecMadd(gz, z, gw)));
+				d = VecMax(d, VecNegate(d));
+
+				vec_float mask = VecMaskCmpgt(d, best);
+				best = VecSelect(best, d, mask);
+				bestIndex = VecInt32Select(bestIndex, index, VecCastInt32(mask));
+				index = VecInt32Add(index, four);
+			}
+
+			alignas(16) float	value[4];
+			alignas(16) int32	lane[4];
+
+			VecStore(best, value);
+			VecInt32Store(bestIndex, lane);
+			for (machine k = 0; k < 4; k++)
+			{
+				if (value[k] > bestDistance)
+				{
+					bestDistance = value[k];
+					farthest = lane[k];
+				}
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			float d = Fabs(point[i] ^ plane);
+			if (d > bestDistance)
+			{
+				bestDistance = d;
+				farthest = int32(i);
+			}
+		}
+
+		*distance = bestDistance;
+		return (farthest);
+	}
+}
+
+
+// A face of the hull under construction. Edge i of the face runs from vertex[i] to vertex[(i + 1) % 3], and it is identified
+// by the half-edge index face * 3 + i. The twin of an edge is the half-edge running in the opposite direction on the adjacent face.
+// Each face owns the outside set of points in front of it, stored as a linked list through the point link array.
+
+struct ConvexHull::BuildFace
+{
+	Plane3D		plane;
+	int32		vertex[3];
+	int32		twin[3];
+
+	int32		outsideHead;
+	int32		furthestPoint;
+	float		furthestDistance;
+
+	int32		pendingPrev;
+	int32		pendingNext;
+	int32		visitMark;
+	bool		live;
+};
+
+
+struct ConvexHull::BuildState
+{
+	const Point3D	*point;
+	int32			pointCount;
+	float			tolerance;
+
+	BuildFace		*face;
+	int32			faceCapacity;
+	int32			faceHigh;
+	int32			freeFace;
+
+	int32			pendingHead;
+	int32			pendingTail;
+	int32			visitMark;
+	int32			visibleCount;
+	int32			newCount;
+	int32			orphanHead;
+
+	int32			*pointLink;
+	int32			*vertexEdge;
+	int32			*stack;
+	int32			*visibleFace;
+	int32			*horizonEdge;
+	int32			*horizonOrder;
+	int32			*newFace;
+	float			*newPlane[4];
+
+	void			*storage;
+
+	BuildState(int32 count, const Point3D *p, const Vector3D& shift);
+	~BuildState();
+
+	float GetDistance(int32 f, int32 p) const
+	{
+		return (point[p] ^ face[f].plane);
+	}
+
+	Plane3D CalculatePlane(int32 a, int32 b, int32 c) const;
+	int32 NewFace(int32 a, int32 b, int32 c);
+	void DeleteFace(int32 f);
+	void AddPending(int32 f);
+	void RemovePending(int32 f);
+	void AssignPoint(int32 p, int32 f, float d);
+	void RemovePoint(int32 p, int32 f);
+
+	bool BuildSimplex(void);
+	void PartitionPoints(void);
+	int32 FindHorizon(int32 eye, int32 f, bool conservative);
+	void AdoptFace(int32 f);
+	bool FlipEdge(int32 edge);
+	void FlipConcaveEdges(void);
+	bool AddPoint(int32 eye, int32 f, bool conservative);
+	bool ReassignOutsidePoints(void);
+	void Run(void);
+};
+
+
+ConvexHull::BuildState::BuildState(int32 count, const Point3D *p, const Vector3D& shift)
+{
+	pointCount = count;
+
+	// A hull with v vertices has 2v - 4 faces. The visible faces are deleted before the new faces are created,
+	// so the number of live faces never exceeds this bound, and deleted faces are recycled through a free list.
+
+	faceCapacity = count * 2 + 8;
+	faceHigh = 0;
+	freeFace = -1;
+	pendingHead = -1;
+	pendingTail = -1;
+	visitMark = 0;
+	visibleCount = 0;
+	newCount = 0;
+	orphanHead = -1;
+
+	int32 edgeCapacity = faceCapacity * 3;
+	int32 planeCapacity = (edgeCapacity + 3) & ~3;
+
+	umachine size = AlignSize(count * sizeof(Point3D)) + AlignSize(faceCapacity * sizeof(BuildFace)) + AlignSize(count * 2 * sizeof(int32))
+	            + AlignSize(faceCapacity * 2 * sizeof(int32)) + AlignSize(faceCapacity * sizeof(int32)) + AlignSize(edgeCapacity * 3 * sizeof(int32))
+	            + AlignSize(planeCapacity * 4 * sizeof(float));
+
+	storage = AllocateAligned(size);
+	char *data = static_cast<char *>(storage);
+
+	Point3D *shifted = reinterpret_cast<Point3D *>(data);
+	data += AlignSize(count * sizeof(Point3D));
+	face = reinterpret_cast<BuildFace *>(data);
+	data += AlignSize(faceCapacity * sizeof(BuildFace));
+	pointLink = reinterpret_cast<int32 *>(data);
+	vertexEdge = pointLink + count;
+	data += AlignSize(count * 2 * sizeof(int32));
+	stack = reinterpret_cast<int32 *>(data);
+	data += AlignSize(faceCapacity * 2 * sizeof(int32));
+	visibleFace = reinterpret_cast<int32 *>(data);
+	data += AlignSize(faceCapacity * sizeof(int32));
+	horizonEdge = reinterpret_cast<int32 *>(data);
+	horizonOrder = horizonEdge + edgeCapacity;
+	newFace = horizonOrder + edgeCapacity;
+	data += AlignSize(edgeCapacity * 3 * sizeof(int32));
+
+	for (machine k = 0; k < 4; k++)
+	{
+		newPlane[k] = reinterpret_cast<float *>(data) + k * planeCapacity;
+	}
+
+	point = shifted;
+	for (machine i = 0; i < count; i++)
+	{
+		shifted[i] = p[i] - shift;
+		pointLink[i] = -1;
+		vertexEdge[i] = -1;
+	}
+}
+
+ConvexHull::BuildState::~BuildState()
+{
+	ReleaseAligned(storage);
+}
+
+Plane3D ConvexHull::BuildState::CalculatePlane(int32 a, int32 b, int32 c) const
+{
+	// The plane is calculated in double precision because the faces of a hull built from densely sampled curved surfaces
+	// are often thin slivers, and the normal of a sliver loses most of its significant bits in a single-precision cross product.
+	// The plane is placed through the centroid of the face.
+
+	const Point3D& pa = point[a];
+	const Point3D& pb = point[b];
+	const Point3D& pc = point[c];
+
+	double ux = double(pb.x) - double(pa.x);
+	double uy = double(pb.y) - double(pa.y);
+	double uz = double(pb.z) - double(pa.z);
+	double vx = double(pc.x) - double(pa.x);
+	double vy = double(pc.y) - double(pa.y);
+	double vz = double(pc.z) - double(pa.z);
+
+	double nx = uy * vz - uz * vy;
+	double ny = uz * vx - ux * vz;
+	double nz = ux * vy - uy * vx;
+
+	double m2 = nx * nx + ny * ny + nz * nz;
+	if (float(m2) > Math::min_float)
+	{
+		double f = InverseSqrt(float(m2));
+		f *= 1.5 - m2 * f * f * 0.5;
+		nx *= f;
+		ny *= f;
+		nz *= f;
+
+		double d = nx * (double(pa.x) + double(pb.x) + double(pc.x)) + ny * (double(pa.y) + double(pb.y) + double(pc.y)) + nz * (double(pa.z) + double(pb.z) + double(pc.z));
+		return (Plane3D(float(nx), float(ny), float(nz), float(d * (-1.0 / 3.0))));
+	}
+
+	return (Plane3D(0.0F, 0.0F, 0.0F, 0.0F));
+}
+
+int32 ConvexHull::BuildState::NewFace(int32 a, int32 b, int32 c)
+{
+	int32 f = freeFace;
+	if (f >= 0)
+	{
+		freeFace = face[f].pendingNext;
+	}
+	else
+	{
+		f = faceHigh++;
+	}
+
+	BuildFace *bf = &face[f];
+	bf->vertex[0] = a;
+	bf->vertex[1] = b;
+	bf->vertex[2] = c;
+	bf->outsideHead = -1;
+	bf->furthestPoint = -1;
+	bf->furthestDistance = 0.0F;
+	bf->pendingPrev = -1;
+	bf->pendingNext = -1;
+	bf->visitMark = 0;
+	bf->live = true;
+
+	bf->plane = CalculatePlane(a, b, c);
+
+	return (f);
+}
+
+void ConvexHull::BuildState::DeleteFace(int32 f)
+{
+	face[f].live = false;
+	face[f].pendingNext = freeFace;
+	freeFace = f;
+}
+
+void ConvexHull::BuildState::AddPending(int32 f)
+{
+	BuildFace *bf = &face[f];
+	bf->pendingPrev = pendingTail;
+	bf->pendingNext = -1;
+
+	if (pendingTail >= 0)
+	{
+		face[pendingTail].pendingNext = f;
+	}
+	else
+	{
+		pendingHead = f;
+	}
+
+	pendingTail = f;
+}
+
+void ConvexHull::BuildState::RemovePending(int32 f)
+{
+	BuildFace *bf = &face[f];
+	int32 prev = bf->pendingPrev;
+	int32 next = bf->pendingNext;
+
+	if (prev >= 0)
+	{
+		face[prev].pendingNext = next;
+	}
+	else
+	{
+		pendingHead = next;
+	}
+
+	if (next >= 0)
+	{
+		face[next].pendingPrev = prev;
+	}
+	else
+	{
+		pendingTail = prev;
+	}
+
+	bf->pendingPrev = -1;
+	bf->pendingNext = -1;
+}
+
+void ConvexHull::BuildState::AssignPoint(int32 p, int32 f, float d)
+{
+	BuildFace *bf = &face[f];
+	if (bf->outsideHead < 0)
+	{
+		AddPending(f);
+	}
+
+	pointLink[p] = bf->outsideHead;
+	bf->outsideHead = p;
+
+	if (d > bf->furthestDistance)
+	{
+		bf->furthestDistance = d;
+		bf->furthestPoint = p;
+	}
+}
+
+void ConvexHull::BuildState::RemovePoint(int32 p, int32 f)
+{
+	// Unlink the point from the outside set of the face, and find the new furthest point.
+
+	BuildFace *bf = &face[f];
+	int32 *link = &bf->outsideHead;
+	while (*link >= 0)
+	{
+		if (*link == p)
+		{
+			*link = pointLink[p];
+			break;
+		}
+
+		link = &pointLink[*link];
+	}
+
+	bf->furthestPoint = -1;
+	bf->furthestDistance = 0.0F;
+	for (int32 q = bf->outsideHead; q >= 0; q = pointLink[q])
+	{
+		float d = GetDistance(f, q);
+		if (d > bf->furthestDistance)
+		{
+			bf->furthestDistance = d;
+			bf->furthestPoint = q;
+		}
+	}
+
+	if (bf->outsideHead < 0)
+	{
+		RemovePending(f);
+	}
+	else if (bf->furthestPoint < 0)
+	{
+		bf->furthestPoint = bf->outsideHead;
+	}
+}
+
+bool ConvexHull::BuildState::BuildSimplex(void)
+{
+	// Find the extreme points along the coordinate axes, and start with the most widely separated pair.
+
+	int32 extreme[6] = {0, 0, 0, 0, 0, 0};
+	for (machine i = 1; i < pointCount; i++)
+	{
+		const Point3D& p = point[i];
+		for (machine a = 0; a < 3; a++)
+		{
+			if (p[a] < point[extreme[a]][a])
+			{
+				extreme[a] = int32(i);
+			}
+
+			if (p[a] > point[extreme[a + 3]][a])
+			{
+				extreme[a + 3] = int32(i);
+			}
+		}
+	}
+
+	int32 v0 = extreme[0];
+	int32 v1 = extreme[3];
+	float bestDistance = SquaredMag(point[v1] - point[v0]);
+	for (machine a = 1; a < 3; a++)
+	{
+		float d = SquaredMag(point[extreme[a + 3]] - point[extreme[a]]);
+		if (d > bestDistance)
+		{
+			bestDistance = d;
+			v0 = extreme[a];
+			v1 = extreme[a + 3];
+		}
+	}
+
+	if (!(bestDistance > tolerance * tolerance))
+	{
+		return (false);
+	}
+
+	// Find the point farthest from the line through v0 and v1, and then find the point farthest from the plane through v0, v1, and v2.
+
+	const Point3D& p0 = point[v0];
+	int32 v2 = FindFarthestFromLine(pointCount, point, p0, Normalize(point[v1] - p0), &bestDistance);
+	if ((v2 < 0) || (!(bestDistance > tolerance * tolerance)))
+	{
+		return (false);
+	}
+
+	Plane3D base(p0, point[v1], point[v2]);
+	base *= InverseSqrt(base.x * base.x + base.y * base.y + base.z * base.z);
+
+	int32 v3 = FindFarthestFromPlane(pointCount, point, base, &bestDistance);
+	if ((v3 < 0) || (!(bestDistance > tolerance)))
+	{
+		return (false);
+	}
+
+	// Orient the base so that v3 lies behind it, and create the four faces of the tetrahedron.
+
+	if ((point[v3] ^ base) > 0.0F)
+	{
+		int32 t = v1;
+		v1 = v2;
+		v2 = t;
+	}
+
+	int32 f[4];
+	f[0] = NewFace(v0, v1, v2);
+	f[1] = NewFace(v0, v3, v1);
+	f[2] = NewFace(v1, v3, v2);
+	f[3] = NewFace(v2, v3, v0);
+
+	for (machine a = 0; a < 4; a++)
+	{
+		for (machine ea = 0; ea < 3; ea++)
+		{
+			int32 s = face[f[a]].vertex[ea];
+			int32 t = face[f[a]].vertex[(ea + 1) % 3];
+
+			for (machine b = 0; b < 4; b++)
+			{
+				for (machine eb = 0; eb < 3; eb++)
+				{
+					if ((face[f[b]].vertex[eb] == t) && (face[f[b]].vertex[(eb + 1) % 3] == s))
+					{
+						face[f[a]].twin[ea] = int32(f[b] * 3 + eb);
+					}
+				}
+			}
+		}
+	}
+
+	return (true);
+}
+
+void ConvexHull::BuildState::PartitionPoints(void)
+{
+	// Assign every point in front of a face of the initial tetrahedron to the face it is farthest in front of.
+	// Four points are tested against all four planes at once.
+
+	machine i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		vec_float	g[4][4];
+
+		for (machine k = 0; k < 4; k++)
+		{
+			const Plane3D& plane = face[k].plane;
+			g[k][0] = VecLoadSmearScalar(&plane.x);
+			g[k][1] = VecLoadSmearScalar(&plane.y);
+			g[k][2] = VecLoadSmearScalar(&plane.z);
+			g[k][3] = VecLoadSmearScalar(&plane.w);
+		}
+
+		alignas(16) float	value[4];
+		alignas(16) int32	lane[4];
+
+		for (; i + 4 <= pointCount; i += 4)
+		{
+			vec_float	x, y, z;
+
+			VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+
+			vec_float best = VecMadd(g[0][0], x, VecMadd(g[0][1], y, VecMadd(g[0][2], z, g[0][3])));
+			vec_int32 bestFace = VecInt32GetZero();
+
+			for (machine k = 1; k < 4; k++)
+			{
+				vec_float d = VecMadd(g[k][0], x, VecMadd(g[k][1], y, VecMadd(g[k][2], z, g[k][3])));
+				vec_float mask = VecMaskCmpgt(d, best);
+				best = VecSelect(best, d, mask);
+
+				alignas(16) const int32 faceIndex[4] = {int32(k), int32(k), int32(k), int32(k)};
+				bestFace = VecInt32Select(bestFace, VecInt32Load(faceIndex), VecCastInt32(mask));
+			}
+
+			VecStore(best, value);
+			VecInt32Store(bestFace, lane);
+			for (machine k = 0; k < 4; k++)
+			{
+				if (value[k] > tolerance)
+				{
+					AssignPoint(int32(i + k), lane[k], value[k]);
+				}
+			}
+		}
+
+	#endif
+
+	for (; i < pointCount; i++)
+	{
+		float best = GetDistance(0, int32(i));
+		int32 bestFace = 0;
+		for (machine k = 1; k < 4; k++)
+		{
+			float d = GetDistance(int32(k), int32(i));
+			if (d > best)
+			{
+				best = d;
+				bestFace = int32(k);
+			}
+		}
+
+		if (best > tolerance)
+		{
+			AssignPoint(int32(i), bestFace, best);
+		}
+	}
+}
+
+int32 ConvexHull::BuildState::FindHorizon(int32 eye, int32 f, bool conservative)
+{
+	// Visit the connected set of faces that can see the eye point with a depth-first traversal across edges, and record
+	// each edge whose adjacent face cannot see the eye point. These edges form the horizon. The stack holds a face and
+	// the number of its edges already examined, and a face entered through an edge examines its other two edges.
+	// In conservative mode, every face whose plane the eye point lies within the tolerance of is treated as visible.
+
+	int32 mark = ++visitMark;
+	visibleCount = 0;
+	int32 horizonCount = 0;
+	int32 stackCount = 1;
+
+	face[f].visitMark = mark;
+	visibleFace[visibleCount++] = f;
+	stack[0] = f * 3;
+	stack[1] = 0;
+
+	while (stackCount > 0)
+	{
+		int32 *top = &stack[(stackCount - 1) * 2];
+		int32 current = top[0] / 3;
+		int32 entry = top[0] - current * 3;
+		int32 limit = (stackCount == 1) ? 3 : 2;
+
+		if (top[1] == limit)
+		{
+			stackCount--;
+			continue;
+		}
+
+		int32 e = (stackCount == 1) ? top[1] : entry + 1 + top[1];
+		e = (e < 3) ? e : e - 3;
+		top[1]++;
+
+		int32 twin = face[current].twin[e];
+		int32 neighbor = twin / 3;
+		if (face[neighbor].visitMark == mark)
+		{
+			continue;
+		}
+
+		// A face is also treated as visible when the eye point lies within the tolerance of its plane and above the face itself
+		// or within the tolerance of the shared edge. Otherwise, the new face on that edge would be folded over the neighbor or
+		// degenerate, and its plane could not be reliably oriented.
+
+		float d = GetDistance(neighbor, eye);
+		bool visible = (d > ((conservative) ? -tolerance : 0.0F));
+		if ((!visible) && (d > -tolerance))
+		{
+			const Plane3D& g = face[neighbor].plane;
+			const Point3D& a = point[face[current].vertex[e]];
+			Vector3D ab = point[face[current].vertex[(e < 2) ? e + 1 : 0]] - a;
+			visible = (Dot(Cross(ab, point[eye] - a), Vector3D(g.x, g.y, g.z)) < tolerance * Magnitude(ab));
+		}
+
+		if (visible)
+		{
+			face[neighbor].visitMark = mark;
+			visibleFace[visibleCount++] = neighbor;
+			stack[stackCount * 2] = twin;
+			stack[stackCount * 2 + 1] = 0;
+			stackCount++;
+		}
+		else
+		{
+			horizonEdge[horizonCount++] = current * 3 + e;
+		}
+	}
+
+	return (horizonCount);
+}
+
+void ConvexHull::BuildState::AdoptFace(int32 f)
+{
+	// Add an existing face changed by an edge flip to the list of new faces, and move its outside set to the orphans.
+
+	BuildFace *bf = &face[f];
+	if (bf->visitMark != -visitMark)
+	{
+		bf->visitMark = -visitMark;
+		newFace[newCount++] = f;
+
+		if (bf->outsideHead >= 0)
+		{
+			RemovePending(f);
+
+			int32 p = bf->outsideHead;
+			while (p >= 0)
+			{
+				int32 next = pointLink[p];
+				pointLink[p] = orphanHead;
+				orphanHead = p;
+				p = next;
+			}
+
+			bf->outsideHead = -1;
+			bf->furthestPoint = -1;
+			bf->furthestDistance = 0.0F;
+		}
+	}
+}
+
+bool ConvexHull::BuildState::FlipEdge(int32 edge)
+{
+	// The edge runs from p to q on face A = (p, q, r), and from q to p on face B = (q, p, s). If the edge is concave, then it is
+	// replaced by the edge between r and s, giving the faces A = (r, p, s) and B = (s, q, r). The flip is made only if it reduces
+	// the concavity, which prevents flips from alternating when the four vertices are nearly coplanar.
+
+	int32 fa = edge / 3;
+	int32 i = edge - fa * 3;
+	int32 twin = face[fa].twin[i];
+	int32 fb = twin / 3;
+	int32 j = twin - fb * 3;
+
+	int32 i1 = (i < 2) ? i + 1 : 0;
+	int32 i2 = (i1 < 2) ? i1 + 1 : 0;
+	int32 j1 = (j < 2) ? j + 1 : 0;
+	int32 j2 = (j1 < 2) ? j1 + 1 : 0;
+
+	int32 p = face[fa].vertex[i];
+	int32 q = face[fa].vertex[i1];
+	int32 r = face[fa].vertex[i2];
+	int32 s = face[fb].vertex[j2];
+
+	int32 ta1 = face[fa].twin[i1];
+	int32 ta2 = face[fa].twin[i2];
+	int32 tb1 = face[fb].twin[j1];
+	int32 tb2 = face[fb].twin[j2];
+
+	if ((r == s) || (ta1 / 3 == fb) || (ta2 / 3 == fb) || (tb1 / 3 == fa) || (tb2 / 3 == fa))
+	{
+		return (false);
+	}
+
+	float concavity = Fmax(GetDistance(fa, s), GetDistance(fb, r));
+	if (!(concavity > 0.0F))
+	{
+		return (false);
+	}
+
+	// The new faces must face the same way as the old pair. Otherwise, the quadrilateral is not convex, and one of the
+	// new faces would be folded over the other.
+
+	Plane3D planeA = CalculatePlane(r, p, s);
+	Plane3D planeB = CalculatePlane(s, q, r);
+
+	const Plane3D& ga = face[fa].plane;
+	const Plane3D& gb = face[fb].plane;
+	float nx = ga.x + gb.x;
+	float ny = ga.y + gb.y;
+	float nz = ga.z + gb.z;
+
+	if ((!(planeA.x * nx + planeA.y * ny + planeA.z * nz > 0.0F)) || (!(planeB.x * nx + planeB.y * ny + planeB.z * nz > 0.0F)) || (!(Fmax(point[q] ^ planeA, point[p] ^ planeB) < concavity)))
+	{
+		return (false);
+	}
+
+	AdoptFace(fa);
+	AdoptFace(fb);
+
+	BuildFace *ba = &face[fa];
+	ba->vertex[0] = r;
+	ba->vertex[1] = p;
+	ba->vertex[2] = s;
+	ba->twin[0] = ta2;
+	ba->twin[1] = tb1;
+	ba->twin[2] = fb * 3 + 2;
+	ba->plane = planeA;
+
+	BuildFace *bb = &face[fb];
+	bb->vertex[0] = s;
+	bb->vertex[1] = q;
+	bb->vertex[2] = r;
+	bb->twin[0] = tb2;
+	bb->twin[1] = ta1;
+	bb->twin[2] = fa * 3 + 2;
+	bb->plane = planeB;
+
+	face[ta2 / 3].twin[ta2 % 3] = fa * 3;
+	face[tb1 / 3].twin[tb1 % 3] = fa * 3 + 1;
+	face[tb2 / 3].twin[tb2 % 3] = fb * 3;
+	face[ta1 / 3].twin[ta1 % 3] = fb * 3 + 1;
+
+	return (true);
+}
+
+void ConvexHull::BuildState::FlipConcaveEdges(void)
+{
+	// When the eye point is nearly coplanar with a face beyond the horizon, the new face on the horizon edge is a sliver whose plane
+	// is poorly determined, and the edge can be concave by much more than the tolerance. Such edges are flipped, and the edges
+	// surrounding each flipped pair of faces are then examined in turn. The stack holds half-edge indices, and its capacity bounds
+	// the total number of flips.
+
+	int32 stackCapacity = faceCapacity * 2;
+	int32 stackCount = 0;
+
+	for (machine n = 0; n < newCount; n++)
+	{
+		stack[stackCount++] = newFace[n] * 3;
+		stack[stackCount++] = newFace[n] * 3 + 1;
+	}
+
+	int32 flipCount = 0;
+	while (stackCount > 0)
+	{
+		int32 edge = stack[--stackCount];
+		if ((FlipEdge(edge)) && (stackCount + 4 <= stackCapacity) && (++flipCount < stackCapacity))
+		{
+			int32 fa = edge / 3;
+			int32 fb = face[fa].twin[2] / 3;
+
+			stack[stackCount++] = fa * 3;
+			stack[stackCount++] = fa * 3 + 1;
+			stack[stackCount++] = fb * 3;
+			stack[stackCount++] = fb * 3 + 1;
+		}
+	}
+}
+
+bool ConvexHull::BuildState::AddPoint(int32 eye, int32 f, bool conservative)
+{
+	int32 horizonCount = FindHorizon(eye, f, conservative);
+
+	// Chain the horizon edges into a closed loop. If rounding has made the set of visible faces inconsistent,
+	// the horizon is not a simple loop, and the point is rejected without changing the hull.
+
+	for (machine k = 0; k < horizonCount; k++)
+	{
+		int32 e = horizonEdge[k];
+		int32 start = face[e / 3].vertex[e % 3];
+		if (vertexEdge[start] >= 0)
+		{
+			for (machine j = 0; j < k; j++)
+			{
+				vertexEdge[face[horizonEdge[j] / 3].vertex[horizonEdge[j] % 3]] = -1;
+			}
+
+			return (false);
+		}
+
+		vertexEdge[start] = int32(k);
+	}
+
+	bool closed = true;
+	int32 k = 0;
+	for (machine n = 0; n < horizonCount; n++)
+	{
+		int32 e = horizonEdge[k];
+		horizonOrder[n] = e;
+
+		int32 end = face[e / 3].vertex[(e % 3 + 1) % 3];
+		k = vertexEdge[end];
+		if ((k < 0) || ((k == 0) && (n + 1 < horizonCount)))
+		{
+			closed = false;
+			break;
+		}
+	}
+
+	if ((!closed) || (k != 0) || (horizonCount < 3))
+	{
+		for (machine j = 0; j < horizonCount; j++)
+		{
+			vertexEdge[face[horizonEdge[j] / 3].vertex[horizonEdge[j] % 3]] = -1;
+		}
+
+		return (false);
+	}
+
+	// Collect the points owned by the visible faces, remember the horizon vertices and the twins on the far side
+	// of the horizon, and then delete the visible faces. The vertices of the visible faces that are not on the horizon
+	// are removed from the hull, and they are collected as well. Because faces within the tolerance of the eye point
+	// are treated as visible, such a vertex can still lie outside the new faces, and it must not be lost.
+
+	orphanHead = -1;
+	for (machine j = 0; j < visibleCount; j++)
+	{
+		int32 v = visibleFace[j];
+		BuildFace *bf = &face[v];
+
+		for (machine i = 0; i < 3; i++)
+		{
+			int32 p = bf->vertex[i];
+			if ((vertexEdge[p] < 0) && (p != eye))
+			{
+				vertexEdge[p] = horizonCount;
+				pointLink[p] = orphanHead;
+				orphanHead = p;
+			}
+		}
+
+		if (bf->outsideHead >= 0)
+		{
+			RemovePending(v);
+
+			int32 p = bf->outsideHead;
+			while (p >= 0)
+			{
+				int32 next = pointLink[p];
+				if (p != eye)
+				{
+					pointLink[p] = orphanHead;
+					orphanHead = p;
+				}
+
+				p = next;
+			}
+		}
+	}
+
+	for (machine n = 0; n < horizonCount; n++)
+	{
+		int32 e = horizonOrder[n];
+		const BuildFace *bf = &face[e / 3];
+		int32 local = e % 3;
+
+		horizonEdge[n * 3] = bf->vertex[local];
+		horizonEdge[n * 3 + 1] = bf->vertex[(local + 1) % 3];
+		horizonEdge[n * 3 + 2] = bf->twin[local];
+	}
+
+	for (machine n = 0; n < horizonCount; n++)
+	{
+		vertexEdge[horizonEdge[n * 3]] = -1;
+	}
+
+	for (int32 p = orphanHead; p >= 0; p = pointLink[p])
+	{
+		vertexEdge[p] = -1;
+	}
+
+	for (machine j = 0; j < visibleCount; j++)
+	{
+		DeleteFace(visibleFace[j]);
+	}
+
+	// Create a cone of new faces connecting the horizon to the eye point. The new faces are marked with the
+	// negated visit mark so that faces later adopted by edge flips can be distinguished from them.
+
+	for (machine n = 0; n < horizonCount; n++)
+	{
+		int32 nf = NewFace(horizonEdge[n * 3], horizonEdge[n * 3 + 1], eye);
+		int32 twin = horizonEdge[n * 3 + 2];
+
+		face[nf].twin[0] = twin;
+		face[twin / 3].twin[twin % 3] = nf * 3;
+		face[nf].visitMark = -visitMark;
+		newFace[n] = nf;
+	}
+
+	for (machine n = 0; n < horizonCount; n++)
+	{
+		int32 a = newFace[n];
+		int32 b = newFace[(n + 1 < horizonCount) ? n + 1 : 0];
+		face[a].twin[1] = b * 3 + 2;
+		face[b].twin[2] = a * 3 + 1;
+	}
+
+	newCount = horizonCount;
+	FlipConcaveEdges();
+
+	// Reassign each orphaned point to the new face it is farthest in front of. The planes of the new faces are stored in
+	// structure-of-arrays layout, padded to a multiple of four with planes that no point is in front of.
+
+	int32 paddedCount = (newCount + 3) & ~3;
+	for (machine n = 0; n < newCount; n++)
+	{
+		const Plane3D& plane = face[newFace[n]].plane;
+		newPlane[0][n] = plane.x;
+		newPlane[1][n] = plane.y;
+		newPlane[2][n] = plane.z;
+		newPlane[3][n] = plane.w;
+	}
+
+	for (machine n = newCount; n < paddedCount; n++)
+	{
+		newPlane[0][n] = 0.0F;
+		newPlane[1][n] = 0.0F;
+		newPlane[2][n] = 0.0F;
+		newPlane[3][n] = -Math::max_float;
+	}
+
+	int32 p = orphanHead;
+	while (p >= 0)
+	{
+		int32 next = pointLink[p];
+		float best = tolerance;
+		int32 bestFace = -1;
+
+		#ifndef TERATHON_NO_SIMD
+
+			const Point3D& q = point[p];
+			vec_float px = VecLoadSmearScalar(&q.x);
+			vec_float py = VecLoadSmearScalar(&q.y);
+			vec_float pz = VecLoadSmearScalar(&q.z);
+
+			alignas(16) float	value[4];
+
+			for (machine n = 0; n < paddedCount; n += 4)
+			{
+				vec_float d = VecMadd(VecLoad(&newPlane[0][n]), px, VecMadd(VecLoad(&newPlane[1][n]), py, VecMadd(VecLoad(&newPlane[2][n]), pz, VecLoad(&newPlane[3][n]))));
+				if (VecMaskGetBits(VecMaskCmpgt(d, VecLoadSmearScalar(&best))) != 0)
+				{
+					VecStore(d, value);
+					for (machine j = 0; j < 4; j++)
+					{
+						if (value[j] > best)
+						{
+							best = value[j];
+							bestFace = newFace[n + j];
+						}
+					}
+				}
+			}
+
+		#else
+
+			for (machine n = 0; n < newCount; n++)
+			{
+				float d = GetDistance(newFace[n], p);
+				if (d > best)
+				{
+					best = d;
+					bestFace = newFace[n];
+				}
+			}
+
+		#endif
+
+		if (bestFace >= 0)
+		{
+			AssignPoint(p, bestFace, best);
+		}
+		else
+		{
+			pointLink[p] = -1;
+		}
+
+		p = next;
+	}
+
+	return (true);
+}
+
+bool ConvexHull::BuildState::ReassignOutsidePoints(void)
+{
+	// Faces treated as visible because the eye point lies within the tolerance of them can make the new faces dip slightly into the hull,
+	// and on thin inputs, the planes of sliver faces can be tilted enough that a point discarded earlier ends up outside the final hull.
+	// Every point that is not a vertex is therefore tested again, and each one found outside is assigned to the face it is farthest in front of.
+	//
+	// The hull contains the average of its vertices, and the distance to each plane divided by the height of that center below it is
+	// a linear function of the point maximized over the vertices of the polar polytope. Walking across edges toward larger values thus finds
+	// the maximum over all faces, and a full search is made only when the maximum shows that the point may lie outside by the tolerance.
+	// Points inside the largest sphere about the center that the planes enclose are skipped, and each walk starts at the best of a small
+	// set of faces spread through the face array.
+
+	int32 vertexCount = 0;
+	int32 liveCount = 0;
+	Vector3D sum(0.0F, 0.0F, 0.0F);
+
+	for (machine f = 0; f < faceHigh; f++)
+	{
+		const BuildFace *bf = &face[f];
+		if (bf->live)
+		{
+			for (machine k = 0; k < 3; k++)
+			{
+				int32 v = bf->vertex[k];
+				if (vertexEdge[v] < 0)
+				{
+					vertexEdge[v] = 0;
+					sum += point[v];
+					vertexCount++;
+				}
+			}
+
+			stack[liveCount++] = int32(f);
+		}
+	}
+
+	Point3D center(sum / float(vertexCount));
+
+	float *scale = newPlane[0];
+	float maxHeight = tolerance;
+	float minHeight = Math::max_float;
+
+	for (machine k = 0; k < liveCount; k++)
+	{
+		int32 f = stack[k];
+		float h = Fmax(-(center ^ face[f].plane), tolerance);
+		maxHeight = Fmax(maxHeight, h);
+		minHeight = Fmin(minHeight, h);
+		scale[f] = 1.0F / h;
+	}
+
+	int32 seedCount = (liveCount < kMaxHullSeedCount) ? liveCount : kMaxHullSeedCount;
+	for (machine k = 0; k < seedCount; k++)
+	{
+		stack[k] = stack[k * liveCount / seedCount];
+	}
+
+	float threshold = tolerance / maxHeight;
+	float r2 = minHeight * minHeight;
+	bool assigned = false;
+
+	for (machine p = 0; p < pointCount; p++)
+	{
+		if ((vertexEdge[p] >= 0) || (SquaredMag(point[p] - center) < r2))
+		{
+			continue;
+		}
+
+		int32 current = stack[0];
+		float value = GetDistance(current, int32(p)) * scale[current];
+		for (machine k = 1; k < seedCount; k++)
+		{
+			float v = GetDistance(stack[k], int32(p)) * scale[stack[k]];
+			if (v > value)
+			{
+				value = v;
+				current = stack[k];
+			}
+		}
+
+		for (;;)
+		{
+			int32 next = -1;
+			for (machine e = 0; e < 3; e++)
+			{
+				int32 neighbor = face[current].twin[e] / 3;
+				float v = GetDistance(neighbor, int32(p)) * scale[neighbor];
+				if (v > value)
+				{
+					value = v;
+					next = neighbor;
+				}
+			}
+
+			if (next < 0)
+			{
+				break;
+			}
+
+			current = next;
+		}
+
+		if (value > threshold)
+		{
+			float best = tolerance;
+			int32 bestFace = -1;
+
+			for (machine f = 0; f < faceHigh; f++)
+			{
+				if (face[f].live)
+				{
+					float d = GetDistance(int32(f), int32(p));
+					if (d > best)
+					{
+						best = d;
+						bestFace = int32(f);
+					}
+				}
+			}
+
+			if (bestFace >= 0)
+			{
+				AssignPoint(int32(p), bestFace, best);
+				assigned = true;
+			}
+		}
+	}
+
+	for (machine f = 0; f < faceHigh; f++)
+	{
+		const BuildFace *bf = &face[f];
+		if (bf->live)
+		{
+			vertexEdge[bf->vertex[0]] = -1;
+			vertexEdge[bf->vertex[1]] = -1;
+			vertexEdge[bf->vertex[2]] = -1;
+		}
+	}
+
+	return (assigned);
+}
+
+void ConvexHull::BuildState::Run(void)
+{
+	for (machine pass = 0; pass < kMaxHullPassCount; pass++)
+	{
+		while (pendingHead >= 0)
+		{
+			int32 f = pendingHead;
+			int32 eye = face[f].furthestPoint;
+
+			// If rounding makes the horizon inconsistent, then the point is retried with the larger set of faces that it is within
+			// the tolerance of. If that also fails, the point is set aside, and it is found again by the test of all points below.
+
+			if ((!AddPoint(eye, f, false)) && (!AddPoint(eye, f, true)))
+			{
+				RemovePoint(eye, f);
+			}
+		}
+
+		if (!ReassignOutsidePoints())
+		{
+			break;
+		}
+	}
+}
+
+
+ConvexHull::ConvexHull()
+{
+	vertexCount = 0;
+	faceCount = 0;
+	pointCapacity = 0;
+	tolerance = 0.0F;
+	vertexArray = nullptr;
+	vertexIndex = nullptr;
+	faceArray = nullptr;
+	planeArray = nullptr;
+	hullStorage = nullptr;
+}
+
+ConvexHull::ConvexHull(int32 count, const Point3D *point)
+{
+	vertexCount = 0;
+	faceCount = 0;
+	pointCapacity = 0;
+	tolerance = 0.0F;
+	vertexArray = nullptr;
+	vertexIndex = nullptr;
+	faceArray = nullptr;
+	planeArray = nullptr;
+	hullStorage = nullptr;
+
+	Build(count, point);
+}
+
+ConvexHull::~ConvexHull()
+{
+	ReleaseAligned(hullStorage);
+}
+
+void ConvexHull::Release(void)
+{
+	ReleaseAligned(hullStorage);
+	hullStorage = nullptr;
+	vertexArray = nullptr;
+	vertexIndex = nullptr;
+	faceArray = nullptr;
+	planeArray = nullptr;
+	pointCapacity = 0;
+}
+
+void ConvexHull::Prepare(int32 count)
+{
+	// A hull with v vertices has 2v - 4 triangular faces.
+
+	if (count > pointCapacity)
+	{
+		Release();
+
+		int32 faceMax = count * 2;
+		hullStorage = AllocateAligned(AlignSize(count * sizeof(Point3D)) + AlignSize(count * sizeof(int32)) + AlignSize(faceMax * sizeof(Face)) + faceMax * sizeof(Plane3D));
+		pointCapacity = count;
+	}
+
+	int32 faceMax = pointCapacity * 2;
+	char *storage = static_cast<char *>(hullStorage);
+	vertexArray = reinterpret_cast<Point3D *>(storage);
+	storage += AlignSize(pointCapacity * sizeof(Point3D));
+	vertexIndex = reinterpret_cast<int32 *>(storage);
+	storage += AlignSize(pointCapacity * sizeof(int32));
+	faceArray = reinterpret_cast<Face *>(storage);
+	storage += AlignSize(faceMax * sizeof(Face));
+	planeArray = reinterpret_cast<Plane3D *>(storage);
+}
+
+/// @brief Builds the convex hull of a set of points.
+///
+/// The points are shifted so that the center of their bounding box is at the origin before the hull is built, which keeps the plane
+/// distances precise for points far from the origin. The initial tetrahedron is formed by the most widely separated pair of extreme points
+/// along the coordinate axes, the point farthest from the line through them, and the point farthest from the plane through those three.
+/// Each remaining point is assigned to the outside set of the face it is farthest in front of, and the hull is then expanded by
+/// repeatedly adding the farthest point of a nonempty outside set, replacing the faces visible from that point with a cone of new faces.
+/// The farthest-point searches and the tests of points against the planes of the initial and new faces use SIMD instructions.
+/// Once no outside points remain, every point that is not a vertex is tested against the finished hull, and any point that rounding
+/// has left outside by more than the tolerance is added again, so points are never lost on thin or nearly degenerate inputs.
+///
+/// If all of the points lie within the distance tolerance of a common plane, then the hull has no volume, and it is left empty.
+///
+/// @param count	The number of points.
+/// @param point	A pointer to an array of \c count points.
+/// @return \c true if the hull was built, and \c false if the points are degenerate.
+
+bool ConvexHull::Build(int32 count, const Point3D *point)
+{
+	vertexCount = 0;
+	faceCount = 0;
+	tolerance = 0.0F;
+
+	if (count < 4)
+	{
+		return (false);
+	}
+
+	Point3D pmin = point[0];
+	Point3D pmax = point[0];
+	for (machine i = 1; i < count; i++)
+	{
+		const Point3D& p = point[i];
+		pmin.Set(Fmin(pmin.x, p.x), Fmin(pmin.y, p.y), Fmin(pmin.z, p.z));
+		pmax.Set(Fmax(pmax.x, p.x), Fmax(pmax.y, p.y), Fmax(pmax.z, p.z));
+	}
+
+	Vector3D shift = (pmin + pmax) * 0.5F;
+	Vector3D extent = (pmax - pmin) * 0.5F;
+
+	BuildState state(count, point, shift);
+
+	// The tolerance follows the usual bound on the rounding error of a plane distance calculated from coordinates
+	// of the given magnitudes, including the error of the coordinate shift.
+
+	tolerance = (Fabs(shift.x) + Fabs(shift.y) + Fabs(shift.z) + extent.x + extent.y + extent.z) * 3.6e-7F;
+	state.tolerance = tolerance;
+
+	if (!state.BuildSimplex())
+	{
+		return (false);
+	}
+
+	state.PartitionPoints();
+	state.Run();
+
+	// Compact the live faces and the vertices they use into the output arrays. The planes are shifted back
+	// to the original coordinate system.
+
+	Prepare(count);
+
+	int32 *vertexMap = state.vertexEdge;
+	for (machine f = 0; f < state.faceHigh; f++)
+	{
+		const BuildFace *bf = &state.face[f];
+		if (bf->live)
+		{
+			Face *outFace = &faceArray[faceCount];
+			for (machine k = 0; k < 3; k++)
+			{
+				int32 v = bf->vertex[k];
+				if (vertexMap[v] < 0)
+				{
+					vertexMap[v] = vertexCount;
+					vertexArray[vertexCount] = point[v];
+					vertexIndex[vertexCount] = v;
+					vertexCount++;
+				}
+
+				outFace->vertex[k] = vertexMap[v];
+			}
+
+			const Plane3D& g = bf->plane;
+			planeArray[faceCount].Set(g.x, g.y, g.z, g.w - (g.x * shift.x + g.y * shift.y + g.z * shift.z));
+			faceCount++;
+		}
+	}
+
+	return (true);
+}
+
+/// @brief Returns a boolean value indicating whether a point is inside the hull.
+///
+/// The point is tested against the planes of four faces at a time with SIMD instructions. A point lying within \c epsilon in front
+/// of every plane is considered inside. If the hull is empty, then the return value is always \c false.
+///
+/// @param p			The point to test.
+/// @param epsilon		The distance by which the point may lie outside the hull.
+
+bool ConvexHull::Contains(const Point3D& p, float epsilon) const
+{
+	if (faceCount == 0)
+	{
+		return (false);
+	}
+
+	machine k = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		vec_float px = VecLoadSmearScalar(&p.x);
+		vec_float py = VecLoadSmearScalar(&p.y);
+		vec_float pz = VecLoadSmearScalar(&p.z);
+		vec_float e = VecLoadSmearScalar(&epsilon);
+
+		for (; k + 4 <= faceCount; k += 4)
+		{
+			vec_float gx = VecLoadUnaligned(&planeArray[k].x);
+			vec_float gy = VecLoadUnaligned(&planeArray[k + 1].x);
+			vec_float gz = VecLoadUnaligned(&planeArray[k + 2].x);
+			vec_float gw = VecLoadUnaligned(&planeArray[k + 3].x);
+			VecTranspose4D(&gx, &gy, &gz, &gw);
+
+			vec_float d = VecMadd(gx, px, VecMadd(gy, py, VecMadd(gz, pz, gw)));
+			if (VecMaskGetBits(VecMaskCmpgt(d, e)) != 0)
+			{
+				return (false);
+			}
+		}
+
+	#endif
+
+	for (; k < faceCount; k++)
+	{
+		if ((p ^ planeArray[k]) > epsilon)
+		{
+			return (false);
+		}
+	}
+
+	return (true);
+}
@@ -0,0 +1,136 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSConvexHull_h
+#define TSConvexHull_h
+
+
+#include "TSRigid3D.h"
+#include "TSMemory.h"
+
+
+#define TERATHON_CONVEXHULL 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	ConvexHull
+	// ==============================================
+
+	/// @brief Calculates and stores the convex hull of a set of 3D points.
+	///
+	/// The \c ConvexHull class builds the convex hull of a set of points with the quickhull algorithm. The hull is stored as an array
+	/// of vertices, an array of triangular faces whose vertices are wound counterclockwise when viewed from outside the hull, and an array
+	/// holding the plane of each face. The planes are unitized and have normals pointing away from the hull, so a point is inside the
+	/// hull when it lies on the negative side of every plane.
+	///
+	/// Points within a distance tolerance of a face are considered to lie on the face. The tolerance is proportional to the magnitudes
+	/// of the coordinates of the input points and to the precision of floating-point arithmetic. Such points never become hull vertices,
+	/// which prevents the construction of slivers and keeps the faces consistently oriented. Coplanar faces are not merged, so a planar
+	/// region of the hull is represented by several triangles having nearly the same plane.
+	///
+	/// The output arrays share a single allocation that is reused when the hull is rebuilt for no more points than before.
+
+	class ConvexHull
+	{
+		public:
+
+			/// @brief A triangular face of a convex hull.
+
+			struct Face
+			{
+				int32			vertex[3];		///< The indices of the vertices of the face in the hull's vertex array, wound counterclockwise when viewed from outside.
+			};
+
+		private:
+
+			int32				vertexCount;
+			int32				faceCount;
+			int32				pointCapacity;
+			float				tolerance;
+
+			Point3D				*vertexArray;
+			int32				*vertexIndex;
+			Face				*faceArray;
+			Plane3D				*planeArray;
+			void				*hullStorage;
+
+			struct BuildFace;
+			struct BuildState;
+
+			void Release(void);
+			void Prepare(int32 count);
+
+		public:
+
+			TERATHON_API ConvexHull();
+			TERATHON_API ConvexHull(int32 count, const Point3D *point);
+			TERATHON_API ~ConvexHull();
+
+			ConvexHull(const ConvexHull&) = delete;
+			ConvexHull& operator =(const ConvexHull&) = delete;
+
+			/// @brief Returns the number of vertices of the hull.
+
+			int32 GetVertexCount(void) const
+			{
+				return (vertexCount);
+			}
+
+			/// @brief Returns the number of faces of the hull.
+
+			int32 GetFaceCount(void) const
+			{
+				return (faceCount);
+			}
+
+			/// @brief Returns the distance tolerance used when the hull was built.
+
+			float GetTolerance(void) const
+			{
+				return (tolerance);
+			}
+
+			/// @brief Returns a pointer to the array of hull vertices.
+
+			const Point3D *GetVertexArray(void) const
+			{
+				return (vertexArray);
+			}
+
+			/// @brief Returns the index of a hull vertex in the array of points from which the hull was built.
+			/// @param index	The index of the vertex in the hull's vertex array.
+
+			int32 GetVertexIndex(int32 index) const
+			{
+				return (vertexIndex[index]);
+			}
+
+			/// @brief Returns a pointer to the array of hull faces.
+
+			const Face *GetFaceArray(void) const
+			{
+				return (faceArray);
+			}
+
+			/// @brief Returns a pointer to the array of face planes. Plane <i>k</i> contains face <i>k</i>.
+
+			const Plane3D *GetPlaneArray(void) const
+			{
+				return (planeArray);
+			}
+
+			TERATHON_API bool Build(int32 count, const Point3D *point);
+			TERATHON_API bool Contains(const Point3D& p, float epsilon = 0.0F) const;
+	};
+}
+
+
+#endif
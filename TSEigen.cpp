@@ -0,0 +1,176 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSEigen.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum
+	{
+		kMaxJacobiSweepCount = 32
+	};
+
+
+	// Diagonalizes the symmetric n x n matrix a with cyclic Jacobi rotations. On return, the diagonal of a holds
+	// the eigenvalues, and the columns of v hold the corresponding eigenvectors. The eigenpairs are then sorted
+	// so that the eigenvalues are in decreasing order.
+
+	template <int32 n>
+	void SolveJacobi(float (& a)[n][n], float (& v)[n][n])
+	{
+		for (machine i = 0; i < n; i++)
+		{
+			for (machine j = 0; j < n; j++)
+			{
+				v[i][j] = (i == j) ? 1.0F : 0.0F;
+			}
+		}
+
+		for (machine sweep = 0; sweep < kMaxJacobiSweepCount; sweep++)
+		{
+			float diagonal = 0.0F;
+			float offDiagonal = 0.0F;
+			for (machine i = 0; i < n; i++)
+			{
+				diagonal += a[i][i] * a[i][i];
+				for (machine j = i + 1; j < n; j++)
+				{
+					offDiagonal += a[i][j] * a[i][j];
+				}
+			}
+
+			if (!(offDiagonal > diagonal * 1.0e-14F))
+			{
+				break;
+			}
+
+			for (machine p = 0; p < n - 1; p++)
+			{
+				for (machine q = p + 1; q < n; q++)
+				{
+					float apq = a[p][q];
+					if (Fabs(apq) > Math::min_float)
+					{
+						// Calculate the rotation that annihilates a[p][q], using the smaller root for t = tan(angle).
+
+						// When theta is so large that its square would overflow, t is replaced by its limit 1 / (2 theta).
+
+						float theta = (a[q][q] - a[p][p]) / (apq * 2.0F);
+						float absTheta = Fabs(theta);
+						float t = (absTheta < 1.0e18F) ? 1.0F / (absTheta + Sqrt(theta * theta + 1.0F)) : 0.5F / absTheta;
+						t = (theta < 0.0F) ? -t : t;
+
+						// The cosine is refined with one extra Newton-Raphson step so that the rotation stays
+						// orthogonal to full precision, which matters when many rotations are accumulated.
+
+						float u = t * t + 1.0F;
+						float c = InverseSqrt(u);
+						c *= 1.5F - u * c * c * 0.5F;
+						float s = t * c;
+
+						for (machine k = 0; k < n; k++)
+						{
+							float akp = a[k][p];
+							float akq = a[k][q];
+							a[k][p] = c * akp - s * akq;
+							a[k][q] = s * akp + c * akq;
+						}
+
+						for (machine k = 0; k < n; k++)
+						{
+							float apk = a[p][k];
+							float aqk = a[q][k];
+							a[p][k] = c * apk - s * aqk;
+							a[q][k] = s * apk + c * aqk;
+						}
+
+						for (machine k = 0; k < n; k++)
+						{
+							float vkp = v[k][p];
+							float vkq = v[k][q];
+							v[k][p] = c * vkp - s * vkq;
+							v[k][q] = s * vkp + c * vkq;
+						}
+					}
+				}
+			}
+		}
+
+		for (machine i = 0; i < n - 1; i++)
+		{
+			machine m = i;
+			for (machine j = i + 1; j < n; j++)
+			{
+				if (a[j][j] > a[m][m])
+				{
+					m = j;
+				}
+			}
+
+			if (m != i)
+			{
+				float t = a[i][i];
+				a[i][i] = a[m][m];
+				a[m][m] = t;
+
+				for (machine k = 0; k < n; k++)
+				{
+					t = v[k][i];
+					v[k][i] = v[k][m];
+					v[k][m] = t;
+				}
+			}
+		}
+	}
+}
+
+
+/// @brief Calculates the eigenvalues and eigenvectors of a symmetric 3&nbsp;&times;&nbsp;3 matrix.
+/// @param m				The matrix. Only the entries on and above the diagonal are read.
+/// @param eigenvalues		A pointer to a vector that receives the three eigenvalues in decreasing order.
+/// @param eigenvectors		A pointer to a matrix whose columns receive the unit-length eigenvectors corresponding to the eigenvalues.
+///
+/// The eigensystem is calculated with the cyclic Jacobi method, and the eigenvectors form a rotation or reflection matrix.
+///
+/// @relatedalso Matrix3D
+
+void Terathon::CalculateEigensystem(const Matrix3D& m, Vector3D *eigenvalues, Matrix3D *eigenvectors)
+{
+	float	v[3][3];
+
+	float a[3][3] = {{m(0,0), m(0,1), m(0,2)}, {m(0,1), m(1,1), m(1,2)}, {m(0,2), m(1,2), m(2,2)}};
+	SolveJacobi(a, v);
+
+	eigenvalues->Set(a[0][0], a[1][1], a[2][2]);
+	eigenvectors->Set(v[0][0], v[0][1], v[0][2], v[1][0], v[1][1], v[1][2], v[2][0], v[2][1], v[2][2]);
+}
+
+/// @brief Calculates the eigenvalues and eigenvectors of a symmetric 4&nbsp;&times;&nbsp;4 matrix.
+/// @param m				The matrix. Only the entries on and above the diagonal are read.
+/// @param eigenvalues		A pointer to a vector that receives the four eigenvalues in decreasing order.
+/// @param eigenvectors		A pointer to a matrix whose columns receive the unit-length eigenvectors corresponding to the eigenvalues.
+///
+/// The eigensystem is calculated with the cyclic Jacobi method.
+///
+/// @relatedalso Matrix4D
+
+void Terathon::CalculateEigensystem(const Matrix4D& m, Vector4D *eigenvalues, Matrix4D *eigenvectors)
+{
+	float	v[4][4];
+
+	float a[4][4] = {{m(0,0), m(0,1), m(0,2), m(0,3)}, {m(0,1), m(1,1), m(1,2), m(1,3)}, {m(0,2), m(1,2), m(2,2), m(2,3)}, {m(0,3), m(1,3), m(2,3), m(3,3)}};
+	SolveJacobi(a, v);
+
+	eigenvalues->Set(a[0][0], a[1][1], a[2][2], a[3][3]);
+	eigenvectors->Set(v[0][0], v[0][1], v[0][2], v[0][3], v[1][0], v[1][1], v[1][2], v[1][3], v[2][0], v[2][1], v[2][2], v[2][3], v[3][0], v[3][1], v[3][2], v[3][3]);
+}
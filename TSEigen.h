@@ -0,0 +1,27 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSEigen_h
+#define TSEigen_h
+
+
+#include "TSMatrix4D.h"
+
+
+#define TERATHON_EIGEN 1
+
+
+namespace Terathon
+{
+	TERATHON_API void CalculateEigensystem(const Matrix3D& m, Vector3D *eigenvalues, Matrix3D *eigenvectors);
+	TERATHON_API void CalculateEigensystem(const Matrix4D& m, Vector4D *eigenvalues, Matrix4D *eigenvectors);
+}
+
+
+#endif
@@ -0,0 +1,512 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSGeometryArray.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	void ScatterStreams4D(const float *source, int32 sourceStride, int32 count, float *x, float *y, float *z, float *w)
+	{
+		int32 i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			for (; i + 4 <= count; i += 4)
+			{
+				const float *s = source + i * sourceStride;
+				vec_float a = VecLoadUnaligned(s);
+				vec_float b = VecLoadUnaligned(s + sourceStride);
+				vec_float c = VecLoadUnaligned(s + sourceStride * 2);
+				vec_float d = VecLoadUnaligned(s + sourceStride * 3);
+
+				VecTranspose4D(&a, &b, &c, &d);
+
+				VecStoreUnaligned(a, x + i);
+				VecStoreUnaligned(b, y + i);
+				VecStoreUnaligned(c, z + i);
+				VecStoreUnaligned(d, w + i);
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			const float *s = source + i * sourceStride;
+			x[i] = s[0];
+			y[i] = s[1];
+			z[i] = s[2];
+			w[i] = s[3];
+		}
+	}
+
+	void GatherStreams4D(const float *x, const float *y, const float *z, const float *w, int32 count, float *dest, int32 destStride)
+	{
+		int32 i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			for (; i + 4 <= count; i += 4)
+			{
+				vec_float a = VecLoadUnaligned(x + i);
+				vec_float b = VecLoadUnaligned(y + i);
+				vec_float c = VecLoadUnaligned(z + i);
+				vec_float d = VecLoadUnaligned(w + i);
+
+				VecTranspose4D(&a, &b, &c, &d);
+
+				float *t = dest + i * destStride;
+				VecStoreUnaligned(a, t);
+				VecStoreUnaligned(b, t + destStride);
+				VecStoreUnaligned(c, t + destStride * 2);
+				VecStoreUnaligned(d, t + destStride * 3);
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			float *t = dest + i * destStride;
+			t[0] = x[i];
+			t[1] = y[i];
+			t[2] = z[i];
+			t[3] = w[i];
+		}
+	}
+}
+
+
+GeometryArray::GeometryArray(int32 components)
+{
+	elementCount = 0;
+	componentCount = components;
+	componentStride = 0;
+	componentData = nullptr;
+	ownedStorage = nullptr;
+}
+
+GeometryArray::GeometryArray(int32 components, int32 count)
+{
+	componentCount = components;
+	ownedStorage = nullptr;
+	Allocate(count);
+}
+
+GeometryArray::GeometryArray(int32 components, int32 count, void *storage)
+{
+	componentCount = components;
+	ownedStorage = nullptr;
+	SetStorage(count, storage);
+}
+
+GeometryArray::GeometryArray(int32 components, int32 count, MemoryArena *arena)
+{
+	componentCount = components;
+	ownedStorage = nullptr;
+	Allocate(count, arena);
+}
+
+GeometryArray::~GeometryArray()
+{
+	ReleaseAligned(ownedStorage);
+}
+
+void GeometryArray::Release(void)
+{
+	ReleaseAligned(ownedStorage);
+	ownedStorage = nullptr;
+}
+
+void GeometryArray::Initialize(int32 count, void *storage)
+{
+	elementCount = count;
+	componentStride = GetPaddedCount(count);
+	componentData = static_cast<float *>(storage);
+}
+
+void GeometryArray::ClearPadding(void)
+{
+	// Clear the padding at the end of each stream so that full-width SIMD kernels
+	// never read uninitialized values.
+
+	umachine padding = umachine(componentStride - elementCount) * sizeof(float);
+	if (padding != 0)
+	{
+		float *data = componentData + elementCount;
+		for (machine k = 0; k < componentCount; k++)
+		{
+			ClearMemory(data, padding);
+			data += componentStride;
+		}
+	}
+}
+
+/// @brief Allocates internally owned storage for the array.
+/// @param count	The number of elements.
+///
+/// Any storage previously allocated by the array is released, and the contents of the array become undefined.
+/// If the allocation fails, then the return value is \c false, and the array is left empty.
+
+bool GeometryArray::Allocate(int32 count)
+{
+	Release();
+
+	umachine size = GetStorageSize(componentCount, count);
+	if (size != 0)
+	{
+		ownedStorage = AllocateAligned(size, kStreamAlignment);
+		if (!ownedStorage)
+		{
+			Initialize(0, nullptr);
+			return (false);
+		}
+
+		Initialize(count, ownedStorage);
+		ClearPadding();
+	}
+	else
+	{
+		Initialize(0, nullptr);
+	}
+
+	return (true);
+}
+
+/// @brief Allocates storage for the array from a memory arena.
+/// @param count	The number of elements.
+/// @param arena	The arena from which storage is allocated.
+///
+/// Any storage previously allocated by the array is released, and the contents of the array become undefined.
+/// The storage remains valid until the arena is reset or rewound past this allocation. If the arena does not have
+/// enough space left, then the return value is \c false, and the array is left empty.
+
+bool GeometryArray::Allocate(int32 count, MemoryArena *arena)
+{
+	Release();
+
+	void *storage = arena->Allocate(GetStorageSize(componentCount, count), kStreamAlignment);
+	if ((storage) || (count == 0))
+	{
+		Initialize(count, storage);
+		ClearPadding();
+		return (true);
+	}
+
+	Initialize(0, nullptr);
+	return (false);
+}
+
+/// @brief Assigns externally owned storage to the array.
+/// @param count		The number of elements.
+/// @param storage		A pointer to storage aligned to 64 bytes that is at least as large as the size returned by \c GetStorageSize().
+///
+/// Any storage previously allocated by the array is released. The array does not take ownership of the new storage, and it never
+/// writes to the storage on its own, so a read-only mapping such as a stream returned by \c GeometryFile::GetComponent() can back
+/// an array that is only read. The padding at the end of each stream should already be zero because SIMD kernels read it.
+
+void GeometryArray::SetStorage(int32 count, void *storage)
+{
+	Release();
+	Initialize(count, storage);
+}
+
+
+/// @brief Copies an array of points into the array.
+/// @param start	The index of the first element to overwrite.
+/// @param count	The number of points to copy.
+/// @param point	A pointer to an array of \c count points.
+
+void Point3DArray::SetPoints(int32 start, int32 count, const Point3D *point)
+{
+	float *x = GetX() + start;
+	float *y = GetY() + start;
+	float *z = GetZ() + start;
+
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		const float *source = &point->x;
+		for (; i + 4 <= count; i += 4)
+		{
+			vec_float vx, vy, vz;
+			VecLoadTranspose3D(source + i * 3, &vx, &vy, &vz);
+			VecStoreUnaligned(vx, x + i);
+			VecStoreUnaligned(vy, y + i);
+			VecStoreUnaligned(vz, z + i);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		x[i] = point[i].x;
+		y[i] = point[i].y;
+		z[i] = point[i].z;
+	}
+}
+
+/// @brief Copies points out of the array.
+/// @param start	The index of the first element to read.
+/// @param count	The number of points to copy.
+/// @param point	A pointer to an array that receives \c count points.
+
+void Point3DArray::GetPoints(int32 start, int32 count, Point3D *point) const
+{
+	const float *x = GetX() + start;
+	const float *y = GetY() + start;
+	const float *z = GetZ() + start;
+
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		float *dest = &point->x;
+		for (; i + 4 <= count; i += 4)
+		{
+			VecStoreTranspose3D(VecLoadUnaligned(x + i), VecLoadUnaligned(y + i), VecLoadUnaligned(z + i), dest + i * 3);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		point[i].Set(x[i], y[i], z[i]);
+	}
+}
+
+
+/// @brief Copies an array of bivectors into the array.
+/// @param start		The index of the first element to overwrite.
+/// @param count		The number of bivectors to copy.
+/// @param bivector		A pointer to an array of \c count bivectors.
+
+void Bivector3DArray::SetBivectors(int32 start, int32 count, const Bivector3D *bivector)
+{
+	float *x = GetX() + start;
+	float *y = GetY() + start;
+	float *z = GetZ() + start;
+
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		const float *source = &bivector->x;
+		for (; i + 4 <= count; i += 4)
+		{
+			vec_float vx, vy, vz;
+			VecLoadTranspose3D(source + i * 3, &vx, &vy, &vz);
+			VecStoreUnaligned(vx, x + i);
+			VecStoreUnaligned(vy, y + i);
+			VecStoreUnaligned(vz, z + i);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		x[i] = bivector[i].x;
+		y[i] = bivector[i].y;
+		z[i] = bivector[i].z;
+	}
+}
+
+/// @brief Copies bivectors out of the array.
+/// @param start		The index of the first element to read.
+/// @param count		The number of bivectors to copy.
+/// @param bivector		A pointer to an array that receives \c count bivectors.
+
+void Bivector3DArray::GetBivectors(int32 start, int32 count, Bivector3D *bivector) const
+{
+	const float *x = GetX() + start;
+	const float *y = GetY() + start;
+	const float *z = GetZ() + start;
+
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		float *dest = &bivector->x;
+		for (; i + 4 <= count; i += 4)
+		{
+			VecStoreTranspose3D(VecLoadUnaligned(x + i), VecLoadUnaligned(y + i), VecLoadUnaligned(z + i), dest + i * 3);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		bivector[i].Set(x[i], y[i], z[i]);
+	}
+}
+
+
+/// @brief Copies an array of planes into the array.
+/// @param start	The index of the first element to overwrite.
+/// @param count	The number of planes to copy.
+/// @param plane	A pointer to an array of \c count planes.
+
+void Plane3DArray::SetPlanes(int32 start, int32 count, const Plane3D *plane)
+{
+	ScatterStreams4D(&plane->x, 4, count, GetX() + start, GetY() + start, GetZ() + start, GetW() + start);
+}
+
+/// @brief Copies planes out of the array.
+/// @param start	The index of the first element to read.
+/// @param count	The number of planes to copy.
+/// @param plane	A pointer to an array that receives \c count planes.
+
+void Plane3DArray::GetPlanes(int32 start, int32 count, Plane3D *plane) const
+{
+	GatherStreams4D(GetX() + start, GetY() + start, GetZ() + start, GetW() + start, count, &plane->x, 4);
+}
+
+
+/// @brief Copies an array of lines into the array.
+/// @param start	The index of the first element to overwrite.
+/// @param count	The number of lines to copy.
+/// @param line		A pointer to an array of \c count lines.
+
+void Line3DArray::SetLines(int32 start, int32 count, const Line3D *line)
+{
+	float *stream[6];
+	for (machine k = 0; k < 6; k++)
+	{
+		stream[k] = GetComponent(int32(k)) + start;
+	}
+
+	// Each line is six floats, so the second group of four overlaps the first, and streams 2 and 3 are written twice with the same values.
+
+	const float *source = &line->v.x;
+	ScatterStreams4D(source, 6, count, stream[0], stream[1], stream[2], stream[3]);
+	ScatterStreams4D(source + 2, 6, count, stream[2], stream[3], stream[4], stream[5]);
+}
+
+/// @brief Copies lines out of the array.
+/// @param start	The index of the first element to read.
+/// @param count	The number of lines to copy.
+/// @param line		A pointer to an array that receives \c count lines.
+
+void Line3DArray::GetLines(int32 start, int32 count, Line3D *line) const
+{
+	const float *stream[6];
+	for (machine k = 0; k < 6; k++)
+	{
+		stream[k] = GetComponent(int32(k)) + start;
+	}
+
+	float *dest = &line->v.x;
+	GatherStreams4D(stream[0], stream[1], stream[2], stream[3], count, dest, 6);
+	GatherStreams4D(stream[2], stream[3], stream[4], stream[5], count, dest + 2, 6);
+}
+
+
+/// @brief Copies an array of quaternions into the array.
+/// @param start		The index of the first element to overwrite.
+/// @param count		The number of quaternions to copy.
+/// @param quaternion	A pointer to an array of \c count quaternions.
+
+void QuaternionArray::SetQuaternions(int32 start, int32 count, const Quaternion *quaternion)
+{
+	ScatterStreams4D(&quaternion->x, 4, count, GetX() + start, GetY() + start, GetZ() + start, GetW() + start);
+}
+
+/// @brief Copies quaternions out of the array.
+/// @param start		The index of the first element to read.
+/// @param count		The number of quaternions to copy.
+/// @param quaternion	A pointer to an array that receives \c count quaternions.
+
+void QuaternionArray::GetQuaternions(int32 start, int32 count, Quaternion *quaternion) const
+{
+	GatherStreams4D(GetX() + start, GetY() + start, GetZ() + start, GetW() + start, count, &quaternion->x, 4);
+}
+
+
+/// @brief Copies an array of motors into the array.
+/// @param start	The index of the first element to overwrite.
+/// @param count	The number of motors to copy.
+/// @param motor	A pointer to an array of \c count motors.
+
+void Motor3DArray::SetMotors(int32 start, int32 count, const Motor3D *motor)
+{
+	float *stream[8];
+	for (machine k = 0; k < 8; k++)
+	{
+		stream[k] = GetComponent(int32(k)) + start;
+	}
+
+	const float *source = &motor->v.x;
+	int32 i = 0;
+
+	#if defined(TERATHON_AVX)
+
+		for (; i + 8 <= count; i += 8)
+		{
+			exv_float r[8];
+			for (machine k = 0; k < 8; k++)
+			{
+				r[k] = ExvLoadUnaligned(source + (i + k) * 8);
+			}
+
+			ExvTranspose8D(r);
+
+			for (machine k = 0; k < 8; k++)
+			{
+				ExvStoreUnaligned(r[k], stream[k] + i);
+			}
+		}
+
+	#endif
+
+	ScatterStreams4D(source + i * 8, 8, count - i, stream[0] + i, stream[1] + i, stream[2] + i, stream[3] + i);
+	ScatterStreams4D(source + i * 8 + 4, 8, count - i, stream[4] + i, stream[5] + i, stream[6] + i, stream[7] + i);
+}
+
+/// @brief Copies motors out of the array.
+/// @param start	The index of the first element to read.
+/// @param count	The number of motors to copy.
+/// @param motor	A pointer to an array that receives \c count motors.
+
+void Motor3DArray::GetMotors(int32 start, int32 count, Motor3D *motor) const
+{
+	const float *stream[8];
+	for (machine k = 0; k < 8; k++)
+	{
+		stream[k] = GetComponent(int32(k)) + start;
+	}
+
+	float *dest = &motor->v.x;
+	int32 i = 0;
+
+	#if defined(TERATHON_AVX)
+
+		for (; i + 8 <= count; i += 8)
+		{
+			exv_float r[8];
+			for (machine k = 0; k < 8; k++)
+			{
+				r[k] = ExvLoadUnaligned(stream[k] + i);
+			}
+
+			ExvTranspose8D(r);
+
+			for (machine k = 0; k < 8; k++)
+			{
+				ExvStoreUnaligned(r[k], dest + (i + k) * 8);
+			}
+		}
+
+	#endif
+
+	GatherStreams4D(stream[0] + i, stream[1] + i, stream[2] + i, stream[3] + i, count - i, dest + i * 8, 8);
+	GatherStreams4D(stream[4] + i, stream[5] + i, stream[6] + i, stream[7] + i, count - i, dest + i * 8 + 4, 8);
+}
@@ -0,0 +1,511 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSGeometryArray_h
+#define TSGeometryArray_h
+
+
+#include "TSMotor3D.h"
+#include "TSMemory.h"
+
+
+#define TERATHON_GEOMETRYARRAY 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	GeometryArray
+	// ==============================================
+
+	/// @brief Base class for arrays of geometric objects stored in structure-of-arrays layout.
+	///
+	/// The \c GeometryArray class stores each component of a geometric object in its own contiguous stream of floating-point values.
+	/// Every stream begins on a 64-byte boundary, and the number of floats in each stream is padded to a multiple of 16 so that
+	/// SIMD kernels can always process full vectors without a scalar tail. Padding entries are initialized to zero when the array
+	/// allocates its own storage.
+	///
+	/// Storage is either allocated by the array itself, taken from a \c MemoryArena, or supplied by the caller. Externally supplied
+	/// storage must be aligned to 64 bytes and must be at least as large as the size returned by the \c GetStorageSize() function.
+	/// The array never writes to external storage on its own, so the caller is responsible for its padding.
+	/// Arena and external storage is not released when the array is destroyed, so transient arrays used by batch operations
+	/// should take their storage from a per-frame arena.
+
+	class GeometryArray
+	{
+		public:
+
+			enum : uint32
+			{
+				kStreamAlignment	= 64,
+				kStreamGranularity	= 16
+			};
+
+		private:
+
+			int32		elementCount;
+			int32		componentCount;
+			int32		componentStride;
+
+			float		*componentData;
+			void		*ownedStorage;
+
+			void Release(void);
+			void Initialize(int32 count, void *storage);
+			void ClearPadding(void);
+
+		protected:
+
+			TERATHON_API explicit GeometryArray(int32 components);
+			TERATHON_API GeometryArray(int32 components, int32 count);
+			TERATHON_API GeometryArray(int32 components, int32 count, void *storage);
+			TERATHON_API GeometryArray(int32 components, int32 count, MemoryArena *arena);
+
+		public:
+
+			TERATHON_API ~GeometryArray();
+
+			GeometryArray(const GeometryArray&) = delete;
+			GeometryArray& operator =(const GeometryArray&) = delete;
+
+			/// @brief Returns the number of elements stored in the array.
+
+			int32 GetElementCount(void) const
+			{
+				return (elementCount);
+			}
+
+			/// @brief Returns the number of components that each element has.
+
+			int32 GetComponentCount(void) const
+			{
+				return (componentCount);
+			}
+
+			/// @brief Returns the number of floats between the beginnings of consecutive component streams.
+			///
+			/// The stride is always a multiple of 16 and is at least as large as the element count.
+
+			int32 GetComponentStride(void) const
+			{
+				return (componentStride);
+			}
+
+			/// @brief Returns a pointer to the beginning of a component stream.
+			/// @param index	The index of the component. This must be less than the value returned by \c GetComponentCount().
+
+			float *GetComponent(int32 index)
+			{
+				return (componentData + index * componentStride);
+			}
+
+			/// @brief Returns a pointer to the beginning of a component stream.
+			/// @param index	The index of the component. This must be less than the value returned by \c GetComponentCount().
+
+			const float *GetComponent(int32 index) const
+			{
+				return (componentData + index * componentStride);
+			}
+
+			/// @brief Returns the padded number of floats in one component stream for a given element count.
+			/// @param count	The number of elements.
+
+			static int32 GetPaddedCount(int32 count)
+			{
+				return ((count + (kStreamGranularity - 1)) & ~(kStreamGranularity - 1));
+			}
+
+			/// @brief Returns the number of bytes of storage needed for an array.
+			/// @param components	The number of components per element.
+			/// @param count		The number of elements.
+
+			static umachine GetStorageSize(int32 components, int32 count)
+			{
+				return (umachine(components) * umachine(GetPaddedCount(count)) * sizeof(float));
+			}
+
+			TERATHON_API bool Allocate(int32 count);
+			TERATHON_API bool Allocate(int32 count, MemoryArena *arena);
+			TERATHON_API void SetStorage(int32 count, void *storage);
+	};
+
+
+	// ==============================================
+	//	Point3DArray
+	// ==============================================
+
+	/// @brief Stores an array of 3D points in structure-of-arrays layout.
+	///
+	/// The \c Point3DArray class stores the <i>x</i>, <i>y</i>, and <i>z</i> coordinates of a set of points in three separate aligned streams.
+	///
+	/// @sa GeometryArray
+
+	class Point3DArray : public GeometryArray
+	{
+		public:
+
+			enum {kComponentCount = 3};
+
+			Point3DArray() : GeometryArray(kComponentCount) {}
+			explicit Point3DArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			Point3DArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			Point3DArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			float *GetX(void) {return (GetComponent(0));}
+			float *GetY(void) {return (GetComponent(1));}
+			float *GetZ(void) {return (GetComponent(2));}
+			const float *GetX(void) const {return (GetComponent(0));}
+			const float *GetY(void) const {return (GetComponent(1));}
+			const float *GetZ(void) const {return (GetComponent(2));}
+
+			/// @brief Returns a single point stored in the array.
+			/// @param index	The index of the point.
+
+			Point3D Get(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(0) + index;
+				return (Point3D(data[0], data[stride], data[stride * 2]));
+			}
+
+			/// @brief Stores a single point in the array.
+			/// @param index	The index of the point.
+			/// @param p		The point to store.
+
+			void Set(int32 index, const Point3D& p)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(0) + index;
+				data[0] = p.x;
+				data[stride] = p.y;
+				data[stride * 2] = p.z;
+			}
+
+			TERATHON_API void SetPoints(int32 start, int32 count, const Point3D *point);
+			TERATHON_API void GetPoints(int32 start, int32 count, Point3D *point) const;
+	};
+
+
+	// ==============================================
+	//	Bivector3DArray
+	// ==============================================
+
+	/// @brief Stores an array of 3D bivectors in structure-of-arrays layout.
+	///
+	/// The \c Bivector3DArray class stores the <i>x</i>, <i>y</i>, and <i>z</i> coordinates of a set of bivectors, such as angular velocities,
+	/// in three separate aligned streams.
+	///
+	/// @sa GeometryArray
+
+	class Bivector3DArray : public GeometryArray
+	{
+		public:
+
+			enum {kComponentCount = 3};
+
+			Bivector3DArray() : GeometryArray(kComponentCount) {}
+			explicit Bivector3DArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			Bivector3DArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			Bivector3DArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			float *GetX(void) {return (GetComponent(0));}
+			float *GetY(void) {return (GetComponent(1));}
+			float *GetZ(void) {return (GetComponent(2));}
+			const float *GetX(void) const {return (GetComponent(0));}
+			const float *GetY(void) const {return (GetComponent(1));}
+			const float *GetZ(void) const {return (GetComponent(2));}
+
+			/// @brief Returns a single bivector stored in the array.
+			/// @param index	The index of the bivector.
+
+			Bivector3D Get(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(0) + index;
+				return (Bivector3D(data[0], data[stride], data[stride * 2]));
+			}
+
+			/// @brief Stores a single bivector in the array.
+			/// @param index	The index of the bivector.
+			/// @param v		The bivector to store.
+
+			void Set(int32 index, const Bivector3D& v)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(0) + index;
+				data[0] = v.x;
+				data[stride] = v.y;
+				data[stride * 2] = v.z;
+			}
+
+			TERATHON_API void SetBivectors(int32 start, int32 count, const Bivector3D *bivector);
+			TERATHON_API void GetBivectors(int32 start, int32 count, Bivector3D *bivector) const;
+	};
+
+
+	// ==============================================
+	//	Plane3DArray
+	// ==============================================
+
+	/// @brief Stores an array of 3D planes in structure-of-arrays layout.
+	///
+	/// The \c Plane3DArray class stores the <i>x</i>, <i>y</i>, <i>z</i>, and <i>w</i> coordinates of a set of planes in four separate aligned streams.
+	///
+	/// @sa GeometryArray
+
+	class Plane3DArray : public GeometryArray
+	{
+		public:
+
+			enum {kComponentCount = 4};
+
+			Plane3DArray() : GeometryArray(kComponentCount) {}
+			explicit Plane3DArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			Plane3DArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			Plane3DArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			float *GetX(void) {return (GetComponent(0));}
+			float *GetY(void) {return (GetComponent(1));}
+			float *GetZ(void) {return (GetComponent(2));}
+			float *GetW(void) {return (GetComponent(3));}
+			const float *GetX(void) const {return (GetComponent(0));}
+			const float *GetY(void) const {return (GetComponent(1));}
+			const float *GetZ(void) const {return (GetComponent(2));}
+			const float *GetW(void) const {return (GetComponent(3));}
+
+			/// @brief Returns a single plane stored in the array.
+			/// @param index	The index of the plane.
+
+			Plane3D Get(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(0) + index;
+				return (Plane3D(data[0], data[stride], data[stride * 2], data[stride * 3]));
+			}
+
+			/// @brief Stores a single plane in the array.
+			/// @param index	The index of the plane.
+			/// @param g		The plane to store.
+
+			void Set(int32 index, const Plane3D& g)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(0) + index;
+				data[0] = g.x;
+				data[stride] = g.y;
+				data[stride * 2] = g.z;
+				data[stride * 3] = g.w;
+			}
+
+			TERATHON_API void SetPlanes(int32 start, int32 count, const Plane3D *plane);
+			TERATHON_API void GetPlanes(int32 start, int32 count, Plane3D *plane) const;
+	};
+
+
+	// ==============================================
+	//	Line3DArray
+	// ==============================================
+
+	/// @brief Stores an array of 3D lines in structure-of-arrays layout.
+	///
+	/// The \c Line3DArray class stores the six coordinates of a set of lines, such as rigid body velocities, in separate aligned streams.
+	/// Streams 0&ndash;2 hold the <i>x</i>, <i>y</i>, and <i>z</i> coordinates of the direction \c v, and streams 3&ndash;5 hold the
+	/// <i>x</i>, <i>y</i>, and <i>z</i> coordinates of the moment \c m.
+	///
+	/// @sa GeometryArray
+
+	class Line3DArray : public GeometryArray
+	{
+		public:
+
+			enum {kComponentCount = 6};
+
+			Line3DArray() : GeometryArray(kComponentCount) {}
+			explicit Line3DArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			Line3DArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			Line3DArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			/// @brief Returns a single line stored in the array.
+			/// @param index	The index of the line.
+
+			Line3D Get(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(0) + index;
+				return (Line3D(data[0], data[stride], data[stride * 2], data[stride * 3], data[stride * 4], data[stride * 5]));
+			}
+
+			/// @brief Stores a single line in the array.
+			/// @param index	The index of the line.
+			/// @param l		The line to store.
+
+			void Set(int32 index, const Line3D& l)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(0) + index;
+				data[0] = l.v.x;
+				data[stride] = l.v.y;
+				data[stride * 2] = l.v.z;
+				data[stride * 3] = l.m.x;
+				data[stride * 4] = l.m.y;
+				data[stride * 5] = l.m.z;
+			}
+
+			TERATHON_API void SetLines(int32 start, int32 count, const Line3D *line);
+			TERATHON_API void GetLines(int32 start, int32 count, Line3D *line) const;
+	};
+
+
+	// ==============================================
+	//	QuaternionArray
+	// ==============================================
+
+	/// @brief Stores an array of quaternions in structure-of-arrays layout.
+	///
+	/// The \c QuaternionArray class stores the <i>x</i>, <i>y</i>, <i>z</i>, and <i>w</i> coordinates of a set of quaternions in four separate aligned streams.
+	///
+	/// @sa GeometryArray
+
+	class QuaternionArray : public GeometryArray
+	{
+		public:
+
+			enum {kComponentCount = 4};
+
+			QuaternionArray() : GeometryArray(kComponentCount) {}
+			explicit QuaternionArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			QuaternionArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			QuaternionArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			float *GetX(void) {return (GetComponent(0));}
+			float *GetY(void) {return (GetComponent(1));}
+			float *GetZ(void) {return (GetComponent(2));}
+			float *GetW(void) {return (GetComponent(3));}
+			const float *GetX(void) const {return (GetComponent(0));}
+			const float *GetY(void) const {return (GetComponent(1));}
+			const float *GetZ(void) const {return (GetComponent(2));}
+			const float *GetW(void) const {return (GetComponent(3));}
+
+			/// @brief Returns a single quaternion stored in the array.
+			/// @param index	The index of the quaternion.
+
+			Quaternion Get(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(0) + index;
+				return (Quaternion(data[0], data[stride], data[stride * 2], data[stride * 3]));
+			}
+
+			/// @brief Stores a single quaternion in the array.
+			/// @param index	The index of the quaternion.
+			/// @param q		The quaternion to store.
+
+			void Set(int32 index, const Quaternion& q)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(0) + index;
+				data[0] = q.x;
+				data[stride] = q.y;
+				data[stride * 2] = q.z;
+				data[stride * 3] = q.w;
+			}
+
+			TERATHON_API void SetQuaternions(int32 start, int32 count, const Quaternion *quaternion);
+			TERATHON_API void GetQuaternions(int32 start, int32 count, Quaternion *quaternion) const;
+	};
+
+
+	// ==============================================
+	//	Motor3DArray
+	// ==============================================
+
+	/// @brief Stores an array of 3D motors in structure-of-arrays layout.
+	///
+	/// The \c Motor3DArray class stores the eight coordinates of a set of motors in separate aligned streams. Streams 0&ndash;3 hold
+	/// the <i>x</i>, <i>y</i>, <i>z</i>, and <i>w</i> coordinates of the weight quaternion \c v, and streams 4&ndash;7 hold the
+	/// <i>x</i>, <i>y</i>, <i>z</i>, and <i>w</i> coordinates of the bulk quaternion \c m.
+	///
+	/// @sa GeometryArray
+
+	class Motor3DArray : public GeometryArray
+	{
+		public:
+
+			enum {kComponentCount = 8};
+
+			Motor3DArray() : GeometryArray(kComponentCount) {}
+			explicit Motor3DArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			Motor3DArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			Motor3DArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			/// @brief Returns a single motor stored in the array.
+			/// @param index	The index of the motor.
+
+			Motor3D Get(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(0) + index;
+				return (Motor3D(data[0], data[stride], data[stride * 2], data[stride * 3], data[stride * 4], data[stride * 5], data[stride * 6], data[stride * 7]));
+			}
+
+			/// @brief Stores a single motor in the array.
+			/// @param index	The index of the motor.
+			/// @param Q		The motor to store.
+
+			void Set(int32 index, const Motor3D& Q)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(0) + index;
+				data[0] = Q.v.x;
+				data[stride] = Q.v.y;
+				data[stride * 2] = Q.v.z;
+				data[stride * 3] = Q.v.w;
+				data[stride * 4] = Q.m.x;
+				data[stride * 5] = Q.m.y;
+				data[stride * 6] = Q.m.z;
+				data[stride * 7] = Q.m.w;
+			}
+
+			TERATHON_API void SetMotors(int32 start, int32 count, const Motor3D *motor);
+			TERATHON_API void GetMotors(int32 start, int32 count, Motor3D *motor) const;
+	};
+}
+
+
+#endif
@@ -0,0 +1,636 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSGeometryFile.h"
+#include "TSMemory.h"
+
+#ifndef TERATHON_NO_SYSTEM
+
+	#include <stdio.h>
+
+#endif
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	static_assert(sizeof(GeometryFileHeader) == kGeometryFileAlignment, "GeometryFileHeader must be 64 bytes");
+	static_assert(sizeof(GeometryStreamHeader) == kGeometryFileAlignment, "GeometryStreamHeader must be 64 bytes");
+
+
+	inline uint64 AlignFileOffset(uint64 offset)
+	{
+		return ((offset + (kGeometryFileAlignment - 1)) & ~uint64(kGeometryFileAlignment - 1));
+	}
+
+	inline uint32 GetComponentSize(uint32 format)
+	{
+		return ((format == kComponentFormatFloat32) ? 4 : ((format == kComponentFormatInt16) ? 2 : 1));
+	}
+
+	inline int32 GetQuantizationRange(uint32 format)
+	{
+		return ((format == kComponentFormatInt16) ? 32767 : 127);
+	}
+
+	inline int32 QuantizeComponent(float v, float inverseScale, float bias, int32 range)
+	{
+		float f = (v - bias) * inverseScale;
+		int32 q = (f >= 0.0F) ? int32(f + 0.5F) : -int32(0.5F - f);
+		return ((q < -range) ? -range : ((q > range) ? range : q));
+	}
+
+	void ClearFileMemory(void *ptr, uint64 size)
+	{
+		char *p = static_cast<char *>(ptr);
+		while (size != 0)
+		{
+			uint32 s = (size < 0x40000000U) ? uint32(size) : 0x40000000U;
+			ClearMemory(p, s);
+			p += s;
+			size -= s;
+		}
+	}
+}
+
+
+GeometryFile::GeometryFile()
+{
+	fileData = nullptr;
+	fileSize = 0;
+	streamTable = nullptr;
+	streamCount = 0;
+}
+
+GeometryFile::~GeometryFile()
+{
+}
+
+bool GeometryFile::Validate(void)
+{
+	if ((fileSize < sizeof(GeometryFileHeader)) || ((GetPointerAddress(fileData) & (kGeometryFileAlignment - 1)) != 0))
+	{
+		return (false);
+	}
+
+	const GeometryFileHeader *fileHeader = reinterpret_cast<const GeometryFileHeader *>(fileData);
+	if ((fileHeader->fileIdentifier != kGeometryFileIdentifier) || (fileHeader->fileVersion != kGeometryFileVersion) || (fileHeader->headerSize != sizeof(GeometryFileHeader)) || (fileHeader->fileSize > fileSize))
+	{
+		return (false);
+	}
+
+	uint64 tableOffset = fileHeader->streamTableOffset;
+	uint64 count = fileHeader->streamCount;
+	if (((tableOffset & (kGeometryFileAlignment - 1)) != 0) || (tableOffset > fileSize) || (count > (fileSize - tableOffset) / sizeof(GeometryStreamHeader)))
+	{
+		return (false);
+	}
+
+	const GeometryStreamHeader *table = reinterpret_cast<const GeometryStreamHeader *>(fileData + tableOffset);
+	for (machine a = 0; a < machine(count); a++)
+	{
+		const GeometryStreamHeader *header = &table[a];
+
+		uint32 componentCount = header->componentCount;
+		if ((componentCount - 1 >= kGeometryMaxComponentCount) || (header->storageLayout > kGeometryLayoutSoA) || (header->componentFormat > kComponentFormatInt8))
+		{
+			return (false);
+		}
+
+		uint64 offset = header->dataOffset;
+		uint64 size = header->dataSize;
+		if (((offset & (kGeometryFileAlignment - 1)) != 0) || (offset > fileSize) || (size > fileSize - offset))
+		{
+			return (false);
+		}
+
+		// Make sure every element of every component lies inside the data block without
+		// forming any products that could overflow.
+
+		uint64 elementCount = header->elementCount;
+		uint64 stride = header->componentStride;
+		uint32 componentSize = GetComponentSize(header->componentFormat);
+
+		if (header->storageLayout == kGeometryLayoutSoA)
+		{
+			if (((stride & (kGeometryFileAlignment - 1)) != 0) || (stride > size / componentCount) || (elementCount > stride / componentSize))
+			{
+				return (false);
+			}
+		}
+		else
+		{
+			if ((stride < componentCount * componentSize) || ((elementCount != 0) && (elementCount > size / stride)))
+			{
+				return (false);
+			}
+		}
+
+		if (header->componentFormat != kComponentFormatFloat32)
+		{
+			uint64 quantizationOffset = header->quantizationOffset;
+			if (((quantizationOffset & (kGeometryFileAlignment - 1)) != 0) || (quantizationOffset > fileSize) || (componentCount * 8 > fileSize - quantizationOffset))
+			{
+				return (false);
+			}
+		}
+	}
+
+	streamTable = table;
+	streamCount = int32(count);
+	return (true);
+}
+
+/// @brief Maps a geometry file from disk and validates its headers.
+/// @param name		The name of the file.
+///
+/// If the file cannot be mapped or is not a valid geometry file, then the return value is \c false.
+
+bool GeometryFile::Open(const char *name)
+{
+	Close();
+
+	if (mappedFile.Open(name))
+	{
+		fileData = static_cast<const char *>(mappedFile.GetData());
+		fileSize = mappedFile.GetSize();
+		if (Validate())
+		{
+			return (true);
+		}
+	}
+
+	Close();
+	return (false);
+}
+
+/// @brief Validates the headers of a geometry file already stored in memory.
+/// @param data		A pointer to the file data. This must be aligned to 64 bytes.
+/// @param size		The size of the file data, in bytes.
+///
+/// The data is accessed in place and must remain valid while the file is open.
+/// If the data is not a valid geometry file, then the return value is \c false.
+
+bool GeometryFile::Open(const void *data, uint64 size)
+{
+	Close();
+
+	fileData = static_cast<const char *>(data);
+	fileSize = size;
+	if (Validate())
+	{
+		return (true);
+	}
+
+	Close();
+	return (false);
+}
+
+/// @brief Closes the file and unmaps it if it was mapped from disk.
+
+void GeometryFile::Close(void)
+{
+	mappedFile.Close();
+	fileData = nullptr;
+	fileSize = 0;
+	streamTable = nullptr;
+	streamCount = 0;
+}
+
+/// @brief Returns the index of the next stream holding objects of a given type.
+/// @param type		The geometry type code of the stream.
+/// @param start	The index at which the search begins.
+///
+/// If no such stream exists, then the return value is &minus;1.
+
+int32 GeometryFile::FindStream(uint32 type, int32 start) const
+{
+	for (machine a = start; a < streamCount; a++)
+	{
+		if (streamTable[a].geometryType == type)
+		{
+			return (int32(a));
+		}
+	}
+
+	return (-1);
+}
+
+/// @brief Returns a pointer to one component array of an unquantized SoA stream.
+/// @param index		The index of the stream.
+/// @param component	The index of the component.
+///
+/// The returned pointer is aligned to 64 bytes, and the array is padded with zeros to a multiple of 16 entries.
+/// If the stream is quantized or does not use the SoA layout, then the return value is \c nullptr.
+
+const float *GeometryFile::GetComponent(int32 index, int32 component) const
+{
+	const GeometryStreamHeader *header = &streamTable[index];
+	if ((header->storageLayout == kGeometryLayoutSoA) && (header->componentFormat == kComponentFormatFloat32))
+	{
+		return (reinterpret_cast<const float *>(fileData + header->dataOffset + header->componentStride * component));
+	}
+
+	return (nullptr);
+}
+
+/// @brief Decodes a range of values for one component of any stream.
+/// @param index		The index of the stream.
+/// @param component	The index of the component.
+/// @param start		The index of the first element to decode.
+/// @param count		The number of elements to decode.
+/// @param result		A pointer to an array that receives \c count floating-point values.
+
+void GeometryFile::DecodeComponent(int32 index, int32 component, uint64 start, uint64 count, float *result) const
+{
+	const GeometryStreamHeader *header = &streamTable[index];
+	uint32 format = header->componentFormat;
+	uint32 componentSize = GetComponentSize(format);
+
+	const char *data = fileData + header->dataOffset;
+	uint64 elementStride;
+
+	if (header->storageLayout == kGeometryLayoutSoA)
+	{
+		data += header->componentStride * component + start * componentSize;
+		elementStride = componentSize;
+	}
+	else
+	{
+		data += header->componentStride * start + component * componentSize;
+		elementStride = header->componentStride;
+	}
+
+	if (format == kComponentFormatFloat32)
+	{
+		for (uint64 i = 0; i < count; i++)
+		{
+			result[i] = *reinterpret_cast<const float *>(data + i * elementStride);
+		}
+	}
+	else
+	{
+		const float *quantization = reinterpret_cast<const float *>(fileData + header->quantizationOffset) + component * 2;
+		float scale = quantization[0];
+		float bias = quantization[1];
+
+		if (format == kComponentFormatInt16)
+		{
+			for (uint64 i = 0; i < count; i++)
+			{
+				result[i] = float(*reinterpret_cast<const int16 *>(data + i * elementStride)) * scale + bias;
+			}
+		}
+		else
+		{
+			for (uint64 i = 0; i < count; i++)
+			{
+				result[i] = float(*reinterpret_cast<const int8 *>(data + i * elementStride)) * scale + bias;
+			}
+		}
+	}
+}
+
+
+GeometryFileWriter::GeometryFileWriter()
+{
+	streamCount = 0;
+	fileSize = sizeof(GeometryFileHeader);
+}
+
+GeometryFileWriter::~GeometryFileWriter()
+{
+}
+
+/// @brief Adds an array of floating-point components to the file.
+/// @param type				The geometry type code for the stream.
+/// @param componentCount	The number of components per element. This must be in the range [1, 16].
+/// @param data				A pointer to the first component of the first element.
+/// @param stride			The number of floats between consecutive elements in the source array.
+/// @param count			The number of elements.
+/// @param layout			The storage layout used in the file.
+/// @param format			The storage format used for each component.
+///
+/// The return value is the index of the new stream, or &minus;1 if the stream could not be added.
+
+int32 GeometryFileWriter::AddStream(uint32 type, uint32 componentCount, const float *data, uint32 stride, uint64 count, uint32 layout, uint32 format)
+{
+	if ((streamCount >= kMaxStreamCount) || (componentCount - 1 >= kGeometryMaxComponentCount) || (stride < componentCount) || (layout > kGeometryLayoutSoA) || (format > kComponentFormatInt8))
+	{
+		return (-1);
+	}
+
+	int32 index = streamCount++;
+	GeometryStreamHeader *header = &streamHeader[index];
+	ClearMemory(header, sizeof(GeometryStreamHeader));
+
+	header->geometryType = type;
+	header->componentCount = componentCount;
+	header->storageLayout = layout;
+	header->componentFormat = format;
+	header->elementCount = count;
+
+	streamSource[index] = data;
+	sourceStride[index] = stride;
+
+	uint32 componentSize = GetComponentSize(format);
+	if (layout == kGeometryLayoutSoA)
+	{
+		header->componentStride = AlignFileOffset(count * componentSize);
+		header->dataSize = header->componentStride * componentCount;
+	}
+	else
+	{
+		header->componentStride = componentCount * componentSize;
+		header->dataSize = AlignFileOffset(count * header->componentStride);
+	}
+
+	if (format != kComponentFormatFloat32)
+	{
+		// Calculate a scale and bias for each component that maps the full range of
+		// values onto the range of the quantized integers.
+
+		float range = float(GetQuantizationRange(format));
+		for (machine k = 0; k < machine(componentCount); k++)
+		{
+			float minValue = 0.0F;
+			float maxValue = 0.0F;
+
+			if (count != 0)
+			{
+				minValue = maxValue = data[k];
+				for (uint64 i = 1; i < count; i++)
+				{
+					float v = data[i * stride + k];
+					minValue = Fmin(minValue, v);
+					maxValue = Fmax(maxValue, v);
+				}
+			}
+
+			float scale = (maxValue - minValue) * 0.5F / range;
+			quantizationTable[index][k * 2] = (scale > 0.0F) ? scale : 1.0F;
+			quantizationTable[index][k * 2 + 1] = (maxValue + minValue) * 0.5F;
+		}
+	}
+
+	// Lay out the whole file again now that the stream table has grown.
+
+	uint64 offset = AlignFileOffset(sizeof(GeometryFileHeader) + streamCount * sizeof(GeometryStreamHeader));
+	for (machine a = 0; a < streamCount; a++)
+	{
+		GeometryStreamHeader *h = &streamHeader[a];
+		h->dataOffset = offset;
+		offset += h->dataSize;
+
+		if (h->componentFormat != kComponentFormatFloat32)
+		{
+			h->quantizationOffset = offset;
+			offset += AlignFileOffset(h->componentCount * 8);
+		}
+	}
+
+	fileSize = offset;
+	return (index);
+}
+
+void GeometryFileWriter::EncodeComponent(int32 index, int32 component, uint64 start, uint64 count, void *result) const
+{
+	const GeometryStreamHeader *header = &streamHeader[index];
+	uint32 stride = sourceStride[index];
+	const float *source = streamSource[index] + start * stride + component;
+
+	uint32 format = header->componentFormat;
+	if (format == kComponentFormatFloat32)
+	{
+		float *f = static_cast<float *>(result);
+		for (uint64 i = 0; i < count; i++)
+		{
+			f[i] = source[i * stride];
+		}
+	}
+	else
+	{
+		float inverseScale = 1.0F / quantizationTable[index][component * 2];
+		float bias = quantizationTable[index][component * 2 + 1];
+		int32 range = GetQuantizationRange(format);
+
+		if (format == kComponentFormatInt16)
+		{
+			int16 *q = static_cast<int16 *>(result);
+			for (uint64 i = 0; i < count; i++)
+			{
+				q[i] = int16(QuantizeComponent(source[i * stride], inverseScale, bias, range));
+			}
+		}
+		else
+		{
+			int8 *q = static_cast<int8 *>(result);
+			for (uint64 i = 0; i < count; i++)
+			{
+				q[i] = int8(QuantizeComponent(source[i * stride], inverseScale, bias, range));
+			}
+		}
+	}
+}
+
+void GeometryFileWriter::EncodeElements(int32 index, uint64 start, uint64 count, void *result) const
+{
+	const GeometryStreamHeader *header = &streamHeader[index];
+	uint32 stride = sourceStride[index];
+	uint32 componentCount = header->componentCount;
+	uint32 format = header->componentFormat;
+
+	if (format == kComponentFormatFloat32)
+	{
+		const float *source = streamSource[index] + start * stride;
+		float *f = static_cast<float *>(result);
+		for (uint64 i = 0; i < count; i++)
+		{
+			CopyMemory(source, f, componentCount * 4);
+			source += stride;
+			f += componentCount;
+		}
+	}
+	else
+	{
+		// Quantized AoS data is encoded one component at a time into a temporary
+		// row so that the per-component scale and bias can be reused.
+
+		uint32 componentSize = GetComponentSize(format);
+		char *element = static_cast<char *>(result);
+		for (uint64 i = 0; i < count; i++)
+		{
+			for (machine k = 0; k < machine(componentCount); k++)
+			{
+				EncodeComponent(index, int32(k), start + i, 1, element + k * componentSize);
+			}
+
+			element += componentCount * componentSize;
+		}
+	}
+}
+
+/// @brief Writes the complete file into a buffer.
+/// @param buffer	A pointer to a buffer that is at least as large as the size returned by \c GetFileSize().
+///
+/// The buffer should be aligned to 64 bytes so that it can be opened in place with the \c GeometryFile::Open() function.
+
+void GeometryFileWriter::Write(void *buffer) const
+{
+	char *file = static_cast<char *>(buffer);
+	uint64 tableEnd = sizeof(GeometryFileHeader) + streamCount * sizeof(GeometryStreamHeader);
+	ClearFileMemory(file, AlignFileOffset(tableEnd));
+
+	GeometryFileHeader *fileHeader = reinterpret_cast<GeometryFileHeader *>(file);
+	fileHeader->fileIdentifier = kGeometryFileIdentifier;
+	fileHeader->fileVersion = kGeometryFileVersion;
+	fileHeader->headerSize = sizeof(GeometryFileHeader);
+	fileHeader->streamCount = uint32(streamCount);
+	fileHeader->fileSize = fileSize;
+	fileHeader->streamTableOffset = sizeof(GeometryFileHeader);
+
+	CopyMemory(streamHeader, file + sizeof(GeometryFileHeader), uint32(streamCount * sizeof(GeometryStreamHeader)));
+
+	for (machine a = 0; a < streamCount; a++)
+	{
+		const GeometryStreamHeader *header = &streamHeader[a];
+		char *data = file + header->dataOffset;
+		uint64 count = header->elementCount;
+
+		if (header->storageLayout == kGeometryLayoutSoA)
+		{
+			uint64 used = count * GetComponentSize(header->componentFormat);
+			for (machine k = 0; k < machine(header->componentCount); k++)
+			{
+				EncodeComponent(int32(a), int32(k), 0, count, data);
+				ClearFileMemory(data + used, header->componentStride - used);
+				data += header->componentStride;
+			}
+		}
+		else
+		{
+			uint64 used = count * header->componentStride;
+			EncodeElements(int32(a), 0, count, data);
+			ClearFileMemory(data + used, header->dataSize - used);
+		}
+
+		if (header->componentFormat != kComponentFormatFloat32)
+		{
+			uint32 tableSize = header->componentCount * 8;
+			char *table = file + header->quantizationOffset;
+			CopyMemory(quantizationTable[a], table, tableSize);
+			ClearMemory(table + tableSize, uint32(AlignFileOffset(tableSize) - tableSize));
+		}
+	}
+}
+
+/// @brief Writes the complete file to disk.
+/// @param name		The name of the file.
+///
+/// The streams are encoded in small pieces so that the file is never held in memory all at once.
+/// If the file cannot be written, or if \c TERATHON_NO_SYSTEM is defined, then the return value is \c false.
+
+bool GeometryFileWriter::WriteFile(const char *name) const
+{
+	#ifndef TERATHON_NO_SYSTEM
+
+		enum : uint32 {kChunkSize = 0x10000};
+
+		FILE *file = fopen(name, "wb");
+		if (!file)
+		{
+			return (false);
+		}
+
+		char *chunk = static_cast<char *>(AllocateAligned(kChunkSize));
+		bool success = true;
+
+		// The headers and stream table always fit in the first chunk because there
+		// are at most 64 streams.
+
+		uint64 tableSize = AlignFileOffset(sizeof(GeometryFileHeader) + streamCount * sizeof(GeometryStreamHeader));
+		GeometryFileHeader *fileHeader = reinterpret_cast<GeometryFileHeader *>(chunk);
+		ClearMemory(chunk, uint32(tableSize));
+
+		fileHeader->fileIdentifier = kGeometryFileIdentifier;
+		fileHeader->fileVersion = kGeometryFileVersion;
+		fileHeader->headerSize = sizeof(GeometryFileHeader);
+		fileHeader->streamCount = uint32(streamCount);
+		fileHeader->fileSize = fileSize;
+		fileHeader->streamTableOffset = sizeof(GeometryFileHeader);
+
+		CopyMemory(streamHeader, chunk + sizeof(GeometryFileHeader), uint32(streamCount * sizeof(GeometryStreamHeader)));
+		success &= (fwrite(chunk, 1, size_t(tableSize), file) == size_t(tableSize));
+
+		for (machine a = 0; (a < streamCount) && (success); a++)
+		{
+			const GeometryStreamHeader *header = &streamHeader[a];
+			uint64 count = header->elementCount;
+			uint64 written = 0;
+
+			if (header->storageLayout == kGeometryLayoutSoA)
+			{
+				uint32 componentSize = GetComponentSize(header->componentFormat);
+				uint64 chunkCount = kChunkSize / componentSize;
+
+				for (machine k = 0; k < machine(header->componentCount); k++)
+				{
+					for (uint64 start = 0; start < count; start += chunkCount)
+					{
+						uint64 n = (count - start < chunkCount) ? count - start : chunkCount;
+						EncodeComponent(int32(a), int32(k), start, n, chunk);
+						success &= (fwrite(chunk, componentSize, size_t(n), file) == size_t(n));
+					}
+
+					written += count * componentSize;
+					uint32 padding = uint32(header->componentStride * (k + 1) - written);
+					ClearMemory(chunk, padding);
+					success &= (fwrite(chunk, 1, padding, file) == padding);
+					written += padding;
+				}
+			}
+			else
+			{
+				uint64 elementSize = header->componentStride;
+				uint64 chunkCount = kChunkSize / elementSize;
+
+				for (uint64 start = 0; start < count; start += chunkCount)
+				{
+					uint64 n = (count - start < chunkCount) ? count - start : chunkCount;
+					EncodeElements(int32(a), start, n, chunk);
+					success &= (fwrite(chunk, size_t(elementSize), size_t(n), file) == size_t(n));
+				}
+
+				written = count * elementSize;
+				uint32 padding = uint32(header->dataSize - written);
+				ClearMemory(chunk, padding);
+				success &= (fwrite(chunk, 1, padding, file) == padding);
+			}
+
+			if (header->componentFormat != kComponentFormatFloat32)
+			{
+				uint32 quantizationSize = uint32(AlignFileOffset(header->componentCount * 8));
+				ClearMemory(chunk, quantizationSize);
+				CopyMemory(quantizationTable[a], chunk, header->componentCount * 8);
+				success &= (fwrite(chunk, 1, quantizationSize, file) == quantizationSize);
+			}
+		}
+
+		ReleaseAligned(chunk);
+		success &= (fclose(file) == 0);
+		return (success);
+
+	#else
+
+		return (false);
+
+	#endif
+}
@@ -0,0 +1,342 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSGeometryFile_h
+#define TSGeometryFile_h
+
+
+#include "TSFlector3D.h"
+#include "TSConformal3D.h"
+#include "TSMappedFile.h"
+
+
+#define TERATHON_GEOMETRYFILE 1
+
+
+namespace Terathon
+{
+	enum : uint32
+	{
+		kGeometryFileIdentifier			= 0x4F454754,		///< The characters "TGEO" stored in little-endian order.
+		kGeometryFileVersion			= 1,
+		kGeometryFileAlignment			= 64,				///< The alignment of every header, stream, and table within a geometry file.
+		kGeometryMaxComponentCount		= 16
+	};
+
+
+	/// @brief Identifies the type of object stored in a geometry file stream.
+
+	enum : uint32
+	{
+		kGeometryFloat					= 0,				///< Generic floating-point attributes with an arbitrary number of components.
+		kGeometryVector3D				= 1,
+		kGeometryPoint3D				= 2,
+		kGeometryBivector3D				= 3,
+		kGeometryVector4D				= 4,
+		kGeometryFlatPoint3D			= 5,
+		kGeometryLine3D					= 6,
+		kGeometryPlane3D				= 7,
+		kGeometryQuaternion				= 8,
+		kGeometryMotor3D				= 9,
+		kGeometryFlector3D				= 10,
+		kGeometryTransform3D			= 11,
+		kGeometryRoundPoint3D			= 12,
+		kGeometryDipole3D				= 13,
+		kGeometryCircle3D				= 14,
+		kGeometrySphere3D				= 15
+	};
+
+
+	/// @brief Identifies the memory layout of a geometry file stream.
+
+	enum : uint32
+	{
+		kGeometryLayoutAoS				= 0,				///< Elements are stored contiguously with the same layout as the corresponding library class.
+		kGeometryLayoutSoA				= 1					///< Each component is stored in a separate stream padded to a multiple of 64 bytes.
+	};
+
+
+	/// @brief Identifies the storage format of the components in a geometry file stream.
+
+	enum : uint32
+	{
+		kComponentFormatFloat32			= 0,				///< Components are stored as 32-bit floating-point values.
+		kComponentFormatInt16			= 1,				///< Components are quantized to signed 16-bit integers with a per-component scale and bias.
+		kComponentFormatInt8			= 2					///< Components are quantized to signed 8-bit integers with a per-component scale and bias.
+	};
+
+
+	/// @brief Maps a library class to its geometry file type code and component count.
+	///
+	/// The \c GeometryTraits template is specialized for every class that can be stored in a geometry file.
+
+	template <class type>
+	struct GeometryTraits;
+
+	#define TERATHON_GEOMETRY_TRAITS(type, code, count) \
+		template <> struct GeometryTraits<type> \
+		{ \
+			enum : uint32 {kGeometryType = code, kComponentCount = count}; \
+			static_assert(sizeof(type) == count * sizeof(float), "Unexpected size of " #type); \
+		};
+
+	TERATHON_GEOMETRY_TRAITS(Vector3D, kGeometryVector3D, 3)
+	TERATHON_GEOMETRY_TRAITS(Point3D, kGeometryPoint3D, 3)
+	TERATHON_GEOMETRY_TRAITS(Bivector3D, kGeometryBivector3D, 3)
+	TERATHON_GEOMETRY_TRAITS(Vector4D, kGeometryVector4D, 4)
+	TERATHON_GEOMETRY_TRAITS(FlatPoint3D, kGeometryFlatPoint3D, 4)
+	TERATHON_GEOMETRY_TRAITS(Line3D, kGeometryLine3D, 6)
+	TERATHON_GEOMETRY_TRAITS(Plane3D, kGeometryPlane3D, 4)
+	TERATHON_GEOMETRY_TRAITS(Quaternion, kGeometryQuaternion, 4)
+	TERATHON_GEOMETRY_TRAITS(Motor3D, kGeometryMotor3D, 8)
+	TERATHON_GEOMETRY_TRAITS(Flector3D, kGeometryFlector3D, 8)
+	TERATHON_GEOMETRY_TRAITS(Transform3D, kGeometryTransform3D, 16)
+	TERATHON_GEOMETRY_TRAITS(RoundPoint3D, kGeometryRoundPoint3D, 5)
+	TERATHON_GEOMETRY_TRAITS(Dipole3D, kGeometryDipole3D, 10)
+	TERATHON_GEOMETRY_TRAITS(Circle3D, kGeometryCircle3D, 10)
+	TERATHON_GEOMETRY_TRAITS(Sphere3D, kGeometrySphere3D, 5)
+
+	#undef TERATHON_GEOMETRY_TRAITS
+
+
+	/// @brief The header at the beginning of a geometry file.
+	///
+	/// The file header is immediately followed by an array of \c streamCount stream headers.
+
+	struct alignas(64) GeometryFileHeader
+	{
+		uint32		fileIdentifier;				///< Always \c kGeometryFileIdentifier.
+		uint32		fileVersion;				///< The version of the file format. The current version is \c kGeometryFileVersion.
+		uint32		headerSize;					///< The size of the file header, in bytes.
+		uint32		streamCount;				///< The number of streams stored in the file.
+		uint64		fileSize;					///< The total size of the file, in bytes.
+		uint64		streamTableOffset;			///< The offset from the beginning of the file to the array of stream headers.
+		uint32		reserved[8];
+	};
+
+
+	/// @brief The header describing a single stream in a geometry file.
+	///
+	/// For streams with the SoA layout, component <i>k</i> begins at the byte offset \c dataOffset&nbsp;+&nbsp;<i>k</i>&nbsp;&times;&nbsp;\c componentStride.
+	/// For streams with the AoS layout, element <i>i</i> begins at the byte offset \c dataOffset&nbsp;+&nbsp;<i>i</i>&nbsp;&times;&nbsp;\c componentStride.
+	/// All offsets are multiples of 64 bytes. If the components are quantized, then the table at \c quantizationOffset holds
+	/// a scale and bias for each component, and the decoded value is <i>q</i>&nbsp;&times;&nbsp;scale&nbsp;+&nbsp;bias.
+
+	struct alignas(64) GeometryStreamHeader
+	{
+		uint32		geometryType;				///< The type of object stored in the stream.
+		uint32		componentCount;				///< The number of floating-point components per element.
+		uint32		storageLayout;				///< The memory layout of the stream.
+		uint32		componentFormat;			///< The storage format of each component.
+		uint64		elementCount;				///< The number of elements stored in the stream.
+		uint64		dataOffset;					///< The offset from the beginning of the file to the stream data.
+		uint64		dataSize;					///< The size of the stream data, in bytes.
+		uint64		componentStride;			///< The number of bytes between consecutive component streams (SoA) or elements (AoS).
+		uint64		quantizationOffset;			///< The offset from the beginning of the file to the scale and bias table, or zero if the components are not quantized.
+		uint32		reserved[2];
+	};
+
+
+	/// @brief A read-only view of a contiguous array of objects.
+
+	template <class type>
+	struct GeometrySpan
+	{
+		const type		*data;
+		uint64			count;
+
+		const type& operator [](machine index) const
+		{
+			return (data[index]);
+		}
+
+		const type *begin(void) const
+		{
+			return (data);
+		}
+
+		const type *end(void) const
+		{
+			return (data + count);
+		}
+
+		bool Empty(void) const
+		{
+			return (count == 0);
+		}
+	};
+
+
+	// ==============================================
+	//	GeometryFile
+	// ==============================================
+
+	/// @brief Provides zero-copy access to the streams stored in a geometry file.
+	///
+	/// The \c GeometryFile class validates the headers of a geometry file stored in memory or mapped from disk and then exposes
+	/// its streams directly. Unquantized AoS streams are returned as spans of the corresponding library class, and unquantized
+	/// SoA streams are returned as pointers to 64-byte aligned component arrays that can be passed to batch kernels. Quantized
+	/// streams must be decoded with the \c DecodeComponent() function.
+	///
+	/// @sa GeometryFileWriter
+
+	class GeometryFile
+	{
+		private:
+
+			const char						*fileData;
+			uint64							fileSize;
+			const GeometryStreamHeader		*streamTable;
+			int32							streamCount;
+			MappedFile						mappedFile;
+
+			bool Validate(void);
+
+		public:
+
+			TERATHON_API GeometryFile();
+			TERATHON_API ~GeometryFile();
+
+			GeometryFile(const GeometryFile&) = delete;
+			GeometryFile& operator =(const GeometryFile&) = delete;
+
+			/// @brief Returns the number of streams in the file.
+
+			int32 GetStreamCount(void) const
+			{
+				return (streamCount);
+			}
+
+			/// @brief Returns the header for a stream in the file.
+			/// @param index	The index of the stream.
+
+			const GeometryStreamHeader *GetStreamHeader(int32 index) const
+			{
+				return (&streamTable[index]);
+			}
+
+			/// @brief Returns a pointer to the raw data for a stream in the file.
+			/// @param index	The index of the stream.
+
+			const void *GetStreamData(int32 index) const
+			{
+				return (fileData + streamTable[index].dataOffset);
+			}
+
+			/// @brief Returns a span covering an unquantized AoS stream.
+			/// @param index	The index of the stream.
+			///
+			/// If the stream does not hold unquantized objects of the requested type in the AoS layout, then the returned span is empty.
+
+			template <class type>
+			GeometrySpan<type> GetSpan(int32 index) const
+			{
+				const GeometryStreamHeader *header = &streamTable[index];
+				if ((header->geometryType == GeometryTraits<type>::kGeometryType) && (header->storageLayout == kGeometryLayoutAoS) && (header->componentFormat == kComponentFormatFloat32) && (header->componentStride == sizeof(type)))
+				{
+					return (GeometrySpan<type>{reinterpret_cast<const type *>(fileData + header->dataOffset), header->elementCount});
+				}
+
+				return (GeometrySpan<type>{nullptr, 0});
+			}
+
+			/// @brief Returns a span covering the first unquantized AoS stream holding objects of a given type.
+			///
+			/// If no such stream exists, then the returned span is empty.
+
+			template <class type>
+			GeometrySpan<type> FindSpan(void) const
+			{
+				for (machine a = 0; a < streamCount; a++)
+				{
+					GeometrySpan<type> span = GetSpan<type>(int32(a));
+					if (span.data)
+					{
+						return (span);
+					}
+				}
+
+				return (GeometrySpan<type>{nullptr, 0});
+			}
+
+			TERATHON_API bool Open(const char *name);
+			TERATHON_API bool Open(const void *data, uint64 size);
+			TERATHON_API void Close(void);
+
+			TERATHON_API int32 FindStream(uint32 type, int32 start = 0) const;
+			TERATHON_API const float *GetComponent(int32 index, int32 component) const;
+			TERATHON_API void DecodeComponent(int32 index, int32 component, uint64 start, uint64 count, float *result) const;
+	};
+
+
+	// ==============================================
+	//	GeometryFileWriter
+	// ==============================================
+
+	/// @brief Assembles arrays of geometric objects into a geometry file.
+	///
+	/// The \c GeometryFileWriter class records a set of source arrays and their requested storage layouts and formats. It then
+	/// produces the complete file either in a caller-supplied buffer or directly on disk. The source arrays are not copied, so they
+	/// must remain valid until the file has been written.
+	///
+	/// @sa GeometryFile
+
+	class GeometryFileWriter
+	{
+		public:
+
+			enum {kMaxStreamCount = 64};
+
+		private:
+
+			int32						streamCount;
+			uint64						fileSize;
+
+			GeometryStreamHeader		streamHeader[kMaxStreamCount];
+			const float					*streamSource[kMaxStreamCount];
+			uint32						sourceStride[kMaxStreamCount];
+			float						quantizationTable[kMaxStreamCount][kGeometryMaxComponentCount * 2];
+
+			void EncodeComponent(int32 index, int32 component, uint64 start, uint64 count, void *result) const;
+			void EncodeElements(int32 index, uint64 start, uint64 count, void *result) const;
+
+		public:
+
+			TERATHON_API GeometryFileWriter();
+			TERATHON_API ~GeometryFileWriter();
+
+			/// @brief Returns the total size of the file, in bytes, for the streams added so far.
+
+			uint64 GetFileSize(void) const
+			{
+				return (fileSize);
+			}
+
+			/// @brief Adds an array of library objects to the file.
+			/// @param data		A pointer to the array of objects.
+			/// @param count	The number of objects in the array.
+			/// @param layout	The storage layout used in the file.
+			/// @param format	The storage format used for each component.
+			///
+			/// The return value is the index of the new stream, or &minus;1 if the stream could not be added.
+
+			template <class type>
+			int32 AddStream(const type *data, uint64 count, uint32 layout = kGeometryLayoutSoA, uint32 format = kComponentFormatFloat32)
+			{
+				return (AddStream(GeometryTraits<type>::kGeometryType, GeometryTraits<type>::kComponentCount, reinterpret_cast<const float *>(data), GeometryTraits<type>::kComponentCount, count, layout, format));
+			}
+
+			TERATHON_API int32 AddStream(uint32 type, uint32 componentCount, const float *data, uint32 stride, uint64 count, uint32 layout, uint32 format);
+			TERATHON_API void Write(void *buffer) const;
+			TERATHON_API bool WriteFile(const char *name) const;
+	};
+}
+
+
+#endif
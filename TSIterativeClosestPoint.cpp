@@ -0,0 +1,560 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSIterativeClosestPoint.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum : int32
+	{
+		kCorrespondenceBlockSize	= 64,
+		kNormalSumCount				= 21,
+		kPlaneSumCount				= 27
+	};
+
+
+	void TransformBlock(int32 count, const Point3D *source, const Transform3D& M, float *x, float *y, float *z)
+	{
+		int32 i = 0;
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float m00 = VecLoadSmearScalar(&M(0,0)), m01 = VecLoadSmearScalar(&M(0,1)), m02 = VecLoadSmearScalar(&M(0,2)), m03 = VecLoadSmearScalar(&M(0,3));
+			vec_float m10 = VecLoadSmearScalar(&M(1,0)), m11 = VecLoadSmearScalar(&M(1,1)), m12 = VecLoadSmearScalar(&M(1,2)), m13 = VecLoadSmearScalar(&M(1,3));
+			vec_float m20 = VecLoadSmearScalar(&M(2,0)), m21 = VecLoadSmearScalar(&M(2,1)), m22 = VecLoadSmearScalar(&M(2,2)), m23 = VecLoadSmearScalar(&M(2,3));
+
+			for (; i <= count - 4; i += 4)
+			{
+				vec_float	px, py, pz;
+
+				VecLoadTranspose3D(&source[i].x, &px, &py, &pz);
+				VecStore(VecMadd(m02, pz, VecMadd(m01, py, VecMadd(m00, px, m03))), x + i);
+				VecStore(VecMadd(m12, pz, VecMadd(m11, py, VecMadd(m10, px, m13))), y + i);
+				VecStore(VecMadd(m22, pz, VecMadd(m21, py, VecMadd(m20, px, m23))), z + i);
+			}
+
+		#endif
+
+		for (; i < count; i++)
+		{
+			const Point3D& p = source[i];
+			x[i] = M(0,0) * p.x + M(0,1) * p.y + M(0,2) * p.z + M(0,3);
+			y[i] = M(1,0) * p.x + M(1,1) * p.y + M(1,2) * p.z + M(1,3);
+			z[i] = M(2,0) * p.x + M(2,1) * p.y + M(2,2) * p.z + M(2,3);
+		}
+	}
+
+	void AccumulatePlanePairs(int32 count, const float *point, const float *plane, const float *origin, float *sum)
+	{
+		// For each pair, the Jacobian row is J = (u x n, n), where u is the transformed source point relative to the
+		// origin and n is the normal of the target plane, and the residual r is the signed distance to the plane.
+		// The upper triangle of the sum of J^T J is accumulated first, followed by the sum of J^T r.
+
+		const float *px = point;
+		const float *py = point + kCorrespondenceBlockSize;
+		const float *pz = point + kCorrespondenceBlockSize * 2;
+		const float *nx = plane;
+		const float *ny = plane + kCorrespondenceBlockSize;
+		const float *nz = plane + kCorrespondenceBlockSize * 2;
+		const float *nw = plane + kCorrespondenceBlockSize * 3;
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float	acc[kPlaneSumCount];
+			vec_float	J[6];
+
+			for (machine a = 0; a < kPlaneSumCount; a++)
+			{
+				acc[a] = VecFloatGetZero();
+			}
+
+			vec_float ox = VecLoadSmearScalar(&origin[0]);
+			vec_float oy = VecLoadSmearScalar(&origin[1]);
+			vec_float oz = VecLoadSmearScalar(&origin[2]);
+
+			for (machine i = 0; i < count; i += 4)
+			{
+				vec_float x = VecLoad(px + i);
+				vec_float y = VecLoad(py + i);
+				vec_float z = VecLoad(pz + i);
+				J[3] = VecLoad(nx + i);
+				J[4] = VecLoad(ny + i);
+				J[5] = VecLoad(nz + i);
+
+				vec_float r = VecMadd(J[5], z, VecMadd(J[4], y, VecMadd(J[3], x, VecLoad(nw + i))));
+
+				x = VecSub(x, ox);
+				y = VecSub(y, oy);
+				z = VecSub(z, oz);
+				J[0] = VecNmsub(z, J[4], VecMul(y, J[5]));
+				J[1] = VecNmsub(x, J[5], VecMul(z, J[3]));
+				J[2] = VecNmsub(y, J[3], VecMul(x, J[4]));
+
+				vec_float *s = acc;
+				for (machine j = 0; j < 6; j++)
+				{
+					for (machine k = j; k < 6; k++)
+					{
+						*s = VecMadd(J[j], J[k], *s);
+						s++;
+					}
+				}
+
+				for (machine j = 0; j < 6; j++)
+				{
+					s[j] = VecMadd(J[j], r, s[j]);
+				}
+			}
+
+			alignas(16) float	f[4];
+
+			for (machine a = 0; a < kPlaneSumCount; a++)
+			{
+				VecStore(acc[a], f);
+				sum[a] += (f[0] + f[1]) + (f[2] + f[3]);
+			}
+
+		#else
+
+			float	J[6];
+
+			for (machine i = 0; i < count; i++)
+			{
+				float x = px[i];
+				float y = py[i];
+				float z = pz[i];
+				J[3] = nx[i];
+				J[4] = ny[i];
+				J[5] = nz[i];
+
+				float r = J[3] * x + J[4] * y + J[5] * z + nw[i];
+
+				x -= origin[0];
+				y -= origin[1];
+				z -= origin[2];
+				J[0] = y * J[5] - z * J[4];
+				J[1] = z * J[3] - x * J[5];
+				J[2] = x * J[4] - y * J[3];
+
+				float *s = sum;
+				for (machine j = 0; j < 6; j++)
+				{
+					for (machine k = j; k < 6; k++)
+					{
+						*s += J[j] * J[k];
+						s++;
+					}
+				}
+
+				for (machine j = 0; j < 6; j++)
+				{
+					s[j] += J[j] * r;
+				}
+			}
+
+		#endif
+	}
+
+	bool SolveNormalEquations(const float *normalSum, const float *residualSum, float *x)
+	{
+		// Solve the symmetric 6x6 system A x = -b with an LDL^T factorization. A small multiple of the
+		// average diagonal entry is added to the diagonal so that directions left unconstrained by the
+		// geometry, such as sliding along a plane, produce no motion instead of an unbounded one.
+
+		float	L[6][6];
+		float	D[6];
+
+		const float *s = normalSum;
+		for (machine j = 0; j < 6; j++)
+		{
+			for (machine k = j; k < 6; k++)
+			{
+				L[k][j] = *s;
+				s++;
+			}
+		}
+
+		float damping = (L[0][0] + L[1][1] + L[2][2] + L[3][3] + L[4][4] + L[5][5]) * 1.0e-6F;
+		if (!(damping > 0.0F))
+		{
+			return (false);
+		}
+
+		for (machine j = 0; j < 6; j++)
+		{
+			float d = L[j][j] + damping;
+			for (machine k = 0; k < j; k++)
+			{
+				d -= L[j][k] * L[j][k] * D[k];
+			}
+
+			if (!(d > 0.0F))
+			{
+				return (false);
+			}
+
+			D[j] = d;
+			float f = 1.0F / d;
+			for (machine i = j + 1; i < 6; i++)
+			{
+				float e = L[i][j];
+				for (machine k = 0; k < j; k++)
+				{
+					e -= L[i][k] * L[j][k] * D[k];
+				}
+
+				L[i][j] = e * f;
+			}
+		}
+
+		for (machine i = 0; i < 6; i++)
+		{
+			float e = -residualSum[i];
+			for (machine k = 0; k < i; k++)
+			{
+				e -= L[i][k] * x[k];
+			}
+
+			x[i] = e;
+		}
+
+		for (machine i = 5; i >= 0; i--)
+		{
+			float e = x[i] / D[i];
+			for (machine k = i + 1; k < 6; k++)
+			{
+				e -= L[k][i] * x[k];
+			}
+
+			x[i] = e;
+		}
+
+		return (true);
+	}
+}
+
+
+ClosestPointAccumulator::ClosestPointAccumulator()
+{
+	Reset();
+}
+
+/// @brief Removes all accumulated correspondences and sets the origin for the point-to-plane normal equations.
+/// @param origin	The point about which rotations are linearized. This should lie near the transformed source points.
+
+void ClosestPointAccumulator::Reset(const Point3D& origin)
+{
+	planeOrigin[0] = origin.x;
+	planeOrigin[1] = origin.y;
+	planeOrigin[2] = origin.z;
+
+	for (machine a = 0; a < kNormalSumCount; a++)
+	{
+		normalSum[a] = 0.0F;
+	}
+
+	for (machine a = 0; a < 6; a++)
+	{
+		residualSum[a] = 0.0F;
+	}
+
+	squaredErrorSum = 0.0F;
+	pairCount = 0;
+
+	registration.Reset();
+}
+
+/// @brief Adds the correspondences accumulated by another accumulator to this one.
+/// @param accumulator	The accumulator whose correspondences are added. It must have been reset with the same origin as this accumulator.
+
+void ClosestPointAccumulator::Merge(const ClosestPointAccumulator& accumulator)
+{
+	for (machine a = 0; a < kNormalSumCount; a++)
+	{
+		normalSum[a] += accumulator.normalSum[a];
+	}
+
+	for (machine a = 0; a < 6; a++)
+	{
+		residualSum[a] += accumulator.residualSum[a];
+	}
+
+	squaredErrorSum += accumulator.squaredErrorSum;
+	pairCount += accumulator.pairCount;
+
+	registration.Merge(accumulator.registration);
+}
+
+
+/// @brief Constructs an iterative closest point solver for a target point set.
+/// @param tree		A k-d tree built for the target points. It must remain valid while the solver is in use.
+/// @param point	A pointer to the target points in their original order, as passed to the \c PointTree::Build() function.
+/// @param plane	A pointer to an array of tangent planes at the target points, in the same order. The planes must have unit normals. This can be \c nullptr if the point-to-plane metric is not used.
+
+IterativeClosestPoint::IterativeClosestPoint(const PointTree *tree, const Point3D *point, const Plane3D *plane)
+{
+	targetTree = tree;
+	targetPoint = point;
+	targetPlane = plane;
+
+	errorMetric = (plane) ? kClosestPointMetricPlane : kClosestPointMetricPoint;
+	maxIterationCount = 32;
+	maxCorrespondenceDistance = Math::infinity;
+	distanceTolerance = 1.0e-5F;
+	angleTolerance = 1.0e-5F;
+}
+
+/// @brief Finds correspondences for a range of source points and accumulates them.
+/// @param start			The index of the first source point in the range.
+/// @param count			The number of source points in the range.
+/// @param source			A pointer to the array of source points.
+/// @param motor			The current motion applied to the source points.
+/// @param accumulator		The accumulator to which the correspondences are added.
+///
+/// Each source point is transformed by the motor, and its nearest target point within the maximum correspondence distance
+/// is found. Source points with no target point in range are ignored. This function can be called for disjoint ranges
+/// on different threads with a separate accumulator for each range.
+
+void IterativeClosestPoint::AccumulateCorrespondences(int32 start, int32 count, const Point3D *source, const Motor3D& motor, ClosestPointAccumulator *accumulator) const
+{
+	alignas(64) float	transformedBlock[kCorrespondenceBlockSize * 3];
+	alignas(64) float	sourceBlock[kCorrespondenceBlockSize * 3];
+	alignas(64) float	targetBlock[kCorrespondenceBlockSize * 4];
+	float				planeSum[kPlaneSumCount];
+
+	Transform3D M = motor.GetTransformMatrix();
+	bool planeMetric = (errorMetric == kClosestPointMetricPlane);
+
+	Point3DArray sourceArray(kCorrespondenceBlockSize, sourceBlock);
+	Point3DArray targetArray(kCorrespondenceBlockSize, targetBlock);
+
+	float *tx = transformedBlock;
+	float *ty = tx + kCorrespondenceBlockSize;
+	float *tz = ty + kCorrespondenceBlockSize;
+	float *sx = sourceBlock;
+	float *sy = sx + kCorrespondenceBlockSize;
+	float *sz = sy + kCorrespondenceBlockSize;
+	float *gx = targetBlock;
+	float *gy = gx + kCorrespondenceBlockSize;
+	float *gz = gy + kCorrespondenceBlockSize;
+	float *gw = gz + kCorrespondenceBlockSize;
+
+	for (machine a = 0; a < kPlaneSumCount; a++)
+	{
+		planeSum[a] = 0.0F;
+	}
+
+	float squaredError = 0.0F;
+	int32 pairCount = 0;
+
+	const Point3D *p = source + start;
+	while (count > 0)
+	{
+		int32 blockCount = (count < kCorrespondenceBlockSize) ? count : kCorrespondenceBlockSize;
+		TransformBlock(blockCount, p, M, tx, ty, tz);
+
+		// Gather the source points that have a correspondence into contiguous streams
+		// together with their target points or target planes.
+
+		int32 k = 0;
+		for (machine i = 0; i < blockCount; i++)
+		{
+			float	d2;
+
+			Point3D q(tx[i], ty[i], tz[i]);
+			int32 index = targetTree->FindNearestPoint(q, maxCorrespondenceDistance, &d2);
+			if (index >= 0)
+			{
+				sx[k] = q.x;
+				sy[k] = q.y;
+				sz[k] = q.z;
+
+				if (planeMetric)
+				{
+					const Plane3D& g = targetPlane[index];
+					float r = g.x * q.x + g.y * q.y + g.z * q.z + g.w;
+					gx[k] = g.x;
+					gy[k] = g.y;
+					gz[k] = g.z;
+					gw[k] = g.w;
+					squaredError += r * r;
+				}
+				else
+				{
+					const Point3D& t = targetPoint[index];
+					gx[k] = t.x;
+					gy[k] = t.y;
+					gz[k] = t.z;
+					squaredError += d2;
+				}
+
+				k++;
+			}
+		}
+
+		if (k != 0)
+		{
+			pairCount += k;
+			if (planeMetric)
+			{
+				// Pad to a multiple of four with zero planes, which contribute nothing to the sums.
+
+				for (machine i = k; i < ((k + 3) & ~3); i++)
+				{
+					sx[i] = 0.0F;
+					sy[i] = 0.0F;
+					sz[i] = 0.0F;
+					gx[i] = 0.0F;
+					gy[i] = 0.0F;
+					gz[i] = 0.0F;
+					gw[i] = 0.0F;
+				}
+
+				AccumulatePlanePairs(k, sourceBlock, targetBlock, accumulator->planeOrigin, planeSum);
+			}
+			else
+			{
+				accumulator->registration.AddPoints(0, k, sourceArray, targetArray);
+			}
+		}
+
+		p += blockCount;
+		count -= blockCount;
+	}
+
+	for (machine a = 0; a < kNormalSumCount; a++)
+	{
+		accumulator->normalSum[a] += planeSum[a];
+	}
+
+	for (machine a = 0; a < 6; a++)
+	{
+		accumulator->residualSum[a] += planeSum[kNormalSumCount + a];
+	}
+
+	accumulator->squaredErrorSum += squaredError;
+	accumulator->pairCount += pairCount;
+}
+
+/// @brief Improves a motion using the correspondences gathered in an accumulator.
+/// @param accumulator		The accumulator containing the correspondences found for the current motion.
+/// @param motor			A pointer to the current motion, which is replaced by the improved motion.
+///
+/// The improvement is calculated with the current error metric and composed with the motion. The return value is
+/// \c true if the improvement is smaller than both convergence tolerances or if there are too few correspondences
+/// to determine an improvement, in which case the motion is not changed.
+
+bool IterativeClosestPoint::UpdateMotor(const ClosestPointAccumulator& accumulator, Motor3D *motor) const
+{
+	Motor3D		delta;
+	float		distance;
+
+	if (accumulator.pairCount < 3)
+	{
+		return (true);
+	}
+
+	Point3D origin(accumulator.planeOrigin[0], accumulator.planeOrigin[1], accumulator.planeOrigin[2]);
+
+	if (errorMetric == kClosestPointMetricPlane)
+	{
+		float	x[6];
+
+		if (!SolveNormalEquations(accumulator.normalSum, accumulator.residualSum, x))
+		{
+			return (true);
+		}
+
+		// The solution is the small rotation vector about the origin followed by a translation.
+		// The rotation is applied exactly so that the motion stays rigid.
+
+		Vector3D omega(x[0], x[1], x[2]);
+		Quaternion r(0.0F, 0.0F, 0.0F, 1.0F);
+		float angle = Magnitude(omega);
+		if (angle > Math::min_float)
+		{
+			r = Quaternion::MakeRotation(angle, !(omega / angle));
+		}
+
+		Vector3D offset(x[3], x[4], x[5]);
+		delta = Motor3D::MakeTranslation(origin - r.GetRotationMatrix() * origin + offset) * r;
+		distance = Magnitude(offset);
+	}
+	else
+	{
+		delta = accumulator.registration.CalculateMotor();
+		distance = Magnitude(Transform(origin, delta) - origin);
+	}
+
+	*motor = delta * *motor;
+
+	float angle = Magnitude(Bivector3D(delta.v.x, delta.v.y, delta.v.z)) * 2.0F;
+	return ((angle < angleTolerance) && (distance < distanceTolerance));
+}
+
+/// @brief Aligns a set of source points with the target points.
+/// @param count				The number of source points.
+/// @param source				A pointer to an array of \c count source points.
+/// @param motor				A pointer to the initial motion applied to the source points, which is replaced by the final motion.
+/// @param meanSquaredError		A pointer to a location that receives the mean squared error of the correspondences found in the last iteration. This can be \c nullptr.
+///
+/// Iterations are performed until the motion converges or the maximum iteration count is reached. The return value is the
+/// number of iterations that were performed. The initial motion should be close enough to the true alignment that most
+/// nearest-neighbor correspondences are correct.
+
+int32 IterativeClosestPoint::Align(int32 count, const Point3D *source, Motor3D *motor, float *meanSquaredError) const
+{
+	ClosestPointAccumulator		accumulator;
+
+	if (count <= 0)
+	{
+		if (meanSquaredError)
+		{
+			*meanSquaredError = 0.0F;
+		}
+
+		return (0);
+	}
+
+	// Rotations are linearized about the centroid of the source points, which is calculated
+	// relative to the first point so that precision is not lost for scans far from the origin.
+
+	const Point3D& base = source[0];
+	Vector3D sum(0.0F, 0.0F, 0.0F);
+	for (machine i = 1; i < count; i++)
+	{
+		sum += source[i] - base;
+	}
+
+	Point3D centroid = base + sum / float(count);
+
+	int32 iteration = 0;
+	while (iteration < maxIterationCount)
+	{
+		accumulator.Reset(Transform(centroid, *motor));
+		AccumulateCorrespondences(0, count, source, *motor, &accumulator);
+
+		iteration++;
+		if (UpdateMotor(accumulator, motor))
+		{
+			break;
+		}
+	}
+
+	if (meanSquaredError)
+	{
+		*meanSquaredError = accumulator.GetMeanSquaredError();
+	}
+
+	return (iteration);
+}
@@ -0,0 +1,195 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSIterativeClosestPoint_h
+#define TSIterativeClosestPoint_h
+
+
+#include "TSPointTree.h"
+#include "TSRegistration.h"
+
+
+#define TERATHON_ITERATIVECLOSESTPOINT 1
+
+
+namespace Terathon
+{
+	class IterativeClosestPoint;
+
+
+	/// @brief Identifies the error metric minimized by the iterative closest point algorithm.
+
+	enum : uint32
+	{
+		kClosestPointMetricPoint		= 0,		///< Minimize the squared distances between source points and their nearest target points.
+		kClosestPointMetricPlane		= 1			///< Minimize the squared distances between source points and the tangent planes at their nearest target points.
+	};
+
+
+	// ==============================================
+	//	ClosestPointAccumulator
+	// ==============================================
+
+	/// @brief Accumulates the correspondences found during one iteration of the iterative closest point algorithm.
+	///
+	/// For the point-to-point metric, the \c ClosestPointAccumulator class gathers the sums needed by a \c RegistrationAccumulator.
+	/// For the point-to-plane metric, it gathers the 6&nbsp;&times;&nbsp;6 normal equations of the problem linearized about the
+	/// current motion, with the rotational part expressed relative to an origin specified by the \c Reset() function.
+	///
+	/// Separate accumulators can be filled for different ranges of source points, for example on different threads,
+	/// and combined with the \c Merge() function, as long as all of them were reset with the same origin.
+	///
+	/// @sa IterativeClosestPoint
+
+	class ClosestPointAccumulator
+	{
+		friend class IterativeClosestPoint;
+
+		private:
+
+			float						planeOrigin[3];
+			float						normalSum[21];
+			float						residualSum[6];
+			float						squaredErrorSum;
+			int32						pairCount;
+
+			RegistrationAccumulator		registration;
+
+		public:
+
+			TERATHON_API ClosestPointAccumulator();
+
+			/// @brief Returns the number of correspondences that have been accumulated.
+
+			int32 GetPairCount(void) const
+			{
+				return (pairCount);
+			}
+
+			/// @brief Returns the mean squared error of the correspondences that have been accumulated.
+			///
+			/// The error is measured with the metric that was used to find the correspondences, and it is
+			/// calculated before the motion derived from the correspondences is applied.
+
+			float GetMeanSquaredError(void) const
+			{
+				return ((pairCount != 0) ? squaredErrorSum / float(pairCount) : 0.0F);
+			}
+
+			TERATHON_API void Reset(const Point3D& origin = Point3D(0.0F, 0.0F, 0.0F));
+			TERATHON_API void Merge(const ClosestPointAccumulator& accumulator);
+	};
+
+
+	// ==============================================
+	//	IterativeClosestPoint
+	// ==============================================
+
+	/// @brief Aligns a set of source points with a target point set using the iterative closest point algorithm.
+	///
+	/// The \c IterativeClosestPoint class repeatedly pairs each transformed source point with its nearest target point,
+	/// found with a \c PointTree built for the target points, and then improves the motion so that the paired points
+	/// are brought closer together. Each improvement is composed with the current motion as a new motor, so the result
+	/// is always a proper rigid motion. Pairs farther apart than a maximum correspondence distance are rejected.
+	///
+	/// With the point-to-point metric, the improvement is the exact least-squares alignment of the current pairs. With the
+	/// point-to-plane metric, the target tangent planes must be supplied, and the improvement is the solution of the
+	/// linearized problem. The point-to-plane metric typically converges in far fewer iterations on sampled surfaces.
+	///
+	/// The \c Align() function runs the entire algorithm on the calling thread. For very large scans, an application can
+	/// instead call \c AccumulateCorrespondences() for separate ranges of source points on several threads, merge the
+	/// accumulators, and then call \c UpdateMotor() once per iteration. The target tree is never modified, so it can
+	/// be shared by any number of threads and reused for multiple alignments.
+
+	class IterativeClosestPoint
+	{
+		private:
+
+			const PointTree		*targetTree;
+			const Point3D		*targetPoint;
+			const Plane3D		*targetPlane;
+
+			uint32				errorMetric;
+			int32				maxIterationCount;
+			float				maxCorrespondenceDistance;
+			float				distanceTolerance;
+			float				angleTolerance;
+
+		public:
+
+			TERATHON_API IterativeClosestPoint(const PointTree *tree, const Point3D *point, const Plane3D *plane = nullptr);
+
+			/// @brief Returns the error metric.
+
+			uint32 GetErrorMetric(void) const
+			{
+				return (errorMetric);
+			}
+
+			/// @brief Sets the error metric.
+			/// @param metric	The error metric. This can be \c kClosestPointMetricPoint or \c kClosestPointMetricPlane. The point-to-plane metric requires target planes.
+			///
+			/// The initial error metric is \c kClosestPointMetricPlane if target planes were specified and \c kClosestPointMetricPoint otherwise.
+
+			void SetErrorMetric(uint32 metric)
+			{
+				errorMetric = metric;
+			}
+
+			/// @brief Returns the maximum number of iterations performed by the \c Align() function.
+
+			int32 GetMaxIterationCount(void) const
+			{
+				return (maxIterationCount);
+			}
+
+			/// @brief Sets the maximum number of iterations performed by the \c Align() function.
+			/// @param count	The maximum number of iterations. The initial value is 32.
+
+			void SetMaxIterationCount(int32 count)
+			{
+				maxIterationCount = count;
+			}
+
+			/// @brief Returns the maximum distance between corresponding points.
+
+			float GetMaxCorrespondenceDistance(void) const
+			{
+				return (maxCorrespondenceDistance);
+			}
+
+			/// @brief Sets the maximum distance between corresponding points.
+			/// @param distance		The maximum distance. Source points farther than this from every target point are ignored. The initial value is infinity.
+
+			void SetMaxCorrespondenceDistance(float distance)
+			{
+				maxCorrespondenceDistance = distance;
+			}
+
+			/// @brief Sets the tolerances used to detect convergence.
+			/// @param distance		The largest displacement considered negligible. The initial value is 10<sup>&minus;5</sup>.
+			/// @param angle		The largest angle of rotation, in radians, considered negligible. The initial value is 10<sup>&minus;5</sup>.
+			///
+			/// The algorithm terminates when an iteration changes the motion by less than both tolerances.
+
+			void SetTolerance(float distance, float angle)
+			{
+				distanceTolerance = distance;
+				angleTolerance = angle;
+			}
+
+			TERATHON_API void AccumulateCorrespondences(int32 start, int32 count, const Point3D *source, const Motor3D& motor, ClosestPointAccumulator *accumulator) const;
+			TERATHON_API bool UpdateMotor(const ClosestPointAccumulator& accumulator, Motor3D *motor) const;
+
+			TERATHON_API int32 Align(int32 count, const Point3D *source, Motor3D *motor, float *meanSquaredError = nullptr) const;
+	};
+}
+
+
+#endif
@@ -0,0 +1,273 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSMappedFile.h"
+
+#ifndef TERATHON_NO_SYSTEM
+
+	#if defined(_WIN32)
+
+		#define WIN32_LEAN_AND_MEAN
+		#include <windows.h>
+
+	#else
+
+		#include <fcntl.h>
+		#include <unistd.h>
+		#include <sys/mman.h>
+		#include <sys/stat.h>
+
+	#endif
+
+#endif
+
+
+using namespace Terathon;
+
+
+MappedFile::MappedFile()
+{
+	fileData = nullptr;
+	fileSize = 0;
+
+	#if defined(_WIN32)
+
+		fileHandle = nullptr;
+		mappingHandle = nullptr;
+
+	#else
+
+		fileHandle = -1;
+
+	#endif
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/// @brief Maps a file into memory.
+/// @param name		The name of the file.
+///
+/// Any previously open file is closed first. If the file cannot be opened or mapped, then the return value is \c false.
+/// An empty file can be opened successfully, but its data pointer is \c nullptr.
+
+bool MappedFile::Open(const char *name)
+{
+	Close();
+
+	#ifndef TERATHON_NO_SYSTEM
+
+		#if defined(_WIN32)
+
+			HANDLE file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return (false);
+			}
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size))
+			{
+				CloseHandle(file);
+				return (false);
+			}
+
+			fileHandle = file;
+			fileSize = uint64(size.QuadPart);
+			if (fileSize == 0)
+			{
+				return (true);
+			}
+
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping)
+			{
+				mappingHandle = mapping;
+				fileData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				if (fileData)
+				{
+					return (true);
+				}
+			}
+
+		#else
+
+			int file = open(name, O_RDONLY);
+			if (file < 0)
+			{
+				return (false);
+			}
+
+			struct stat status;
+			if (fstat(file, &status) != 0)
+			{
+				close(file);
+				return (false);
+			}
+
+			fileHandle = file;
+			fileSize = uint64(status.st_size);
+			if (fileSize == 0)
+			{
+				return (true);
+			}
+
+			void *data = mmap(nullptr, size_t(fileSize), PROT_READ, MAP_SHARED, file, 0);
+			if (data != MAP_FAILED)
+			{
+				fileData = data;
+				return (true);
+			}
+
+		#endif
+
+		Close();
+
+	#endif
+
+	return (false);
+}
+
+/// @brief Unmaps and closes the file, if any.
+
+void MappedFile::Close(void)
+{
+	#ifndef TERATHON_NO_SYSTEM
+
+		#if defined(_WIN32)
+
+			if (fileData)
+			{
+				UnmapViewOfFile(fileData);
+			}
+
+			if (mappingHandle)
+			{
+				CloseHandle(mappingHandle);
+				mappingHandle = nullptr;
+			}
+
+			if (fileHandle)
+			{
+				CloseHandle(fileHandle);
+				fileHandle = nullptr;
+			}
+
+		#else
+
+			if (fileData)
+			{
+				munmap(const_cast<void *>(fileData), size_t(fileSize));
+			}
+
+			if (fileHandle >= 0)
+			{
+				close(fileHandle);
+				fileHandle = -1;
+			}
+
+		#endif
+
+	#endif
+
+	fileData = nullptr;
+	fileSize = 0;
+}
+
+/// @brief Asks the operating system to begin loading a range of the file into memory.
+/// @param offset	The byte offset of the beginning of the range.
+/// @param size		The size of the range, in bytes.
+///
+/// This function returns immediately, and the pages are read asynchronously. It is only a hint, and it has no effect on
+/// platforms that do not support it.
+
+void MappedFile::Prefetch(uint64 offset, uint64 size) const
+{
+	#ifndef TERATHON_NO_SYSTEM
+
+		if ((fileData) && (offset < fileSize))
+		{
+			size = (size < fileSize - offset) ? size : fileSize - offset;
+
+			#if defined(_WIN32)
+
+				#if (_WIN32_WINNT >= 0x0602)
+
+					WIN32_MEMORY_RANGE_ENTRY range = {const_cast<char *>(static_cast<const char *>(fileData)) + offset, size_t(size)};
+					PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+
+				#endif
+
+			#else
+
+				// The range passed to madvise() must begin on a page boundary.
+
+				machine_address pageMask = machine_address(sysconf(_SC_PAGESIZE)) - 1;
+				machine_address begin = GetPointerAddress(static_cast<const char *>(fileData) + offset);
+				machine_address start = begin & ~pageMask;
+				madvise(reinterpret_cast<void *>(start), size_t(size + (begin - start)), MADV_WILLNEED);
+
+			#endif
+		}
+
+	#endif
+}
+
+/// @brief Tells the operating system that a range of the file will not be accessed again soon.
+/// @param offset	The byte offset of the beginning of the range.
+/// @param size		The size of the range, in bytes.
+///
+/// Evicting ranges that have already been processed keeps the resident memory of a sequential pass over a large file bounded.
+/// The data remains accessible, and it is read from disk again if it is touched later. On POSIX systems, only pages that lie
+/// entirely inside the range are affected, except that a range reaching the end of the file also includes the last page.
+///
+/// The return value is the offset of the first byte that was not evicted. A sequential reader should pass it as the beginning
+/// of the next range so that a page straddling the boundary between two ranges is evicted once the second range is finished.
+
+uint64 MappedFile::Evict(uint64 offset, uint64 size) const
+{
+	#ifndef TERATHON_NO_SYSTEM
+
+		if ((fileData) && (offset < fileSize))
+		{
+			size = (size < fileSize - offset) ? size : fileSize - offset;
+
+			#if defined(_WIN32)
+
+				// Unlocking pages that are not locked removes them from the working set.
+
+				VirtualUnlock(const_cast<char *>(static_cast<const char *>(fileData)) + offset, size_t(size));
+				return (offset + size);
+
+			#else
+
+				// The mapping begins on a page boundary, and the last page of the file is mapped in its entirety.
+
+				machine_address pageMask = machine_address(sysconf(_SC_PAGESIZE)) - 1;
+				machine_address base = GetPointerAddress(fileData);
+				machine_address begin = base + machine_address(offset);
+				machine_address start = (begin + pageMask) & ~pageMask;
+				machine_address end = begin + machine_address(size);
+				end = (offset + size == fileSize) ? (end + pageMask) & ~pageMask : end & ~pageMask;
+
+				if (end > start)
+				{
+					madvise(reinterpret_cast<void *>(start), size_t(end - start), MADV_DONTNEED);
+					return ((offset + size < uint64(end - base)) ? offset + size : uint64(end - base));
+				}
+
+			#endif
+		}
+
+	#endif
+
+	return (offset);
+}
@@ -0,0 +1,82 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSMappedFile_h
+#define TSMappedFile_h
+
+
+#include "TSPlatform.h"
+
+
+#define TERATHON_MAPPEDFILE 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	MappedFile
+	// ==============================================
+
+	/// @brief Provides read-only access to the contents of a file through virtual memory mapping.
+	///
+	/// The \c MappedFile class maps an entire file into the address space of the process so that its contents can be accessed
+	/// directly without reading them into a separate buffer. Pages are loaded by the operating system on demand.
+	///
+	/// File mapping is not available when \c TERATHON_NO_SYSTEM is defined, in which case the \c Open() function always fails.
+
+	class MappedFile
+	{
+		private:
+
+			const void		*fileData;
+			uint64			fileSize;
+
+			#if defined(_WIN32)
+
+				void		*fileHandle;
+				void		*mappingHandle;
+
+			#else
+
+				int32		fileHandle;
+
+			#endif
+
+		public:
+
+			TERATHON_API MappedFile();
+			TERATHON_API ~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator =(const MappedFile&) = delete;
+
+			/// @brief Returns a pointer to the beginning of the mapped file, or \c nullptr if no file is open.
+
+			const void *GetData(void) const
+			{
+				return (fileData);
+			}
+
+			/// @brief Returns the size of the mapped file, in bytes.
+
+			uint64 GetSize(void) const
+			{
+				return (fileSize);
+			}
+
+			TERATHON_API bool Open(const char *name);
+			TERATHON_API void Close(void);
+
+			TERATHON_API void Prefetch(uint64 offset, uint64 size) const;
+			TERATHON_API uint64 Evict(uint64 offset, uint64 size) const;
+	};
+}
+
+
+#endif
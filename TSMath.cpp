@@ -476,6 +476,106 @@ float Terathon::Arctan(float y, float x)
 	return ((x < 0.0F) ? Math::tau_over_2 : 0.0F);
 }
 
+/// @brief Calculates the cosines and sines of an array of angles.
+/// @param count	The number of angles.
+/// @param x		A pointer to an array of \c count angles, in radians.
+/// @param c		A pointer to an array that receives the \c count cosines.
+/// @param s		A pointer to an array that receives the \c count sines.
+///
+/// When SIMD is available, four angles are processed at a time with the \c VecCosSin() function, and the same calculation
+/// is applied to the final group of fewer than four angles so that every result is independent of its position in the array.
+
+void Terathon::CosSin(int32 count, const float *x, float *c, float *s)
+{
+	#ifndef TERATHON_NO_SIMD
+
+		vec_float	vc, vs;
+
+		int32 i = 0;
+		for (; i <= count - 4; i += 4)
+		{
+			VecCosSin(VecLoadUnaligned(x + i), &vc, &vs);
+			VecStoreUnaligned(vc, c + i);
+			VecStoreUnaligned(vs, s + i);
+		}
+
+		int32 n = count - i;
+		if (n > 0)
+		{
+			alignas(16) float	temp[3][4];
+
+			for (machine k = 0; k < 4; k++)
+			{
+				temp[0][k] = (k < n) ? x[i + k] : 0.0F;
+			}
+
+			VecCosSin(VecLoad(temp[0]), &vc, &vs);
+			VecStore(vc, temp[1]);
+			VecStore(vs, temp[2]);
+
+			for (machine k = 0; k < n; k++)
+			{
+				c[i + k] = temp[1][k];
+				s[i + k] = temp[2][k];
+			}
+		}
+
+	#else
+
+		for (machine i = 0; i < count; i++)
+		{
+			CosSin(x[i], &c[i], &s[i]);
+		}
+
+	#endif
+}
+
+/// @brief Calculates the angles between the positive <i>x</i> axis and an array of points (<i>x</i>,&nbsp;<i>y</i>).
+/// @param count	The number of points.
+/// @param y		A pointer to an array of \c count <i>y</i> coordinates.
+/// @param x		A pointer to an array of \c count <i>x</i> coordinates.
+/// @param result	A pointer to an array that receives the \c count angles. This may be the same as \c y or \c x.
+
+void Terathon::Arctan(int32 count, const float *y, const float *x, float *result)
+{
+	#ifndef TERATHON_NO_SIMD
+
+		int32 i = 0;
+		for (; i <= count - 4; i += 4)
+		{
+			VecStoreUnaligned(VecArctan(VecLoadUnaligned(y + i), VecLoadUnaligned(x + i)), result + i);
+		}
+
+		int32 n = count - i;
+		if (n > 0)
+		{
+			alignas(16) float	temp[2][4];
+
+			for (machine k = 0; k < 4; k++)
+			{
+				bool valid = (k < n);
+				temp[0][k] = (valid) ? y[i + k] : 0.0F;
+				temp[1][k] = (valid) ? x[i + k] : 0.0F;
+			}
+
+			VecStore(VecArctan(VecLoad(temp[0]), VecLoad(temp[1])), temp[0]);
+
+			for (machine k = 0; k < n; k++)
+			{
+				result[i + k] = temp[0][k];
+			}
+		}
+
+	#else
+
+		for (machine i = 0; i < count; i++)
+		{
+			result[i] = Arctan(y[i], x[i]);
+		}
+
+	#endif
+}
+
 float Terathon::Exp(float x)
 {
 	// Values of exp(n) for integers n in the range [-88, 91].
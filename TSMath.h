@@ -467,6 +467,83 @@ namespace Terathon
 		return (Exp(Log(base) * exponent));
 	}
 
+	TERATHON_API void CosSin(int32 count, const float *x, float *c, float *s);
+	TERATHON_API void Arctan(int32 count, const float *y, const float *x, float *result);
+
+
+	#ifndef TERATHON_NO_SIMD
+
+		/// @brief Calculates the cosine and sine of four angles at once.
+		/// @param x	The angles, in radians.
+		/// @param c	A pointer to a location that receives the cosines.
+		/// @param s	A pointer to a location that receives the sines.
+		///
+		/// The angles are reduced to the range [&minus;&tau;/8,&nbsp;&tau;/8] by subtracting the nearest multiple of &tau;/4 in three parts,
+		/// so the results are accurate to within a few ulps for angles whose magnitudes do not exceed several thousand radians.
+		/// No lookup table is used, so all four lanes are calculated with the same instructions.
+
+		inline void VecCosSin(const vec_float& x, vec_float *c, vec_float *s)
+		{
+			const vec_float one = VecLoadVectorConstant<0x3F800000>();
+			const vec_float half = VecLoadVectorConstant<0x3F000000>();
+			const vec_float minus_zero = VecFloatGetMinusZero();
+
+			// j is the nearest integer to x / (tau / 4), and r = x - j * tau / 4.
+
+			vec_float j = VecFloor(VecMadd(x, VecLoadVectorConstant<0x3F22F983>(), half));
+			vec_float r = VecNmsub(j, VecLoadVectorConstant<0x3FC90000>(), x);
+			r = VecNmsub(j, VecLoadVectorConstant<0x39FDA000>(), r);
+			r = VecNmsub(j, VecLoadVectorConstant<0x33A22169>(), r);
+
+			vec_float r2 = VecMul(r, r);
+			vec_float sine = VecMadd(VecMul(r, r2), VecMadd(VecMadd(VecLoadVectorConstant<0xB94CA1F9>(), r2, VecLoadVectorConstant<0x3C08839E>()), r2, VecLoadVectorConstant<0xBE2AAAA3>()), r);
+			vec_float cosine = VecMadd(VecMul(r2, r2), VecMadd(VecMadd(VecLoadVectorConstant<0x37CCF5CE>(), r2, VecLoadVectorConstant<0xBAB6061A>()), r2, VecLoadVectorConstant<0x3D2AAAA5>()), VecNmsub(r2, half, one));
+
+			// The quadrant m = j mod 4 determines whether the sine and cosine are exchanged and which of them are negated.
+
+			vec_float m = VecNmsub(VecFloor(VecMul(j, VecLoadVectorConstant<0x3E800000>())), VecLoadVectorConstant<0x40800000>(), j);
+			vec_float swap = VecMaskCmpeq(VecNmsub(VecFloor(VecMul(m, half)), VecLoadVectorConstant<0x40000000>(), m), one);
+
+			vec_float sine_sign = VecAnd(VecMaskCmpgt(m, VecLoadVectorConstant<0x3FC00000>()), minus_zero);
+			vec_float cosine_sign = VecAnd(VecAnd(VecMaskCmpgt(m, half), VecMaskCmplt(m, VecLoadVectorConstant<0x40200000>())), minus_zero);
+
+			*s = VecXor(VecSelect(sine, cosine, swap), sine_sign);
+			*c = VecXor(VecSelect(cosine, sine, swap), cosine_sign);
+		}
+
+		/// @brief Calculates the angles between the positive <i>x</i> axis and four points (<i>x</i>,&nbsp;<i>y</i>) at once.
+		/// @param y	The <i>y</i> coordinates.
+		/// @param x	The <i>x</i> coordinates.
+		///
+		/// The results are in the range [&minus;&tau;/2,&nbsp;&tau;/2], and they follow the same conventions as the scalar
+		/// \c Arctan() function with two parameters. When both <i>x</i> and <i>y</i> are zero, the result is zero.
+
+		inline vec_float VecArctan(const vec_float& y, const vec_float& x)
+		{
+			const vec_float one = VecLoadVectorConstant<0x3F800000>();
+			const vec_float minus_zero = VecFloatGetMinusZero();
+
+			vec_float ax = VecAndc(x, minus_zero);
+			vec_float ay = VecAndc(y, minus_zero);
+
+			// Calculate arctan(a) for a = min(|x|, |y|) / max(|x|, |y|) in the range [0, 1]. Above tan(tau / 16),
+			// the identity arctan(a) = tau / 8 + arctan((a - 1) / (a + 1)) moves the argument back toward zero.
+
+			vec_float a = VecDiv(VecMin(ax, ay), VecMax(VecMax(ax, ay), VecLoadVectorConstant<0x00800000>()));
+			vec_float large = VecMaskCmpgt(a, VecLoadVectorConstant<0x3ED413CD>());
+			vec_float t = VecSelect(a, VecDiv(VecSub(a, one), VecAdd(a, one)), large);
+
+			vec_float t2 = VecMul(t, t);
+			vec_float p = VecMadd(VecMadd(VecMadd(VecLoadVectorConstant<0x3DA4F0D1>(), t2, VecLoadVectorConstant<0xBE0E1B85>()), t2, VecLoadVectorConstant<0x3E4C925F>()), t2, VecLoadVectorConstant<0xBEAAAA2A>());
+			vec_float r = VecAdd(VecMadd(VecMul(p, t2), t, t), VecAnd(large, VecLoadVectorConstant<0x3F490FDB>()));
+
+			r = VecSelect(r, VecSub(VecLoadVectorConstant<0x3FC90FDB>(), r), VecMaskCmpgt(ay, ax));
+			r = VecSelect(r, VecSub(VecLoadVectorConstant<0x40490FDB>(), r), VecMaskCmplt(x, VecFloatGetZero()));
+			return (VecOr(r, VecAnd(y, minus_zero)));
+		}
+
+	#endif
+
 
 	namespace Math
 	{
@@ -0,0 +1,229 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSMemory.h"
+
+
+using namespace Terathon;
+
+
+/// @brief Allocates a block of memory with a specific alignment.
+/// @param size			The size of the block, in bytes.
+/// @param alignment	The alignment of the block. This must be a power of two no smaller than the size of a pointer.
+///
+/// Memory allocated with this function must be released with the \c ReleaseAligned() function. If the memory cannot be allocated,
+/// or the size is so large that the space needed for alignment cannot be added to it, then the return value is \c nullptr.
+///
+/// @relatedalso MemoryArena
+
+void *Terathon::AllocateAligned(umachine size, uint32 alignment)
+{
+	// The original pointer returned by new is stored immediately before the aligned block.
+
+	umachine overhead = alignment - 1 + sizeof(void *);
+	if (size > ~umachine(0) - overhead)
+	{
+		return (nullptr);
+	}
+
+	#ifdef TERATHON_NO_SYSTEM
+
+		char *storage = new char[size + overhead];
+
+	#else
+
+		char *storage = new(std::nothrow) char[size + overhead];
+
+	#endif
+
+	if (!storage)
+	{
+		return (nullptr);
+	}
+
+	void *ptr = AlignPointer(storage + sizeof(void *), alignment);
+	static_cast<void **>(ptr)[-1] = storage;
+	return (ptr);
+}
+
+/// @brief Releases a block of memory previously allocated with the \c AllocateAligned() function.
+/// @param ptr		A pointer to the block of memory. This can be \c nullptr.
+/// @relatedalso MemoryArena
+
+void Terathon::ReleaseAligned(void *ptr)
+{
+	if (ptr)
+	{
+		delete[] static_cast<char **>(ptr)[-1];
+	}
+}
+
+
+/// @brief Constructs a memory arena that owns its storage.
+/// @param size		The size of the arena, in bytes.
+
+MemoryArena::MemoryArena(uint32 size)
+{
+	// A size within one alignment of the largest 32-bit value would wrap when rounded up, so it is rounded down instead.
+
+	arenaSize = (size <= ~uint32(kMemoryAlignment - 1)) ? uint32(AlignSize(size)) : ~uint32(kMemoryAlignment - 1);
+	ownedStorage = static_cast<char *>(AllocateAligned(arenaSize));
+	arenaStorage = ownedStorage;
+	if (!ownedStorage)
+	{
+		arenaSize = 0;
+	}
+
+	arenaOffset = 0;
+	highWaterMark = 0;
+}
+
+/// @brief Constructs a memory arena that uses external storage.
+/// @param storage	A pointer to the storage for the arena. It does not need to be aligned.
+/// @param size		The size of the storage, in bytes.
+///
+/// The arena does not take ownership of the storage.
+
+MemoryArena::MemoryArena(void *storage, uint32 size)
+{
+	char *begin = static_cast<char *>(AlignPointer(storage));
+	uint32 skip = uint32(begin - static_cast<char *>(storage));
+
+	arenaStorage = begin;
+	ownedStorage = nullptr;
+	arenaSize = (size > skip) ? (size - skip) & ~(kMemoryAlignment - 1) : 0;
+	arenaOffset = 0;
+	highWaterMark = 0;
+}
+
+MemoryArena::~MemoryArena()
+{
+	ReleaseAligned(ownedStorage);
+}
+
+/// @brief Allocates a block of memory from the arena.
+/// @param size			The size of the block, in bytes.
+/// @param alignment	The alignment of the block. Values smaller than 64 are raised to 64.
+///
+/// If there is not enough space left in the arena, then the return value is \c nullptr and the arena is not modified.
+
+void *MemoryArena::Allocate(umachine size, uint32 alignment)
+{
+	if (alignment < kMemoryAlignment)
+	{
+		alignment = kMemoryAlignment;
+	}
+
+	// The size is compared with the space remaining before it is rounded up, so no sum can wrap. The arena size and the
+	// offset are both multiples of 64 bytes, so the rounded size never extends past the end of the arena.
+
+	umachine offset = AlignSize(arenaOffset, alignment);
+	if ((offset < arenaOffset) || (offset > arenaSize) || (size > arenaSize - offset))
+	{
+		return (nullptr);
+	}
+
+	uint32 end = uint32(offset + AlignSize(size));
+	arenaOffset = end;
+	if (end > highWaterMark)
+	{
+		highWaterMark = end;
+	}
+
+	return (arenaStorage + offset);
+}
+
+
+/// @brief Allocates temporary storage.
+/// @param size		The size of the storage, in bytes.
+/// @param arena	The arena from which the storage is preferably taken. This can be \c nullptr.
+///
+/// If an arena is specified and has enough space left, then the storage is allocated from it. Otherwise, the storage is allocated
+/// with the \c AllocateAligned() function. In either case, it is aligned to 64 bytes.
+
+ScratchStorage::ScratchStorage(umachine size, MemoryArena *arena)
+{
+	memoryArena = arena;
+	ownedStorage = nullptr;
+
+	if (arena)
+	{
+		arenaMarker = arena->GetMarker();
+		scratchPointer = arena->Allocate(size);
+		if (scratchPointer)
+		{
+			return;
+		}
+	}
+
+	ownedStorage = AllocateAligned(size);
+	scratchPointer = ownedStorage;
+}
+
+ScratchStorage::~ScratchStorage()
+{
+	if (memoryArena)
+	{
+		memoryArena->Rewind(arenaMarker);
+	}
+
+	ReleaseAligned(ownedStorage);
+}
+
+
+/// @brief Constructs a memory pool that owns its storage.
+/// @param size		The size of each block, in bytes.
+/// @param count	The number of blocks.
+
+MemoryPool::MemoryPool(uint32 size, uint32 count)
+{
+	blockSize = AlignSize((size > sizeof(void *)) ? size : uint32(sizeof(void *)));
+	ownedStorage = static_cast<char *>(AllocateAligned(umachine(blockSize) * count));
+	poolStorage = ownedStorage;
+	blockCount = (ownedStorage) ? count : 0;
+	Reset();
+}
+
+/// @brief Constructs a memory pool that uses external storage.
+/// @param size		The size of each block, in bytes.
+/// @param count	The number of blocks.
+/// @param storage	A pointer to storage aligned to 64 bytes that is at least as large as the size returned by \c GetStorageSize().
+///
+/// The pool does not take ownership of the storage.
+
+MemoryPool::MemoryPool(uint32 size, uint32 count, void *storage)
+{
+	blockSize = AlignSize((size > sizeof(void *)) ? size : uint32(sizeof(void *)));
+	blockCount = count;
+	ownedStorage = nullptr;
+	poolStorage = static_cast<char *>(storage);
+	Reset();
+}
+
+MemoryPool::~MemoryPool()
+{
+	ReleaseAligned(ownedStorage);
+}
+
+/// @brief Returns all blocks to the pool.
+
+void MemoryPool::Reset(void)
+{
+	void *next = nullptr;
+	char *block = poolStorage + umachine(blockSize) * blockCount;
+	for (machine k = blockCount; k > 0; k--)
+	{
+		block -= blockSize;
+		*reinterpret_cast<void **>(block) = next;
+		next = block;
+	}
+
+	freeBlock = next;
+	usedCount = 0;
+}
@@ -0,0 +1,304 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSMemory_h
+#define TSMemory_h
+
+
+#include "TSPlatform.h"
+
+
+#define TERATHON_MEMORY 1
+
+
+namespace Terathon
+{
+	enum : uint32
+	{
+		kMemoryAlignment		= 64			///< The default alignment for all allocations. This matches the cache line size so that separately allocated buffers never share a line.
+	};
+
+
+	/// @brief Rounds a size up to a multiple of an alignment.
+	/// @param size			The size to round up.
+	/// @param alignment	The alignment. This must be a power of two.
+	/// @relatedalso MemoryArena
+
+	inline umachine AlignSize(umachine size, umachine alignment = kMemoryAlignment)
+	{
+		return ((size + (alignment - 1)) & ~(alignment - 1));
+	}
+
+	/// @brief Rounds a pointer up to a multiple of an alignment.
+	/// @param ptr			The pointer to round up.
+	/// @param alignment	The alignment. This must be a power of two.
+	/// @relatedalso MemoryArena
+
+	inline void *AlignPointer(void *ptr, uint32 alignment = kMemoryAlignment)
+	{
+		return (reinterpret_cast<void *>((GetPointerAddress(ptr) + (alignment - 1)) & ~machine_address(alignment - 1)));
+	}
+
+	TERATHON_API void *AllocateAligned(umachine size, uint32 alignment = kMemoryAlignment);
+	TERATHON_API void ReleaseAligned(void *ptr);
+
+
+	// ==============================================
+	//	MemoryArena
+	// ==============================================
+
+	/// @brief Linear allocator for transient buffers.
+	///
+	/// The \c MemoryArena class hands out aligned blocks from a single contiguous region by advancing an offset. Individual
+	/// allocations are never freed. Instead, the entire arena is returned to its empty state with the \c Reset() function,
+	/// typically once per frame, or it is rolled back to a marker previously returned by the \c GetMarker() function.
+	///
+	/// Every allocation is aligned to at least 64 bytes, and its size is rounded up to a multiple of 64 bytes, so buffers handed to
+	/// different threads never share a cache line. When the arena is exhausted, the \c Allocate() function returns \c nullptr.
+	///
+	/// @sa MemoryPool
+
+	class MemoryArena
+	{
+		private:
+
+			char		*arenaStorage;
+			char		*ownedStorage;
+			uint32		arenaSize;
+			uint32		arenaOffset;
+			uint32		highWaterMark;
+
+		public:
+
+			TERATHON_API explicit MemoryArena(uint32 size);
+			TERATHON_API MemoryArena(void *storage, uint32 size);
+			TERATHON_API ~MemoryArena();
+
+			MemoryArena(const MemoryArena&) = delete;
+			MemoryArena& operator =(const MemoryArena&) = delete;
+
+			/// @brief Returns the total number of bytes that the arena can hold.
+
+			uint32 GetSize(void) const
+			{
+				return (arenaSize);
+			}
+
+			/// @brief Returns the number of bytes currently allocated from the arena.
+
+			uint32 GetUsedSize(void) const
+			{
+				return (arenaOffset);
+			}
+
+			/// @brief Returns the largest number of bytes that have been allocated from the arena at any one time.
+
+			uint32 GetHighWaterMark(void) const
+			{
+				return (highWaterMark);
+			}
+
+			/// @brief Returns a marker representing the current state of the arena.
+			///
+			/// The marker can later be passed to the \c Rewind() function to release all allocations made after this call.
+
+			uint32 GetMarker(void) const
+			{
+				return (arenaOffset);
+			}
+
+			/// @brief Releases all allocations made after a marker was obtained.
+			/// @param marker	A value previously returned by the \c GetMarker() function.
+
+			void Rewind(uint32 marker)
+			{
+				arenaOffset = marker;
+			}
+
+			/// @brief Releases all allocations made from the arena.
+
+			void Reset(void)
+			{
+				arenaOffset = 0;
+			}
+
+			TERATHON_API void *Allocate(umachine size, uint32 alignment = kMemoryAlignment);
+
+			/// @brief Allocates an uninitialized array of objects from the arena.
+			/// @param count	The number of objects to allocate.
+			///
+			/// No constructors are run, so the type should be trivially constructible.
+
+			template <typename type>
+			type *AllocateArray(uint32 count)
+			{
+				return (static_cast<type *>(Allocate(count * sizeof(type), uint32(alignof(type)))));
+			}
+	};
+
+
+	/// @brief Rewinds a memory arena to its state at construction time when it goes out of scope.
+	///
+	/// The \c MemoryArenaScope class is intended for batch functions that need temporary storage from a caller-supplied arena.
+	///
+	/// @sa MemoryArena
+
+	class MemoryArenaScope
+	{
+		private:
+
+			MemoryArena		*memoryArena;
+			uint32			arenaMarker;
+
+		public:
+
+			explicit MemoryArenaScope(MemoryArena *arena)
+			{
+				memoryArena = arena;
+				arenaMarker = arena->GetMarker();
+			}
+
+			~MemoryArenaScope()
+			{
+				memoryArena->Rewind(arenaMarker);
+			}
+
+			MemoryArenaScope(const MemoryArenaScope&) = delete;
+			MemoryArenaScope& operator =(const MemoryArenaScope&) = delete;
+	};
+
+
+	/// @brief Temporary storage for a batch function, taken from a memory arena when one is available.
+	///
+	/// The \c ScratchStorage class is used by batch functions that accept an optional \c MemoryArena for their temporary buffers.
+	/// Storage taken from the arena is released by rewinding the arena when the object goes out of scope, so scratch storage
+	/// objects must be destroyed in the reverse order of their construction. When no arena is supplied, or the arena does not
+	/// have enough space left, the storage is allocated from the heap and released when the object goes out of scope.
+	///
+	/// @sa MemoryArenaScope
+
+	class ScratchStorage
+	{
+		private:
+
+			MemoryArena		*memoryArena;
+			uint32			arenaMarker;
+			void			*scratchPointer;
+			void			*ownedStorage;
+
+		public:
+
+			TERATHON_API ScratchStorage(umachine size, MemoryArena *arena);
+			TERATHON_API ~ScratchStorage();
+
+			ScratchStorage(const ScratchStorage&) = delete;
+			ScratchStorage& operator =(const ScratchStorage&) = delete;
+
+			/// @brief Returns a pointer to the storage, or \c nullptr if it could not be allocated.
+
+			void *GetStorage(void) const
+			{
+				return (scratchPointer);
+			}
+	};
+
+
+	// ==============================================
+	//	MemoryPool
+	// ==============================================
+
+	/// @brief Fixed-size block allocator.
+	///
+	/// The \c MemoryPool class manages a fixed number of equally sized blocks stored contiguously in a single allocation.
+	/// Blocks are allocated and released in constant time through an intrusive free list. Block sizes are rounded up to a
+	/// multiple of 64 bytes, and every block is aligned to 64 bytes. When all blocks are in use, the \c Allocate() function
+	/// returns \c nullptr.
+	///
+	/// @sa MemoryArena
+
+	class MemoryPool
+	{
+		private:
+
+			char		*poolStorage;
+			char		*ownedStorage;
+			void		*freeBlock;
+			uint32		blockSize;
+			uint32		blockCount;
+			uint32		usedCount;
+
+		public:
+
+			TERATHON_API MemoryPool(uint32 size, uint32 count);
+			TERATHON_API MemoryPool(uint32 size, uint32 count, void *storage);
+			TERATHON_API ~MemoryPool();
+
+			MemoryPool(const MemoryPool&) = delete;
+			MemoryPool& operator =(const MemoryPool&) = delete;
+
+			/// @brief Returns the size of each block in bytes, after rounding to the pool alignment.
+
+			uint32 GetBlockSize(void) const
+			{
+				return (blockSize);
+			}
+
+			/// @brief Returns the total number of blocks in the pool.
+
+			uint32 GetBlockCount(void) const
+			{
+				return (blockCount);
+			}
+
+			/// @brief Returns the number of blocks currently allocated from the pool.
+
+			uint32 GetUsedCount(void) const
+			{
+				return (usedCount);
+			}
+
+			/// @brief Returns the number of bytes of storage needed for a pool.
+			/// @param size		The size of each block.
+			/// @param count	The number of blocks.
+
+			static umachine GetStorageSize(uint32 size, uint32 count)
+			{
+				return (AlignSize((size > sizeof(void *)) ? size : uint32(sizeof(void *))) * count);
+			}
+
+			/// @brief Allocates one block from the pool.
+
+			void *Allocate(void)
+			{
+				void *block = freeBlock;
+				if (block)
+				{
+					freeBlock = *static_cast<void **>(block);
+					usedCount++;
+				}
+
+				return (block);
+			}
+
+			/// @brief Returns one block to the pool.
+			/// @param block	A pointer previously returned by the \c Allocate() function.
+
+			void Release(void *block)
+			{
+				*static_cast<void **>(block) = freeBlock;
+				freeBlock = block;
+				usedCount--;
+			}
+
+			TERATHON_API void Reset(void);
+	};
+}
+
+
+#endif
@@ -0,0 +1,365 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSMeshNormals.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	// Holds the per-face quantities for a group of four triangles in structure-of-arrays layout.
+	// Normals are not normalized, so their magnitudes are twice the areas of the triangles.
+
+	struct FaceGroup
+	{
+		alignas(16) float	normal[3][4];
+		alignas(16) float	magnitude[4];
+		alignas(16) float	angle[3][4];
+		alignas(16) float	tangent[3][4];
+		alignas(16) float	bitangent[3][4];
+		alignas(16) float	uvArea[4];
+	};
+
+
+	void CalculateFaceGroup(const Point3D *vertex, const Point2D *texcoord, const int32 *triangleIndex, int32 count, FaceGroup *group)
+	{
+		// Gather the two edges leaving vertex 0 of each triangle. Unused lanes hold degenerate triangles.
+
+		alignas(16) float	edge[6][4];
+		alignas(16) float	uv[4][4];
+
+		for (machine k = 0; k < 4; k++)
+		{
+			if (k < count)
+			{
+				const int32 *index = triangleIndex + k * 3;
+				const Point3D& p0 = vertex[index[0]];
+				Vector3D e1 = vertex[index[1]] - p0;
+				Vector3D e2 = vertex[index[2]] - p0;
+
+				for (machine a = 0; a < 3; a++)
+				{
+					edge[a][k] = e1[a];
+					edge[a + 3][k] = e2[a];
+				}
+
+				if (texcoord)
+				{
+					const Point2D& t0 = texcoord[index[0]];
+					Vector2D d1 = texcoord[index[1]] - t0;
+					Vector2D d2 = texcoord[index[2]] - t0;
+					uv[0][k] = d1.x;
+					uv[1][k] = d1.y;
+					uv[2][k] = d2.x;
+					uv[3][k] = d2.y;
+				}
+			}
+			else
+			{
+				for (machine a = 0; a < 6; a++)
+				{
+					edge[a][k] = 0.0F;
+				}
+
+				for (machine a = 0; a < 4; a++)
+				{
+					uv[a][k] = 0.0F;
+				}
+			}
+		}
+
+		#ifndef TERATHON_NO_SIMD
+
+			vec_float e1x = VecLoad(edge[0]);
+			vec_float e1y = VecLoad(edge[1]);
+			vec_float e1z = VecLoad(edge[2]);
+			vec_float e2x = VecLoad(edge[3]);
+			vec_float e2y = VecLoad(edge[4]);
+			vec_float e2z = VecLoad(edge[5]);
+
+			vec_float nx = VecNmsub(e1z, e2y, VecMul(e1y, e2z));
+			vec_float ny = VecNmsub(e1x, e2z, VecMul(e1z, e2x));
+			vec_float nz = VecNmsub(e1y, e2x, VecMul(e1x, e2y));
+			vec_float m = VecSqrt(VecMadd(nx, nx, VecMadd(ny, ny, VecMul(nz, nz))));
+
+			VecStore(nx, group->normal[0]);
+			VecStore(ny, group->normal[1]);
+			VecStore(nz, group->normal[2]);
+			VecStore(m, group->magnitude);
+
+			// Every interior angle has a sine proportional to the magnitude of the normal, so each angle is the
+			// arctangent of the magnitude and the dot product of the two edges leaving the corresponding vertex.
+
+			vec_float d12 = VecMadd(e1x, e2x, VecMadd(e1y, e2y, VecMul(e1z, e2z)));
+			vec_float d11 = VecMadd(e1x, e1x, VecMadd(e1y, e1y, VecMul(e1z, e1z)));
+			vec_float d22 = VecMadd(e2x, e2x, VecMadd(e2y, e2y, VecMul(e2z, e2z)));
+
+			VecStore(VecArctan(m, d12), group->angle[0]);
+			VecStore(VecArctan(m, VecSub(d11, d12)), group->angle[1]);
+			VecStore(VecArctan(m, VecSub(d22, d12)), group->angle[2]);
+
+			if (texcoord)
+			{
+				vec_float du1 = VecLoad(uv[0]);
+				vec_float dv1 = VecLoad(uv[1]);
+				vec_float du2 = VecLoad(uv[2]);
+				vec_float dv2 = VecLoad(uv[3]);
+
+				// The tangent and bitangent are (e1 dv2 - e2 dv1) / r and (e2 du1 - e1 du2) / r. Only their directions
+				// are needed, so they are multiplied by the sign of r instead of being divided by r.
+
+				vec_float r = VecNmsub(du2, dv1, VecMul(du1, dv2));
+				vec_float s = VecAnd(r, VecFloatGetMinusZero());
+
+				VecStore(VecXor(VecNmsub(e2x, dv1, VecMul(e1x, dv2)), s), group->tangent[0]);
+				VecStore(VecXor(VecNmsub(e2y, dv1, VecMul(e1y, dv2)), s), group->tangent[1]);
+				VecStore(VecXor(VecNmsub(e2z, dv1, VecMul(e1z, dv2)), s), group->tangent[2]);
+				VecStore(VecXor(VecNmsub(e1x, du2, VecMul(e2x, du1)), s), group->bitangent[0]);
+				VecStore(VecXor(VecNmsub(e1y, du2, VecMul(e2y, du1)), s), group->bitangent[1]);
+				VecStore(VecXor(VecNmsub(e1z, du2, VecMul(e2z, du1)), s), group->bitangent[2]);
+				VecStore(r, group->uvArea);
+			}
+
+		#else
+
+			for (machine k = 0; k < 4; k++)
+			{
+				Vector3D e1(edge[0][k], edge[1][k], edge[2][k]);
+				Vector3D e2(edge[3][k], edge[4][k], edge[5][k]);
+
+				Vector3D n = Cross(e1, e2);
+				float m = Magnitude(n);
+				group->normal[0][k] = n.x;
+				group->normal[1][k] = n.y;
+				group->normal[2][k] = n.z;
+				group->magnitude[k] = m;
+
+				float d12 = Dot(e1, e2);
+				group->angle[0][k] = Arctan(m, d12);
+				group->angle[1][k] = Arctan(m, SquaredMag(e1) - d12);
+				group->angle[2][k] = Arctan(m, SquaredMag(e2) - d12);
+
+				if (texcoord)
+				{
+					float r = uv[0][k] * uv[3][k] - uv[2][k] * uv[1][k];
+					float s = (r < 0.0F) ? -1.0F : 1.0F;
+					Vector3D t = (e1 * uv[3][k] - e2 * uv[1][k]) * s;
+					Vector3D b = (e2 * uv[0][k] - e1 * uv[2][k]) * s;
+
+					for (machine a = 0; a < 3; a++)
+					{
+						group->tangent[a][k] = t[a];
+						group->bitangent[a][k] = b[a];
+					}
+
+					group->uvArea[k] = r;
+				}
+			}
+
+		#endif
+	}
+
+	inline Vector3D GetGroupVector(const float (& v)[3][4], machine k)
+	{
+		return (Vector3D(v[0][k], v[1][k], v[2][k]));
+	}
+}
+
+
+/// @brief Calculates the unit normals of the triangles in a mesh.
+///
+/// The normal of a triangle with vertices <b>p</b><sub>0</sub>, <b>p</b><sub>1</sub>, and <b>p</b><sub>2</sub> points in the direction of
+/// (<b>p</b><sub>1</sub>&nbsp;&minus;&nbsp;<b>p</b><sub>0</sub>)&nbsp;&times;&nbsp;(<b>p</b><sub>2</sub>&nbsp;&minus;&nbsp;<b>p</b><sub>0</sub>), so it faces
+/// toward a viewer who sees the vertices wound counterclockwise. The triangles are processed four at a time with SIMD instructions.
+/// The normal of a degenerate triangle is zero.
+///
+/// @param triangleCount	The number of triangles.
+/// @param triangleIndex	A pointer to an array of 3&nbsp;&times;&nbsp;<tt>triangleCount</tt> vertex indices.
+/// @param vertex			A pointer to the array of vertex positions.
+/// @param normal			A pointer to an array that receives one normal for each triangle.
+/// @relatedalso Vector3D
+
+void Terathon::CalculateFaceNormals(int32 triangleCount, const int32 *triangleIndex, const Point3D *vertex, Vector3D *normal)
+{
+	FaceGroup	group;
+
+	for (machine i = 0; i < triangleCount; i += 4)
+	{
+		int32 count = (triangleCount - i < 4) ? int32(triangleCount - i) : 4;
+		CalculateFaceGroup(vertex, nullptr, triangleIndex + i * 3, count, &group);
+
+		for (machine k = 0; k < count; k++)
+		{
+			float m = group.magnitude[k];
+			float f = (m > Math::min_float) ? 1.0F / m : 0.0F;
+			normal[i + k] = GetGroupVector(group.normal, k) * f;
+		}
+	}
+}
+
+/// @brief Calculates the unit normals at the vertices of a mesh.
+///
+/// The normal at each vertex is the normalized weighted sum of the normals of the triangles that use the vertex.
+/// The weights are determined by the \c weighting parameter. Angle weighting is the usual choice because the result
+/// depends only on the shape of the surface and not on how it is triangulated. The normal of a vertex that is not used by
+/// any nondegenerate triangle is zero.
+///
+/// Face quantities are calculated four triangles at a time with SIMD instructions, and they are then accumulated into the
+/// vertex normals in triangle order, so the results are identical every time the same mesh is processed.
+///
+/// @param vertexCount		The number of vertices.
+/// @param vertex			A pointer to an array of \c vertexCount vertex positions.
+/// @param triangleCount	The number of triangles.
+/// @param triangleIndex	A pointer to an array of 3&nbsp;&times;&nbsp;<tt>triangleCount</tt> vertex indices.
+/// @param normal			A pointer to an array that receives \c vertexCount vertex normals.
+/// @param weighting		The weighting method, which must be \c kNormalWeightArea or \c kNormalWeightAngle.
+/// @relatedalso Vector3D
+
+void Terathon::CalculateVertexNormals(int32 vertexCount, const Point3D *vertex, int32 triangleCount, const int32 *triangleIndex, Vector3D *normal, uint32 weighting)
+{
+	FaceGroup	group;
+
+	for (machine j = 0; j < vertexCount; j++)
+	{
+		normal[j].Set(0.0F, 0.0F, 0.0F);
+	}
+
+	for (machine i = 0; i < triangleCount; i += 4)
+	{
+		int32 count = (triangleCount - i < 4) ? int32(triangleCount - i) : 4;
+		const int32 *index = triangleIndex + i * 3;
+		CalculateFaceGroup(vertex, nullptr, index, count, &group);
+
+		for (machine k = 0; k < count; k++)
+		{
+			float m = group.magnitude[k];
+			if (m > Math::min_float)
+			{
+				Vector3D n = GetGroupVector(group.normal, k);
+
+				if (weighting == kNormalWeightAngle)
+				{
+					n /= m;
+					normal[index[0]] += n * group.angle[0][k];
+					normal[index[1]] += n * group.angle[1][k];
+					normal[index[2]] += n * group.angle[2][k];
+				}
+				else
+				{
+					normal[index[0]] += n;
+					normal[index[1]] += n;
+					normal[index[2]] += n;
+				}
+			}
+
+			index += 3;
+		}
+	}
+
+	for (machine j = 0; j < vertexCount; j++)
+	{
+		float m2 = SquaredMag(normal[j]);
+		if (m2 > Math::min_float)
+		{
+			normal[j] *= InverseSqrt(m2);
+		}
+	}
+}
+
+/// @brief Calculates the tangent frames at the vertices of a mesh.
+///
+/// The tangent at each vertex is aligned with the direction in which the <i>u</i> texture coordinate increases, and it is
+/// made perpendicular to the vertex normal. The tangents follow the conventions used by MikkTSpace. Each triangle contributes its
+/// tangent direction projected onto the plane perpendicular to the vertex normal, normalized, and weighted by the angle of the
+/// triangle at the vertex. Triangles whose texture coordinates are degenerate make no contribution.
+///
+/// The <i>x</i>, <i>y</i>, and <i>z</i> coordinates of each result hold the unit tangent <b>t</b>, and the <i>w</i> coordinate holds
+/// the handedness &plusmn;1. The bitangent is reconstructed as <i>w</i>(<b>n</b>&nbsp;&times;&nbsp;<b>t</b>), where <b>n</b> is the
+/// vertex normal. Where the triangles sharing a vertex disagree about the handedness, the sign chosen is the one having the greater
+/// total weight. If no triangle contributes a tangent to a vertex, then an arbitrary unit vector perpendicular to the normal is used.
+///
+/// @param vertexCount		The number of vertices.
+/// @param vertex			A pointer to an array of \c vertexCount vertex positions.
+/// @param normal			A pointer to an array of \c vertexCount unit vertex normals, such as those calculated by the \c CalculateVertexNormals() function.
+/// @param texcoord			A pointer to an array of \c vertexCount texture coordinates.
+/// @param triangleCount	The number of triangles.
+/// @param triangleIndex	A pointer to an array of 3&nbsp;&times;&nbsp;<tt>triangleCount</tt> vertex indices.
+/// @param tangent			A pointer to an array that receives \c vertexCount tangents.
+/// @relatedalso Vector4D
+
+void Terathon::CalculateVertexTangents(int32 vertexCount, const Point3D *vertex, const Vector3D *normal, const Point2D *texcoord, int32 triangleCount, const int32 *triangleIndex, Vector4D *tangent)
+{
+	FaceGroup	group;
+
+	// The tangent sums accumulate in the xyz coordinates, and the w coordinate accumulates the signed handedness weights.
+
+	for (machine j = 0; j < vertexCount; j++)
+	{
+		tangent[j].Set(0.0F, 0.0F, 0.0F, 0.0F);
+	}
+
+	for (machine i = 0; i < triangleCount; i += 4)
+	{
+		int32 count = (triangleCount - i < 4) ? int32(triangleCount - i) : 4;
+		const int32 *index = triangleIndex + i * 3;
+		CalculateFaceGroup(vertex, texcoord, index, count, &group);
+
+		for (machine k = 0; k < count; k++)
+		{
+			if ((group.magnitude[k] > Math::min_float) && (Fabs(group.uvArea[k]) > Math::min_float))
+			{
+				Vector3D t = GetGroupVector(group.tangent, k);
+				Vector3D b = GetGroupVector(group.bitangent, k);
+
+				for (machine c = 0; c < 3; c++)
+				{
+					int32 v = index[c];
+					const Vector3D& n = normal[v];
+
+					Vector3D u = t - n * Dot(n, t);
+					float m2 = SquaredMag(u);
+					if (m2 > Math::min_float)
+					{
+						float w = group.angle[c][k];
+						u *= InverseSqrt(m2) * w;
+						tangent[v].xyz += u;
+						tangent[v].w += (Dot(Cross(n, u), b) < 0.0F) ? -w : w;
+					}
+				}
+			}
+
+			index += 3;
+		}
+	}
+
+	for (machine j = 0; j < vertexCount; j++)
+	{
+		const Vector3D& n = normal[j];
+
+		Vector3D t = tangent[j].xyz - n * Dot(n, tangent[j].xyz);
+		float m2 = SquaredMag(t);
+		if (!(m2 > Math::min_float))
+		{
+			// Choose the coordinate axis least aligned with the normal and make it perpendicular to the normal.
+
+			float ax = Fabs(n.x);
+			float ay = Fabs(n.y);
+			float az = Fabs(n.z);
+			const Vector3D& axis = ((ax < ay) && (ax < az)) ? Vector3D::x_unit : ((ay < az) ? Vector3D::y_unit : Vector3D::z_unit);
+
+			t = axis - n * Dot(n, axis);
+			m2 = SquaredMag(t);
+		}
+
+		t *= InverseSqrt(m2);
+		tangent[j].Set(t, (tangent[j].w < 0.0F) ? -1.0F : 1.0F);
+	}
+}
@@ -0,0 +1,38 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSMeshNormals_h
+#define TSMeshNormals_h
+
+
+#include "TSVector2D.h"
+#include "TSVector4D.h"
+
+
+#define TERATHON_MESHNORMALS 1
+
+
+namespace Terathon
+{
+	/// @brief Identifies how the normals of the faces sharing a vertex are weighted when the vertex normal is calculated.
+
+	enum : uint32
+	{
+		kNormalWeightArea			= 0,		///< Each face normal is weighted by the area of the face. Large faces dominate, and long thin triangles have little effect.
+		kNormalWeightAngle			= 1			///< Each face normal is weighted by the angle of the face at the vertex. The result does not depend on how the surface is triangulated.
+	};
+
+
+	TERATHON_API void CalculateFaceNormals(int32 triangleCount, const int32 *triangleIndex, const Point3D *vertex, Vector3D *normal);
+	TERATHON_API void CalculateVertexNormals(int32 vertexCount, const Point3D *vertex, int32 triangleCount, const int32 *triangleIndex, Vector3D *normal, uint32 weighting = kNormalWeightAngle);
+	TERATHON_API void CalculateVertexTangents(int32 vertexCount, const Point3D *vertex, const Vector3D *normal, const Point2D *texcoord, int32 triangleCount, const int32 *triangleIndex, Vector4D *tangent);
+}
+
+
+#endif
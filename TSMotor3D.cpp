@@ -172,9 +172,9 @@ Motor3D Terathon::operator *(const Motor3D& a, const Motor3D& b)
 	                a.v.w * b.v.y + a.v.y * b.v.w + a.v.z * b.v.x - a.v.x * b.v.z,
 	                a.v.w * b.v.z + a.v.z * b.v.w + a.v.x * b.v.y - a.v.y * b.v.x,
 	                a.v.w * b.v.w - a.v.x * b.v.x - a.v.y * b.v.y - a.v.z * b.v.z,
-	                a.m.w * b.v.z + a.m.x * b.v.y - a.m.y * b.v.x + a.m.z * b.v.w + b.m.w * a.v.z - b.m.x * a.v.y + b.m.y * a.v.x + b.m.z * a.v.w,
 	                a.m.w * b.v.x + a.m.x * b.v.w + a.m.y * b.v.z - a.m.z * b.v.y + b.m.w * a.v.x + b.m.x * a.v.w - b.m.y * a.v.z + b.m.z * a.v.y,
 	                a.m.w * b.v.y - a.m.x * b.v.z + a.m.y * b.v.w + a.m.z * b.v.x + b.m.w * a.v.y + b.m.x * a.v.z + b.m.y * a.v.w - b.m.z * a.v.x,
+	                a.m.w * b.v.z + a.m.x * b.v.y - a.m.y * b.v.x + a.m.z * b.v.w + b.m.w * a.v.z - b.m.x * a.v.y + b.m.y * a.v.x + b.m.z * a.v.w,
 	                a.m.w * b.v.w - a.m.x * b.v.x - a.m.y * b.v.y - a.m.z * b.v.z + b.m.w * a.v.w - b.m.x * a.v.x - b.m.y * a.v.y - b.m.z * a.v.z));
 }
 
@@ -184,9 +184,9 @@ Motor3D Terathon::operator *(const Motor3D& Q, const Quaternion& r)
 	                Q.v.w * r.y - Q.v.x * r.z + Q.v.y * r.w + Q.v.z * r.x,
 	                Q.v.w * r.z + Q.v.x * r.y - Q.v.y * r.x + Q.v.z * r.w,
 	                Q.v.w * r.w - Q.v.x * r.x - Q.v.y * r.y - Q.v.z * r.z,
-	                Q.m.w * r.z + Q.m.x * r.y - Q.m.y * r.x + Q.m.z * r.w,
 	                Q.m.w * r.x + Q.m.x * r.w + Q.m.y * r.z - Q.m.z * r.y,
 	                Q.m.w * r.y - Q.m.x * r.z + Q.m.y * r.w + Q.m.z * r.x,
+	                Q.m.w * r.z + Q.m.x * r.y - Q.m.y * r.x + Q.m.z * r.w,
 	                Q.m.w * r.w - Q.m.x * r.x - Q.m.y * r.y - Q.m.z * r.z));
 }
 
@@ -196,9 +196,9 @@ Motor3D Terathon::operator *(const Quaternion& r, const Motor3D& Q)
 	                r.w * Q.v.y - r.x * Q.v.z + r.y * Q.v.w + r.z * Q.v.x,
 	                r.w * Q.v.z + r.x * Q.v.y - r.y * Q.v.x + r.z * Q.v.w,
 	                r.w * Q.v.w - r.x * Q.v.x - r.y * Q.v.y - r.z * Q.v.z,
-	                r.w * Q.m.z + r.x * Q.m.y - r.y * Q.m.x + r.z * Q.m.w,
 	                r.w * Q.m.x + r.x * Q.m.w + r.y * Q.m.z - r.z * Q.m.y,
 	                r.w * Q.m.y - r.x * Q.m.z + r.y * Q.m.w + r.z * Q.m.x,
+	                r.w * Q.m.z + r.x * Q.m.y - r.y * Q.m.x + r.z * Q.m.w,
 	                r.w * Q.m.w - r.x * Q.m.x - r.y * Q.m.y - r.z * Q.m.z));
 }
 
@@ -210,6 +210,99 @@ Motor3D Terathon::Sqrt(const Motor3D& Q)
 	return (Motor3D(Q.v.x * b, Q.v.y * b, Q.v.z * b, Q.v.w * b + b, (Q.v.x * a + Q.m.x) * b, (Q.v.y * a + Q.m.y) * b, (Q.v.z * a + Q.m.z) * b, Q.m.w * (b * 0.5F)));
 }
 
+/// @brief Returns the logarithm of a unitized 3D motor.
+/// @param Q	The motor. Its weight must have unit magnitude.
+///
+/// The motor is interpreted as a screw motion through the angle 2&phi; about a unitized line <b>a</b> with a displacement
+/// of 2&delta; along that line, and the return value is the line &phi;<b>a</b>&nbsp;+&nbsp;&delta;<b>a</b><sub>v</sub>, where
+/// <b>a</b><sub>v</sub> is the direction of <b>a</b> placed in the moment components. The motors <b>Q</b> and &minus;<b>Q</b>
+/// have the same logarithm, and the angle &phi; lies in the range [0,&nbsp;&tau;/4]. For a pure translation, the direction of the result is zero,
+/// and its moment is half the translation vector. The \c Exp() function is the inverse of this function, and scaling the
+/// logarithm by <i>t</i> before calculating its exponential produces the motion that is the fraction <i>t</i> of the original motion.
+///
+/// @relatedalso Motor3D
+
+Line3D Terathon::Log(const Motor3D& Q)
+{
+	float f = (Q.v.w < 0.0F) ? -1.0F : 1.0F;
+	float vx = Q.v.x * f;
+	float vy = Q.v.y * f;
+	float vz = Q.v.z * f;
+	float c = Q.v.w * f;
+	float mx = Q.m.x * f;
+	float my = Q.m.y * f;
+	float mz = Q.m.z * f;
+
+	float s2 = vx * vx + vy * vy + vz * vz;
+	if (s2 > Math::min_float)
+	{
+		float r = InverseSqrt(s2);
+		float s = s2 * r;
+		float phi = Arctan(s, c);
+
+		// The displacement along the axis is delta = c * dot(a, m) - s * m.w, where a is the unit direction.
+
+		float delta = (vx * mx + vy * my + vz * mz) * r * c - s * Q.m.w * f;
+		float k = phi * r;
+
+		// The factor 1 - phi * cot(phi) cancels badly for small angles, so its series is used there.
+
+		float g = phi * phi;
+		float e = (phi < 0.25F) ? g * (0.33333333F + g * (0.022222222F + g * 0.0021164021F)) : 1.0F - k * c;
+		float d = e * delta * r;
+
+		return (Line3D(vx * k, vy * k, vz * k, mx * k + vx * d, my * k + vy * d, mz * k + vz * d));
+	}
+
+	return (Line3D(vx, vy, vz, mx, my, mz));
+}
+
+/// @brief Returns the exponential of a line, which is a unitized 3D motor.
+/// @param l	The line, which does not need to be unitized or satisfy the Pl&uuml;cker condition.
+///
+/// The magnitude of the direction of the line is half the angle of rotation, and the component of the moment parallel to the
+/// direction is half the displacement along the axis of rotation. This function is the inverse of the \c Log() function.
+///
+/// @relatedalso Motor3D
+
+Motor3D Terathon::Exp(const Line3D& l)
+{
+	float	c, s;
+
+	float lvlm = l.v.x * l.m.x + l.v.y * l.m.y + l.v.z * l.m.z;
+	float phi2 = l.v.x * l.v.x + l.v.y * l.v.y + l.v.z * l.v.z;
+	if (phi2 > Math::min_float)
+	{
+		float	e, k;
+
+		float r = InverseSqrt(phi2);
+		float delta = lvlm * r;
+
+		if (phi2 < 0.0625F)
+		{
+			// For small angles, the sine must be accurate relative to its own size, and the factor
+			// cos(phi) - sin(phi) / phi cancels badly, so series are used for all three quantities.
+
+			k = 1.0F - phi2 * (0.16666667F - phi2 * (0.0083333333F - phi2 * 1.9841270e-4F));
+			c = 1.0F - phi2 * (0.5F - phi2 * (0.041666667F - phi2 * (0.0013888889F - phi2 * 2.4801587e-5F)));
+			s = k * phi2 * r;
+			e = -phi2 * (0.33333333F - phi2 * (0.033333333F - phi2 * 0.0011904762F));
+		}
+		else
+		{
+			CosSin(phi2 * r, &c, &s);
+			k = s * r;
+			e = c - k;
+		}
+
+		float d = e * delta * r;
+
+		return (Motor3D(l.v.x * k, l.v.y * k, l.v.z * k, c, l.m.x * k + l.v.x * d, l.m.y * k + l.v.y * d, l.m.z * k + l.v.z * d, -delta * s));
+	}
+
+	return (Motor3D(l.v.x, l.v.y, l.v.z, 1.0F, l.m.x, l.m.y, l.m.z, -lvlm));
+}
+
 FlatPoint3D Terathon::Transform(const FlatPoint3D& p, const Motor3D& Q)
 {
 	#ifdef TERATHON_SSE
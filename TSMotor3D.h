@@ -383,6 +383,20 @@ namespace Terathon
 
 	TERATHON_API Motor3D Sqrt(const Motor3D& Q);
 
+	// ==============================================
+	//	Logarithm and exponential
+	// ==============================================
+
+	/// @brief Returns the logarithm of the unitized 3D motor \c Q.
+	/// @relatedalso Motor3D
+
+	TERATHON_API Line3D Log(const Motor3D& Q);
+
+	/// @brief Returns the exponential of the line \c l, which is a unitized 3D motor.
+	/// @relatedalso Motor3D
+
+	TERATHON_API Motor3D Exp(const Line3D& l);
+
 	// ==============================================
 	//	Transformations
 	// ==============================================
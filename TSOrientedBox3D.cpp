@@ -0,0 +1,498 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSOrientedBox3D.h"
+#include "TSEigen.h"
+#include "TSMemory.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum : uint32
+	{
+		kCovarianceSumCount			= 9,
+		kMaxRefineIterationCount	= 4
+	};
+
+
+	inline bool PointPrecedes(const Point2D& p, const Point2D& q)
+	{
+		return ((p.x < q.x) || ((p.x == q.x) && (p.y < q.y)));
+	}
+
+	void SiftDown(Point2D *point, machine root, machine end)
+	{
+		for (;;)
+		{
+			machine child = root * 2 + 1;
+			if (child >= end)
+			{
+				break;
+			}
+
+			if ((child + 1 < end) && (PointPrecedes(point[child], point[child + 1])))
+			{
+				child++;
+			}
+
+			if (!PointPrecedes(point[root], point[child]))
+			{
+				break;
+			}
+
+			Point2D t = point[root];
+			point[root] = point[child];
+			point[child] = t;
+			root = child;
+		}
+	}
+
+	void SortPoints(int32 count, Point2D *point)
+	{
+		// Heap sort by x coordinate and then by y coordinate.
+
+		for (machine i = count / 2 - 1; i >= 0; i--)
+		{
+			SiftDown(point, i, count);
+		}
+
+		for (machine end = count - 1; end > 0; end--)
+		{
+			Point2D t = point[0];
+			point[0] = point[end];
+			point[end] = t;
+			SiftDown(point, 0, end);
+		}
+	}
+
+	inline float Cross2D(const Point2D& o, const Point2D& a, const Point2D& b)
+	{
+		return ((a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x));
+	}
+
+	int32 BuildConvexHull(int32 count, Point2D *point, Point2D *hull)
+	{
+		// Build the hull in counterclockwise order with Andrew's monotone chain algorithm. Collinear points are removed.
+
+		SortPoints(count, point);
+
+		int32 hullCount = 0;
+		for (machine i = 0; i < count; i++)
+		{
+			while ((hullCount >= 2) && (Cross2D(hull[hullCount - 2], hull[hullCount - 1], point[i]) <= 0.0F))
+			{
+				hullCount--;
+			}
+
+			hull[hullCount++] = point[i];
+		}
+
+		int32 lowerCount = hullCount + 1;
+		for (machine i = count - 2; i >= 0; i--)
+		{
+			while ((hullCount >= lowerCount) && (Cross2D(hull[hullCount - 2], hull[hullCount - 1], point[i]) <= 0.0F))
+			{
+				hullCount--;
+			}
+
+			hull[hullCount++] = point[i];
+		}
+
+		// The last point duplicates the first point.
+
+		return ((hullCount > 1) ? hullCount - 1 : hullCount);
+	}
+
+	Vector2D FindMinimumAreaRectangle(int32 hullCount, const Point2D *hull)
+	{
+		// One side of the minimum-area rectangle enclosing a convex polygon is collinear with an edge of the polygon.
+		// The rotating calipers visit the edges in order while advancing the vertices having the maximum projection onto
+		// the edge direction, the minimum projection onto the edge direction, and the maximum distance from the edge.
+
+		if (hullCount < 2)
+		{
+			return (Vector2D(1.0F, 0.0F));
+		}
+
+		if (hullCount == 2)
+		{
+			return (Normalize(hull[1] - hull[0]));
+		}
+
+		Vector2D bestDirection(1.0F, 0.0F);
+		float bestArea = Math::infinity;
+
+		int32 a = 0;
+		int32 b = 0;
+		int32 c = 0;
+
+		for (machine i = 0; i < hullCount; i++)
+		{
+			machine j = (i + 1 < hullCount) ? i + 1 : 0;
+			Vector2D e = hull[j] - hull[i];
+			float m2 = e.x * e.x + e.y * e.y;
+			if (!(m2 > Math::min_float))
+			{
+				continue;
+			}
+
+			Vector2D u = e * InverseSqrt(m2);
+			Vector2D v(-u.y, u.x);
+
+			if (bestArea == Math::infinity)
+			{
+				for (machine k = 1; k < hullCount; k++)
+				{
+					if (Dot(u, hull[k] - hull[a]) > 0.0F)
+					{
+						a = int32(k);
+					}
+
+					if (Dot(v, hull[k] - hull[b]) > 0.0F)
+					{
+						b = int32(k);
+					}
+
+					if (Dot(u, hull[k] - hull[c]) < 0.0F)
+					{
+						c = int32(k);
+					}
+				}
+			}
+			else
+			{
+				for (machine k = 0; k < hullCount; k++)
+				{
+					int32 n = (a + 1 < hullCount) ? a + 1 : 0;
+					if (!(Dot(u, hull[n] - hull[a]) > 0.0F))
+					{
+						break;
+					}
+
+					a = n;
+				}
+
+				for (machine k = 0; k < hullCount; k++)
+				{
+					int32 n = (b + 1 < hullCount) ? b + 1 : 0;
+					if (!(Dot(v, hull[n] - hull[b]) > 0.0F))
+					{
+						break;
+					}
+
+					b = n;
+				}
+
+				for (machine k = 0; k < hullCount; k++)
+				{
+					int32 n = (c + 1 < hullCount) ? c + 1 : 0;
+					if (!(Dot(u, hull[n] - hull[c]) < 0.0F))
+					{
+						break;
+					}
+
+					c = n;
+				}
+			}
+
+			float area = Dot(u, hull[a] - hull[c]) * Dot(v, hull[b] - hull[i]);
+			if (area < bestArea)
+			{
+				bestArea = area;
+				bestDirection = u;
+			}
+		}
+
+		return (bestDirection);
+	}
+}
+
+
+/// @brief Calculates the centroid and covariance matrix of an array of points.
+///
+/// The sums of the coordinates and their pairwise products are accumulated in a single pass over the points, four points at a time
+/// with SIMD instructions. The coordinates are taken relative to the first point so that the covariance does not lose precision when the
+/// points are far from the origin. The covariance is normalized by the number of points.
+///
+/// @param count		The number of points. This must be at least 1.
+/// @param point		A pointer to an array of \c count points.
+/// @param centroid		A pointer to a location that receives the centroid of the points.
+/// @param covariance	A pointer to a location that receives the covariance matrix of the points.
+/// @relatedalso OrientedBox3D
+
+void Terathon::CalculatePointCovariance(int32 count, const Point3D *point, Point3D *centroid, Matrix3D *covariance)
+{
+	const Point3D& origin = point[0];
+	float sum[kCovarianceSumCount] = {};
+	machine i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		if (count >= 4)
+		{
+			vec_float	acc[kCovarianceSumCount];
+
+			for (machine k = 0; k < kCovarianceSumCount; k++)
+			{
+				acc[k] = VecFloatGetZero();
+			}
+
+			vec_float ox = VecLoadSmearScalar(&origin.x);
+			vec_float oy = VecLoadSmearScalar(&origin.y);
+			vec_float oz = VecLoadSmearScalar(&origin.z);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				vec_float	x, y, z;
+
+				VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+				x = VecSub(x, ox);
+				y = VecSub(y, oy);
+				z = VecSub(z, oz);
+
+				acc[0] = VecAdd(acc[0], x);
+				acc[1] = VecAdd(acc[1], y);
+				acc[2] = VecAdd(acc[2], z);
+				acc[3] = VecMadd(x, x, acc[3]);
+				acc[4] = VecMadd(x, y, acc[4]);
+				acc[5] = VecMadd(x, z, acc[5]);
+				acc[6] = VecMadd(y, y, acc[6]);
+				acc[7] = VecMadd(y, z, acc[7]);
+				acc[8] = VecMadd(z, z, acc[8]);
+			}
+
+			alignas(16) float	value[4];
+
+			for (machine k = 0; k < kCovarianceSumCount; k++)
+			{
+				VecStore(acc[k], value);
+				sum[k] = (value[0] + value[1]) + (value[2] + value[3]);
+			}
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		Vector3D v = point[i] - origin;
+		sum[0] += v.x;
+		sum[1] += v.y;
+		sum[2] += v.z;
+		sum[3] += v.x * v.x;
+		sum[4] += v.x * v.y;
+		sum[5] += v.x * v.z;
+		sum[6] += v.y * v.y;
+		sum[7] += v.y * v.z;
+		sum[8] += v.z * v.z;
+	}
+
+	float f = 1.0F / float(count);
+	float mx = sum[0] * f;
+	float my = sum[1] * f;
+	float mz = sum[2] * f;
+
+	float cxx = sum[3] * f - mx * mx;
+	float cxy = sum[4] * f - mx * my;
+	float cxz = sum[5] * f - mx * mz;
+	float cyy = sum[6] * f - my * my;
+	float cyz = sum[7] * f - my * mz;
+	float czz = sum[8] * f - mz * mz;
+
+	centroid->Set(origin.x + mx, origin.y + my, origin.z + mz);
+	covariance->Set(cxx, cxy, cxz, cxy, cyy, cyz, cxz, cyz, czz);
+}
+
+/// @brief Calculates the oriented box having given axis directions that tightly bounds an array of points.
+///
+/// The points are projected onto each of the box axes four at a time with SIMD instructions, and the extents of the box are
+/// determined by the minimum and maximum projections.
+///
+/// @param count		The number of points. This must be at least 1.
+/// @param point		A pointer to an array of \c count points.
+/// @param rotation		The rotation matrix whose columns are the unit directions of the box axes.
+/// @relatedalso OrientedBox3D
+
+OrientedBox3D Terathon::CalculateOrientedBox(int32 count, const Point3D *point, const Matrix3D& rotation)
+{
+	const Point3D& origin = point[0];
+
+	float	pmin[3] = {0.0F, 0.0F, 0.0F};
+	float	pmax[3] = {0.0F, 0.0F, 0.0F};
+
+	machine i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		vec_float	axis[3][3];
+		vec_float	vmin[3];
+		vec_float	vmax[3];
+
+		for (machine a = 0; a < 3; a++)
+		{
+			for (machine k = 0; k < 3; k++)
+			{
+				float f = rotation(k,a);
+				axis[a][k] = VecLoadSmearScalar(&f);
+			}
+
+			vmin[a] = VecFloatGetZero();
+			vmax[a] = VecFloatGetZero();
+		}
+
+		vec_float ox = VecLoadSmearScalar(&origin.x);
+		vec_float oy = VecLoadSmearScalar(&origin.y);
+		vec_float oz = VecLoadSmearScalar(&origin.z);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			vec_float	x, y, z;
+
+			VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+			x = VecSub(x, ox);
+			y = VecSub(y, oy);
+			z = VecSub(z, oz);
+
+			for (machine a = 0; a < 3; a++)
+			{
+				vec_float d = VecMadd(x, axis[a][0], VecMadd(y, axis[a][1], VecMul(z, axis[a][2])));
+				vmin[a] = VecMin(vmin[a], d);
+				vmax[a] = VecMax(vmax[a], d);
+			}
+		}
+
+		alignas(16) float	value[2][4];
+
+		for (machine a = 0; a < 3; a++)
+		{
+			VecStore(vmin[a], value[0]);
+			VecStore(vmax[a], value[1]);
+			pmin[a] = Fmin(Fmin(value[0][0], value[0][1]), Fmin(value[0][2], value[0][3]));
+			pmax[a] = Fmax(Fmax(value[1][0], value[1][1]), Fmax(value[1][2], value[1][3]));
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		Vector3D v = point[i] - origin;
+		for (machine a = 0; a < 3; a++)
+		{
+			float d = Dot(v, rotation[a]);
+			pmin[a] = Fmin(pmin[a], d);
+			pmax[a] = Fmax(pmax[a], d);
+		}
+	}
+
+	Vector3D mid((pmin[0] + pmax[0]) * 0.5F, (pmin[1] + pmax[1]) * 0.5F, (pmin[2] + pmax[2]) * 0.5F);
+	Vector3D halfExtent((pmax[0] - pmin[0]) * 0.5F, (pmax[1] - pmin[1]) * 0.5F, (pmax[2] - pmin[2]) * 0.5F);
+	return (OrientedBox3D(origin + rotation * mid, rotation, halfExtent));
+}
+
+/// @brief Calculates an oriented box that tightly bounds an array of points.
+///
+/// The axes of the box are the principal axes of the points, which are the eigenvectors of their covariance matrix, ordered so that
+/// the first axis has the greatest spread. The extents of the box are then determined by projecting the points onto the axes.
+///
+/// When \c refine is \c true, each axis of the box is held fixed in turn while the points are projected onto the plane perpendicular to it,
+/// and the minimum-area rectangle enclosing the two-dimensional convex hull of the projected points is found with rotating calipers.
+/// Whenever this produces a box with a smaller volume, the box is replaced, and the process is repeated with the new axes a few times
+/// until the volume stops decreasing. Refinement matters most when the principal axes are poorly determined, such as for shapes
+/// whose spread is nearly the same in two or three directions.
+///
+/// Refinement needs temporary storage for the projected points and their convex hull, and it is taken from \c arena when one is
+/// supplied. If the temporary storage cannot be allocated at all, then the box is not refined.
+///
+/// @param count	The number of points. If this is zero, then the result is a box with zero extents centered at the origin.
+/// @param point	A pointer to an array of \c count points.
+/// @param refine	Indicates whether the box is refined with rotating calipers.
+/// @param arena	A memory arena from which temporary storage is allocated. This can be \c nullptr.
+/// @relatedalso OrientedBox3D
+
+OrientedBox3D Terathon::CalculateOrientedBox(int32 count, const Point3D *point, bool refine, MemoryArena *arena)
+{
+	Point3D		centroid;
+	Matrix3D	covariance;
+	Vector3D	eigenvalues;
+	Matrix3D	eigenvectors;
+
+	if (count <= 0)
+	{
+		return (OrientedBox3D(Point3D(0.0F, 0.0F, 0.0F), Matrix3D::identity, Vector3D(0.0F, 0.0F, 0.0F)));
+	}
+
+	CalculatePointCovariance(count, point, &centroid, &covariance);
+	CalculateEigensystem(covariance, &eigenvalues, &eigenvectors);
+
+	// Make the axes right-handed so that the rotation has a determinant of +1.
+
+	Vector3D a0 = Normalize(eigenvectors[0]);
+	Vector3D a1 = Normalize(eigenvectors[1]);
+	OrientedBox3D box = CalculateOrientedBox(count, point, Matrix3D(a0, a1, Cross(a0, a1)));
+
+	if ((refine) && (count >= 3))
+	{
+		ScratchStorage scratch(count * sizeof(Point2D) * 3, arena);
+		Point2D *storage = static_cast<Point2D *>(scratch.GetStorage());
+		if (!storage)
+		{
+			return (box);
+		}
+
+		Point2D *projection = storage;
+		Point2D *hull = storage + count;
+
+		const Point3D& origin = point[0];
+		float volume = box.GetVolume();
+
+		for (machine iteration = 0; iteration < kMaxRefineIterationCount; iteration++)
+		{
+			const Matrix3D rotation = box.rotation;
+			bool improved = false;
+
+			for (machine k = 0; k < 3; k++)
+			{
+				// The axes b1, b2, and the fixed axis form a right-handed basis.
+
+				const Vector3D& b1 = rotation[(k + 1) % 3];
+				const Vector3D& b2 = rotation[(k + 2) % 3];
+
+				for (machine i = 0; i < count; i++)
+				{
+					Vector3D v = point[i] - origin;
+					projection[i].Set(Dot(v, b1), Dot(v, b2));
+				}
+
+				int32 hullCount = BuildConvexHull(count, projection, hull);
+				Vector2D u = FindMinimumAreaRectangle(hullCount, hull);
+
+				Vector3D U = b1 * u.x + b2 * u.y;
+				Vector3D V = b2 * u.x - b1 * u.y;
+
+				OrientedBox3D candidate = CalculateOrientedBox(count, point, Matrix3D(U, V, rotation[k]));
+				float candidateVolume = candidate.GetVolume();
+				if (candidateVolume < volume * 0.999F)
+				{
+					volume = candidateVolume;
+					box = candidate;
+					improved = true;
+				}
+			}
+
+			if (!improved)
+			{
+				break;
+			}
+		}
+	}
+
+	return (box);
+}
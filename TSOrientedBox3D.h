@@ -0,0 +1,90 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSOrientedBox3D_h
+#define TSOrientedBox3D_h
+
+
+#include "TSQuaternion.h"
+#include "TSMemory.h"
+
+
+#define TERATHON_ORIENTEDBOX3D 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	OrientedBox3D
+	// ==============================================
+
+	/// @brief Encapsulates a 3D oriented box.
+	///
+	/// The \c OrientedBox3D class stores an oriented box as its center, a rotation matrix whose columns are the unit directions of
+	/// the box axes, and the half-extents of the box along those axes. The rotation matrix is orthogonal and has a determinant of +1,
+	/// so it can also be converted to a quaternion.
+
+	class OrientedBox3D
+	{
+		public:
+
+			Point3D		center;
+			Matrix3D	rotation;
+			Vector3D	halfExtent;
+
+			/// @brief Default constructor that leaves the components uninitialized.
+
+			inline OrientedBox3D() = default;
+
+			/// @brief Constructor that sets the components of the box.
+			/// @param c	The center of the box.
+			/// @param r	The rotation matrix whose columns are the directions of the box axes.
+			/// @param h	The half-extents of the box along its axes.
+
+			OrientedBox3D(const Point3D& c, const Matrix3D& r, const Vector3D& h)
+			{
+				center = c;
+				rotation = r;
+				halfExtent = h;
+			}
+
+			/// @brief Returns the unit quaternion corresponding to the rotation of the box.
+
+			Quaternion GetRotationQuaternion(void) const
+			{
+				Quaternion	q;
+
+				return (q.SetRotationMatrix(rotation));
+			}
+
+			/// @brief Returns the volume of the box.
+
+			float GetVolume(void) const
+			{
+				return (halfExtent.x * halfExtent.y * halfExtent.z * 8.0F);
+			}
+
+			/// @brief Returns a boolean value indicating whether the box contains a point.
+			/// @param p	The point to test.
+
+			bool Contains(const Point3D& p) const
+			{
+				Vector3D v = p - center;
+				return ((Fabs(Dot(v, rotation[0])) <= halfExtent.x) && (Fabs(Dot(v, rotation[1])) <= halfExtent.y) && (Fabs(Dot(v, rotation[2])) <= halfExtent.z));
+			}
+	};
+
+
+	TERATHON_API void CalculatePointCovariance(int32 count, const Point3D *point, Point3D *centroid, Matrix3D *covariance);
+	TERATHON_API OrientedBox3D CalculateOrientedBox(int32 count, const Point3D *point, bool refine = false, MemoryArena *arena = nullptr);
+	TERATHON_API OrientedBox3D CalculateOrientedBox(int32 count, const Point3D *point, const Matrix3D& rotation);
+}
+
+
+#endif
@@ -217,17 +217,17 @@ namespace Terathon
 	#undef ClearMemory
 
 
-	inline void CopyMemory(const void *source, void *dest, uint32 size)
+	inline void CopyMemory(const void *source, void *dest, umachine size)
 	{
 		memcpy(dest, source, size);
 	}
 
-	inline void FillMemory(void *ptr, uint32 size, uint8 value)
+	inline void FillMemory(void *ptr, umachine size, uint8 value)
 	{
 		memset(ptr, value, size);
 	}
 
-	inline void ClearMemory(void *ptr, uint32 size)
+	inline void ClearMemory(void *ptr, umachine size)
 	{
 		memset(ptr, 0, size);
 	}
@@ -0,0 +1,465 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSPointGrid.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	inline int32 GetBucketCountForPoints(int32 count)
+	{
+		int32 n = 1;
+		while (n < count)
+		{
+			n <<= 1;
+		}
+
+		return (n);
+	}
+
+	// The visit function is called for every point within the radius of the query point. It receives the
+	// bucket-order index of the point and its squared distance, and it returns false to end the search.
+
+	template <class visitor_type> void VisitPointsInRadius(const PointGrid *grid, const Point3D& p, float radius, visitor_type *visitor)
+	{
+		int32	cmin[3], cmax[3];
+
+		grid->GetCellCoordinates(Point3D(p.x - radius, p.y - radius, p.z - radius), cmin);
+		grid->GetCellCoordinates(Point3D(p.x + radius, p.y + radius, p.z + radius), cmax);
+
+		const Point3DArray& point = grid->GetGridPoints();
+		const float *px = point.GetX();
+		const float *py = point.GetY();
+		const float *pz = point.GetZ();
+
+		float r2 = radius * radius;
+		float f = 1.0F / grid->GetCellSize();
+
+		for (int32 k = cmin[2]; k <= cmax[2]; k++)
+		{
+			for (int32 j = cmin[1]; j <= cmax[1]; j++)
+			{
+				for (int32 i = cmin[0]; i <= cmax[0]; i++)
+				{
+					int32	start;
+
+					int32 count = grid->GetCellPoints(i, j, k, &start);
+					int32 end = start + count;
+					for (machine m = start; m < end; m++)
+					{
+						float dx = px[m] - p.x;
+						float dy = py[m] - p.y;
+						float dz = pz[m] - p.z;
+						float d2 = dx * dx + dy * dy + dz * dz;
+
+						// Points from other cells sharing the bucket are skipped so that no point is visited twice.
+
+						if ((!(d2 > r2)) && (int32(Floor(px[m] * f)) == i) && (int32(Floor(py[m] * f)) == j) && (int32(Floor(pz[m] * f)) == k))
+						{
+							if (!visitor->Visit(int32(m), d2))
+							{
+								return;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	struct RadiusVisitor
+	{
+		int32		foundCount;
+		int32		maxCount;
+		int32		*foundIndex;
+		float		*foundDistance;
+
+		const PointGrid		*grid;
+
+		bool Visit(int32 index, float d2)
+		{
+			if (foundCount < maxCount)
+			{
+				foundIndex[foundCount] = grid->GetPointIndex(index);
+				if (foundDistance)
+				{
+					foundDistance[foundCount] = d2;
+				}
+			}
+
+			foundCount++;
+			return (true);
+		}
+	};
+
+	struct NearestVisitor
+	{
+		int32		nearest;
+		float		bound;
+
+		bool Visit(int32 index, float d2)
+		{
+			if (d2 < bound)
+			{
+				bound = d2;
+				nearest = index;
+			}
+
+			return (true);
+		}
+	};
+
+	struct WeldVisitor
+	{
+		int32		cluster;
+		int32		*remap;
+
+		const PointGrid		*grid;
+
+		bool Visit(int32 index, float)
+		{
+			int32 i = grid->GetPointIndex(index);
+			if (remap[i] < 0)
+			{
+				remap[i] = cluster;
+			}
+
+			return (true);
+		}
+	};
+}
+
+
+PointGrid::PointGrid()
+{
+	pointCount = 0;
+	pointCapacity = 0;
+	bucketCount = 1;
+	cellSize = 1.0F;
+	inverseCellSize = 1.0F;
+
+	bucketStart = nullptr;
+	pointIndex = nullptr;
+	pointBucket = nullptr;
+	gridStorage = nullptr;
+}
+
+/// @brief Constructs a grid and builds it for a set of points.
+/// @param count	The number of points.
+/// @param point	A pointer to an array of \c count points.
+/// @param size		The edge length of each cell.
+
+PointGrid::PointGrid(int32 count, const Point3D *point, float size)
+{
+	pointCount = 0;
+	pointCapacity = 0;
+	bucketCount = 1;
+	cellSize = 1.0F;
+	inverseCellSize = 1.0F;
+
+	bucketStart = nullptr;
+	pointIndex = nullptr;
+	pointBucket = nullptr;
+	gridStorage = nullptr;
+
+	Build(count, point, size);
+}
+
+PointGrid::~PointGrid()
+{
+	ReleaseAligned(gridStorage);
+}
+
+void PointGrid::Release(void)
+{
+	gridPoint.SetStorage(0, nullptr);
+	ReleaseAligned(gridStorage);
+	gridStorage = nullptr;
+	bucketStart = nullptr;
+	pointIndex = nullptr;
+	pointBucket = nullptr;
+	pointCount = 0;
+	pointCapacity = 0;
+}
+
+bool PointGrid::Prepare(int32 count)
+{
+	if (count <= 0)
+	{
+		pointCount = 0;
+		bucketCount = 1;
+		gridPoint.SetStorage(0, nullptr);
+		return (false);
+	}
+
+	// The number of buckets is the smallest power of two not less than the capacity, so the
+	// bucket table fits in the storage allocated for the capacity.
+
+	int32 capacity = (count > pointCapacity) ? count : pointCapacity;
+	int32 maxBucketCount = GetBucketCountForPoints(capacity);
+	umachine bucketSize = AlignSize((maxBucketCount + 1) * sizeof(int32));
+	umachine indexSize = AlignSize(capacity * sizeof(int32));
+
+	if (count > pointCapacity)
+	{
+		Release();
+
+		gridStorage = AllocateAligned(bucketSize + indexSize * 2 + Point3DArray::GetStorageSize(capacity));
+		pointCapacity = capacity;
+	}
+
+	char *storage = static_cast<char *>(gridStorage);
+	bucketStart = reinterpret_cast<int32 *>(storage);
+	pointIndex = reinterpret_cast<int32 *>(storage + bucketSize);
+	pointBucket = reinterpret_cast<int32 *>(storage + bucketSize + indexSize);
+	gridPoint.SetStorage(count, storage + bucketSize + indexSize * 2);
+
+	pointCount = count;
+	bucketCount = GetBucketCountForPoints(count);
+	return (true);
+}
+
+/// @brief Builds the grid for a set of points, replacing any previous contents.
+/// @param count	The number of points.
+/// @param point	A pointer to an array of \c count points.
+/// @param size		The edge length of each cell. For radius queries, this is typically set to the query radius.
+///
+/// The points are copied into the grid, so the array does not need to persist after this function returns.
+
+void PointGrid::Build(int32 count, const Point3D *point, float size)
+{
+	cellSize = size;
+	inverseCellSize = 1.0F / size;
+
+	if (!Prepare(count))
+	{
+		return;
+	}
+
+	// Calculate the bucket for each point, with the cell coordinates of four points at a time
+	// calculated with SIMD instructions.
+
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		alignas(16) int32	laneCoord[12];
+
+		vec_float f = VecLoadSmearScalar(&inverseCellSize);
+		for (; i <= count - 4; i += 4)
+		{
+			vec_float	x, y, z;
+
+			VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+			VecInt32Store(VecConvertInt32(VecFloor(VecMul(x, f))), laneCoord);
+			VecInt32Store(VecConvertInt32(VecFloor(VecMul(y, f))), laneCoord + 4);
+			VecInt32Store(VecConvertInt32(VecFloor(VecMul(z, f))), laneCoord + 8);
+
+			for (machine a = 0; a < 4; a++)
+			{
+				pointBucket[i + a] = GetCellBucket(laneCoord[a], laneCoord[a + 4], laneCoord[a + 8]);
+			}
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		int32	coord[3];
+
+		GetCellCoordinates(point[i], coord);
+		pointBucket[i] = GetCellBucket(coord[0], coord[1], coord[2]);
+	}
+
+	// Sort the points into buckets with a counting sort. After the scatter pass, each entry of
+	// the start table has advanced to the start of the next bucket, so the table is shifted back.
+
+	ClearMemory(bucketStart, (bucketCount + 1) * sizeof(int32));
+	for (machine m = 0; m < count; m++)
+	{
+		bucketStart[pointBucket[m]]++;
+	}
+
+	int32 sum = 0;
+	for (machine b = 0; b < bucketCount; b++)
+	{
+		int32 n = bucketStart[b];
+		bucketStart[b] = sum;
+		sum += n;
+	}
+
+	float *x = gridPoint.GetX();
+	float *y = gridPoint.GetY();
+	float *z = gridPoint.GetZ();
+
+	for (machine m = 0; m < count; m++)
+	{
+		int32 k = bucketStart[pointBucket[m]]++;
+		const Point3D& p = point[m];
+		x[k] = p.x;
+		y[k] = p.y;
+		z[k] = p.z;
+		pointIndex[k] = int32(m);
+	}
+
+	for (machine b = bucketCount; b > 0; b--)
+	{
+		bucketStart[b] = bucketStart[b - 1];
+	}
+
+	bucketStart[0] = 0;
+}
+
+/// @brief Returns the range of points in the bucket to which a cell maps.
+/// @param i,j,k	The integer coordinates of the cell.
+/// @param start	A pointer to a location that receives the bucket-order index of the first point in the bucket.
+///
+/// The return value is the number of points in the bucket. These points include all points in the specified cell,
+/// but they can also include points in other cells that map to the same bucket.
+
+int32 PointGrid::GetCellPoints(int32 i, int32 j, int32 k, int32 *start) const
+{
+	if (pointCount == 0)
+	{
+		*start = 0;
+		return (0);
+	}
+
+	int32 b = GetCellBucket(i, j, k);
+	*start = bucketStart[b];
+	return (bucketStart[b + 1] - bucketStart[b]);
+}
+
+/// @brief Finds all points in the grid within a given distance of a point.
+/// @param p					The query point.
+/// @param radius				The maximum distance at which a point is accepted.
+/// @param maxCount				The maximum number of points to store.
+/// @param index				A pointer to an array of \c maxCount entries that receives the original indices of the points found, in no particular order.
+/// @param squaredDistance		A pointer to an array of \c maxCount entries that receives the squared distances to the points found. This can be \c nullptr.
+///
+/// The return value is the total number of points within the radius. If it is greater than \c maxCount, then only \c maxCount
+/// of those points are stored. The query examines every cell overlapping the cube enclosing the radius, so it is efficient
+/// only when the radius is not much larger than the cell size.
+
+int32 PointGrid::FindPointsInRadius(const Point3D& p, float radius, int32 maxCount, int32 *index, float *squaredDistance) const
+{
+	RadiusVisitor visitor;
+	visitor.foundCount = 0;
+	visitor.maxCount = maxCount;
+	visitor.foundIndex = index;
+	visitor.foundDistance = squaredDistance;
+	visitor.grid = this;
+
+	if (pointCount != 0)
+	{
+		VisitPointsInRadius(this, p, radius, &visitor);
+	}
+
+	return (visitor.foundCount);
+}
+
+/// @brief Finds the point in the grid nearest to a given point.
+/// @param p					The query point.
+/// @param maxDistance			The maximum distance at which a point is accepted. This must be finite.
+/// @param squaredDistance		A pointer to a location that receives the squared distance to the nearest point. This can be \c nullptr.
+///
+/// The return value is the original index of the nearest point, or -1 if no point lies within the maximum distance.
+
+int32 PointGrid::FindNearestPoint(const Point3D& p, float maxDistance, float *squaredDistance) const
+{
+	NearestVisitor visitor;
+	visitor.nearest = -1;
+	visitor.bound = maxDistance * maxDistance;
+
+	if (pointCount != 0)
+	{
+		VisitPointsInRadius(this, p, maxDistance, &visitor);
+	}
+
+	if (visitor.nearest < 0)
+	{
+		return (-1);
+	}
+
+	if (squaredDistance)
+	{
+		*squaredDistance = visitor.bound;
+	}
+
+	return (pointIndex[visitor.nearest]);
+}
+
+
+/// @brief Merges points that lie within a given distance of each other.
+/// @param count		The number of points.
+/// @param point		A pointer to an array of \c count points.
+/// @param epsilon		The distance within which points are merged.
+/// @param remap		A pointer to an array of \c count entries that receives the index of the merged point corresponding to each input point.
+/// @param result		A pointer to an array of \c count entries that receives the merged points. This can be \c nullptr.
+///
+/// The points are processed in order. Each point that has not yet been merged becomes the seed of a new merged point, and every
+/// unmerged point within the distance given by \c epsilon of the seed is merged with it. The merged points therefore appear in
+/// the order of their first occurrence, and the result does not depend on the way points are stored internally. Every point lies
+/// within \c epsilon of the merged point it is mapped to, so two points merged together can be up to 2&nbsp;&times;&nbsp;\c epsilon
+/// apart. Merging is not transitive, however, so a chain of close points is not merged into one point unless every point in the
+/// chain lies within \c epsilon of the same seed.
+///
+/// The return value is the number of merged points. A typical use is the removal of duplicate vertices from a triangle mesh,
+/// in which case the vertex indices of the triangles are replaced by the corresponding \c remap entries.
+///
+/// @relatedalso PointGrid
+
+int32 Terathon::WeldPoints(int32 count, const Point3D *point, float epsilon, int32 *remap, Point3D *result)
+{
+	if (count <= 0)
+	{
+		return (0);
+	}
+
+	// A cell size of twice the distance limits each search to at most eight cells. A zero distance
+	// still needs a positive cell size, so exactly coincident points are found in the same cell.
+
+	float size = epsilon * 2.0F;
+	if (!(size > Math::min_float))
+	{
+		size = 1.0F;
+	}
+
+	PointGrid grid(count, point, size);
+
+	for (machine i = 0; i < count; i++)
+	{
+		remap[i] = -1;
+	}
+
+	WeldVisitor visitor;
+	visitor.cluster = 0;
+	visitor.remap = remap;
+	visitor.grid = &grid;
+
+	for (machine i = 0; i < count; i++)
+	{
+		if (remap[i] < 0)
+		{
+			if (result)
+			{
+				result[visitor.cluster] = point[i];
+			}
+
+			remap[i] = visitor.cluster;
+			VisitPointsInRadius(&grid, point[i], epsilon, &visitor);
+			visitor.cluster++;
+		}
+	}
+
+	return (visitor.cluster);
+}
@@ -0,0 +1,137 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSPointGrid_h
+#define TSPointGrid_h
+
+
+#include "TSGeometryArray.h"
+
+
+#define TERATHON_POINTGRID 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	PointGrid
+	// ==============================================
+
+	/// @brief Hashed uniform grid over a set of 3D points for neighbor queries.
+	///
+	/// The \c PointGrid class divides space into cubic cells of a fixed size and maps the integer coordinates of each cell
+	/// to one of a power-of-two number of buckets with a spatial hash. The points are sorted into buckets with a counting sort
+	/// and copied into a \c Point3DArray in bucket order, so the points in each bucket occupy a contiguous range.
+	///
+	/// Because the cells are hashed, a bucket can also contain points belonging to other cells. The \c GetCellPoints() function
+	/// returns the range for the bucket to which a cell maps, and a caller iterating over neighboring cells should compare the
+	/// coordinates of each point with the cell, as the \c FindPointsInRadius() function does.
+	///
+	/// A grid does not change after it is built, so any number of threads can query it at the same time. The storage
+	/// is reused when the grid is rebuilt for no more points than before.
+
+	class PointGrid
+	{
+		private:
+
+			int32				pointCount;
+			int32				pointCapacity;
+			int32				bucketCount;
+
+			float				cellSize;
+			float				inverseCellSize;
+
+			int32				*bucketStart;
+			int32				*pointIndex;
+			int32				*pointBucket;
+			void				*gridStorage;
+
+			Point3DArray		gridPoint;
+
+			void Release(void);
+			bool Prepare(int32 count);
+			void BuildGrid(void);
+
+		public:
+
+			TERATHON_API PointGrid();
+			TERATHON_API PointGrid(int32 count, const Point3D *point, float size);
+			TERATHON_API ~PointGrid();
+
+			PointGrid(const PointGrid&) = delete;
+			PointGrid& operator =(const PointGrid&) = delete;
+
+			/// @brief Returns the number of points stored in the grid.
+
+			int32 GetPointCount(void) const
+			{
+				return (pointCount);
+			}
+
+			/// @brief Returns the number of hash buckets.
+
+			int32 GetBucketCount(void) const
+			{
+				return (bucketCount);
+			}
+
+			/// @brief Returns the edge length of each cell.
+
+			float GetCellSize(void) const
+			{
+				return (cellSize);
+			}
+
+			/// @brief Returns the points stored in the grid in bucket order.
+
+			const Point3DArray& GetGridPoints(void) const
+			{
+				return (gridPoint);
+			}
+
+			/// @brief Returns the original index of a point stored in the grid.
+			/// @param index	The bucket-order index of the point.
+
+			int32 GetPointIndex(int32 index) const
+			{
+				return (pointIndex[index]);
+			}
+
+			/// @brief Calculates the integer coordinates of the cell containing a point.
+			/// @param p		The point.
+			/// @param coord	A pointer to an array of three integers that receives the cell coordinates.
+
+			void GetCellCoordinates(const Point3D& p, int32 *coord) const
+			{
+				coord[0] = int32(Floor(p.x * inverseCellSize));
+				coord[1] = int32(Floor(p.y * inverseCellSize));
+				coord[2] = int32(Floor(p.z * inverseCellSize));
+			}
+
+			/// @brief Returns the hash bucket to which a cell maps.
+			/// @param i,j,k	The integer coordinates of the cell.
+
+			int32 GetCellBucket(int32 i, int32 j, int32 k) const
+			{
+				return (int32((uint32(i) * 0x8DA6B343U ^ uint32(j) * 0xD8163841U ^ uint32(k) * 0xCB1AB31FU) & uint32(bucketCount - 1)));
+			}
+
+			TERATHON_API void Build(int32 count, const Point3D *point, float size);
+
+			TERATHON_API int32 GetCellPoints(int32 i, int32 j, int32 k, int32 *start) const;
+			TERATHON_API int32 FindPointsInRadius(const Point3D& p, float radius, int32 maxCount, int32 *index, float *squaredDistance = nullptr) const;
+			TERATHON_API int32 FindNearestPoint(const Point3D& p, float maxDistance, float *squaredDistance = nullptr) const;
+	};
+
+
+	TERATHON_API int32 WeldPoints(int32 count, const Point3D *point, float epsilon, int32 *remap, Point3D *result = nullptr);
+}
+
+
+#endif
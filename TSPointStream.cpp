@@ -0,0 +1,292 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSPointStream.h"
+#include "TSMemory.h"
+
+
+using namespace Terathon;
+
+
+/// @brief Constructs a point stream.
+/// @param format	The layout of the records in the stream.
+/// @param size		The maximum number of records processed at one time.
+///
+/// The chunk size is rounded up to a multiple of four records, and it is never less than four.
+///
+/// The transform is initially the identity, there are no clip planes, and there is no output function.
+
+PointStream::PointStream(const PointStreamFormat& format, uint32 size)
+{
+	streamFormat = format;
+	size = (size != 0) ? size : 4;
+	chunkSize = (size <= 0xFFFFFFFCU) ? (size + 3) & ~3U : 0xFFFFFFFCU;
+
+	streamTransform.SetIdentity();
+	clipPlaneCount = 0;
+
+	outputProc = nullptr;
+	outputCookie = nullptr;
+
+	// The chunk storage holds four planar arrays of floats (x, y, z, and the clip distance)
+	// followed by separate input and output record buffers.
+
+	umachine positionSize = AlignSize(chunkSize * sizeof(float) * 4);
+	umachine recordSize = AlignSize(umachine(chunkSize) * format.recordStride);
+
+	chunkStorage = static_cast<char *>(AllocateAligned(positionSize + recordSize * 2));
+	positionBuffer = reinterpret_cast<float *>(chunkStorage);
+	inputBuffer = chunkStorage + positionSize;
+	outputBuffer = inputBuffer + recordSize;
+}
+
+PointStream::~PointStream()
+{
+	ReleaseAligned(chunkStorage);
+}
+
+/// @brief Sets the planes bounding the region in which records are kept.
+/// @param count	The number of planes. This can be zero to disable clipping, and it cannot be greater than \c kMaxClipPlaneCount.
+/// @param plane	A pointer to an array of \c count planes.
+///
+/// A record is kept only if its transformed position lies on the positive side of every plane, or on the plane itself.
+
+void PointStream::SetClipPlanes(int32 count, const Plane3D *plane)
+{
+	clipPlaneCount = (count < kMaxClipPlaneCount) ? count : kMaxClipPlaneCount;
+	for (machine a = 0; a < clipPlaneCount; a++)
+	{
+		clipPlane[a] = plane[a];
+	}
+}
+
+uint32 PointStream::ProcessChunk(const char *record, uint32 count)
+{
+	uint32 stride = streamFormat.recordStride;
+	uint32 offset = streamFormat.positionOffset;
+	bool point = (streamFormat.positionType == kPointStreamPoint);
+	int32 planeCount = (point) ? clipPlaneCount : 0;
+
+	float *x = positionBuffer;
+	float *y = x + chunkSize;
+	float *z = y + chunkSize;
+	float *d = z + chunkSize;
+
+	// Gather the positions from the records into planar arrays. The final group of
+	// four is padded with zeros so the SIMD loops never read uninitialized values.
+
+	const char *position = record + offset;
+	for (uint32 i = 0; i < count; i++)
+	{
+		const float *p = reinterpret_cast<const float *>(position);
+		x[i] = p[0];
+		y[i] = p[1];
+		z[i] = p[2];
+		position += stride;
+	}
+
+	uint32 paddedCount = (count + 3) & ~3;
+	for (uint32 i = count; i < paddedCount; i++)
+	{
+		x[i] = 0.0F;
+		y[i] = 0.0F;
+		z[i] = 0.0F;
+	}
+
+	const Transform3D& M = streamTransform;
+	float tx = (point) ? M(0,3) : 0.0F;
+	float ty = (point) ? M(1,3) : 0.0F;
+	float tz = (point) ? M(2,3) : 0.0F;
+
+	#ifndef TERATHON_NO_SIMD
+
+		vec_float m00 = VecLoadSmearScalar(&M(0,0)), m01 = VecLoadSmearScalar(&M(0,1)), m02 = VecLoadSmearScalar(&M(0,2));
+		vec_float m10 = VecLoadSmearScalar(&M(1,0)), m11 = VecLoadSmearScalar(&M(1,1)), m12 = VecLoadSmearScalar(&M(1,2));
+		vec_float m20 = VecLoadSmearScalar(&M(2,0)), m21 = VecLoadSmearScalar(&M(2,1)), m22 = VecLoadSmearScalar(&M(2,2));
+		vec_float m03 = VecLoadSmearScalar(&tx), m13 = VecLoadSmearScalar(&ty), m23 = VecLoadSmearScalar(&tz);
+
+		for (uint32 i = 0; i < paddedCount; i += 4)
+		{
+			vec_float px = VecLoad(x + i);
+			vec_float py = VecLoad(y + i);
+			vec_float pz = VecLoad(z + i);
+
+			vec_float qx = VecMadd(m02, pz, VecMadd(m01, py, VecMadd(m00, px, m03)));
+			vec_float qy = VecMadd(m12, pz, VecMadd(m11, py, VecMadd(m10, px, m13)));
+			vec_float qz = VecMadd(m22, pz, VecMadd(m21, py, VecMadd(m20, px, m23)));
+
+			VecStore(qx, x + i);
+			VecStore(qy, y + i);
+			VecStore(qz, z + i);
+
+			if (planeCount != 0)
+			{
+				const Plane3D *g = clipPlane;
+				vec_float dist = VecMadd(VecLoadSmearScalar(&g->z), qz, VecMadd(VecLoadSmearScalar(&g->y), qy, VecMadd(VecLoadSmearScalar(&g->x), qx, VecLoadSmearScalar(&g->w))));
+				for (machine a = 1; a < planeCount; a++)
+				{
+					g++;
+					dist = VecMin(dist, VecMadd(VecLoadSmearScalar(&g->z), qz, VecMadd(VecLoadSmearScalar(&g->y), qy, VecMadd(VecLoadSmearScalar(&g->x), qx, VecLoadSmearScalar(&g->w)))));
+				}
+
+				VecStore(dist, d + i);
+			}
+		}
+
+	#else
+
+		for (uint32 i = 0; i < count; i++)
+		{
+			float px = x[i];
+			float py = y[i];
+			float pz = z[i];
+
+			float qx = M(0,0) * px + M(0,1) * py + M(0,2) * pz + tx;
+			float qy = M(1,0) * px + M(1,1) * py + M(1,2) * pz + ty;
+			float qz = M(2,0) * px + M(2,1) * py + M(2,2) * pz + tz;
+
+			x[i] = qx;
+			y[i] = qy;
+			z[i] = qz;
+
+			if (planeCount != 0)
+			{
+				float dist = clipPlane[0].x * qx + clipPlane[0].y * qy + clipPlane[0].z * qz + clipPlane[0].w;
+				for (machine a = 1; a < planeCount; a++)
+				{
+					const Plane3D& g = clipPlane[a];
+					dist = Fmin(dist, g.x * qx + g.y * qy + g.z * qz + g.w);
+				}
+
+				d[i] = dist;
+			}
+		}
+
+	#endif
+
+	// Copy the surviving records to the output buffer and replace their positions.
+
+	uint32 outputCount = 0;
+	char *output = outputBuffer;
+	for (uint32 i = 0; i < count; i++)
+	{
+		if ((planeCount == 0) || (d[i] >= 0.0F))
+		{
+			CopyMemory(record + i * stride, output, stride);
+			float *p = reinterpret_cast<float *>(output + offset);
+			p[0] = x[i];
+			p[1] = y[i];
+			p[2] = z[i];
+
+			output += stride;
+			outputCount++;
+		}
+	}
+
+	if ((outputCount != 0) && (outputProc))
+	{
+		(*outputProc)(outputBuffer, outputCount, outputCookie);
+	}
+
+	return (outputCount);
+}
+
+/// @brief Processes records stored in memory.
+/// @param record	A pointer to the first record.
+/// @param count	The number of records.
+///
+/// The return value is the total number of records passed to the output function.
+
+uint64 PointStream::Process(const void *record, uint64 count)
+{
+	uint64 outputCount = 0;
+	const char *data = static_cast<const char *>(record);
+
+	while (count != 0)
+	{
+		uint32 n = (count < chunkSize) ? uint32(count) : chunkSize;
+		outputCount += ProcessChunk(data, n);
+		data += uint64(n) * streamFormat.recordStride;
+		count -= n;
+	}
+
+	return (outputCount);
+}
+
+/// @brief Processes records stored in a memory-mapped file.
+/// @param file		The mapped file.
+/// @param offset	The byte offset of the first record within the file.
+/// @param count	The maximum number of records. This is reduced if the file ends before the last record.
+///
+/// Before each chunk is processed, the operating system is asked to begin loading the next chunk, and after each chunk
+/// is processed, every page preceding the next chunk is evicted so that the resident size of the mapping stays bounded.
+/// The return value is the total number of records passed to the output function.
+
+uint64 PointStream::Process(const MappedFile *file, uint64 offset, uint64 count)
+{
+	uint64 stride = streamFormat.recordStride;
+	uint64 fileSize = file->GetSize();
+	if ((stride == 0) || (offset >= fileSize))
+	{
+		return (0);
+	}
+
+	uint64 available = (fileSize - offset) / stride;
+	count = (count < available) ? count : available;
+
+	const char *data = static_cast<const char *>(file->GetData());
+	uint64 chunkBytes = chunkSize * stride;
+	uint64 outputCount = 0;
+
+	// The eviction offset trails the end of the processed records by less than one page. The page straddling the end of one
+	// chunk is evicted along with the next chunk, and a final chunk reaching the end of the file takes the last page with it.
+
+	uint64 evictOffset = offset;
+
+	file->Prefetch(offset, chunkBytes);
+	while (count != 0)
+	{
+		uint32 n = (count < chunkSize) ? uint32(count) : chunkSize;
+		uint64 size = n * stride;
+
+		file->Prefetch(offset + size, chunkBytes);
+		outputCount += ProcessChunk(data + offset, n);
+
+		offset += size;
+		count -= n;
+
+		evictOffset = file->Evict(evictOffset, offset - evictOffset);
+	}
+
+	return (outputCount);
+}
+
+/// @brief Processes records read from a sequential source.
+/// @param proc		The function called to read each chunk of records.
+/// @param cookie	A user-defined pointer passed to the read function.
+///
+/// The read function is called repeatedly until it returns zero.
+/// The return value is the total number of records passed to the output function.
+
+uint64 PointStream::Process(PointStreamReadProc *proc, void *cookie)
+{
+	uint64 outputCount = 0;
+	for (;;)
+	{
+		uint32 n = (*proc)(inputBuffer, chunkSize, cookie);
+		if (n == 0)
+		{
+			break;
+		}
+
+		outputCount += ProcessChunk(inputBuffer, (n < chunkSize) ? n : chunkSize);
+	}
+
+	return (outputCount);
+}
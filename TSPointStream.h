@@ -0,0 +1,162 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSPointStream_h
+#define TSPointStream_h
+
+
+#include "TSMotor3D.h"
+#include "TSMappedFile.h"
+
+
+#define TERATHON_POINTSTREAM 1
+
+
+namespace Terathon
+{
+	/// @brief Identifies how the position field of a point stream record is transformed.
+
+	enum : uint32
+	{
+		kPointStreamPoint		= 0,		///< The field holds a Point3D, and it receives the full transform, including translation.
+		kPointStreamVector		= 1			///< The field holds a Vector3D, and it receives only the linear part of the transform. Clip planes are ignored.
+	};
+
+
+	/// @brief Describes the layout of the records in a point stream.
+	///
+	/// Each record has a fixed size and holds three consecutive floating-point values at a fixed byte offset that are treated
+	/// as a point or vector. Any other bytes in the record are extra attributes that are copied to the output unchanged.
+
+	struct PointStreamFormat
+	{
+		uint32		recordStride;			///< The size of each record, in bytes.
+		uint32		positionOffset;			///< The byte offset of the position field within each record.
+		uint32		positionType;			///< The way in which the position field is transformed.
+	};
+
+
+	/// @brief The type of function called to read the next group of records from a sequential source.
+	/// @param buffer		A pointer to the buffer that receives the records.
+	/// @param maxCount		The maximum number of records that may be written to the buffer.
+	/// @param cookie		The user-defined pointer passed to the \c PointStream::Process() function.
+	///
+	/// The function should return the number of records that were read. A return value of zero ends the stream.
+
+	typedef uint32 PointStreamReadProc(void *buffer, uint32 maxCount, void *cookie);
+
+	/// @brief The type of function called to write a group of transformed records.
+	/// @param record		A pointer to the transformed records, stored with the stride given by the stream format.
+	/// @param count		The number of records.
+	/// @param cookie		The user-defined pointer passed to the \c PointStream::SetOutputProc() function.
+
+	typedef void PointStreamWriteProc(const void *record, uint32 count, void *cookie);
+
+
+	// ==============================================
+	//	PointStream
+	// ==============================================
+
+	/// @brief Transforms and filters a sequence of point records in fixed-size chunks.
+	///
+	/// The \c PointStream class reads point records from memory, a memory-mapped file, or a sequential source, applies a rigid
+	/// transform to the position field of each record, optionally discards records lying outside a convex region bounded by a set
+	/// of planes, and passes the surviving records to an output function one chunk at a time. The memory used by the stream is
+	/// proportional to the chunk size and never depends on the total number of records.
+	///
+	/// When reading from a memory-mapped file, the next chunk is prefetched while the current chunk is being processed, and chunks
+	/// that have been processed are evicted from memory.
+
+	class PointStream
+	{
+		public:
+
+			enum
+			{
+				kDefaultChunkSize		= 65536,
+				kMaxClipPlaneCount		= 16
+			};
+
+		private:
+
+			PointStreamFormat			streamFormat;
+			uint32						chunkSize;
+
+			Transform3D					streamTransform;
+			int32						clipPlaneCount;
+			Plane3D						clipPlane[kMaxClipPlaneCount];
+
+			PointStreamWriteProc		*outputProc;
+			void						*outputCookie;
+
+			char						*chunkStorage;
+			float						*positionBuffer;
+			char						*inputBuffer;
+			char						*outputBuffer;
+
+			uint32 ProcessChunk(const char *record, uint32 count);
+
+		public:
+
+			TERATHON_API PointStream(const PointStreamFormat& format, uint32 size = kDefaultChunkSize);
+			TERATHON_API ~PointStream();
+
+			PointStream(const PointStream&) = delete;
+			PointStream& operator =(const PointStream&) = delete;
+
+			/// @brief Returns the maximum number of records processed at one time.
+
+			uint32 GetChunkSize(void) const
+			{
+				return (chunkSize);
+			}
+
+			/// @brief Returns the transform applied to the position field of each record.
+
+			const Transform3D& GetTransform(void) const
+			{
+				return (streamTransform);
+			}
+
+			/// @brief Sets the transform applied to the position field of each record.
+			/// @param transform	The new transform.
+
+			void SetTransform(const Transform3D& transform)
+			{
+				streamTransform = transform;
+			}
+
+			/// @brief Sets the transform applied to the position field of each record to the one represented by a motor.
+			/// @param motor	The motor. It should be unitized.
+
+			void SetTransform(const Motor3D& motor)
+			{
+				streamTransform = motor.GetTransformMatrix();
+			}
+
+			/// @brief Sets the function that receives the transformed records.
+			/// @param proc		The output function.
+			/// @param cookie	A user-defined pointer passed to the output function.
+
+			void SetOutputProc(PointStreamWriteProc *proc, void *cookie = nullptr)
+			{
+				outputProc = proc;
+				outputCookie = cookie;
+			}
+
+			TERATHON_API void SetClipPlanes(int32 count, const Plane3D *plane);
+
+			TERATHON_API uint64 Process(const void *record, uint64 count);
+			TERATHON_API uint64 Process(const MappedFile *file, uint64 offset, uint64 count);
+			TERATHON_API uint64 Process(PointStreamReadProc *proc, void *cookie);
+	};
+}
+
+
+#endif
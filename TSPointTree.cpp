@@ -0,0 +1,726 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSPointTree.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	struct TreeStackEntry
+	{
+		int32		nodeIndex;
+		float		squaredDistance;
+	};
+
+
+	inline void SwapPoints(float *coord[3], int32 *index, int32 i, int32 j)
+	{
+		for (machine a = 0; a < 3; a++)
+		{
+			float f = coord[a][i];
+			coord[a][i] = coord[a][j];
+			coord[a][j] = f;
+		}
+
+		int32 k = index[i];
+		index[i] = index[j];
+		index[j] = k;
+	}
+
+	void SelectMedian(float *coord[3], int32 *index, int32 axis, int32 left, int32 right, int32 median)
+	{
+		// Rearrange the points in the range [left, right] so that the point at the median position has
+		// the coordinate it would have if the range were sorted, with no larger values before it and
+		// no smaller values after it.
+
+		const float *c = coord[axis];
+		while (left < right)
+		{
+			int32 middle = (left + right) >> 1;
+			if (c[middle] < c[left])
+			{
+				SwapPoints(coord, index, middle, left);
+			}
+
+			if (c[right] < c[left])
+			{
+				SwapPoints(coord, index, right, left);
+			}
+
+			if (c[right] < c[middle])
+			{
+				SwapPoints(coord, index, right, middle);
+			}
+
+			float pivot = c[middle];
+			int32 i = left;
+			int32 j = right;
+
+			do
+			{
+				while (c[i] < pivot)
+				{
+					i++;
+				}
+
+				while (pivot < c[j])
+				{
+					j--;
+				}
+
+				if (i <= j)
+				{
+					SwapPoints(coord, index, i, j);
+					i++;
+					j--;
+				}
+			} while (i <= j);
+
+			if (median <= j)
+			{
+				right = j;
+			}
+			else if (median >= i)
+			{
+				left = i;
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+
+	inline float CalculateSquaredDistance(const Point3DArray& point, int32 index, const float *q)
+	{
+		float dx = point.GetX()[index] - q[0];
+		float dy = point.GetY()[index] - q[1];
+		float dz = point.GetZ()[index] - q[2];
+		return (dx * dx + dy * dy + dz * dz);
+	}
+
+	void CalculateLeafDistances(const Point3DArray& point, int32 start, int32 count, const float *q, float *distance)
+	{
+		const float *px = point.GetX() + start;
+		const float *py = point.GetY() + start;
+		const float *pz = point.GetZ() + start;
+
+		#ifndef TERATHON_NO_SIMD
+
+			// The point streams are padded to a multiple of 16 entries, so a full vector
+			// can always be loaded even when the leaf ends at the last point in the tree.
+
+			vec_float qx = VecLoadSmearScalar(&q[0]);
+			vec_float qy = VecLoadSmearScalar(&q[1]);
+			vec_float qz = VecLoadSmearScalar(&q[2]);
+
+			for (machine i = 0; i < count; i += 4)
+			{
+				vec_float dx = VecSub(VecLoadUnaligned(px + i), qx);
+				vec_float dy = VecSub(VecLoadUnaligned(py + i), qy);
+				vec_float dz = VecSub(VecLoadUnaligned(pz + i), qz);
+				VecStore(VecMadd(dz, dz, VecMadd(dy, dy, VecMul(dx, dx))), distance + i);
+			}
+
+		#else
+
+			for (machine i = 0; i < count; i++)
+			{
+				float dx = px[i] - q[0];
+				float dy = py[i] - q[1];
+				float dz = pz[i] - q[2];
+				distance[i] = dx * dx + dy * dy + dz * dz;
+			}
+
+		#endif
+	}
+
+	// Each query type maintains a squared distance bound beyond which subtrees are not visited,
+	// and it examines the squared distances to the points in each leaf that is reached.
+
+	struct NearestQuery
+	{
+		float		bound;
+		int32		nearest;
+
+		NearestQuery(float squaredDistance, int32 index)
+		{
+			bound = squaredDistance;
+			nearest = index;
+		}
+
+		void Visit(int32 start, int32 count, const float *distance)
+		{
+			for (machine i = 0; i < count; i++)
+			{
+				if (distance[i] < bound)
+				{
+					bound = distance[i];
+					nearest = start + int32(i);
+				}
+			}
+		}
+	};
+
+	struct NearestSetQuery
+	{
+		float			bound;
+		int32			foundCount;
+		int32			maxCount;
+		int32			*nearestIndex;
+		float			*nearestDistance;
+
+		const Point3DArray		*treePoint;
+		const float				*queryPoint;
+
+		float GetDistance(int32 k) const
+		{
+			return ((nearestDistance) ? nearestDistance[k] : CalculateSquaredDistance(*treePoint, nearestIndex[k], queryPoint));
+		}
+
+		void Visit(int32 start, int32 count, const float *distance)
+		{
+			for (machine i = 0; i < count; i++)
+			{
+				float d = distance[i];
+				if (d < bound)
+				{
+					// Insert the point into the sorted list, dropping the farthest point if the list is full.
+
+					int32 k = (foundCount < maxCount) ? foundCount++ : maxCount - 1;
+					for (; k > 0; k--)
+					{
+						float e = GetDistance(k - 1);
+						if (!(e > d))
+						{
+							break;
+						}
+
+						nearestIndex[k] = nearestIndex[k - 1];
+						if (nearestDistance)
+						{
+							nearestDistance[k] = e;
+						}
+					}
+
+					nearestIndex[k] = start + int32(i);
+					if (nearestDistance)
+					{
+						nearestDistance[k] = d;
+					}
+
+					if (foundCount == maxCount)
+					{
+						bound = GetDistance(maxCount - 1);
+					}
+				}
+			}
+		}
+	};
+
+	struct RadiusQuery
+	{
+		float		bound;
+		int32		foundCount;
+		int32		maxCount;
+		int32		*foundIndex;
+		float		*foundDistance;
+
+		void Visit(int32 start, int32 count, const float *distance)
+		{
+			for (machine i = 0; i < count; i++)
+			{
+				float d = distance[i];
+				if (!(d > bound))
+				{
+					if (foundCount < maxCount)
+					{
+						foundIndex[foundCount] = start + int32(i);
+						if (foundDistance)
+						{
+							foundDistance[foundCount] = d;
+						}
+					}
+
+					foundCount++;
+				}
+			}
+		}
+	};
+
+	template <class query_type> void TraverseTree(const PointTree *tree, const float *q, query_type *query)
+	{
+		TreeStackEntry			stack[PointTree::kMaxTreeDepth];
+		alignas(16) float		distance[PointTree::kMaxLeafPointCount];
+
+		const PointTree::Node *nodeArray = tree->GetNodeArray();
+		const Point3DArray& point = tree->GetTreePoints();
+
+		int32 stackDepth = 0;
+		int32 nodeIndex = 0;
+		float nodeDistance = 0.0F;
+
+		for (;;)
+		{
+			if (!(nodeDistance > query->bound))
+			{
+				const PointTree::Node *node = &nodeArray[nodeIndex];
+				if (node->axis == PointTree::Node::kLeafAxis)
+				{
+					CalculateLeafDistances(point, node->start, node->count, q, distance);
+					query->Visit(node->start, node->count, distance);
+				}
+				else
+				{
+					// Descend into the child containing the query point first, and defer the other child
+					// with the squared distance to the splitting plane as a lower bound.
+
+					float d = q[node->axis] - node->split;
+					int32 nearIndex = nodeIndex + 1;
+					int32 farIndex = node->start;
+					if (!(d < 0.0F))
+					{
+						nearIndex = farIndex;
+						farIndex = nodeIndex + 1;
+					}
+
+					stack[stackDepth].nodeIndex = farIndex;
+					stack[stackDepth].squaredDistance = Fmax(nodeDistance, d * d);
+					stackDepth++;
+
+					nodeIndex = nearIndex;
+					continue;
+				}
+			}
+
+			if (stackDepth == 0)
+			{
+				break;
+			}
+
+			stackDepth--;
+			nodeIndex = stack[stackDepth].nodeIndex;
+			nodeDistance = stack[stackDepth].squaredDistance;
+		}
+	}
+}
+
+
+PointTree::PointTree()
+{
+	pointCount = 0;
+	nodeCount = 0;
+	pointCapacity = 0;
+	nodeArray = nullptr;
+	pointIndex = nullptr;
+	treeStorage = nullptr;
+}
+
+/// @brief Constructs a k-d tree and builds it for a set of points.
+/// @param count	The number of points.
+/// @param point	A pointer to an array of \c count points.
+
+PointTree::PointTree(int32 count, const Point3D *point)
+{
+	pointCount = 0;
+	nodeCount = 0;
+	pointCapacity = 0;
+	nodeArray = nullptr;
+	pointIndex = nullptr;
+	treeStorage = nullptr;
+
+	Build(count, point);
+}
+
+PointTree::~PointTree()
+{
+	ReleaseAligned(treeStorage);
+}
+
+int32 PointTree::GetMaxNodeCount(int32 count)
+{
+	// Every leaf produced by a median split holds at least half the maximum number of points,
+	// so the number of nodes is bounded by twice the number of leaves.
+
+	return ((count / int32(kMaxLeafPointCount / 2) + 1) * 2);
+}
+
+void PointTree::Release(void)
+{
+	treePoint.SetStorage(0, nullptr);
+	ReleaseAligned(treeStorage);
+	treeStorage = nullptr;
+	nodeArray = nullptr;
+	pointIndex = nullptr;
+	pointCount = 0;
+	nodeCount = 0;
+	pointCapacity = 0;
+}
+
+bool PointTree::Prepare(int32 count)
+{
+	if (count <= 0)
+	{
+		pointCount = 0;
+		nodeCount = 0;
+		treePoint.SetStorage(0, nullptr);
+		return (false);
+	}
+
+	umachine nodeSize = AlignSize(GetMaxNodeCount(count) * sizeof(Node));
+	umachine indexSize = AlignSize(count * sizeof(int32));
+
+	if (count > pointCapacity)
+	{
+		Release();
+
+		treeStorage = AllocateAligned(nodeSize + indexSize + Point3DArray::GetStorageSize(count));
+		pointCapacity = count;
+	}
+
+	// The node and index arrays are placed at offsets determined by the capacity so that
+	// they never overlap the coordinate streams for any smaller number of points.
+
+	char *storage = static_cast<char *>(treeStorage);
+	nodeArray = reinterpret_cast<Node *>(storage);
+	pointIndex = reinterpret_cast<int32 *>(storage + AlignSize(GetMaxNodeCount(pointCapacity) * sizeof(Node)));
+	treePoint.SetStorage(count, reinterpret_cast<char *>(pointIndex) + AlignSize(pointCapacity * sizeof(int32)));
+
+	pointCount = count;
+	return (true);
+}
+
+void PointTree::BuildTree(void)
+{
+	for (machine i = 0; i < pointCount; i++)
+	{
+		pointIndex[i] = int32(i);
+	}
+
+	float *coord[3] = {treePoint.GetX(), treePoint.GetY(), treePoint.GetZ()};
+	nodeCount = BuildNode(0, 0, pointCount, coord);
+}
+
+int32 PointTree::BuildNode(int32 nodeIndex, int32 start, int32 count, float *coord[3])
+{
+	Node *node = &nodeArray[nodeIndex];
+
+	if (count <= int32(kMaxLeafPointCount))
+	{
+		node->split = 0.0F;
+		node->axis = Node::kLeafAxis;
+		node->start = start;
+		node->count = count;
+		return (nodeIndex + 1);
+	}
+
+	// Split along the axis of greatest extent at the median point.
+
+	float	extent[3];
+
+	for (machine a = 0; a < 3; a++)
+	{
+		const float *c = coord[a] + start;
+		float cmin = c[0];
+		float cmax = c[0];
+		for (machine i = 1; i < count; i++)
+		{
+			cmin = Fmin(cmin, c[i]);
+			cmax = Fmax(cmax, c[i]);
+		}
+
+		extent[a] = cmax - cmin;
+	}
+
+	int32 axis = (extent[1] > extent[0]) ? 1 : 0;
+	axis = (extent[2] > extent[axis]) ? 2 : axis;
+
+	int32 half = count >> 1;
+	SelectMedian(coord, pointIndex, axis, start, start + count - 1, start + half);
+
+	node->split = coord[axis][start + half];
+	node->axis = axis;
+	node->count = 0;
+
+	int32 next = BuildNode(nodeIndex + 1, start, half, coord);
+	nodeArray[nodeIndex].start = next;
+	return (BuildNode(next, start + half, count - half, coord));
+}
+
+/// @brief Builds the k-d tree for a set of points, replacing any previous contents.
+/// @param count	The number of points.
+/// @param point	A pointer to an array of \c count points.
+///
+/// The points are copied into the tree, so the array does not need to persist after this function returns. If the tree
+/// was previously built for at least as many points, then its storage is reused, and no memory is allocated.
+
+void PointTree::Build(int32 count, const Point3D *point)
+{
+	if (Prepare(count))
+	{
+		treePoint.SetPoints(0, count, point);
+		BuildTree();
+	}
+}
+
+/// @brief Builds the k-d tree for a set of position vectors, replacing any previous contents.
+/// @param count	The number of vectors.
+/// @param point	A pointer to an array of \c count vectors, each representing the position of a point.
+
+void PointTree::Build(int32 count, const Vector3D *point)
+{
+	Build(count, static_cast<const Point3D *>(point));
+}
+
+/// @brief Builds the k-d tree for a set of points stored in structure-of-arrays layout, replacing any previous contents.
+/// @param point	The array of points.
+
+void PointTree::Build(const Point3DArray& point)
+{
+	int32 count = point.GetElementCount();
+	if (Prepare(count))
+	{
+		umachine size = count * sizeof(float);
+		CopyMemory(point.GetX(), treePoint.GetX(), size);
+		CopyMemory(point.GetY(), treePoint.GetY(), size);
+		CopyMemory(point.GetZ(), treePoint.GetZ(), size);
+		BuildTree();
+	}
+}
+
+/// @brief Finds the point in the tree nearest to a given point.
+/// @param p					The query point.
+/// @param maxDistance			The maximum distance at which a point is accepted.
+/// @param squaredDistance		A pointer to a location that receives the squared distance to the nearest point. This can be \c nullptr.
+///
+/// The return value is the original index of the nearest point, as it was passed to the \c Build() function. If the tree is
+/// empty or no point lies within the distance given by the \c maxDistance parameter, then the return value is -1, and the
+/// location pointed to by \c squaredDistance is not modified.
+
+int32 PointTree::FindNearestPoint(const Point3D& p, float maxDistance, float *squaredDistance) const
+{
+	if (pointCount == 0)
+	{
+		return (-1);
+	}
+
+	const float q[3] = {p.x, p.y, p.z};
+	NearestQuery query(maxDistance * maxDistance, -1);
+	TraverseTree(this, q, &query);
+
+	if (query.nearest < 0)
+	{
+		return (-1);
+	}
+
+	if (squaredDistance)
+	{
+		*squaredDistance = query.bound;
+	}
+
+	return (pointIndex[query.nearest]);
+}
+
+/// @brief Finds the points in the tree nearest to a given point.
+/// @param p					The query point.
+/// @param maxCount				The maximum number of points to find.
+/// @param index				A pointer to an array of \c maxCount entries that receives the original indices of the nearest points, in order of increasing distance.
+/// @param squaredDistance		A pointer to an array of \c maxCount entries that receives the squared distances to the nearest points. This can be \c nullptr.
+/// @param maxDistance			The maximum distance at which a point is accepted.
+///
+/// The return value is the number of points found, which is less than \c maxCount if the tree contains fewer points
+/// within the distance given by the \c maxDistance parameter.
+
+int32 PointTree::FindNearestPoints(const Point3D& p, int32 maxCount, int32 *index, float *squaredDistance, float maxDistance) const
+{
+	if ((pointCount == 0) || (maxCount <= 0))
+	{
+		return (0);
+	}
+
+	const float q[3] = {p.x, p.y, p.z};
+
+	NearestSetQuery query;
+	query.bound = maxDistance * maxDistance;
+	query.foundCount = 0;
+	query.maxCount = maxCount;
+	query.nearestIndex = index;
+	query.nearestDistance = squaredDistance;
+	query.treePoint = &treePoint;
+	query.queryPoint = q;
+
+	TraverseTree(this, q, &query);
+
+	int32 foundCount = query.foundCount;
+	for (machine k = 0; k < foundCount; k++)
+	{
+		index[k] = pointIndex[index[k]];
+	}
+
+	return (foundCount);
+}
+
+/// @brief Finds all points in the tree within a given distance of a point.
+/// @param p					The query point.
+/// @param radius				The maximum distance at which a point is accepted.
+/// @param maxCount				The maximum number of points to store.
+/// @param index				A pointer to an array of \c maxCount entries that receives the original indices of the points found, in no particular order.
+/// @param squaredDistance		A pointer to an array of \c maxCount entries that receives the squared distances to the points found. This can be \c nullptr.
+///
+/// The return value is the total number of points within the radius. If it is greater than \c maxCount, then only
+/// \c maxCount of those points are stored, and the caller can repeat the query with larger arrays.
+
+int32 PointTree::FindPointsInRadius(const Point3D& p, float radius, int32 maxCount, int32 *index, float *squaredDistance) const
+{
+	if (pointCount == 0)
+	{
+		return (0);
+	}
+
+	const float q[3] = {p.x, p.y, p.z};
+
+	RadiusQuery query;
+	query.bound = radius * radius;
+	query.foundCount = 0;
+	query.maxCount = maxCount;
+	query.foundIndex = index;
+	query.foundDistance = squaredDistance;
+
+	TraverseTree(this, q, &query);
+
+	int32 storedCount = (query.foundCount < maxCount) ? query.foundCount : maxCount;
+	for (machine k = 0; k < storedCount; k++)
+	{
+		index[k] = pointIndex[index[k]];
+	}
+
+	return (query.foundCount);
+}
+
+/// @brief Finds the point in the tree nearest to each point in an array.
+/// @param count				The number of query points.
+/// @param p					A pointer to an array of \c count query points.
+/// @param index				A pointer to an array of \c count entries that receives the original index of the nearest point for each query point, or -1 if no point is within range.
+/// @param squaredDistance		A pointer to an array of \c count entries that receives the squared distance to the nearest point for each query point. This can be \c nullptr.
+/// @param maxDistance			The maximum distance at which a point is accepted.
+///
+/// The point found for each query is used to bound the search for the next query, so batches of query points that are
+/// ordered so that consecutive points are close together visit far fewer nodes than the same number of separate queries.
+
+void PointTree::FindNearestPoint(int32 count, const Point3D *p, int32 *index, float *squaredDistance, float maxDistance) const
+{
+	float maxSquaredDistance = maxDistance * maxDistance;
+	int32 previous = -1;
+
+	for (machine i = 0; i < count; i++)
+	{
+		float d2 = Math::infinity;
+		int32 nearest = -1;
+
+		if (pointCount != 0)
+		{
+			const float q[3] = {p[i].x, p[i].y, p[i].z};
+
+			// The distance to the previous result is an upper bound on the distance to the nearest point.
+
+			NearestQuery query(maxSquaredDistance, -1);
+			if (previous >= 0)
+			{
+				float d = CalculateSquaredDistance(treePoint, previous, q);
+				if (d < maxSquaredDistance)
+				{
+					query.bound = d;
+					query.nearest = previous;
+				}
+			}
+
+			TraverseTree(this, q, &query);
+
+			previous = query.nearest;
+			if (previous >= 0)
+			{
+				d2 = query.bound;
+				nearest = pointIndex[previous];
+			}
+		}
+
+		index[i] = nearest;
+		if (squaredDistance)
+		{
+			squaredDistance[i] = d2;
+		}
+	}
+}
+
+/// @brief Finds the points in the tree nearest to each point in an array.
+/// @param count				The number of query points.
+/// @param p					A pointer to an array of \c count query points.
+/// @param maxCount				The maximum number of points to find for each query point.
+/// @param index				A pointer to an array of <tt>count&nbsp;*&nbsp;maxCount</tt> entries that receives the original indices of the nearest points. The results for query point \c i begin at entry <tt>i&nbsp;*&nbsp;maxCount</tt>, and unused entries are set to -1.
+/// @param squaredDistance		A pointer to an array of <tt>count&nbsp;*&nbsp;maxCount</tt> entries that receives the squared distances to the nearest points, with unused entries set to infinity. This can be \c nullptr.
+/// @param resultCount			A pointer to an array of \c count entries that receives the number of points found for each query point. This can be \c nullptr.
+/// @param maxDistance			The maximum distance at which a point is accepted.
+
+void PointTree::FindNearestPoints(int32 count, const Point3D *p, int32 maxCount, int32 *index, float *squaredDistance, int32 *resultCount, float maxDistance) const
+{
+	for (machine i = 0; i < count; i++)
+	{
+		int32 *queryIndex = index + i * maxCount;
+		float *queryDistance = (squaredDistance) ? squaredDistance + i * maxCount : nullptr;
+
+		int32 foundCount = FindNearestPoints(p[i], maxCount, queryIndex, queryDistance, maxDistance);
+		for (machine k = foundCount; k < maxCount; k++)
+		{
+			queryIndex[k] = -1;
+			if (queryDistance)
+			{
+				queryDistance[k] = Math::infinity;
+			}
+		}
+
+		if (resultCount)
+		{
+			resultCount[i] = foundCount;
+		}
+	}
+}
+
+/// @brief Counts the points in the tree within a given distance of each point in an array.
+/// @param count				The number of query points.
+/// @param p					A pointer to an array of \c count query points.
+/// @param radius				The maximum distance at which a point is counted.
+/// @param resultCount			A pointer to an array of \c count entries that receives the number of points within the radius of each query point.
+///
+/// The counts can be used to allocate storage for subsequent calls to the \c FindPointsInRadius() function.
+
+void PointTree::CountPointsInRadius(int32 count, const Point3D *p, float radius, int32 *resultCount) const
+{
+	RadiusQuery query;
+	query.maxCount = 0;
+	query.foundIndex = nullptr;
+	query.foundDistance = nullptr;
+
+	for (machine i = 0; i < count; i++)
+	{
+		query.bound = radius * radius;
+		query.foundCount = 0;
+
+		if (pointCount != 0)
+		{
+			const float q[3] = {p[i].x, p[i].y, p[i].z};
+			TraverseTree(this, q, &query);
+		}
+
+		resultCount[i] = query.foundCount;
+	}
+}
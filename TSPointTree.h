@@ -0,0 +1,150 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSPointTree_h
+#define TSPointTree_h
+
+
+#include "TSGeometryArray.h"
+
+
+#define TERATHON_POINTTREE 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	PointTree
+	// ==============================================
+
+	/// @brief Static k-d tree over a set of 3D points for nearest-neighbor queries.
+	///
+	/// The \c PointTree class partitions a set of points by recursively splitting them at the median coordinate along
+	/// the axis of greatest extent until each leaf holds no more than \c kMaxLeafPointCount points. The nodes are stored
+	/// in depth-first order so that the first child of an interior node immediately follows it in memory, and the points
+	/// are copied into a \c Point3DArray in leaf order so that each leaf references a contiguous range of coordinates.
+	/// The distances to all points in a leaf are calculated together with SIMD instructions.
+	///
+	/// The nodes, point indices, and coordinates share a single allocation. When the tree is rebuilt for a set of points no
+	/// larger than the set it was previously built for, the existing storage is reused, so a tree over moving points can be
+	/// rebuilt every frame without allocating memory.
+	///
+	/// A tree does not change after it is built, so any number of threads can query it at the same time. The batch query
+	/// functions process a contiguous range of query points, and large batches can be divided among threads by range.
+	/// Batch queries run fastest when consecutive query points are close to each other, as they are after spatial sorting.
+
+	class PointTree
+	{
+		public:
+
+			enum : uint32
+			{
+				kMaxLeafPointCount		= 8,
+				kMaxTreeDepth			= 64
+			};
+
+			/// @brief A single node in a k-d tree.
+			///
+			/// For an interior node, \c axis is 0, 1, or 2, the first child is the next node in the array, and \c start is the
+			/// index of the second child, which contains the points whose coordinate along the axis is not less than \c split.
+			/// For a leaf node, \c axis is \c kLeafAxis, and the node references the \c count points beginning at \c start.
+
+			struct Node
+			{
+				enum : uint32
+				{
+					kLeafAxis = 3
+				};
+
+				float			split;
+				uint32			axis;
+				uint32			start;
+				uint32			count;
+			};
+
+		private:
+
+			int32				pointCount;
+			int32				nodeCount;
+			int32				pointCapacity;
+
+			Node				*nodeArray;
+			int32				*pointIndex;
+			void				*treeStorage;
+
+			Point3DArray		treePoint;
+
+			static int32 GetMaxNodeCount(int32 count);
+
+			void Release(void);
+			bool Prepare(int32 count);
+			void BuildTree(void);
+			int32 BuildNode(int32 nodeIndex, int32 start, int32 count, float *coord[3]);
+
+		public:
+
+			TERATHON_API PointTree();
+			TERATHON_API PointTree(int32 count, const Point3D *point);
+			TERATHON_API ~PointTree();
+
+			PointTree(const PointTree&) = delete;
+			PointTree& operator =(const PointTree&) = delete;
+
+			/// @brief Returns the number of points stored in the tree.
+
+			int32 GetPointCount(void) const
+			{
+				return (pointCount);
+			}
+
+			/// @brief Returns the number of nodes in the tree.
+
+			int32 GetNodeCount(void) const
+			{
+				return (nodeCount);
+			}
+
+			/// @brief Returns a pointer to the array of nodes in depth-first order.
+
+			const Node *GetNodeArray(void) const
+			{
+				return (nodeArray);
+			}
+
+			/// @brief Returns the points stored in the tree in leaf order.
+
+			const Point3DArray& GetTreePoints(void) const
+			{
+				return (treePoint);
+			}
+
+			/// @brief Returns the original index of a point stored in the tree.
+			/// @param index	The leaf-order index of the point.
+
+			int32 GetPointIndex(int32 index) const
+			{
+				return (pointIndex[index]);
+			}
+
+			TERATHON_API void Build(int32 count, const Point3D *point);
+			TERATHON_API void Build(int32 count, const Vector3D *point);
+			TERATHON_API void Build(const Point3DArray& point);
+
+			TERATHON_API int32 FindNearestPoint(const Point3D& p, float maxDistance = Math::infinity, float *squaredDistance = nullptr) const;
+			TERATHON_API int32 FindNearestPoints(const Point3D& p, int32 maxCount, int32 *index, float *squaredDistance = nullptr, float maxDistance = Math::infinity) const;
+			TERATHON_API int32 FindPointsInRadius(const Point3D& p, float radius, int32 maxCount, int32 *index, float *squaredDistance = nullptr) const;
+
+			TERATHON_API void FindNearestPoint(int32 count, const Point3D *p, int32 *index, float *squaredDistance = nullptr, float maxDistance = Math::infinity) const;
+			TERATHON_API void FindNearestPoints(int32 count, const Point3D *p, int32 maxCount, int32 *index, float *squaredDistance = nullptr, int32 *resultCount = nullptr, float maxDistance = Math::infinity) const;
+			TERATHON_API void CountPointsInRadius(int32 count, const Point3D *p, float radius, int32 *resultCount) const;
+	};
+}
+
+
+#endif
@@ -0,0 +1,395 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSPoseFusion.h"
+#include "TSEigen.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	// The ten unique entries of the symmetric matrix sum(w * q * q^T) are stored in the order
+	// xx, xy, xz, xw, yy, yz, yw, zz, zw, ww.
+
+	inline void AccumulateOuterProduct(float x, float y, float z, float w, float k, float *sum)
+	{
+		float kx = k * x;
+		float ky = k * y;
+		float kz = k * z;
+		float kw = k * w;
+
+		sum[0] += kx * x;
+		sum[1] += kx * y;
+		sum[2] += kx * z;
+		sum[3] += kx * w;
+		sum[4] += ky * y;
+		sum[5] += ky * z;
+		sum[6] += ky * w;
+		sum[7] += kz * z;
+		sum[8] += kz * w;
+		sum[9] += kw * w;
+	}
+
+	#ifndef TERATHON_NO_SIMD
+
+		inline void AccumulateOuterProduct(const vec_float *q, const vec_float& k, vec_float *sum)
+		{
+			vec_float kx = VecMul(k, q[0]);
+			vec_float ky = VecMul(k, q[1]);
+			vec_float kz = VecMul(k, q[2]);
+			vec_float kw = VecMul(k, q[3]);
+
+			sum[0] = VecMadd(kx, q[0], sum[0]);
+			sum[1] = VecMadd(kx, q[1], sum[1]);
+			sum[2] = VecMadd(kx, q[2], sum[2]);
+			sum[3] = VecMadd(kx, q[3], sum[3]);
+			sum[4] = VecMadd(ky, q[1], sum[4]);
+			sum[5] = VecMadd(ky, q[2], sum[5]);
+			sum[6] = VecMadd(ky, q[3], sum[6]);
+			sum[7] = VecMadd(kz, q[2], sum[7]);
+			sum[8] = VecMadd(kz, q[3], sum[8]);
+			sum[9] = VecMadd(kw, q[3], sum[9]);
+		}
+
+		inline float GetHorizontalSum(const vec_float& v)
+		{
+			alignas(16) float	f[4];
+
+			VecStore(v, f);
+			return ((f[0] + f[1]) + (f[2] + f[3]));
+		}
+
+		inline void LoadQuaternions(const float *p, machine stride, vec_float *q)
+		{
+			q[0] = VecLoadUnaligned(p);
+			q[1] = VecLoadUnaligned(p + stride);
+			q[2] = VecLoadUnaligned(p + stride * 2);
+			q[3] = VecLoadUnaligned(p + stride * 3);
+			VecTranspose4D(&q[0], &q[1], &q[2], &q[3]);
+		}
+
+	#endif
+}
+
+
+PoseAccumulator::PoseAccumulator()
+{
+	Reset();
+}
+
+/// @brief Removes all accumulated samples.
+
+void PoseAccumulator::Reset(void)
+{
+	for (machine a = 0; a < 10; a++)
+	{
+		rotationSum[a] = 0.0F;
+	}
+
+	positionSum[0] = 0.0F;
+	positionSum[1] = 0.0F;
+	positionSum[2] = 0.0F;
+	weightSum = 0.0F;
+}
+
+/// @brief Adds the samples accumulated by another pose accumulator to this one.
+/// @param accumulator	The accumulator whose samples are added.
+///
+/// Merging accumulators that each hold a range of a sample set produces the same average as accumulating the whole set at once.
+
+void PoseAccumulator::Merge(const PoseAccumulator& accumulator)
+{
+	for (machine a = 0; a < 10; a++)
+	{
+		rotationSum[a] += accumulator.rotationSum[a];
+	}
+
+	positionSum[0] += accumulator.positionSum[0];
+	positionSum[1] += accumulator.positionSum[1];
+	positionSum[2] += accumulator.positionSum[2];
+	weightSum += accumulator.weightSum;
+}
+
+/// @brief Accumulates an array of weighted rotations.
+/// @param count	The number of rotations.
+/// @param q		A pointer to an array of \c count unit quaternions.
+/// @param weight	A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one.
+///
+/// Quaternions only contribute to the average rotation, so they should not be mixed with motors in the same accumulator
+/// if the average position is needed.
+
+void PoseAccumulator::AddQuaternions(int32 count, const Quaternion *q, const float *weight)
+{
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		if (count >= 4)
+		{
+			vec_float	sum[10], v[4];
+
+			for (machine a = 0; a < 10; a++)
+			{
+				sum[a] = VecFloatGetZero();
+			}
+
+			vec_float k = VecLoadVectorConstant<0x3F800000>();
+			vec_float ksum = VecFloatGetZero();
+
+			for (; i <= count - 4; i += 4)
+			{
+				LoadQuaternions(&q[i].x, 4, v);
+				if (weight)
+				{
+					k = VecLoadUnaligned(weight + i);
+				}
+
+				AccumulateOuterProduct(v, k, sum);
+				ksum = VecAdd(ksum, k);
+			}
+
+			for (machine a = 0; a < 10; a++)
+			{
+				rotationSum[a] += GetHorizontalSum(sum[a]);
+			}
+
+			weightSum += GetHorizontalSum(ksum);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		float k = (weight) ? weight[i] : 1.0F;
+		AccumulateOuterProduct(q[i].x, q[i].y, q[i].z, q[i].w, k, rotationSum);
+		weightSum += k;
+	}
+}
+
+/// @brief Accumulates an array of weighted poses.
+/// @param count	The number of poses.
+/// @param motor	A pointer to an array of \c count unitized motors.
+/// @param weight	A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one.
+///
+/// The rotation of each motor is accumulated in the same way as a quaternion, and the position to which the origin
+/// is carried by each motor is accumulated for the average position.
+
+void PoseAccumulator::AddMotors(int32 count, const Motor3D *motor, const float *weight)
+{
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		if (count >= 4)
+		{
+			vec_float	sum[10], v[4], m[4];
+
+			for (machine a = 0; a < 10; a++)
+			{
+				sum[a] = VecFloatGetZero();
+			}
+
+			vec_float px = VecFloatGetZero();
+			vec_float py = VecFloatGetZero();
+			vec_float pz = VecFloatGetZero();
+
+			vec_float k = VecLoadVectorConstant<0x3F800000>();
+			vec_float ksum = VecFloatGetZero();
+
+			for (; i <= count - 4; i += 4)
+			{
+				LoadQuaternions(&motor[i].v.x, 8, v);
+				LoadQuaternions(&motor[i].m.x, 8, m);
+				if (weight)
+				{
+					k = VecLoadUnaligned(weight + i);
+				}
+
+				AccumulateOuterProduct(v, k, sum);
+				ksum = VecAdd(ksum, k);
+
+				// The position is 2 * (v x m + m * v.w - v * m.w), and the factor of two is applied at the end.
+
+				vec_float x = VecNmsub(v[0], m[3], VecMadd(m[0], v[3], VecNmsub(v[2], m[1], VecMul(v[1], m[2]))));
+				vec_float y = VecNmsub(v[1], m[3], VecMadd(m[1], v[3], VecNmsub(v[0], m[2], VecMul(v[2], m[0]))));
+				vec_float z = VecNmsub(v[2], m[3], VecMadd(m[2], v[3], VecNmsub(v[1], m[0], VecMul(v[0], m[1]))));
+				px = VecMadd(k, x, px);
+				py = VecMadd(k, y, py);
+				pz = VecMadd(k, z, pz);
+			}
+
+			for (machine a = 0; a < 10; a++)
+			{
+				rotationSum[a] += GetHorizontalSum(sum[a]);
+			}
+
+			positionSum[0] += GetHorizontalSum(px) * 2.0F;
+			positionSum[1] += GetHorizontalSum(py) * 2.0F;
+			positionSum[2] += GetHorizontalSum(pz) * 2.0F;
+			weightSum += GetHorizontalSum(ksum);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		const Motor3D& Q = motor[i];
+		float k = (weight) ? weight[i] : 1.0F;
+		AccumulateOuterProduct(Q.v.x, Q.v.y, Q.v.z, Q.v.w, k, rotationSum);
+		weightSum += k;
+
+		Point3D p = Q.GetPosition();
+		positionSum[0] += p.x * k;
+		positionSum[1] += p.y * k;
+		positionSum[2] += p.z * k;
+	}
+}
+
+/// @brief Returns the average of the accumulated rotations.
+///
+/// The return value is the unit quaternion <b>q</b> that maximizes the weighted sum of the squared dot products between
+/// <b>q</b> and the accumulated quaternions. Its <i>w</i> component is nonnegative. If no samples with positive weight have
+/// been accumulated, then the return value is the identity.
+
+Quaternion PoseAccumulator::GetAverageRotation(void) const
+{
+	Vector4D	eigenvalues;
+	Matrix4D	eigenvectors;
+
+	if (!(weightSum > 0.0F))
+	{
+		return (Quaternion::identity);
+	}
+
+	const float *s = rotationSum;
+	CalculateEigensystem(Matrix4D(s[0], s[1], s[2], s[3], s[1], s[4], s[5], s[6], s[2], s[5], s[7], s[8], s[3], s[6], s[8], s[9]), &eigenvalues, &eigenvectors);
+
+	float f = (eigenvectors(3,0) < 0.0F) ? -1.0F : 1.0F;
+	return (Quaternion(eigenvectors(0,0) * f, eigenvectors(1,0) * f, eigenvectors(2,0) * f, eigenvectors(3,0) * f));
+}
+
+/// @brief Returns the weighted mean of the accumulated positions.
+///
+/// If no samples with positive weight have been accumulated, then the return value is the origin.
+
+Point3D PoseAccumulator::GetAveragePosition(void) const
+{
+	if (!(weightSum > 0.0F))
+	{
+		return (Point3D(0.0F, 0.0F, 0.0F));
+	}
+
+	float f = 1.0F / weightSum;
+	return (Point3D(positionSum[0] * f, positionSum[1] * f, positionSum[2] * f));
+}
+
+/// @brief Returns the unitized motor that applies the average rotation and then moves the origin to the average position.
+
+Motor3D PoseAccumulator::GetAverageMotor(void) const
+{
+	Quaternion r = GetAverageRotation();
+	Point3D p = GetAveragePosition();
+	return (Motor3D::MakeTranslation(p) * Motor3D(r));
+}
+
+
+/// @brief Calculates the weighted average of an array of rotations.
+/// @param count	The number of rotations.
+/// @param q		A pointer to an array of \c count unit quaternions. The sign of each quaternion does not matter.
+/// @param weight	A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one.
+///
+/// See the \c PoseAccumulator class for a description of the average.
+///
+/// @relatedalso Quaternion
+
+Quaternion Terathon::AverageQuaternions(int32 count, const Quaternion *q, const float *weight)
+{
+	PoseAccumulator		accumulator;
+
+	accumulator.AddQuaternions(count, q, weight);
+	return (accumulator.GetAverageRotation());
+}
+
+/// @brief Calculates the weighted average of an array of poses.
+/// @param count	The number of poses.
+/// @param motor	A pointer to an array of \c count unitized motors. The sign of each motor does not matter.
+/// @param weight	A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one.
+///
+/// The rotation of the result is the eigenvector-based average of the rotations, and the position of the result is the
+/// weighted mean of the positions. See the \c PoseAccumulator class for more information.
+///
+/// @relatedalso Motor3D
+
+Motor3D Terathon::AverageMotors(int32 count, const Motor3D *motor, const float *weight)
+{
+	PoseAccumulator		accumulator;
+
+	accumulator.AddMotors(count, motor, weight);
+	return (accumulator.GetAverageMotor());
+}
+
+/// @brief Calculates the weighted Karcher mean of an array of poses.
+/// @param count				The number of poses.
+/// @param motor				A pointer to an array of \c count unitized motors. The sign of each motor does not matter.
+/// @param weight				A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one.
+/// @param maxIterationCount	The maximum number of iterations.
+/// @param tolerance			The iteration stops when the magnitude of the correction falls below this value.
+///
+/// The Karcher mean <b>M</b> minimizes the weighted sum of the squared magnitudes of the logarithms of the motors
+/// <b>M</b><sup>&minus;1</sup><b>Q</b><sub><i>i</i></sub>, which treats rotation and translation together as a single screw
+/// motion. Starting with the result of the \c AverageMotors() function, each iteration replaces <b>M</b> with
+/// <b>M</b>&#x202F;exp(<b>L</b>), where <b>L</b> is the weighted mean of the logarithms.
+///
+/// @relatedalso Motor3D
+
+Motor3D Terathon::CalculateKarcherMean(int32 count, const Motor3D *motor, const float *weight, int32 maxIterationCount, float tolerance)
+{
+	Motor3D mean = AverageMotors(count, motor, weight);
+
+	for (machine iteration = 0; iteration < maxIterationCount; iteration++)
+	{
+		float	sum[6] = {0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F};
+
+		float ksum = 0.0F;
+		Motor3D inverse = ~mean;
+
+		for (machine i = 0; i < count; i++)
+		{
+			float k = (weight) ? weight[i] : 1.0F;
+			Line3D l = Log(inverse * motor[i]);
+
+			sum[0] += l.v.x * k;
+			sum[1] += l.v.y * k;
+			sum[2] += l.v.z * k;
+			sum[3] += l.m.x * k;
+			sum[4] += l.m.y * k;
+			sum[5] += l.m.z * k;
+			ksum += k;
+		}
+
+		if (!(ksum > 0.0F))
+		{
+			break;
+		}
+
+		float f = 1.0F / ksum;
+		Line3D step(sum[0] * f, sum[1] * f, sum[2] * f, sum[3] * f, sum[4] * f, sum[5] * f);
+		mean = Unitize(mean * Exp(step));
+
+		float d = step.v.x * step.v.x + step.v.y * step.v.y + step.v.z * step.v.z + step.m.x * step.m.x + step.m.y * step.m.y + step.m.z * step.m.z;
+		if (d < tolerance * tolerance)
+		{
+			break;
+		}
+	}
+
+	return (mean);
+}
@@ -0,0 +1,74 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSPoseFusion_h
+#define TSPoseFusion_h
+
+
+#include "TSMotor3D.h"
+
+
+#define TERATHON_POSEFUSION 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	PoseAccumulator
+	// ==============================================
+
+	/// @brief Accumulates weighted rotations and positions for the calculation of an average pose.
+	///
+	/// The \c PoseAccumulator class stores the weighted sum of the outer products <b>qq</b><sup>T</sup> of unit quaternions
+	/// and the weighted sum of positions. The average rotation is the eigenvector corresponding to the largest eigenvalue of
+	/// the summed outer products, as described by Markley et al., so it does not depend on the signs of the input quaternions.
+	/// The average position is the weighted mean of the positions to which the origin is carried by the input motors.
+	///
+	/// Large sample sets can be divided into ranges that are accumulated independently, for example on different threads,
+	/// and the partial results are then combined with the \c Merge() function. The result is independent of the way in
+	/// which the samples are divided, up to floating-point rounding.
+
+	class PoseAccumulator
+	{
+		private:
+
+			float			rotationSum[10];
+			float			positionSum[3];
+			float			weightSum;
+
+		public:
+
+			TERATHON_API PoseAccumulator();
+
+			/// @brief Returns the total weight of the samples that have been accumulated.
+
+			float GetWeightSum(void) const
+			{
+				return (weightSum);
+			}
+
+			TERATHON_API void Reset(void);
+			TERATHON_API void Merge(const PoseAccumulator& accumulator);
+
+			TERATHON_API void AddQuaternions(int32 count, const Quaternion *q, const float *weight = nullptr);
+			TERATHON_API void AddMotors(int32 count, const Motor3D *motor, const float *weight = nullptr);
+
+			TERATHON_API Quaternion GetAverageRotation(void) const;
+			TERATHON_API Point3D GetAveragePosition(void) const;
+			TERATHON_API Motor3D GetAverageMotor(void) const;
+	};
+
+
+	TERATHON_API Quaternion AverageQuaternions(int32 count, const Quaternion *q, const float *weight = nullptr);
+	TERATHON_API Motor3D AverageMotors(int32 count, const Motor3D *motor, const float *weight = nullptr);
+	TERATHON_API Motor3D CalculateKarcherMean(int32 count, const Motor3D *motor, const float *weight = nullptr, int32 maxIterationCount = 16, float tolerance = 1.0e-6F);
+}
+
+
+#endif
@@ -0,0 +1,196 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSQuadric3D.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	#ifndef TERATHON_NO_SIMD
+
+		inline vec_float VecEvaluateQuadric(const vec_float *q, const vec_float& x, const vec_float& y, const vec_float& z)
+		{
+			// The components of q are in the same order as the members of Quadric3D.
+
+			const vec_float two = VecLoadVectorConstant<0x40000000>();
+
+			vec_float fx = VecMadd(q[0], x, VecMul(two, VecMadd(q[1], y, VecMadd(q[2], z, q[3]))));
+			vec_float fy = VecMadd(q[4], y, VecMul(two, VecMadd(q[5], z, q[6])));
+			vec_float fz = VecMadd(q[7], z, VecMul(two, q[8]));
+			return (VecMadd(x, fx, VecMadd(y, fy, VecMadd(z, fz, q[9]))));
+		}
+
+	#endif
+}
+
+
+/// @brief Calculates the point having the smallest error.
+///
+/// The point minimizing <b>p</b><sup>T</sup><b>Qp</b> satisfies <b>Ap</b>&nbsp;=&nbsp;&minus;<b>b</b>, where <b>A</b> is the upper-left
+/// 3&nbsp;&times;&nbsp;3 portion of the quadric and <b>b</b> holds the first three entries of its last column. The solution is calculated
+/// with the inverse of <b>A</b>. When the planes accumulated in the quadric do not meet at a unique point, such as when they are all nearly
+/// parallel, <b>A</b> is close to singular, and this function returns \c false without changing the result. The caller would then
+/// typically choose the best of a few candidate points, such as the endpoints and midpoint of an edge being collapsed.
+///
+/// @param result	A pointer to a location that receives the optimal point.
+/// @return \c true if the optimal point was calculated, and \c false if the quadric is too close to singular.
+
+bool Quadric3D::CalculateOptimalPoint(Point3D *result) const
+{
+	// The matrix A is positive semidefinite, so its determinant is the product of three nonnegative eigenvalues,
+	// and its trace is their sum. A small ratio between the determinant and the cube of the trace indicates
+	// that the smallest eigenvalue is tiny compared to the largest one.
+
+	Matrix3D A = GetMatrix3D();
+	float trace = xx + yy + zz;
+	float det = Determinant(A);
+	if (!(det > trace * trace * trace * 1.0e-6F))
+	{
+		return (false);
+	}
+
+	*result = Inverse(A) * Point3D(-xw, -yw, -zw);
+	return (true);
+}
+
+/// @brief Calculates the error quadric for every vertex in a mesh.
+///
+/// The quadric for each vertex is the sum of the quadrics constructed from the unitized planes of the triangles that use the vertex.
+/// When \c areaWeighted is \c true, each plane quadric is multiplied by the area of its triangle so that the error measures the
+/// squared distance integrated over the surrounding surface, and small triangles have a proportionally small influence. Degenerate triangles
+/// make no contribution. Additional quadrics, such as those constraining boundary edges, can be added to the results afterward.
+///
+/// @param vertexCount		The number of vertices.
+/// @param vertex			A pointer to an array of \c vertexCount vertex positions.
+/// @param triangleCount	The number of triangles.
+/// @param triangleIndex	A pointer to an array of 3&nbsp;&times;&nbsp;<tt>triangleCount</tt> vertex indices.
+/// @param quadric			A pointer to an array that receives \c vertexCount quadrics.
+/// @param areaWeighted		Indicates whether each plane quadric is weighted by the area of its triangle.
+/// @relatedalso Quadric3D
+
+void Terathon::CalculateVertexQuadrics(int32 vertexCount, const Point3D *vertex, int32 triangleCount, const int32 *triangleIndex, Quadric3D *quadric, bool areaWeighted)
+{
+	for (machine j = 0; j < vertexCount; j++)
+	{
+		quadric[j].SetZero();
+	}
+
+	for (machine i = 0; i < triangleCount; i++)
+	{
+		const int32 *index = triangleIndex + i * 3;
+		Plane3D g(vertex[index[0]], vertex[index[1]], vertex[index[2]]);
+
+		float m2 = g.x * g.x + g.y * g.y + g.z * g.z;
+		if (m2 > Math::min_float)
+		{
+			// The magnitude of the plane normal is twice the area of the triangle.
+
+			float f = InverseSqrt(m2);
+			g *= f;
+
+			Quadric3D q(g, (areaWeighted) ? m2 * f * 0.5F : 1.0F);
+			quadric[index[0]] += q;
+			quadric[index[1]] += q;
+			quadric[index[2]] += q;
+		}
+	}
+}
+
+/// @brief Calculates the errors of an array of points with respect to a single quadric.
+///
+/// The points are processed four at a time with SIMD instructions.
+///
+/// @param quadric		The quadric.
+/// @param count		The number of points.
+/// @param point		A pointer to an array of \c count points.
+/// @param error		A pointer to an array that receives \c count errors.
+/// @relatedalso Quadric3D
+
+void Terathon::EvaluateQuadric(const Quadric3D& quadric, int32 count, const Point3D *point, float *error)
+{
+	machine i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		vec_float	q[10];
+
+		const float *data = &quadric.xx;
+		for (machine k = 0; k < 10; k++)
+		{
+			q[k] = VecLoadSmearScalar(&data[k]);
+		}
+
+		for (; i + 4 <= count; i += 4)
+		{
+			vec_float	x, y, z;
+
+			VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+			VecStoreUnaligned(VecEvaluateQuadric(q, x, y, z), &error[i]);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		error[i] = quadric.Evaluate(point[i]);
+	}
+}
+
+/// @brief Calculates the error of each point in an array with respect to a corresponding quadric in another array.
+///
+/// This is typically used to evaluate candidate positions for a batch of edge collapses, where each quadric is the sum of the
+/// quadrics at the two endpoints of an edge. The quadrics are transposed in groups of four and evaluated with SIMD instructions.
+///
+/// @param count		The number of quadrics and points.
+/// @param quadric		A pointer to an array of \c count quadrics.
+/// @param point		A pointer to an array of \c count points.
+/// @param error		A pointer to an array that receives \c count errors.
+/// @relatedalso Quadric3D
+
+void Terathon::EvaluateQuadrics(int32 count, const Quadric3D *quadric, const Point3D *point, float *error)
+{
+	machine i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		alignas(16) float	data[10][4];
+		vec_float			q[10];
+
+		for (; i + 4 <= count; i += 4)
+		{
+			for (machine j = 0; j < 4; j++)
+			{
+				const float *entry = &quadric[i + j].xx;
+				for (machine k = 0; k < 10; k++)
+				{
+					data[k][j] = entry[k];
+				}
+			}
+
+			for (machine k = 0; k < 10; k++)
+			{
+				q[k] = VecLoad(data[k]);
+			}
+
+			vec_float	x, y, z;
+
+			VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+			VecStoreUnaligned(VecEvaluateQuadric(q, x, y, z), &error[i]);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		error[i] = quadric[i].Evaluate(point[i]);
+	}
+}
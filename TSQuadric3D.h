@@ -0,0 +1,155 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSQuadric3D_h
+#define TSQuadric3D_h
+
+
+#include "TSMatrix3D.h"
+#include "TSRigid3D.h"
+
+
+#define TERATHON_QUADRIC3D 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	Quadric3D
+	// ==============================================
+
+	/// @brief Encapsulates a 3D error quadric used for mesh simplification.
+	///
+	/// The \c Quadric3D class stores a symmetric 4&nbsp;&times;&nbsp;4 matrix <b>Q</b> as the ten entries on and above its diagonal.
+	/// The error of a point <b>p</b> is <b>p</b><sup>T</sup><b>Qp</b>, where <b>p</b> is extended to four dimensions with a <i>w</i> coordinate of 1.
+	/// The quadric constructed from a unitized plane <b>g</b> is the outer product <b>gg</b><sup>T</sup>, and its error for any point
+	/// is the squared distance between the point and the plane. Quadrics are summed to measure the total squared distance to a set of planes,
+	/// such as the planes of the triangles surrounding a vertex.
+
+	class Quadric3D
+	{
+		public:
+
+			float		xx, xy, xz, xw;
+			float		yy, yz, yw;
+			float		zz, zw;
+			float		ww;
+
+			/// @brief Default constructor that leaves the components uninitialized.
+
+			inline Quadric3D() = default;
+
+			/// @brief Constructor that sets the quadric to the weighted outer product of a plane with itself.
+			/// @param g		The plane. This should normally be unitized.
+			/// @param weight	The weight by which the outer product is multiplied.
+
+			explicit Quadric3D(const Plane3D& g, float weight = 1.0F)
+			{
+				Set(g, weight);
+			}
+
+			/// @brief Sets the quadric to the weighted outer product of a plane with itself.
+			/// @param g		The plane. This should normally be unitized.
+			/// @param weight	The weight by which the outer product is multiplied.
+
+			Quadric3D& Set(const Plane3D& g, float weight = 1.0F)
+			{
+				float x = g.x * weight;
+				float y = g.y * weight;
+				float z = g.z * weight;
+				float w = g.w * weight;
+
+				xx = g.x * x; xy = g.x * y; xz = g.x * z; xw = g.x * w;
+				yy = g.y * y; yz = g.y * z; yw = g.y * w;
+				zz = g.z * z; zw = g.z * w;
+				ww = g.w * w;
+				return (*this);
+			}
+
+			/// @brief Sets all entries of the quadric to zero.
+
+			Quadric3D& SetZero(void)
+			{
+				xx = 0.0F; xy = 0.0F; xz = 0.0F; xw = 0.0F;
+				yy = 0.0F; yz = 0.0F; yw = 0.0F;
+				zz = 0.0F; zw = 0.0F;
+				ww = 0.0F;
+				return (*this);
+			}
+
+			Quadric3D& operator +=(const Quadric3D& q)
+			{
+				xx += q.xx; xy += q.xy; xz += q.xz; xw += q.xw;
+				yy += q.yy; yz += q.yz; yw += q.yw;
+				zz += q.zz; zw += q.zw;
+				ww += q.ww;
+				return (*this);
+			}
+
+			Quadric3D& operator *=(float n)
+			{
+				xx *= n; xy *= n; xz *= n; xw *= n;
+				yy *= n; yz *= n; yw *= n;
+				zz *= n; zw *= n;
+				ww *= n;
+				return (*this);
+			}
+
+			/// @brief Returns the upper-left 3&nbsp;&times;&nbsp;3 portion of the quadric.
+
+			Matrix3D GetMatrix3D(void) const
+			{
+				return (Matrix3D(xx, xy, xz, xy, yy, yz, xz, yz, zz));
+			}
+
+			/// @brief Calculates the error of a point, which is the sum of the weighted squared distances to the planes accumulated in the quadric.
+			/// @param p	The point to evaluate.
+
+			float Evaluate(const Point3D& p) const
+			{
+				float fx = xx * p.x + 2.0F * (xy * p.y + xz * p.z + xw);
+				float fy = yy * p.y + 2.0F * (yz * p.z + yw);
+				float fz = zz * p.z + 2.0F * zw;
+				return (p.x * fx + p.y * fy + p.z * fz + ww);
+			}
+
+			TERATHON_API bool CalculateOptimalPoint(Point3D *result) const;
+	};
+
+
+	inline Quadric3D operator +(const Quadric3D& a, const Quadric3D& b)
+	{
+		Quadric3D	q;
+
+		q.xx = a.xx + b.xx; q.xy = a.xy + b.xy; q.xz = a.xz + b.xz; q.xw = a.xw + b.xw;
+		q.yy = a.yy + b.yy; q.yz = a.yz + b.yz; q.yw = a.yw + b.yw;
+		q.zz = a.zz + b.zz; q.zw = a.zw + b.zw;
+		q.ww = a.ww + b.ww;
+		return (q);
+	}
+
+	inline Quadric3D operator *(const Quadric3D& a, float n)
+	{
+		Quadric3D	q;
+
+		q.xx = a.xx * n; q.xy = a.xy * n; q.xz = a.xz * n; q.xw = a.xw * n;
+		q.yy = a.yy * n; q.yz = a.yz * n; q.yw = a.yw * n;
+		q.zz = a.zz * n; q.zw = a.zw * n;
+		q.ww = a.ww * n;
+		return (q);
+	}
+
+
+	TERATHON_API void CalculateVertexQuadrics(int32 vertexCount, const Point3D *vertex, int32 triangleCount, const int32 *triangleIndex, Quadric3D *quadric, bool areaWeighted = true);
+	TERATHON_API void EvaluateQuadric(const Quadric3D& quadric, int32 count, const Point3D *point, float *error);
+	TERATHON_API void EvaluateQuadrics(int32 count, const Quadric3D *quadric, const Point3D *point, float *error);
+}
+
+
+#endif
@@ -0,0 +1,277 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSRayPacket.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	inline float CalculateInverseDirection(float d)
+	{
+		if (Fabs(d) < 1.0e-30F)
+		{
+			d = (d < 0.0F) ? -1.0e-30F : 1.0e-30F;
+		}
+
+		return (1.0F / d);
+	}
+}
+
+
+RayPacket::RayPacket()
+{
+	// All lanes are cleared so that a partial group of four rays never operates on uninitialized values.
+
+	rayCount = 0;
+	ClearMemory(rayData, sizeof(rayData));
+}
+
+/// @brief Stores a single ray in the packet.
+///
+/// The number of rays in the packet is not changed. It should be set with the \c SetRayCount() function.
+///
+/// @param index	The index of the ray.
+/// @param p		The origin of the ray.
+/// @param v		The direction of the ray.
+/// @param tmin		The minimum parameter of the ray.
+/// @param tmax		The maximum parameter of the ray.
+
+void RayPacket::SetRay(int32 index, const Point3D& p, const Vector3D& v, float tmin, float tmax)
+{
+	rayData[kComponentOriginX][index] = p.x;
+	rayData[kComponentOriginY][index] = p.y;
+	rayData[kComponentOriginZ][index] = p.z;
+	rayData[kComponentDirectionX][index] = v.x;
+	rayData[kComponentDirectionY][index] = v.y;
+	rayData[kComponentDirectionZ][index] = v.z;
+	rayData[kComponentInverseX][index] = CalculateInverseDirection(v.x);
+	rayData[kComponentInverseY][index] = CalculateInverseDirection(v.y);
+	rayData[kComponentInverseZ][index] = CalculateInverseDirection(v.z);
+	rayData[kComponentMinParam][index] = tmin;
+	rayData[kComponentMaxParam][index] = tmax;
+}
+
+/// @brief Stores a set of rays in the packet and sets the number of rays.
+/// @param count	The number of rays. This cannot be greater than \c kMaxRayCount.
+/// @param p		A pointer to an array of \c count ray origins.
+/// @param v		A pointer to an array of \c count ray directions.
+/// @param tmin		The minimum parameter of every ray.
+/// @param tmax		The maximum parameter of every ray.
+
+void RayPacket::SetRays(int32 count, const Point3D *p, const Vector3D *v, float tmin, float tmax)
+{
+	rayCount = count;
+
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		vec_float vmin = VecLoadSmearScalar(&tmin);
+		vec_float vmax = VecLoadSmearScalar(&tmax);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			vec_float	x, y, z;
+
+			VecLoadTranspose3D(&p[i].x, &x, &y, &z);
+			VecStore(x, &rayData[kComponentOriginX][i]);
+			VecStore(y, &rayData[kComponentOriginY][i]);
+			VecStore(z, &rayData[kComponentOriginZ][i]);
+
+			VecLoadTranspose3D(&v[i].x, &x, &y, &z);
+			VecStore(x, &rayData[kComponentDirectionX][i]);
+			VecStore(y, &rayData[kComponentDirectionY][i]);
+			VecStore(z, &rayData[kComponentDirectionZ][i]);
+
+			VecStore(vmin, &rayData[kComponentMinParam][i]);
+			VecStore(vmax, &rayData[kComponentMaxParam][i]);
+
+			for (machine k = i; k < i + 4; k++)
+			{
+				rayData[kComponentInverseX][k] = CalculateInverseDirection(rayData[kComponentDirectionX][k]);
+				rayData[kComponentInverseY][k] = CalculateInverseDirection(rayData[kComponentDirectionY][k]);
+				rayData[kComponentInverseZ][k] = CalculateInverseDirection(rayData[kComponentDirectionZ][k]);
+			}
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		SetRay(i, p[i], v[i], tmin, tmax);
+	}
+}
+
+/// @brief Stores a set of lines in the packet and sets the number of rays.
+///
+/// Each line <b>l</b> is stored as a ray whose origin is the point on the line closest to the origin,
+/// given by <b>l</b><sub>v</sub>&nbsp;&times;&nbsp;<b>l</b><sub>m</sub>&nbsp;/&nbsp;<b>l</b><sub>v</sub><sup>2</sup>,
+/// whose direction is the direction of the line, and whose parameter range is unbounded.
+///
+/// @param count	The number of lines. This cannot be greater than \c kMaxRayCount.
+/// @param line		A pointer to an array of \c count lines. The direction of each line must not be zero.
+
+void RayPacket::SetLines(int32 count, const Line3D *line)
+{
+	rayCount = count;
+	for (machine i = 0; i < count; i++)
+	{
+		const Vector3D& v = line[i].v;
+		const Bivector3D& m = line[i].m;
+		float f = 1.0F / (v.x * v.x + v.y * v.y + v.z * v.z);
+		Point3D p((v.y * m.z - v.z * m.y) * f, (v.z * m.x - v.x * m.z) * f, (v.x * m.y - v.y * m.x) * f);
+		SetRay(int32(i), p, v, -Math::max_float, Math::max_float);
+	}
+}
+
+/// @brief Calculates the lines containing all rays in the packet.
+///
+/// The line containing ray <i>i</i> is <b>p</b><sub><i>i</i></sub>&nbsp;&and;&nbsp;<b>v</b><sub><i>i</i></sub>.
+///
+/// @param line		A pointer to an array that receives one line for each ray in the packet.
+
+void RayPacket::GetLines(Line3D *line) const
+{
+	const float *px = rayData[kComponentOriginX];
+	const float *py = rayData[kComponentOriginY];
+	const float *pz = rayData[kComponentOriginZ];
+	const float *vx = rayData[kComponentDirectionX];
+	const float *vy = rayData[kComponentDirectionY];
+	const float *vz = rayData[kComponentDirectionZ];
+
+	for (machine i = 0; i < rayCount; i++)
+	{
+		line[i].Set(vx[i], vy[i], vz[i], py[i] * vz[i] - pz[i] * vy[i], pz[i] * vx[i] - px[i] * vz[i], px[i] * vy[i] - py[i] * vx[i]);
+	}
+}
+
+/// @brief Intersects all rays in the packet with a box.
+///
+/// The slab test calculates the parameters at which each ray enters and exits the box, clamped to the parameter range
+/// of the ray, and the ray hits the box if the entry parameter is not greater than the exit parameter. A ray whose
+/// origin is inside the box hits it with an entry parameter equal to its minimum parameter.
+///
+/// @param box			The box to test. An empty box is never hit.
+/// @param entryParam	A pointer to an array that receives the entry parameter for each ray. This can be \c nullptr.
+/// @param exitParam	A pointer to an array that receives the exit parameter for each ray. This can be \c nullptr.
+/// @return A bit mask in which bit <i>i</i> is set if ray <i>i</i> hits the box.
+
+uint32 RayPacket::IntersectBox(const Box3D& box, float *entryParam, float *exitParam) const
+{
+	if (box.Empty())
+	{
+		return (0);
+	}
+
+	uint32 mask = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		float bmin[3] = {box.min.x, box.min.y, box.min.z};
+		float bmax[3] = {box.max.x, box.max.y, box.max.z};
+
+		vec_float minX = VecLoadSmearScalar(&bmin[0]);
+		vec_float minY = VecLoadSmearScalar(&bmin[1]);
+		vec_float minZ = VecLoadSmearScalar(&bmin[2]);
+		vec_float maxX = VecLoadSmearScalar(&bmax[0]);
+		vec_float maxY = VecLoadSmearScalar(&bmax[1]);
+		vec_float maxZ = VecLoadSmearScalar(&bmax[2]);
+
+		alignas(16) float	entry[kMaxRayCount];
+		alignas(16) float	exit[kMaxRayCount];
+
+		for (machine i = 0; i < rayCount; i += 4)
+		{
+			vec_float ix = VecLoad(&rayData[kComponentInverseX][i]);
+			vec_float iy = VecLoad(&rayData[kComponentInverseY][i]);
+			vec_float iz = VecLoad(&rayData[kComponentInverseZ][i]);
+
+			// The slab distances are (b - p) / v. Taking the minimum and maximum of the two distances
+			// along each axis handles both signs of the direction without branches.
+
+			vec_float tx1 = VecMul(VecSub(minX, VecLoad(&rayData[kComponentOriginX][i])), ix);
+			vec_float tx2 = VecMul(VecSub(maxX, VecLoad(&rayData[kComponentOriginX][i])), ix);
+			vec_float ty1 = VecMul(VecSub(minY, VecLoad(&rayData[kComponentOriginY][i])), iy);
+			vec_float ty2 = VecMul(VecSub(maxY, VecLoad(&rayData[kComponentOriginY][i])), iy);
+			vec_float tz1 = VecMul(VecSub(minZ, VecLoad(&rayData[kComponentOriginZ][i])), iz);
+			vec_float tz2 = VecMul(VecSub(maxZ, VecLoad(&rayData[kComponentOriginZ][i])), iz);
+
+			vec_float tmin = VecMax(VecMax(VecMin(tx1, tx2), VecMin(ty1, ty2)), VecMax(VecMin(tz1, tz2), VecLoad(&rayData[kComponentMinParam][i])));
+			vec_float tmax = VecMin(VecMin(VecMax(tx1, tx2), VecMax(ty1, ty2)), VecMin(VecMax(tz1, tz2), VecLoad(&rayData[kComponentMaxParam][i])));
+
+			VecStore(tmin, &entry[i]);
+			VecStore(tmax, &exit[i]);
+			mask |= (VecMaskGetBits(VecMaskCmpgt(tmin, tmax)) ^ 15U) << i;
+		}
+
+		mask &= GetRayMask();
+
+		for (machine i = 0; i < rayCount; i++)
+		{
+			if (entryParam)
+			{
+				entryParam[i] = entry[i];
+			}
+
+			if (exitParam)
+			{
+				exitParam[i] = exit[i];
+			}
+		}
+
+	#else
+
+		for (machine i = 0; i < rayCount; i++)
+		{
+			float tmin = rayData[kComponentMinParam][i];
+			float tmax = rayData[kComponentMaxParam][i];
+
+			for (machine a = 0; a < 3; a++)
+			{
+				float p = rayData[kComponentOriginX + a][i];
+				float f = rayData[kComponentInverseX + a][i];
+				float t1 = (box.min[a] - p) * f;
+				float t2 = (box.max[a] - p) * f;
+				tmin = Fmax(tmin, Fmin(t1, t2));
+				tmax = Fmin(tmax, Fmax(t1, t2));
+			}
+
+			if (entryParam)
+			{
+				entryParam[i] = tmin;
+			}
+
+			if (exitParam)
+			{
+				exitParam[i] = tmax;
+			}
+
+			mask |= uint32(tmin <= tmax) << i;
+		}
+
+	#endif
+
+	return (mask);
+}
+
+/// @brief Intersects all rays in the packet with each box in an array.
+/// @param boxCount		The number of boxes.
+/// @param box			A pointer to an array of \c boxCount boxes.
+/// @param mask			A pointer to an array of \c boxCount bit masks. Bit <i>i</i> of entry <i>k</i> is set if ray <i>i</i> hits box <i>k</i>.
+
+void RayPacket::IntersectBoxes(int32 boxCount, const Box3D *box, uint32 *mask) const
+{
+	for (machine k = 0; k < boxCount; k++)
+	{
+		mask[k] = IntersectBox(box[k]);
+	}
+}
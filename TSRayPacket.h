@@ -0,0 +1,171 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSRayPacket_h
+#define TSRayPacket_h
+
+
+#include "TSBox3D.h"
+
+
+#define TERATHON_RAYPACKET 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	RayPacket
+	// ==============================================
+
+	/// @brief Stores a packet of up to 16 rays in structure-of-arrays layout.
+	///
+	/// The \c RayPacket class stores the origin <b>p</b>, direction <b>v</b>, and parameter range [<i>t</i><sub>min</sub>,&nbsp;<i>t</i><sub>max</sub>]
+	/// of each ray in separate aligned arrays along with the reciprocals of the direction components, which are calculated when
+	/// a ray is stored. A ray consists of the points <b>p</b>&nbsp;+&nbsp;<i>t</i><b>v</b> for <i>t</i> in its parameter range.
+	/// The slab tests against boxes process four rays at a time with SIMD instructions and report the rays that hit a box
+	/// as a bit mask in which bit <i>i</i> corresponds to ray <i>i</i>.
+	///
+	/// Direction components whose magnitudes are smaller than 10<sup>&minus;30</sup> are treated as having that magnitude when the
+	/// reciprocals are calculated, so no slab test ever multiplies zero by infinity.
+	///
+	/// Rays can also be converted to and from lines in rigid geometric algebra. The line containing a ray is <b>p</b>&nbsp;&and;&nbsp;<b>v</b>,
+	/// and a ray made from a line starts at the point on the line closest to the origin and extends infinitely in both directions.
+
+	class RayPacket
+	{
+		public:
+
+			enum : uint32
+			{
+				kMaxRayCount		= 16
+			};
+
+			/// @brief Identifies the components stored for each ray.
+
+			enum
+			{
+				kComponentOriginX,
+				kComponentOriginY,
+				kComponentOriginZ,
+				kComponentDirectionX,
+				kComponentDirectionY,
+				kComponentDirectionZ,
+				kComponentInverseX,
+				kComponentInverseY,
+				kComponentInverseZ,
+				kComponentMinParam,
+				kComponentMaxParam,
+				kComponentCount
+			};
+
+		private:
+
+			int32				rayCount;
+
+			alignas(16) float	rayData[kComponentCount][kMaxRayCount];
+
+		public:
+
+			TERATHON_API RayPacket();
+
+			/// @brief Returns the number of rays in the packet.
+
+			int32 GetRayCount(void) const
+			{
+				return (rayCount);
+			}
+
+			/// @brief Sets the number of rays in the packet.
+			/// @param count	The new number of rays. This cannot be greater than \c kMaxRayCount.
+
+			void SetRayCount(int32 count)
+			{
+				rayCount = count;
+			}
+
+			/// @brief Returns a bit mask having one bit set for each ray in the packet.
+
+			uint32 GetRayMask(void) const
+			{
+				return ((1U << rayCount) - 1U);
+			}
+
+			/// @brief Returns the origin of a ray.
+			/// @param index	The index of the ray.
+
+			Point3D GetOrigin(int32 index) const
+			{
+				return (Point3D(rayData[kComponentOriginX][index], rayData[kComponentOriginY][index], rayData[kComponentOriginZ][index]));
+			}
+
+			/// @brief Returns the direction of a ray.
+			/// @param index	The index of the ray.
+
+			Vector3D GetDirection(int32 index) const
+			{
+				return (Vector3D(rayData[kComponentDirectionX][index], rayData[kComponentDirectionY][index], rayData[kComponentDirectionZ][index]));
+			}
+
+			/// @brief Returns the minimum parameter of a ray.
+			/// @param index	The index of the ray.
+
+			float GetMinParam(int32 index) const
+			{
+				return (rayData[kComponentMinParam][index]);
+			}
+
+			/// @brief Returns the maximum parameter of a ray.
+			/// @param index	The index of the ray.
+
+			float GetMaxParam(int32 index) const
+			{
+				return (rayData[kComponentMaxParam][index]);
+			}
+
+			/// @brief Sets the maximum parameter of a ray.
+			///
+			/// This is typically called to shorten a ray when a closer hit is found so that farther boxes are rejected.
+			///
+			/// @param index	The index of the ray.
+			/// @param t		The new maximum parameter.
+
+			void SetMaxParam(int32 index, float t)
+			{
+				rayData[kComponentMaxParam][index] = t;
+			}
+
+			/// @brief Returns a pointer to the aligned array holding one component of every ray.
+			///
+			/// @param index	The index of the component, such as \c kComponentOriginX.
+
+			const float *GetComponent(int32 index) const
+			{
+				return (rayData[index]);
+			}
+
+			/// @brief Returns the line containing a ray.
+			/// @param index	The index of the ray.
+
+			Line3D GetLine(int32 index) const
+			{
+				return (Wedge(GetOrigin(index), GetDirection(index)));
+			}
+
+			TERATHON_API void SetRay(int32 index, const Point3D& p, const Vector3D& v, float tmin = 0.0F, float tmax = Math::infinity);
+			TERATHON_API void SetRays(int32 count, const Point3D *p, const Vector3D *v, float tmin = 0.0F, float tmax = Math::infinity);
+			TERATHON_API void SetLines(int32 count, const Line3D *line);
+			TERATHON_API void GetLines(Line3D *line) const;
+
+			TERATHON_API uint32 IntersectBox(const Box3D& box, float *entryParam = nullptr, float *exitParam = nullptr) const;
+			TERATHON_API void IntersectBoxes(int32 boxCount, const Box3D *box, uint32 *mask) const;
+	};
+}
+
+
+#endif
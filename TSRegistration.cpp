@@ -0,0 +1,446 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSRegistration.h"
+#include "TSEigen.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	// The eighteen partial sums are stored in the order W, P(3), Q(3), C(9), Sp, Sq, where P and Q are the weighted sums
+	// of the source and target points relative to their origins, C is the row-major weighted sum of the outer products
+	// p q^T, and Sp and Sq are the weighted sums of the squared magnitudes of the relative source and target points.
+
+	enum
+	{
+		kRegistrationSumCount = 18
+	};
+
+
+	inline void AccumulatePair(float px, float py, float pz, float qx, float qy, float qz, float k, float *sum)
+	{
+		float kx = k * px;
+		float ky = k * py;
+		float kz = k * pz;
+
+		sum[0] += k;
+		sum[1] += kx;
+		sum[2] += ky;
+		sum[3] += kz;
+		sum[4] += k * qx;
+		sum[5] += k * qy;
+		sum[6] += k * qz;
+		sum[7] += kx * qx;
+		sum[8] += kx * qy;
+		sum[9] += kx * qz;
+		sum[10] += ky * qx;
+		sum[11] += ky * qy;
+		sum[12] += ky * qz;
+		sum[13] += kz * qx;
+		sum[14] += kz * qy;
+		sum[15] += kz * qz;
+		sum[16] += kx * px + ky * py + kz * pz;
+		sum[17] += k * (qx * qx + qy * qy + qz * qz);
+	}
+
+	#ifndef TERATHON_NO_SIMD
+
+		inline void AccumulatePairs(const vec_float& px, const vec_float& py, const vec_float& pz, const vec_float& qx, const vec_float& qy, const vec_float& qz, const vec_float& k, vec_float *sum)
+		{
+			vec_float kx = VecMul(k, px);
+			vec_float ky = VecMul(k, py);
+			vec_float kz = VecMul(k, pz);
+
+			sum[0] = VecAdd(sum[0], k);
+			sum[1] = VecAdd(sum[1], kx);
+			sum[2] = VecAdd(sum[2], ky);
+			sum[3] = VecAdd(sum[3], kz);
+			sum[4] = VecMadd(k, qx, sum[4]);
+			sum[5] = VecMadd(k, qy, sum[5]);
+			sum[6] = VecMadd(k, qz, sum[6]);
+			sum[7] = VecMadd(kx, qx, sum[7]);
+			sum[8] = VecMadd(kx, qy, sum[8]);
+			sum[9] = VecMadd(kx, qz, sum[9]);
+			sum[10] = VecMadd(ky, qx, sum[10]);
+			sum[11] = VecMadd(ky, qy, sum[11]);
+			sum[12] = VecMadd(ky, qz, sum[12]);
+			sum[13] = VecMadd(kz, qx, sum[13]);
+			sum[14] = VecMadd(kz, qy, sum[14]);
+			sum[15] = VecMadd(kz, qz, sum[15]);
+			sum[16] = VecMadd(kz, pz, VecMadd(ky, py, VecMadd(kx, px, sum[16])));
+			sum[17] = VecMadd(k, VecMadd(qz, qz, VecMadd(qy, qy, VecMul(qx, qx))), sum[17]);
+		}
+
+		inline void StoreSums(const vec_float *v, float *sum)
+		{
+			alignas(16) float	f[4];
+
+			for (machine a = 0; a < kRegistrationSumCount; a++)
+			{
+				VecStore(v[a], f);
+				sum[a] += (f[0] + f[1]) + (f[2] + f[3]);
+			}
+		}
+
+	#endif
+}
+
+
+RegistrationAccumulator::RegistrationAccumulator()
+{
+	Reset();
+}
+
+/// @brief Removes all accumulated point pairs.
+
+void RegistrationAccumulator::Reset(void)
+{
+	weightSum = 0.0F;
+	for (machine a = 0; a < 3; a++)
+	{
+		sourceOrigin[a] = 0.0F;
+		targetOrigin[a] = 0.0F;
+		sourceSum[a] = 0.0F;
+		targetSum[a] = 0.0F;
+	}
+
+	for (machine a = 0; a < 9; a++)
+	{
+		covarianceSum[a] = 0.0F;
+	}
+
+	sourceSquaredSum = 0.0F;
+	targetSquaredSum = 0.0F;
+}
+
+void RegistrationAccumulator::AccumulateSums(const float (& sum)[18])
+{
+	weightSum += sum[0];
+	for (machine a = 0; a < 3; a++)
+	{
+		sourceSum[a] += sum[a + 1];
+		targetSum[a] += sum[a + 4];
+	}
+
+	for (machine a = 0; a < 9; a++)
+	{
+		covarianceSum[a] += sum[a + 7];
+	}
+
+	sourceSquaredSum += sum[16];
+	targetSquaredSum += sum[17];
+}
+
+/// @brief Adds the point pairs accumulated by another registration accumulator to this one.
+/// @param accumulator	The accumulator whose point pairs are added.
+///
+/// The sums held by the other accumulator are converted so that they are relative to the origin used by this accumulator.
+
+void RegistrationAccumulator::Merge(const RegistrationAccumulator& accumulator)
+{
+	if (weightSum == 0.0F)
+	{
+		*this = accumulator;
+		return;
+	}
+
+	float w = accumulator.weightSum;
+	if (w == 0.0F)
+	{
+		return;
+	}
+
+	float	a[3], b[3];
+	float	sum[kRegistrationSumCount];
+
+	// Moving the origin by the offsets a and b changes each relative source point p into p + a
+	// and each relative target point q into q + b.
+
+	for (machine i = 0; i < 3; i++)
+	{
+		a[i] = accumulator.sourceOrigin[i] - sourceOrigin[i];
+		b[i] = accumulator.targetOrigin[i] - targetOrigin[i];
+	}
+
+	const float *P = accumulator.sourceSum;
+	const float *Q = accumulator.targetSum;
+
+	sum[0] = w;
+	for (machine i = 0; i < 3; i++)
+	{
+		sum[i + 1] = P[i] + a[i] * w;
+		sum[i + 4] = Q[i] + b[i] * w;
+
+		for (machine j = 0; j < 3; j++)
+		{
+			sum[i * 3 + j + 7] = accumulator.covarianceSum[i * 3 + j] + a[i] * Q[j] + P[i] * b[j] + a[i] * b[j] * w;
+		}
+	}
+
+	sum[16] = accumulator.sourceSquaredSum + (a[0] * P[0] + a[1] * P[1] + a[2] * P[2]) * 2.0F + (a[0] * a[0] + a[1] * a[1] + a[2] * a[2]) * w;
+	sum[17] = accumulator.targetSquaredSum + (b[0] * Q[0] + b[1] * Q[1] + b[2] * Q[2]) * 2.0F + (b[0] * b[0] + b[1] * b[1] + b[2] * b[2]) * w;
+
+	AccumulateSums(sum);
+}
+
+/// @brief Accumulates an array of corresponding point pairs.
+/// @param count	The number of point pairs.
+/// @param source	A pointer to an array of \c count source points.
+/// @param target	A pointer to an array of \c count target points. The point \c source[i] corresponds to \c target[i].
+/// @param weight	A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one.
+
+void RegistrationAccumulator::AddPoints(int32 count, const Point3D *source, const Point3D *target, const float *weight)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	if (weightSum == 0.0F)
+	{
+		for (machine a = 0; a < 3; a++)
+		{
+			sourceOrigin[a] = (&source->x)[a];
+			targetOrigin[a] = (&target->x)[a];
+		}
+	}
+
+	float sum[kRegistrationSumCount] = {};
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		if (count >= 4)
+		{
+			vec_float	acc[kRegistrationSumCount];
+			vec_float	px, py, pz, qx, qy, qz;
+
+			for (machine a = 0; a < kRegistrationSumCount; a++)
+			{
+				acc[a] = VecFloatGetZero();
+			}
+
+			vec_float ax = VecLoadSmearScalar(&sourceOrigin[0]);
+			vec_float ay = VecLoadSmearScalar(&sourceOrigin[1]);
+			vec_float az = VecLoadSmearScalar(&sourceOrigin[2]);
+			vec_float bx = VecLoadSmearScalar(&targetOrigin[0]);
+			vec_float by = VecLoadSmearScalar(&targetOrigin[1]);
+			vec_float bz = VecLoadSmearScalar(&targetOrigin[2]);
+			vec_float k = VecLoadVectorConstant<0x3F800000>();
+
+			for (; i <= count - 4; i += 4)
+			{
+				VecLoadTranspose3D(&source[i].x, &px, &py, &pz);
+				VecLoadTranspose3D(&target[i].x, &qx, &qy, &qz);
+				if (weight)
+				{
+					k = VecLoadUnaligned(weight + i);
+				}
+
+				AccumulatePairs(VecSub(px, ax), VecSub(py, ay), VecSub(pz, az), VecSub(qx, bx), VecSub(qy, by), VecSub(qz, bz), k, acc);
+			}
+
+			StoreSums(acc, sum);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		const Point3D& p = source[i];
+		const Point3D& q = target[i];
+		float k = (weight) ? weight[i] : 1.0F;
+		AccumulatePair(p.x - sourceOrigin[0], p.y - sourceOrigin[1], p.z - sourceOrigin[2], q.x - targetOrigin[0], q.y - targetOrigin[1], q.z - targetOrigin[2], k, sum);
+	}
+
+	AccumulateSums(sum);
+}
+
+/// @brief Accumulates a range of corresponding point pairs stored in planar arrays.
+/// @param start	The index of the first point pair.
+/// @param count	The number of point pairs.
+/// @param source	The array containing the source points.
+/// @param target	The array containing the target points. The point with index \c i in \c source corresponds to the point with the same index in \c target.
+/// @param weight	A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one. The first weight corresponds to the point pair with index \c start.
+
+void RegistrationAccumulator::AddPoints(int32 start, int32 count, const Point3DArray& source, const Point3DArray& target, const float *weight)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	const float *sx = source.GetX() + start;
+	const float *sy = source.GetY() + start;
+	const float *sz = source.GetZ() + start;
+	const float *tx = target.GetX() + start;
+	const float *ty = target.GetY() + start;
+	const float *tz = target.GetZ() + start;
+
+	if (weightSum == 0.0F)
+	{
+		sourceOrigin[0] = sx[0];
+		sourceOrigin[1] = sy[0];
+		sourceOrigin[2] = sz[0];
+		targetOrigin[0] = tx[0];
+		targetOrigin[1] = ty[0];
+		targetOrigin[2] = tz[0];
+	}
+
+	float sum[kRegistrationSumCount] = {};
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		if (count >= 4)
+		{
+			vec_float	acc[kRegistrationSumCount];
+
+			for (machine a = 0; a < kRegistrationSumCount; a++)
+			{
+				acc[a] = VecFloatGetZero();
+			}
+
+			vec_float ax = VecLoadSmearScalar(&sourceOrigin[0]);
+			vec_float ay = VecLoadSmearScalar(&sourceOrigin[1]);
+			vec_float az = VecLoadSmearScalar(&sourceOrigin[2]);
+			vec_float bx = VecLoadSmearScalar(&targetOrigin[0]);
+			vec_float by = VecLoadSmearScalar(&targetOrigin[1]);
+			vec_float bz = VecLoadSmearScalar(&targetOrigin[2]);
+			vec_float k = VecLoadVectorConstant<0x3F800000>();
+
+			for (; i <= count - 4; i += 4)
+			{
+				if (weight)
+				{
+					k = VecLoadUnaligned(weight + i);
+				}
+
+				AccumulatePairs(VecSub(VecLoadUnaligned(sx + i), ax), VecSub(VecLoadUnaligned(sy + i), ay), VecSub(VecLoadUnaligned(sz + i), az),
+				                VecSub(VecLoadUnaligned(tx + i), bx), VecSub(VecLoadUnaligned(ty + i), by), VecSub(VecLoadUnaligned(tz + i), bz), k, acc);
+			}
+
+			StoreSums(acc, sum);
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		float k = (weight) ? weight[i] : 1.0F;
+		AccumulatePair(sx[i] - sourceOrigin[0], sy[i] - sourceOrigin[1], sz[i] - sourceOrigin[2], tx[i] - targetOrigin[0], ty[i] - targetOrigin[1], tz[i] - targetOrigin[2], k, sum);
+	}
+
+	AccumulateSums(sum);
+}
+
+/// @brief Calculates the rigid motion that best aligns the accumulated source points with the target points.
+/// @param squaredError		A pointer to a location that receives the weighted mean squared distance between the transformed source points and the target points. This can be \c nullptr.
+///
+/// The return value is the unitized motor <b>Q</b> minimizing the weighted sum of the squared distances between the source points
+/// transformed by <b>Q</b> and the corresponding target points. If no point pairs with positive weight have been accumulated,
+/// then the return value is the identity. If the points are degenerate, for example when they all lie on a single line, then
+/// the rotation is not unique, and one of the optimal rotations is returned.
+///
+/// The squared error is derived from the accumulated sums without visiting the points again, so its absolute precision is
+/// limited to a small fraction of the squared spread of the points. A residual much smaller than that is reported as zero.
+
+Motor3D RegistrationAccumulator::CalculateMotor(float *squaredError) const
+{
+	Vector4D	eigenvalues;
+	Matrix4D	eigenvectors;
+
+	float w = weightSum;
+	if (!(w > 0.0F))
+	{
+		if (squaredError)
+		{
+			*squaredError = 0.0F;
+		}
+
+		return (Motor3D::identity);
+	}
+
+	// Remove the centroids from the cross-covariance, and construct Horn's symmetric matrix with the rows and columns
+	// arranged so that the eigenvector holds the quaternion components in the order x, y, z, w.
+
+	float f = 1.0F / w;
+	const float *P = sourceSum;
+	const float *Q = targetSum;
+
+	float	S[3][3];
+
+	for (machine i = 0; i < 3; i++)
+	{
+		for (machine j = 0; j < 3; j++)
+		{
+			S[i][j] = covarianceSum[i * 3 + j] - P[i] * Q[j] * f;
+		}
+	}
+
+	float n00 = S[0][0] - S[1][1] - S[2][2];
+	float n11 = S[1][1] - S[0][0] - S[2][2];
+	float n22 = S[2][2] - S[0][0] - S[1][1];
+	float n33 = S[0][0] + S[1][1] + S[2][2];
+	float n01 = S[0][1] + S[1][0];
+	float n02 = S[2][0] + S[0][2];
+	float n12 = S[1][2] + S[2][1];
+	float n03 = S[1][2] - S[2][1];
+	float n13 = S[2][0] - S[0][2];
+	float n23 = S[0][1] - S[1][0];
+
+	Matrix4D N(n00, n01, n02, n03, n01, n11, n12, n13, n02, n12, n22, n23, n03, n13, n23, n33);
+	CalculateEigensystem(N, &eigenvalues, &eigenvectors);
+
+	float sign = (eigenvectors(3,0) < 0.0F) ? -1.0F : 1.0F;
+	Quaternion r(eigenvectors(0,0) * sign, eigenvectors(1,0) * sign, eigenvectors(2,0) * sign, eigenvectors(3,0) * sign);
+
+	if (squaredError)
+	{
+		float sp = sourceSquaredSum - (P[0] * P[0] + P[1] * P[1] + P[2] * P[2]) * f;
+		float sq = targetSquaredSum - (Q[0] * Q[0] + Q[1] * Q[1] + Q[2] * Q[2]) * f;
+
+		// The largest eigenvalue is recalculated as the quadratic form of the normalized eigenvector because
+		// it is subtracted from the spreads, and any error in it is magnified when the residual is small.
+
+		Vector4D v(r.x, r.y, r.z, r.w);
+		float lambda = Dot(v, N * v);
+		*squaredError = FmaxZero((sp + sq - lambda * 2.0F) * f);
+	}
+
+	// The translation carries the rotated source centroid to the target centroid.
+
+	Vector3D sourceCentroid(sourceOrigin[0] + P[0] * f, sourceOrigin[1] + P[1] * f, sourceOrigin[2] + P[2] * f);
+	Vector3D targetCentroid(targetOrigin[0] + Q[0] * f, targetOrigin[1] + Q[1] * f, targetOrigin[2] + Q[2] * f);
+	Vector3D t = targetCentroid - r.GetRotationMatrix() * sourceCentroid;
+	return (Motor3D::MakeTranslation(t) * Motor3D(r));
+}
+
+
+/// @brief Calculates the rigid motion that best aligns an array of source points with an array of target points.
+/// @param count			The number of point pairs.
+/// @param source			A pointer to an array of \c count source points.
+/// @param target			A pointer to an array of \c count target points. The point \c source[i] corresponds to \c target[i].
+/// @param weight			A pointer to an array of \c count nonnegative weights. If this is \c nullptr, then every weight is one.
+/// @param squaredError		A pointer to a location that receives the weighted mean squared distance between the transformed source points and the target points. This can be \c nullptr.
+///
+/// See the \c RegistrationAccumulator class for a description of the method.
+///
+/// @relatedalso Motor3D
+
+Motor3D Terathon::CalculateRigidAlignment(int32 count, const Point3D *source, const Point3D *target, const float *weight, float *squaredError)
+{
+	RegistrationAccumulator		accumulator;
+
+	accumulator.AddPoints(count, source, target, weight);
+	return (accumulator.CalculateMotor(squaredError));
+}
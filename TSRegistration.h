@@ -0,0 +1,78 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSRegistration_h
+#define TSRegistration_h
+
+
+#include "TSGeometryArray.h"
+
+
+#define TERATHON_REGISTRATION 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	RegistrationAccumulator
+	// ==============================================
+
+	/// @brief Accumulates corresponding pairs of points for the calculation of a best-fit rigid alignment.
+	///
+	/// The \c RegistrationAccumulator class stores the weighted centroids, the 3&nbsp;&times;&nbsp;3 cross-covariance matrix, and
+	/// the weighted squared spreads of a set of source and target point pairs, all gathered in a single pass. The rigid motion
+	/// that best maps the source points onto the target points in the least-squares sense is then calculated with Horn's method,
+	/// which finds the rotation as the eigenvector corresponding to the largest eigenvalue of a symmetric 4&nbsp;&times;&nbsp;4 matrix.
+	/// The result is always a proper rotation, never a reflection.
+	///
+	/// The sums are stored relative to the first pair of points added to the accumulator so that precision is not lost when the
+	/// points are far from the origin. Large point sets can be divided into ranges that are accumulated independently, for example
+	/// on different threads, and the partial results are then combined with the \c Merge() function.
+
+	class RegistrationAccumulator
+	{
+		private:
+
+			float			weightSum;
+			float			sourceOrigin[3];
+			float			targetOrigin[3];
+			float			sourceSum[3];
+			float			targetSum[3];
+			float			covarianceSum[9];
+			float			sourceSquaredSum;
+			float			targetSquaredSum;
+
+			void AccumulateSums(const float (& sum)[18]);
+
+		public:
+
+			TERATHON_API RegistrationAccumulator();
+
+			/// @brief Returns the total weight of the point pairs that have been accumulated.
+
+			float GetWeightSum(void) const
+			{
+				return (weightSum);
+			}
+
+			TERATHON_API void Reset(void);
+			TERATHON_API void Merge(const RegistrationAccumulator& accumulator);
+
+			TERATHON_API void AddPoints(int32 count, const Point3D *source, const Point3D *target, const float *weight = nullptr);
+			TERATHON_API void AddPoints(int32 start, int32 count, const Point3DArray& source, const Point3DArray& target, const float *weight = nullptr);
+
+			TERATHON_API Motor3D CalculateMotor(float *squaredError = nullptr) const;
+	};
+
+
+	TERATHON_API Motor3D CalculateRigidAlignment(int32 count, const Point3D *source, const Point3D *target, const float *weight = nullptr, float *squaredError = nullptr);
+}
+
+
+#endif
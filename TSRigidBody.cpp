@@ -0,0 +1,602 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSRigidBody.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	// The integrators are written once for a generic lane type, which is float for single bodies
+	// and vec_float for groups of four bodies. The functions below are the only places where
+	// the two lane types need different code.
+
+	inline float MakeLane(float f, float)
+	{
+		return (f);
+	}
+
+	inline void LoadLane(const float *ptr, float *x)
+	{
+		*x = *ptr;
+	}
+
+	inline void StoreLane(const float& x, float *ptr)
+	{
+		*ptr = x;
+	}
+
+	inline void GetExpFactors(const float& phi2, float *k, float *c, float *g)
+	{
+		// Calculates k = sin(phi) / phi, c = cos(phi), and g = (cos(phi) - sin(phi) / phi) / phi^2. Series are used
+		// for small angles because the sine must be accurate relative to its own size and the numerator of g cancels badly.
+
+		if (phi2 < 0.0625F)
+		{
+			*k = 1.0F - phi2 * (0.16666667F - phi2 * (0.0083333333F - phi2 * 1.9841270e-4F));
+			*c = 1.0F - phi2 * (0.5F - phi2 * (0.041666667F - phi2 * (0.0013888889F - phi2 * 2.4801587e-5F)));
+			*g = phi2 * (0.033333333F - phi2 * 0.0011904762F) - 0.33333333F;
+		}
+		else
+		{
+			float	s;
+
+			float r = InverseSqrt(phi2);
+			CosSin(phi2 * r, c, &s);
+			*k = s * r;
+			*g = (*c - *k) * (r * r);
+		}
+	}
+
+	inline float GetInverseSqrt(const float& x)
+	{
+		return (InverseSqrt(x));
+	}
+
+	#ifndef TERATHON_NO_SIMD
+
+		inline vec_float MakeLane(float f, const vec_float&)
+		{
+			return (VecLoadSmearScalar(&f));
+		}
+
+		inline void LoadLane(const float *ptr, vec_float *x)
+		{
+			*x = VecLoadUnaligned(ptr);
+		}
+
+		inline void StoreLane(const vec_float& x, float *ptr)
+		{
+			VecStoreUnaligned(x, ptr);
+		}
+
+		inline void GetExpFactors(const vec_float& phi2, vec_float *k, vec_float *c, vec_float *g)
+		{
+			vec_float	cosine, sine;
+
+			float minFloat = Math::min_float;
+			vec_float r = VecInverseSqrt(VecMax(phi2, VecLoadSmearScalar(&minFloat)));
+			VecCosSin(phi2 * r, &cosine, &sine);
+			vec_float kt = sine * r;
+			vec_float gt = (cosine - kt) * (r * r);
+
+			vec_float one = VecLoadVectorConstant<0x3F800000>();
+			vec_float ks = one - phi2 * (MakeLane(0.16666667F, phi2) - phi2 * (MakeLane(0.0083333333F, phi2) - phi2 * MakeLane(1.9841270e-4F, phi2)));
+			vec_float cs = one - phi2 * (MakeLane(0.5F, phi2) - phi2 * (MakeLane(0.041666667F, phi2) - phi2 * (MakeLane(0.0013888889F, phi2) - phi2 * MakeLane(2.4801587e-5F, phi2))));
+			vec_float gs = phi2 * (MakeLane(0.033333333F, phi2) - phi2 * MakeLane(0.0011904762F, phi2)) - MakeLane(0.33333333F, phi2);
+
+			vec_float small = VecMaskCmplt(phi2, MakeLane(0.0625F, phi2));
+			*k = VecSelect(kt, ks, small);
+			*c = VecSelect(cosine, cs, small);
+			*g = VecSelect(gt, gs, small);
+		}
+
+		inline vec_float GetInverseSqrt(const vec_float& x)
+		{
+			return (VecInverseSqrt(x));
+		}
+
+	#endif
+
+
+	template <typename type> struct LaneVector
+	{
+		type	x, y, z;
+	};
+
+	template <typename type> struct LaneLine
+	{
+		LaneVector<type>	v;
+		LaneVector<type>	m;
+	};
+
+	template <typename type> struct LaneMotor
+	{
+		LaneVector<type>	v;
+		type				vw;
+		LaneVector<type>	m;
+		type				mw;
+	};
+
+	template <typename type> struct LaneBody
+	{
+		LaneMotor<type>		pose;
+		LaneLine<type>		momentum;
+		LaneLine<type>		wrench;
+		type				inverseMass;
+		LaneVector<type>	inverseMoment;
+	};
+
+
+	template <typename type> inline LaneVector<type> Add(const LaneVector<type>& a, const LaneVector<type>& b)
+	{
+		return (LaneVector<type>{a.x + b.x, a.y + b.y, a.z + b.z});
+	}
+
+	template <typename type> inline LaneVector<type> Subtract(const LaneVector<type>& a, const LaneVector<type>& b)
+	{
+		return (LaneVector<type>{a.x - b.x, a.y - b.y, a.z - b.z});
+	}
+
+	template <typename type> inline LaneVector<type> Scale(const LaneVector<type>& a, const type& s)
+	{
+		return (LaneVector<type>{a.x * s, a.y * s, a.z * s});
+	}
+
+	template <typename type> inline LaneVector<type> ScaleAdd(const LaneVector<type>& a, const type& s, const LaneVector<type>& b)
+	{
+		return (LaneVector<type>{a.x * s + b.x, a.y * s + b.y, a.z * s + b.z});
+	}
+
+	template <typename type> inline LaneVector<type> Multiply(const LaneVector<type>& a, const LaneVector<type>& b)
+	{
+		return (LaneVector<type>{a.x * b.x, a.y * b.y, a.z * b.z});
+	}
+
+	template <typename type> inline LaneVector<type> Cross(const LaneVector<type>& a, const LaneVector<type>& b)
+	{
+		return (LaneVector<type>{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x});
+	}
+
+	template <typename type> inline type Dot(const LaneVector<type>& a, const LaneVector<type>& b)
+	{
+		return (a.x * b.x + a.y * b.y + a.z * b.z);
+	}
+
+	template <typename type> inline LaneLine<type> Add(const LaneLine<type>& a, const LaneLine<type>& b)
+	{
+		return (LaneLine<type>{Add(a.v, b.v), Add(a.m, b.m)});
+	}
+
+	template <typename type> inline LaneLine<type> ScaleAdd(const LaneLine<type>& a, const type& s, const LaneLine<type>& b)
+	{
+		return (LaneLine<type>{ScaleAdd(a.v, s, b.v), ScaleAdd(a.m, s, b.m)});
+	}
+
+	template <typename type> inline LaneLine<type> Scale(const LaneLine<type>& a, const type& s)
+	{
+		return (LaneLine<type>{Scale(a.v, s), Scale(a.m, s)});
+	}
+
+
+	template <typename type> LaneMotor<type> Multiply(const LaneMotor<type>& a, const LaneMotor<type>& b)
+	{
+		// This is the same product calculated by operator *(const Motor3D&, const Motor3D&).
+
+		LaneMotor<type>		q;
+
+		q.v = ScaleAdd(b.v, a.vw, ScaleAdd(a.v, b.vw, Cross(a.v, b.v)));
+		q.vw = a.vw * b.vw - Dot(a.v, b.v);
+		q.m = Add(ScaleAdd(b.v, a.mw, ScaleAdd(a.m, b.vw, Cross(a.m, b.v))), ScaleAdd(a.v, b.mw, ScaleAdd(b.m, a.vw, Cross(a.v, b.m))));
+		q.mw = a.mw * b.vw + b.mw * a.vw - Dot(a.m, b.v) - Dot(b.m, a.v);
+		return (q);
+	}
+
+	template <typename type> LaneMotor<type> Exp(const LaneLine<type>& l)
+	{
+		// This is the same exponential calculated by Exp(const Line3D&), with the identities
+		// sin(phi) / phi = k and delta * sin(phi) = k * dot(l.v, l.m) used to remove divisions.
+
+		LaneMotor<type>		q;
+		type				k, c, g;
+
+		type phi2 = Dot(l.v, l.v);
+		type lvlm = Dot(l.v, l.m);
+		GetExpFactors(phi2, &k, &c, &g);
+
+		q.v = Scale(l.v, k);
+		q.vw = c;
+		q.m = ScaleAdd(l.v, g * lvlm, Scale(l.m, k));
+		q.mw = -lvlm * k;
+		return (q);
+	}
+
+	template <typename type> void Unitize(LaneMotor<type> *q)
+	{
+		// Rounding errors in repeated products slowly violate both the unit weight and the geometric constraint
+		// dot(v, m) = 0 of a motor, so the bulk is also projected back onto the constraint.
+
+		type r = GetInverseSqrt(Dot(q->v, q->v) + q->vw * q->vw);
+		q->v = Scale(q->v, r);
+		q->vw = q->vw * r;
+		q->m = Scale(q->m, r);
+		q->mw = q->mw * r;
+
+		type h = Dot(q->v, q->m) + q->vw * q->mw;
+		q->m = Subtract(q->m, Scale(q->v, h));
+		q->mw = q->mw - q->vw * h;
+	}
+
+	template <typename type> inline LaneVector<type> GetTranslation(const LaneMotor<type>& q)
+	{
+		type two = MakeLane(2.0F, q.vw);
+		LaneVector<type> t = ScaleAdd(q.m, q.vw, Subtract(Cross(q.v, q.m), Scale(q.v, q.mw)));
+		return (Scale(t, two));
+	}
+
+	template <typename type> inline LaneVector<type> InverseRotate(const LaneMotor<type>& q, const LaneVector<type>& x)
+	{
+		type two = MakeLane(2.0F, q.vw);
+		LaneVector<type> a = Cross(q.v, x);
+		return (ScaleAdd(Subtract(Cross(q.v, a), Scale(a, q.vw)), two, x));
+	}
+
+	template <typename type> inline LaneLine<type> InverseRotate(const LaneMotor<type>& q, const LaneLine<type>& l)
+	{
+		return (LaneLine<type>{InverseRotate(q, l.v), InverseRotate(q, l.m)});
+	}
+
+	template <typename type> LaneLine<type> InverseTransform(const LaneMotor<type>& q, const LaneLine<type>& l)
+	{
+		// Transforms a line with the inverse of the motor q. For a wrench whose moment is the torque about the world origin,
+		// the result is expressed in the local coordinate system with the torque taken about the local origin.
+
+		LaneVector<type> t = GetTranslation(q);
+		return (LaneLine<type>{InverseRotate(q, l.v), InverseRotate(q, Subtract(l.m, Cross(t, l.v)))});
+	}
+
+	template <typename type> inline LaneLine<type> GetVelocity(const LaneBody<type>& body, const LaneLine<type>& momentum)
+	{
+		return (LaneLine<type>{Multiply(momentum.m, body.inverseMoment), Scale(momentum.v, body.inverseMass)});
+	}
+
+	template <typename type> inline LaneLine<type> GetMomentumRate(const LaneLine<type>& wrench, const LaneLine<type>& momentum, const LaneLine<type>& velocity)
+	{
+		// In the rotating body frame, dp/dt = f - w x p and dL/dt = t - w x L. The term v x p vanishes
+		// because the linear momentum is parallel to the velocity of the center of mass.
+
+		return (LaneLine<type>{Add(wrench.v, Cross(momentum.v, velocity.v)), Add(wrench.m, Cross(momentum.m, velocity.v))});
+	}
+
+	template <typename type> inline LaneLine<type> Bracket(const LaneLine<type>& a, const LaneLine<type>& b)
+	{
+		return (LaneLine<type>{Cross(a.v, b.v), Subtract(Cross(a.v, b.m), Cross(b.v, a.m))});
+	}
+
+
+	template <typename type> void LoadBody(const float *data, int32 stride, LaneBody<type> *body)
+	{
+		const float *pose = data + RigidBodyArray::kComponentPose * stride;
+		LoadLane(pose, &body->pose.v.x);
+		LoadLane(pose + stride, &body->pose.v.y);
+		LoadLane(pose + stride * 2, &body->pose.v.z);
+		LoadLane(pose + stride * 3, &body->pose.vw);
+		LoadLane(pose + stride * 4, &body->pose.m.x);
+		LoadLane(pose + stride * 5, &body->pose.m.y);
+		LoadLane(pose + stride * 6, &body->pose.m.z);
+		LoadLane(pose + stride * 7, &body->pose.mw);
+
+		const float *momentum = data + RigidBodyArray::kComponentMomentum * stride;
+		LoadLane(momentum, &body->momentum.v.x);
+		LoadLane(momentum + stride, &body->momentum.v.y);
+		LoadLane(momentum + stride * 2, &body->momentum.v.z);
+		LoadLane(momentum + stride * 3, &body->momentum.m.x);
+		LoadLane(momentum + stride * 4, &body->momentum.m.y);
+		LoadLane(momentum + stride * 5, &body->momentum.m.z);
+
+		const float *wrench = data + RigidBodyArray::kComponentWrench * stride;
+		LoadLane(wrench, &body->wrench.v.x);
+		LoadLane(wrench + stride, &body->wrench.v.y);
+		LoadLane(wrench + stride * 2, &body->wrench.v.z);
+		LoadLane(wrench + stride * 3, &body->wrench.m.x);
+		LoadLane(wrench + stride * 4, &body->wrench.m.y);
+		LoadLane(wrench + stride * 5, &body->wrench.m.z);
+
+		LoadLane(data + RigidBodyArray::kComponentInverseMass * stride, &body->inverseMass);
+
+		const float *inverseMoment = data + RigidBodyArray::kComponentInverseMoment * stride;
+		LoadLane(inverseMoment, &body->inverseMoment.x);
+		LoadLane(inverseMoment + stride, &body->inverseMoment.y);
+		LoadLane(inverseMoment + stride * 2, &body->inverseMoment.z);
+	}
+
+	template <typename type> void StoreBody(const LaneBody<type>& body, float *data, int32 stride)
+	{
+		// The wrench has been consumed by the step, so it is cleared for the next one.
+
+		float *pose = data + RigidBodyArray::kComponentPose * stride;
+		StoreLane(body.pose.v.x, pose);
+		StoreLane(body.pose.v.y, pose + stride);
+		StoreLane(body.pose.v.z, pose + stride * 2);
+		StoreLane(body.pose.vw, pose + stride * 3);
+		StoreLane(body.pose.m.x, pose + stride * 4);
+		StoreLane(body.pose.m.y, pose + stride * 5);
+		StoreLane(body.pose.m.z, pose + stride * 6);
+		StoreLane(body.pose.mw, pose + stride * 7);
+
+		float *momentum = data + RigidBodyArray::kComponentMomentum * stride;
+		StoreLane(body.momentum.v.x, momentum);
+		StoreLane(body.momentum.v.y, momentum + stride);
+		StoreLane(body.momentum.v.z, momentum + stride * 2);
+		StoreLane(body.momentum.m.x, momentum + stride * 3);
+		StoreLane(body.momentum.m.y, momentum + stride * 4);
+		StoreLane(body.momentum.m.z, momentum + stride * 5);
+
+		type zero = MakeLane(0.0F, body.inverseMass);
+		float *wrench = data + RigidBodyArray::kComponentWrench * stride;
+		for (machine k = 0; k < 6; k++)
+		{
+			StoreLane(zero, wrench + stride * k);
+		}
+	}
+
+
+	template <typename type> void StepEuler(LaneBody<type> *body, float dt)
+	{
+		// The pose is multiplied by the exponential of the current velocity, and the momentum about the center of mass is carried
+		// into the new local coordinate system by the inverse rotation of the same motor. The linear and angular momentum of a free
+		// body are therefore conserved exactly in world space.
+
+		type h = MakeLane(dt, body->inverseMass);
+		type halfStep = MakeLane(dt * 0.5F, body->inverseMass);
+
+		LaneLine<type> wrench = InverseTransform(body->pose, body->wrench);
+		LaneMotor<type> step = Exp(Scale(GetVelocity(*body, body->momentum), halfStep));
+
+		body->momentum = InverseRotate(step, ScaleAdd(wrench, h, body->momentum));
+		body->pose = Multiply(body->pose, step);
+		Unitize(&body->pose);
+	}
+
+	template <typename type> void EvaluateStage(const LaneBody<type>& body, const LaneLine<type>& wrench, const LaneLine<type>& omega, const LaneLine<type>& momentum, LaneLine<type> *omegaRate, LaneLine<type> *momentumRate)
+	{
+		// The pose at a stage is Q exp(omega / 2), where omega is the local twist accumulated since the start
+		// of the step. The rate of omega is the inverse differential of the exponential map applied to the velocity,
+		// truncated after the terms that affect fourth-order accuracy.
+
+		type half = MakeLane(0.5F, body.inverseMass);
+		type twelfth = MakeLane(0.083333333F, body.inverseMass);
+
+		LaneMotor<type> pose = Multiply(body.pose, Exp(Scale(omega, half)));
+		LaneLine<type> velocity = GetVelocity(body, momentum);
+		*momentumRate = GetMomentumRate(InverseRotate(pose, wrench), momentum, velocity);
+
+		LaneLine<type> b = Bracket(omega, velocity);
+		*omegaRate = ScaleAdd(Bracket(omega, b), twelfth, ScaleAdd(b, half, velocity));
+	}
+
+	template <typename type> void StepRungeKutta(LaneBody<type> *body, float dt)
+	{
+		LaneLine<type>		w1, w2, w3, w4;
+		LaneLine<type>		p1, p2, p3, p4;
+
+		type h = MakeLane(dt, body->inverseMass);
+		type halfStep = MakeLane(dt * 0.5F, body->inverseMass);
+		type sixthStep = MakeLane(dt * 0.16666667F, body->inverseMass);
+		type two = MakeLane(2.0F, body->inverseMass);
+		type zero = MakeLane(0.0F, body->inverseMass);
+
+		// The force and the torque about the center of mass are held constant in world space over the step, so a force
+		// acting at the center of mass, like gravity, never produces a torque at the intermediate stages.
+
+		LaneVector<type> t = GetTranslation(body->pose);
+		LaneLine<type> wrench = {body->wrench.v, Subtract(body->wrench.m, Cross(t, body->wrench.v))};
+
+		const LaneLine<type>& momentum = body->momentum;
+		LaneLine<type> origin = {{zero, zero, zero}, {zero, zero, zero}};
+
+		EvaluateStage(*body, wrench, origin, momentum, &w1, &p1);
+		EvaluateStage(*body, wrench, Scale(w1, halfStep), ScaleAdd(p1, halfStep, momentum), &w2, &p2);
+		EvaluateStage(*body, wrench, Scale(w2, halfStep), ScaleAdd(p2, halfStep, momentum), &w3, &p3);
+		EvaluateStage(*body, wrench, Scale(w3, h), ScaleAdd(p3, h, momentum), &w4, &p4);
+
+		LaneLine<type> omega = Scale(ScaleAdd(Add(w2, w3), two, Add(w1, w4)), sixthStep);
+		body->momentum = ScaleAdd(ScaleAdd(Add(p2, p3), two, Add(p1, p4)), sixthStep, momentum);
+
+		body->pose = Multiply(body->pose, Exp(Scale(omega, MakeLane(0.5F, body->inverseMass))));
+		Unitize(&body->pose);
+	}
+
+	template <typename type> void StepBody(float *data, int32 stride, float dt, uint32 integrator)
+	{
+		LaneBody<type>		body;
+
+		LoadBody(data, stride, &body);
+
+		if (integrator == kRigidBodyIntegratorRungeKutta)
+		{
+			StepRungeKutta(&body, dt);
+		}
+		else
+		{
+			StepEuler(&body, dt);
+		}
+
+		StoreBody(body, data, stride);
+	}
+}
+
+
+/// @brief Returns the inertia of a single body.
+/// @param index	The index of the body.
+
+RigidInertia RigidBodyArray::GetInertia(int32 index) const
+{
+	int32 stride = GetComponentStride();
+	float inverseMass = GetComponent(kComponentInverseMass)[index];
+	const float *inverseMoment = GetComponent(kComponentInverseMoment) + index;
+
+	float mass = (inverseMass != 0.0F) ? 1.0F / inverseMass : Math::infinity;
+	float ix = (inverseMoment[0] != 0.0F) ? 1.0F / inverseMoment[0] : Math::infinity;
+	float iy = (inverseMoment[stride] != 0.0F) ? 1.0F / inverseMoment[stride] : Math::infinity;
+	float iz = (inverseMoment[stride * 2] != 0.0F) ? 1.0F / inverseMoment[stride * 2] : Math::infinity;
+	return (RigidInertia(mass, Vector3D(ix, iy, iz)));
+}
+
+/// @brief Sets the inertia of a single body.
+/// @param index		The index of the body.
+/// @param inertia		The mass and principal moments of inertia. Infinite values make the body immovable in the corresponding directions.
+///
+/// The momentum of the body is not changed, so its velocity changes unless it is set again afterwards.
+
+void RigidBodyArray::SetInertia(int32 index, const RigidInertia& inertia)
+{
+	int32 stride = GetComponentStride();
+	GetComponent(kComponentInverseMass)[index] = 1.0F / inertia.mass;
+
+	float *inverseMoment = GetComponent(kComponentInverseMoment) + index;
+	inverseMoment[0] = 1.0F / inertia.moment.x;
+	inverseMoment[stride] = 1.0F / inertia.moment.y;
+	inverseMoment[stride * 2] = 1.0F / inertia.moment.z;
+}
+
+/// @brief Returns the velocity of a single body, expressed in the body's local coordinate system.
+/// @param index	The index of the body.
+///
+/// The direction of the returned line is the angular velocity, and its moment is the linear velocity of the center of mass.
+/// The world-space velocity is obtained by transforming the line with the pose of the body.
+
+Line3D RigidBodyArray::GetVelocity(int32 index) const
+{
+	int32 stride = GetComponentStride();
+	float inverseMass = GetComponent(kComponentInverseMass)[index];
+	const float *inverseMoment = GetComponent(kComponentInverseMoment) + index;
+
+	Line3D momentum = GetMomentum(index);
+	return (Line3D(momentum.m.x * inverseMoment[0], momentum.m.y * inverseMoment[stride], momentum.m.z * inverseMoment[stride * 2], momentum.v.x * inverseMass, momentum.v.y * inverseMass, momentum.v.z * inverseMass));
+}
+
+/// @brief Sets the momentum of a single body so that it moves with a given velocity.
+/// @param index		The index of the body.
+/// @param velocity		The velocity line, expressed in the body's local coordinate system.
+///
+/// The inertia of the body must be set before this function is called. Components of the velocity
+/// in directions in which the body is immovable are ignored.
+
+void RigidBodyArray::SetVelocity(int32 index, const Line3D& velocity)
+{
+	RigidInertia inertia = GetInertia(index);
+	float mass = (inertia.mass < Math::infinity) ? inertia.mass : 0.0F;
+	float ix = (inertia.moment.x < Math::infinity) ? inertia.moment.x : 0.0F;
+	float iy = (inertia.moment.y < Math::infinity) ? inertia.moment.y : 0.0F;
+	float iz = (inertia.moment.z < Math::infinity) ? inertia.moment.z : 0.0F;
+	SetMomentum(index, Line3D(velocity.m.x * mass, velocity.m.y * mass, velocity.m.z * mass, velocity.v.x * ix, velocity.v.y * iy, velocity.v.z * iz));
+}
+
+/// @brief Applies a uniform gravitational acceleration to a range of bodies.
+/// @param acceleration		The acceleration due to gravity, expressed in world space.
+/// @param start			The index of the first body in the range.
+/// @param count			The number of bodies in the range.
+///
+/// Each body receives a force equal to its mass times the acceleration, acting at its center of mass. Immovable bodies are skipped.
+
+void RigidBodyArray::ApplyGravity(const Vector3D& acceleration, int32 start, int32 count)
+{
+	int32 stride = GetComponentStride();
+	float *data = GetComponent(0);
+
+	for (machine i = start; i < start + count; i++)
+	{
+		float inverseMass = data[kComponentInverseMass * stride + i];
+		if (inverseMass > 0.0F)
+		{
+			LaneMotor<float>	pose;
+
+			const float *q = data + kComponentPose * stride + i;
+			pose.v = LaneVector<float>{q[0], q[stride], q[stride * 2]};
+			pose.vw = q[stride * 3];
+			pose.m = LaneVector<float>{q[stride * 4], q[stride * 5], q[stride * 6]};
+			pose.mw = q[stride * 7];
+
+			Vector3D force = acceleration / inverseMass;
+			LaneVector<float> torque = Cross(GetTranslation(pose), LaneVector<float>{force.x, force.y, force.z});
+
+			float *wrench = data + kComponentWrench * stride + i;
+			wrench[0] += force.x;
+			wrench[stride] += force.y;
+			wrench[stride * 2] += force.z;
+			wrench[stride * 3] += torque.x;
+			wrench[stride * 4] += torque.y;
+			wrench[stride * 5] += torque.z;
+		}
+	}
+}
+
+/// @brief Clears the wrenches accumulated for a range of bodies.
+/// @param start	The index of the first body in the range.
+/// @param count	The number of bodies in the range.
+
+void RigidBodyArray::ClearWrenches(int32 start, int32 count)
+{
+	int32 stride = GetComponentStride();
+	float *wrench = GetComponent(kComponentWrench) + start;
+
+	for (machine k = 0; k < 6; k++)
+	{
+		float *w = wrench + stride * k;
+		for (machine i = 0; i < count; i++)
+		{
+			w[i] = 0.0F;
+		}
+	}
+}
+
+/// @brief Advances a range of bodies by one time step.
+/// @param dt			The length of the time step.
+/// @param start		The index of the first body in the range.
+/// @param count		The number of bodies in the range.
+/// @param integrator	The integration method. See below for possible values.
+///
+/// The \c Integrate() function updates the pose and momentum of each body in the range under the wrench accumulated since the previous
+/// step and then clears the wrench. The force and the torque about the center of mass are held constant in world space over the step,
+/// and their values in the local coordinate system are recomputed from the pose wherever the integrator needs them. Gyroscopic effects are included, so a spinning body with unequal principal
+/// moments precesses and tumbles as it should. The \c integrator parameter can be one of the following constants.
+///
+/// <table>
+/// <tr><td>\c kRigidBodyIntegratorEuler</td><td>Geometric Euler. This is first-order accurate, but it is cheap, and it conserves the linear and angular momentum of a free body exactly.</td></tr>
+/// <tr><td>\c kRigidBodyIntegratorRungeKutta</td><td>Fourth-order Runge&ndash;Kutta&ndash;Munthe-Kaas. This costs about four times as much per step.</td></tr>
+/// </table>
+///
+/// Only the bodies in the range are read or written, so disjoint ranges can be integrated concurrently on different threads.
+/// Ranges whose start indices are multiples of 4 keep the SIMD loads within single cache lines as much as possible.
+
+void RigidBodyArray::Integrate(float dt, int32 start, int32 count, uint32 integrator)
+{
+	int32 stride = GetComponentStride();
+	float *data = GetComponent(0);
+
+	machine i = start;
+	machine end = start + count;
+
+	#ifndef TERATHON_NO_SIMD
+
+		for (; i + 4 <= end; i += 4)
+		{
+			StepBody<vec_float>(data + i, stride, dt, integrator);
+		}
+
+	#endif
+
+	for (; i < end; i++)
+	{
+		StepBody<float>(data + i, stride, dt, integrator);
+	}
+}
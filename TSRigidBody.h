@@ -0,0 +1,275 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSRigidBody_h
+#define TSRigidBody_h
+
+
+#include "TSGeometryArray.h"
+
+
+#define TERATHON_RIGIDBODY 1
+
+
+namespace Terathon
+{
+	/// @brief Identifies the method used to advance the state of a rigid body by one time step.
+
+	enum : uint32
+	{
+		kRigidBodyIntegratorEuler,				///< Geometric Euler. The pose is moved by the exponential of the current velocity, and the momentum is rotated along with it.
+		kRigidBodyIntegratorRungeKutta			///< Fourth-order Runge&ndash;Kutta&ndash;Munthe-Kaas, which integrates the logarithm of the pose change so that every stage is a rigid motion.
+	};
+
+
+	// ==============================================
+	//	RigidInertia
+	// ==============================================
+
+	/// @brief Encapsulates the mass distribution of a rigid body as a map from velocity lines to momentum lines.
+	///
+	/// The velocity of a rigid body is a 3D line whose direction is the angular velocity &omega; and whose moment is the linear velocity
+	/// <b>v</b> of the point at the origin of the body's local coordinate system. The momentum of the body is a 3D line whose direction is the
+	/// linear momentum <i>m</i><b>v</b> and whose moment is the angular momentum <b>I</b>&omega; about that origin. The \c RigidInertia class
+	/// maps one to the other, swapping the direction and moment in the process. The origin must be the center of mass, and the coordinate
+	/// axes must be the principal axes of inertia, so the inertia tensor is the diagonal matrix whose entries are given by the \c moment member.
+	///
+	/// A body with an infinite mass and infinite principal moments of inertia is immovable.
+
+	class RigidInertia
+	{
+		public:
+
+			float		mass;			///< The total mass of the body.
+			Vector3D	moment;			///< The principal moments of inertia about the center of mass.
+
+			/// @brief Default constructor that leaves the components uninitialized.
+
+			inline RigidInertia() = default;
+
+			/// @brief Constructor that sets the mass and principal moments of inertia.
+			/// @param m	The total mass.
+			/// @param I	The principal moments of inertia about the center of mass.
+
+			RigidInertia(float m, const Vector3D& I)
+			{
+				mass = m;
+				moment = I;
+			}
+
+			/// @brief Returns the momentum of the body when it moves with a given velocity.
+			/// @param velocity		The velocity line of the body, expressed in the body's local coordinate system.
+
+			Line3D GetMomentum(const Line3D& velocity) const
+			{
+				return (Line3D(velocity.m.x * mass, velocity.m.y * mass, velocity.m.z * mass, velocity.v.x * moment.x, velocity.v.y * moment.y, velocity.v.z * moment.z));
+			}
+
+			/// @brief Returns the velocity of the body when it has a given momentum.
+			/// @param momentum		The momentum line of the body, expressed in the body's local coordinate system.
+
+			Line3D GetVelocity(const Line3D& momentum) const
+			{
+				return (Line3D(momentum.m.x / moment.x, momentum.m.y / moment.y, momentum.m.z / moment.z, momentum.v.x / mass, momentum.v.y / mass, momentum.v.z / mass));
+			}
+
+			/// @brief Returns the kinetic energy of the body when it moves with a given velocity.
+			/// @param velocity		The velocity line of the body, expressed in the body's local coordinate system.
+			///
+			/// The kinetic energy is half the sum of &omega;&nbsp;&middot;&nbsp;<b>I</b>&omega; and <b>v</b>&nbsp;&middot;&nbsp;<i>m</i><b>v</b>, which pairs the direction of each line with the moment of the other.
+
+			float GetKineticEnergy(const Line3D& velocity) const
+			{
+				const Vector3D& w = velocity.v;
+				const Bivector3D& v = velocity.m;
+				return ((mass * (v.x * v.x + v.y * v.y + v.z * v.z) + moment.x * w.x * w.x + moment.y * w.y * w.y + moment.z * w.z * w.z) * 0.5F);
+			}
+
+			/// @brief Returns the inertia of a solid sphere centered at the origin.
+			/// @param m		The total mass.
+			/// @param radius	The radius of the sphere.
+
+			static RigidInertia MakeSphere(float m, float radius)
+			{
+				float I = m * radius * radius * 0.4F;
+				return (RigidInertia(m, Vector3D(I, I, I)));
+			}
+
+			/// @brief Returns the inertia of a solid box centered at the origin and aligned to the coordinate axes.
+			/// @param m			The total mass.
+			/// @param halfExtent	The half-extents of the box along the <i>x</i>, <i>y</i>, and <i>z</i> axes.
+
+			static RigidInertia MakeBox(float m, const Vector3D& halfExtent)
+			{
+				float k = m * 0.33333333F;
+				float x2 = halfExtent.x * halfExtent.x;
+				float y2 = halfExtent.y * halfExtent.y;
+				float z2 = halfExtent.z * halfExtent.z;
+				return (RigidInertia(m, Vector3D((y2 + z2) * k, (z2 + x2) * k, (x2 + y2) * k)));
+			}
+	};
+
+
+	// ==============================================
+	//	RigidBodyArray
+	// ==============================================
+
+	/// @brief Stores the dynamic state of many rigid bodies in structure-of-arrays layout and advances it in time.
+	///
+	/// The pose of each body is a unitized motor that transforms from the body's local coordinate system to world space. The momentum
+	/// is a line expressed in the local coordinate system, and the wrench accumulated by the \c ApplyWrench() family of functions is a line
+	/// expressed in world space whose direction is the total force and whose moment is the total torque about the world origin. The inertia
+	/// is stored as reciprocal masses and reciprocal principal moments, so an immovable body simply has zeros in those streams. Like the
+	/// other streams, the wrenches are not initialized when storage is allocated, so \c ClearWrenches() must be called for new bodies
+	/// before any wrench is applied to them.
+	///
+	/// The \c Integrate() function advances a range of bodies without converting to quaternions, vectors, or matrices. Every quantity stays in
+	/// the motor and line forms used by the rest of the library, and the pose changes only by multiplication with the exponential of a velocity
+	/// line, so each step is an exact rigid motion. Different ranges share no data, so disjoint ranges can be integrated on separate threads.
+
+	class RigidBodyArray : public GeometryArray
+	{
+		public:
+
+			enum
+			{
+				kComponentPose				= 0,
+				kComponentMomentum			= 8,
+				kComponentWrench			= 14,
+				kComponentInverseMass		= 20,
+				kComponentInverseMoment		= 21,
+				kComponentCount				= 24
+			};
+
+			RigidBodyArray() : GeometryArray(kComponentCount) {}
+			explicit RigidBodyArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			RigidBodyArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			RigidBodyArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			/// @brief Returns the pose of a single body.
+			/// @param index	The index of the body.
+
+			Motor3D GetPose(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(kComponentPose) + index;
+				return (Motor3D(data[0], data[stride], data[stride * 2], data[stride * 3], data[stride * 4], data[stride * 5], data[stride * 6], data[stride * 7]));
+			}
+
+			/// @brief Sets the pose of a single body.
+			/// @param index	The index of the body.
+			/// @param Q		The unitized motor that transforms from the body's local coordinate system to world space.
+
+			void SetPose(int32 index, const Motor3D& Q)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(kComponentPose) + index;
+				data[0] = Q.v.x;
+				data[stride] = Q.v.y;
+				data[stride * 2] = Q.v.z;
+				data[stride * 3] = Q.v.w;
+				data[stride * 4] = Q.m.x;
+				data[stride * 5] = Q.m.y;
+				data[stride * 6] = Q.m.z;
+				data[stride * 7] = Q.m.w;
+			}
+
+			/// @brief Returns the momentum of a single body, expressed in the body's local coordinate system.
+			/// @param index	The index of the body.
+
+			Line3D GetMomentum(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(kComponentMomentum) + index;
+				return (Line3D(data[0], data[stride], data[stride * 2], data[stride * 3], data[stride * 4], data[stride * 5]));
+			}
+
+			/// @brief Sets the momentum of a single body.
+			/// @param index		The index of the body.
+			/// @param momentum		The momentum line, expressed in the body's local coordinate system.
+
+			void SetMomentum(int32 index, const Line3D& momentum)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(kComponentMomentum) + index;
+				data[0] = momentum.v.x;
+				data[stride] = momentum.v.y;
+				data[stride * 2] = momentum.v.z;
+				data[stride * 3] = momentum.m.x;
+				data[stride * 4] = momentum.m.y;
+				data[stride * 5] = momentum.m.z;
+			}
+
+			/// @brief Returns the total wrench applied to a single body since the last integration step, expressed in world space.
+			/// @param index	The index of the body.
+
+			Line3D GetWrench(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(kComponentWrench) + index;
+				return (Line3D(data[0], data[stride], data[stride * 2], data[stride * 3], data[stride * 4], data[stride * 5]));
+			}
+
+			/// @brief Adds a wrench to the total wrench applied to a single body.
+			/// @param index	The index of the body.
+			/// @param wrench	The wrench, expressed in world space. Its direction is the force, and its moment is the torque about the world origin.
+			///
+			/// A force <b>F</b> acting at a point <b>p</b> is the wrench <b>p</b>&nbsp;&and;&nbsp;<b>F</b>.
+
+			void ApplyWrench(int32 index, const Line3D& wrench)
+			{
+				int32 stride = GetComponentStride();
+				float *data = GetComponent(kComponentWrench) + index;
+				data[0] += wrench.v.x;
+				data[stride] += wrench.v.y;
+				data[stride * 2] += wrench.v.z;
+				data[stride * 3] += wrench.m.x;
+				data[stride * 4] += wrench.m.y;
+				data[stride * 5] += wrench.m.z;
+			}
+
+			/// @brief Applies a force at a point to a single body.
+			/// @param index	The index of the body.
+			/// @param force	The force, expressed in world space.
+			/// @param p		The point at which the force is applied, expressed in world space.
+
+			void ApplyForce(int32 index, const Vector3D& force, const Point3D& p)
+			{
+				ApplyWrench(index, Wedge(p, force));
+			}
+
+			/// @brief Applies a pure torque to a single body.
+			/// @param index	The index of the body.
+			/// @param torque	The torque, expressed in world space.
+
+			void ApplyTorque(int32 index, const Bivector3D& torque)
+			{
+				ApplyWrench(index, Line3D(Vector3D(0.0F, 0.0F, 0.0F), torque));
+			}
+
+			TERATHON_API RigidInertia GetInertia(int32 index) const;
+			TERATHON_API void SetInertia(int32 index, const RigidInertia& inertia);
+
+			TERATHON_API Line3D GetVelocity(int32 index) const;
+			TERATHON_API void SetVelocity(int32 index, const Line3D& velocity);
+
+			TERATHON_API void ApplyGravity(const Vector3D& acceleration, int32 start, int32 count);
+			TERATHON_API void ClearWrenches(int32 start, int32 count);
+
+			TERATHON_API void Integrate(float dt, int32 start, int32 count, uint32 integrator = kRigidBodyIntegratorEuler);
+	};
+}
+
+
+#endif
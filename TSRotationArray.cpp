@@ -0,0 +1,1315 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSRotationArray.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	// Every axis order is handled by relabeling the coordinate axes so that the rotations are applied in the order xyz.
+	// Relabeling with an odd permutation reverses the handedness of the coordinate system, so the angles are negated.
+	// If M is the rotation matrix for a given order, then M[axis[r]][axis[c]] is the (r,c) entry of the xyz matrix.
+
+	struct EulerOrder
+	{
+		machine		axis[3];
+		bool		odd;
+	};
+
+
+	const EulerOrder eulerOrderTable[kEulerOrderCount] =
+	{
+		{{0, 1, 2}, false},
+		{{0, 2, 1}, true},
+		{{1, 0, 2}, true},
+		{{1, 2, 0}, false},
+		{{2, 0, 1}, false},
+		{{2, 1, 0}, true}
+	};
+
+
+	#ifndef TERATHON_NO_SIMD
+
+		// Four conversions are performed at once. Each vec_float holds one component for four different objects.
+
+		enum
+		{
+			kRotationGroupSize = 4
+		};
+
+
+		void BuildEulerMatrix(const vec_float *angle, const EulerOrder& order, vec_float (*m)[3])
+		{
+			vec_float	ca, sa, cb, sb, cc, sc;
+
+			const machine *axis = order.axis;
+			vec_float sign = (order.odd) ? VecFloatGetMinusZero() : VecFloatGetZero();
+
+			VecCosSin(VecXor(angle[axis[0]], sign), &ca, &sa);
+			VecCosSin(VecXor(angle[axis[1]], sign), &cb, &sb);
+			VecCosSin(VecXor(angle[axis[2]], sign), &cc, &sc);
+
+			vec_float sasb = VecMul(sa, sb);
+			vec_float casb = VecMul(ca, sb);
+
+			m[axis[0]][axis[0]] = VecMul(cb, cc);
+			m[axis[0]][axis[1]] = VecNegate(VecMul(cb, sc));
+			m[axis[0]][axis[2]] = sb;
+			m[axis[1]][axis[0]] = VecMadd(sasb, cc, VecMul(ca, sc));
+			m[axis[1]][axis[1]] = VecNmsub(sasb, sc, VecMul(ca, cc));
+			m[axis[1]][axis[2]] = VecNegate(VecMul(sa, cb));
+			m[axis[2]][axis[0]] = VecNmsub(casb, cc, VecMul(sa, sc));
+			m[axis[2]][axis[1]] = VecMadd(casb, sc, VecMul(sa, cc));
+			m[axis[2]][axis[2]] = VecMul(ca, cb);
+		}
+
+		void BuildEulerQuaternion(const vec_float *angle, const EulerOrder& order, vec_float *q)
+		{
+			vec_float	ca, sa, cb, sb, cc, sc;
+
+			const machine *axis = order.axis;
+			const vec_float half = VecLoadVectorConstant<0x3F000000>();
+			vec_float sign = (order.odd) ? VecFloatGetMinusZero() : VecFloatGetZero();
+
+			VecCosSin(VecMul(VecXor(angle[axis[0]], sign), half), &ca, &sa);
+			VecCosSin(VecMul(VecXor(angle[axis[1]], sign), half), &cb, &sb);
+			VecCosSin(VecMul(VecXor(angle[axis[2]], sign), half), &cc, &sc);
+
+			// This is the product of the quaternions for the three rotations in the order xyz. Relabeling
+			// the axes with an odd permutation negates the vector part, which undoes the earlier negation.
+
+			vec_float cacb = VecMul(ca, cb);
+			vec_float sasb = VecMul(sa, sb);
+			vec_float sacb = VecMul(sa, cb);
+			vec_float casb = VecMul(ca, sb);
+
+			q[axis[0]] = VecXor(VecMadd(sacb, cc, VecMul(casb, sc)), sign);
+			q[axis[1]] = VecXor(VecNmsub(sacb, sc, VecMul(casb, cc)), sign);
+			q[axis[2]] = VecXor(VecMadd(cacb, sc, VecMul(sasb, cc)), sign);
+			q[3] = VecNmsub(sasb, sc, VecMul(cacb, cc));
+		}
+
+		void ExtractEulerAngles(const vec_float (*m)[3], const EulerOrder& order, vec_float *angle)
+		{
+			const machine *axis = order.axis;
+			vec_float sign = (order.odd) ? VecFloatGetMinusZero() : VecFloatGetZero();
+
+			vec_float m00 = m[axis[0]][axis[0]];
+			vec_float m01 = m[axis[0]][axis[1]];
+			vec_float m02 = m[axis[0]][axis[2]];
+
+			vec_float x = VecArctan(VecNegate(m[axis[1]][axis[2]]), m[axis[2]][axis[2]]);
+			vec_float y = VecArctan(m02, VecSqrt(VecMadd(m00, m00, VecMul(m01, m01))));
+			vec_float z = VecArctan(VecNegate(m01), m00);
+
+			// In the gimbal lock case, the first angle is zero, and the third angle is calculated from the entries
+			// that depend only on the sum or difference of the first and third angles. The threshold is slightly
+			// less than one because rounding errors dominate the other entries in the first row and last column
+			// when the cosine of the second angle is very small.
+
+			vec_float regular = VecMaskCmplt(VecAndc(m02, VecFloatGetMinusZero()), VecLoadVectorConstant<0x3F7FFFF8>());
+			x = VecAnd(x, regular);
+			z = VecSelect(VecArctan(m[axis[1]][axis[0]], m[axis[1]][axis[1]]), z, regular);
+
+			angle[axis[0]] = VecXor(x, sign);
+			angle[axis[1]] = VecXor(y, sign);
+			angle[axis[2]] = VecXor(z, sign);
+		}
+
+		void QuaternionToMatrix(const vec_float *q, vec_float (*m)[3])
+		{
+			const vec_float one = VecLoadVectorConstant<0x3F800000>();
+			const vec_float two = VecLoadVectorConstant<0x40000000>();
+
+			vec_float x2 = VecMul(q[0], q[0]);
+			vec_float y2 = VecMul(q[1], q[1]);
+			vec_float z2 = VecMul(q[2], q[2]);
+			vec_float xy = VecMul(q[0], q[1]);
+			vec_float zx = VecMul(q[2], q[0]);
+			vec_float yz = VecMul(q[1], q[2]);
+			vec_float wx = VecMul(q[3], q[0]);
+			vec_float wy = VecMul(q[3], q[1]);
+			vec_float wz = VecMul(q[3], q[2]);
+
+			m[0][0] = VecNmsub(two, VecAdd(y2, z2), one);
+			m[0][1] = VecMul(two, VecSub(xy, wz));
+			m[0][2] = VecMul(two, VecAdd(zx, wy));
+			m[1][0] = VecMul(two, VecAdd(xy, wz));
+			m[1][1] = VecNmsub(two, VecAdd(x2, z2), one);
+			m[1][2] = VecMul(two, VecSub(yz, wx));
+			m[2][0] = VecMul(two, VecSub(zx, wy));
+			m[2][1] = VecMul(two, VecAdd(yz, wx));
+			m[2][2] = VecNmsub(two, VecAdd(x2, y2), one);
+		}
+
+		void LoadMatrices(const Matrix3D *matrix, vec_float (*m)[3])
+		{
+			// The nine entries of each matrix are stored in column-major order.
+
+			const float *p = &matrix[0](0,0);
+
+			vec_float a = VecLoadUnaligned(p);
+			vec_float b = VecLoadUnaligned(p + 9);
+			vec_float c = VecLoadUnaligned(p + 18);
+			vec_float d = VecLoadUnaligned(p + 27);
+			VecTranspose4D(&a, &b, &c, &d);
+			m[0][0] = a;
+			m[1][0] = b;
+			m[2][0] = c;
+			m[0][1] = d;
+
+			a = VecLoadUnaligned(p + 4);
+			b = VecLoadUnaligned(p + 13);
+			c = VecLoadUnaligned(p + 22);
+			d = VecLoadUnaligned(p + 31);
+			VecTranspose4D(&a, &b, &c, &d);
+			m[1][1] = a;
+			m[2][1] = b;
+			m[0][2] = c;
+			m[1][2] = d;
+
+			alignas(16) float last[4] = {p[8], p[17], p[26], p[35]};
+			m[2][2] = VecLoad(last);
+		}
+
+		void StoreMatrices(const vec_float (*m)[3], Matrix3D *matrix)
+		{
+			alignas(16) float	last[4];
+
+			float *p = &matrix[0](0,0);
+
+			vec_float a = m[0][0];
+			vec_float b = m[1][0];
+			vec_float c = m[2][0];
+			vec_float d = m[0][1];
+			VecTranspose4D(&a, &b, &c, &d);
+			VecStoreUnaligned(a, p);
+			VecStoreUnaligned(b, p + 9);
+			VecStoreUnaligned(c, p + 18);
+			VecStoreUnaligned(d, p + 27);
+
+			a = m[1][1];
+			b = m[2][1];
+			c = m[0][2];
+			d = m[1][2];
+			VecTranspose4D(&a, &b, &c, &d);
+			VecStoreUnaligned(a, p + 4);
+			VecStoreUnaligned(b, p + 13);
+			VecStoreUnaligned(c, p + 22);
+			VecStoreUnaligned(d, p + 31);
+
+			VecStore(m[2][2], last);
+			p[8] = last[0];
+			p[17] = last[1];
+			p[26] = last[2];
+			p[35] = last[3];
+		}
+
+		void LoadTransforms(const Transform3D *transform, vec_float (*m)[3])
+		{
+			for (machine j = 0; j < 3; j++)
+			{
+				vec_float a = VecLoad(&transform[0](0,j));
+				vec_float b = VecLoad(&transform[1](0,j));
+				vec_float c = VecLoad(&transform[2](0,j));
+				vec_float d = VecLoad(&transform[3](0,j));
+				VecTranspose4D(&a, &b, &c, &d);
+				m[0][j] = a;
+				m[1][j] = b;
+				m[2][j] = c;
+			}
+		}
+
+		void StoreTransforms(const vec_float (*m)[3], Transform3D *transform)
+		{
+			alignas(16) static const float column[4] = {0.0F, 0.0F, 0.0F, 1.0F};
+
+			for (machine j = 0; j < 3; j++)
+			{
+				vec_float a = m[0][j];
+				vec_float b = m[1][j];
+				vec_float c = m[2][j];
+				vec_float d = VecFloatGetZero();
+				VecTranspose4D(&a, &b, &c, &d);
+				VecStore(a, &transform[0](0,j));
+				VecStore(b, &transform[1](0,j));
+				VecStore(c, &transform[2](0,j));
+				VecStore(d, &transform[3](0,j));
+			}
+
+			vec_float w = VecLoad(column);
+			for (machine k = 0; k < 4; k++)
+			{
+				VecStore(w, &transform[k](0,3));
+			}
+		}
+
+		void LoadQuaternions(const Quaternion *quaternion, vec_float *q)
+		{
+			const float *p = &quaternion->x;
+
+			q[0] = VecLoadUnaligned(p);
+			q[1] = VecLoadUnaligned(p + 4);
+			q[2] = VecLoadUnaligned(p + 8);
+			q[3] = VecLoadUnaligned(p + 12);
+			VecTranspose4D(&q[0], &q[1], &q[2], &q[3]);
+		}
+
+		void StoreQuaternions(const vec_float *q, Quaternion *quaternion)
+		{
+			float *p = &quaternion->x;
+
+			vec_float a = q[0];
+			vec_float b = q[1];
+			vec_float c = q[2];
+			vec_float d = q[3];
+			VecTranspose4D(&a, &b, &c, &d);
+			VecStoreUnaligned(a, p);
+			VecStoreUnaligned(b, p + 4);
+			VecStoreUnaligned(c, p + 8);
+			VecStoreUnaligned(d, p + 12);
+		}
+
+		void EulerToMatrix3D(const Vector3D *angles, Matrix3D *result, const EulerOrder& order)
+		{
+			vec_float	a[3], m[3][3];
+
+			VecLoadTranspose3D(&angles->x, &a[0], &a[1], &a[2]);
+			BuildEulerMatrix(a, order, m);
+			StoreMatrices(m, result);
+		}
+
+		void EulerToTransform3D(const Vector3D *angles, Transform3D *result, const EulerOrder& order)
+		{
+			vec_float	a[3], m[3][3];
+
+			VecLoadTranspose3D(&angles->x, &a[0], &a[1], &a[2]);
+			BuildEulerMatrix(a, order, m);
+			StoreTransforms(m, result);
+		}
+
+		void EulerToQuaternion(const Vector3D *angles, Quaternion *result, const EulerOrder& order)
+		{
+			vec_float	a[3], q[4];
+
+			VecLoadTranspose3D(&angles->x, &a[0], &a[1], &a[2]);
+			BuildEulerQuaternion(a, order, q);
+			StoreQuaternions(q, result);
+		}
+
+		void Matrix3DToEuler(const Matrix3D *matrix, Vector3D *angles, const EulerOrder& order)
+		{
+			vec_float	m[3][3], a[3];
+
+			LoadMatrices(matrix, m);
+			ExtractEulerAngles(m, order, a);
+			VecStoreTranspose3D(a[0], a[1], a[2], &angles->x);
+		}
+
+		void Transform3DToEuler(const Transform3D *transform, Vector3D *angles, const EulerOrder& order)
+		{
+			vec_float	m[3][3], a[3];
+
+			LoadTransforms(transform, m);
+			ExtractEulerAngles(m, order, a);
+			VecStoreTranspose3D(a[0], a[1], a[2], &angles->x);
+		}
+
+		void QuaternionToEuler(const Quaternion *quaternion, Vector3D *angles, const EulerOrder& order)
+		{
+			vec_float	q[4], m[3][3], a[3];
+
+			LoadQuaternions(quaternion, q);
+			QuaternionToMatrix(q, m);
+			ExtractEulerAngles(m, order, a);
+			VecStoreTranspose3D(a[0], a[1], a[2], &angles->x);
+		}
+
+		void StoreMotors(const vec_float *q, Motor3D *motor)
+		{
+			vec_float a = q[0];
+			vec_float b = q[1];
+			vec_float c = q[2];
+			vec_float d = q[3];
+			VecTranspose4D(&a, &b, &c, &d);
+
+			vec_float zero = VecFloatGetZero();
+			VecStoreUnaligned(a, &motor[0].v.x);
+			VecStoreUnaligned(zero, &motor[0].m.x);
+			VecStoreUnaligned(b, &motor[1].v.x);
+			VecStoreUnaligned(zero, &motor[1].m.x);
+			VecStoreUnaligned(c, &motor[2].v.x);
+			VecStoreUnaligned(zero, &motor[2].m.x);
+			VecStoreUnaligned(d, &motor[3].v.x);
+			VecStoreUnaligned(zero, &motor[3].m.x);
+		}
+
+		void BuildAxisMatrix(const float *angle, const Bivector3D *axis, vec_float (*m)[3])
+		{
+			vec_float	c, s, x, y, z;
+
+			VecCosSin(VecLoadUnaligned(angle), &c, &s);
+			VecLoadTranspose3D(&axis->x, &x, &y, &z);
+
+			vec_float d = VecSub(VecLoadVectorConstant<0x3F800000>(), c);
+			vec_float xd = VecMul(x, d);
+			vec_float yd = VecMul(y, d);
+			vec_float axay = VecMul(xd, y);
+			vec_float axaz = VecMul(xd, z);
+			vec_float ayaz = VecMul(yd, z);
+
+			m[0][0] = VecMadd(xd, x, c);
+			m[0][1] = VecNmsub(s, z, axay);
+			m[0][2] = VecMadd(s, y, axaz);
+			m[1][0] = VecMadd(s, z, axay);
+			m[1][1] = VecMadd(yd, y, c);
+			m[1][2] = VecNmsub(s, x, ayaz);
+			m[2][0] = VecNmsub(s, y, axaz);
+			m[2][1] = VecMadd(s, x, ayaz);
+			m[2][2] = VecMadd(VecMul(z, d), z, c);
+		}
+
+		void BuildAxisQuaternion(const float *angle, const Bivector3D *axis, vec_float *q)
+		{
+			vec_float	c, s, x, y, z;
+
+			VecCosSin(VecMul(VecLoadUnaligned(angle), VecLoadVectorConstant<0x3F000000>()), &c, &s);
+			VecLoadTranspose3D(&axis->x, &x, &y, &z);
+
+			q[0] = VecMul(x, s);
+			q[1] = VecMul(y, s);
+			q[2] = VecMul(z, s);
+			q[3] = c;
+		}
+
+		void AxisAngleToMatrix3D(const float *angle, const Bivector3D *axis, Matrix3D *result)
+		{
+			vec_float	m[3][3];
+
+			BuildAxisMatrix(angle, axis, m);
+			StoreMatrices(m, result);
+		}
+
+		void AxisAngleToTransform3D(const float *angle, const Bivector3D *axis, Transform3D *result)
+		{
+			vec_float	m[3][3];
+
+			BuildAxisMatrix(angle, axis, m);
+			StoreTransforms(m, result);
+		}
+
+		void AxisAngleToQuaternion(const float *angle, const Bivector3D *axis, Quaternion *result)
+		{
+			vec_float	q[4];
+
+			BuildAxisQuaternion(angle, axis, q);
+			StoreQuaternions(q, result);
+		}
+
+		void AxisAngleToMotor3D(const float *angle, const Bivector3D *axis, Motor3D *result)
+		{
+			vec_float	q[4];
+
+			BuildAxisQuaternion(angle, axis, q);
+			StoreMotors(q, result);
+		}
+
+		void RotateVectors(const float *angle, const Bivector3D *axis, const Vector3D *v, Vector3D *result)
+		{
+			vec_float	c, s, ax, ay, az, vx, vy, vz;
+
+			VecCosSin(VecLoadUnaligned(angle), &c, &s);
+			VecLoadTranspose3D(&axis->x, &ax, &ay, &az);
+			VecLoadTranspose3D(&v->x, &vx, &vy, &vz);
+
+			// v' = v cos(angle) + (a x v) sin(angle) + a (a . v)(1 - cos(angle))
+
+			vec_float k = VecMul(VecMadd(az, vz, VecMadd(ay, vy, VecMul(ax, vx))), VecSub(VecLoadVectorConstant<0x3F800000>(), c));
+			vec_float cx = VecNmsub(az, vy, VecMul(ay, vz));
+			vec_float cy = VecNmsub(ax, vz, VecMul(az, vx));
+			vec_float cz = VecNmsub(ay, vx, VecMul(ax, vy));
+
+			vx = VecMadd(ax, k, VecMadd(cx, s, VecMul(vx, c)));
+			vy = VecMadd(ay, k, VecMadd(cy, s, VecMul(vy, c)));
+			vz = VecMadd(az, k, VecMadd(cz, s, VecMul(vz, c)));
+			VecStoreTranspose3D(vx, vy, vz, &result->x);
+		}
+
+		inline vec_float LoadConstant(float f)
+		{
+			return (VecLoadSmearScalar(&f));
+		}
+
+		void GetExpFactors(const vec_float& phi2, uint32 method, vec_float *k, vec_float *c, vec_float *g, vec_float *e)
+		{
+			// The exponential of a bivector or line x with squared weight magnitude phi^2 is assembled from k = sin(phi) / phi,
+			// c = cos(phi), g = (c - k) / phi^2, and the factor e = k applied to the antiscalar. The approximations replace
+			// exp(x) by 1 + x or 1 + x + x^2 / 2, where x^2 = -phi^2 for the bivector part.
+
+			const vec_float one = VecLoadVectorConstant<0x3F800000>();
+
+			if (method == kRotationIntegrationExact)
+			{
+				vec_float	cosine, sine;
+
+				// Series are used for small angles, where the sine must be accurate relative to its own size and g cancels badly.
+
+				vec_float r = VecInverseSqrt(VecMax(phi2, LoadConstant(Math::min_float)));
+				VecCosSin(VecMul(phi2, r), &cosine, &sine);
+				vec_float kt = VecMul(sine, r);
+				vec_float gt = VecMul(VecSub(cosine, kt), VecMul(r, r));
+
+				vec_float ks = VecNmsub(phi2, VecNmsub(phi2, VecNmsub(phi2, LoadConstant(1.9841270e-4F), LoadConstant(0.0083333333F)), LoadConstant(0.16666667F)), one);
+				vec_float cs = VecNmsub(phi2, VecNmsub(phi2, VecNmsub(phi2, VecNmsub(phi2, LoadConstant(2.4801587e-5F), LoadConstant(0.0013888889F)), LoadConstant(0.041666667F)), LoadConstant(0.5F)), one);
+				vec_float gs = VecSub(VecMul(phi2, VecNmsub(phi2, LoadConstant(0.0011904762F), LoadConstant(0.033333333F))), LoadConstant(0.33333333F));
+
+				vec_float small = VecMaskCmplt(phi2, LoadConstant(0.0625F));
+				*k = VecSelect(kt, ks, small);
+				*c = VecSelect(cosine, cs, small);
+				*g = VecSelect(gt, gs, small);
+				*e = *k;
+			}
+			else
+			{
+				*k = one;
+				*g = VecFloatGetZero();
+
+				if (method == kRotationIntegrationSecondOrder)
+				{
+					*c = VecNmsub(phi2, VecLoadVectorConstant<0x3F000000>(), one);
+					*e = one;
+				}
+				else
+				{
+					*c = one;
+					*e = VecFloatGetZero();
+				}
+			}
+		}
+
+		void MultiplyQuaternions(const vec_float *a, const vec_float *b, vec_float *r)
+		{
+			r[0] = VecMadd(a[3], b[0], VecMadd(a[0], b[3], VecNmsub(a[2], b[1], VecMul(a[1], b[2]))));
+			r[1] = VecMadd(a[3], b[1], VecMadd(a[1], b[3], VecNmsub(a[0], b[2], VecMul(a[2], b[0]))));
+			r[2] = VecMadd(a[3], b[2], VecMadd(a[2], b[3], VecNmsub(a[1], b[0], VecMul(a[0], b[1]))));
+			r[3] = VecNmsub(a[2], b[2], VecNmsub(a[1], b[1], VecNmsub(a[0], b[0], VecMul(a[3], b[3]))));
+		}
+
+		void AdvanceQuaternions(vec_float *q, const vec_float *w, const vec_float& halfStep, uint32 method)
+		{
+			vec_float	k, c, g, e, d[4], r[4];
+
+			vec_float x = VecMul(w[0], halfStep);
+			vec_float y = VecMul(w[1], halfStep);
+			vec_float z = VecMul(w[2], halfStep);
+			GetExpFactors(VecMadd(z, z, VecMadd(y, y, VecMul(x, x))), method, &k, &c, &g, &e);
+
+			d[0] = VecMul(x, k);
+			d[1] = VecMul(y, k);
+			d[2] = VecMul(z, k);
+			d[3] = c;
+			MultiplyQuaternions(q, d, r);
+
+			vec_float f = VecInverseSqrt(VecMadd(r[3], r[3], VecMadd(r[2], r[2], VecMadd(r[1], r[1], VecMul(r[0], r[0])))));
+			for (machine i = 0; i < 4; i++)
+			{
+				q[i] = VecMul(r[i], f);
+			}
+		}
+
+		void AdvanceMotors(vec_float *Q, const vec_float *l, const vec_float& halfStep, uint32 method)
+		{
+			vec_float	k, c, g, e, d[8], r[8], t[4];
+
+			vec_float vx = VecMul(l[0], halfStep);
+			vec_float vy = VecMul(l[1], halfStep);
+			vec_float vz = VecMul(l[2], halfStep);
+			vec_float mx = VecMul(l[3], halfStep);
+			vec_float my = VecMul(l[4], halfStep);
+			vec_float mz = VecMul(l[5], halfStep);
+
+			vec_float lvlm = VecMadd(vz, mz, VecMadd(vy, my, VecMul(vx, mx)));
+			GetExpFactors(VecMadd(vz, vz, VecMadd(vy, vy, VecMul(vx, vx))), method, &k, &c, &g, &e);
+			vec_float h = VecMul(g, lvlm);
+
+			d[0] = VecMul(vx, k);
+			d[1] = VecMul(vy, k);
+			d[2] = VecMul(vz, k);
+			d[3] = c;
+			d[4] = VecMadd(vx, h, VecMul(mx, k));
+			d[5] = VecMadd(vy, h, VecMul(my, k));
+			d[6] = VecMadd(vz, h, VecMul(mz, k));
+			d[7] = VecNegate(VecMul(lvlm, e));
+
+			// The weight of the product is the quaternion product of the weights, and the bulk is the
+			// sum of the products of each bulk with the other weight.
+
+			MultiplyQuaternions(Q, d, r);
+			MultiplyQuaternions(Q + 4, d, r + 4);
+			MultiplyQuaternions(Q, d + 4, t);
+
+			vec_float f = VecInverseSqrt(VecMadd(r[3], r[3], VecMadd(r[2], r[2], VecMadd(r[1], r[1], VecMul(r[0], r[0])))));
+			for (machine i = 0; i < 4; i++)
+			{
+				r[i] = VecMul(r[i], f);
+				r[i + 4] = VecMul(VecAdd(r[i + 4], t[i]), f);
+			}
+
+			// Rounding errors slowly violate the constraint that the weight and bulk are orthogonal, so the bulk is projected back.
+
+			vec_float p = VecMadd(r[3], r[7], VecMadd(r[2], r[6], VecMadd(r[1], r[5], VecMul(r[0], r[4]))));
+			for (machine i = 0; i < 4; i++)
+			{
+				Q[i] = r[i];
+				Q[i + 4] = VecNmsub(r[i], p, r[i + 4]);
+			}
+		}
+
+		void IntegrateQuaternionGroup(const Bivector3D *velocity, float dt, Quaternion *quaternion, uint32 method)
+		{
+			vec_float	q[4], w[3];
+
+			float halfStep = dt * 0.5F;
+			LoadQuaternions(quaternion, q);
+			VecLoadTranspose3D(&velocity->x, &w[0], &w[1], &w[2]);
+			AdvanceQuaternions(q, w, VecLoadSmearScalar(&halfStep), method);
+			StoreQuaternions(q, quaternion);
+		}
+
+		void IntegrateMotorGroup(const Line3D *velocity, float dt, Motor3D *motor, uint32 method)
+		{
+			vec_float	Q[8], l[8];
+
+			for (machine k = 0; k < 4; k++)
+			{
+				Q[k] = VecLoadUnaligned(&motor[k].v.x);
+				Q[k + 4] = VecLoadUnaligned(&motor[k].m.x);
+				l[k] = VecLoadUnaligned(&velocity[k].v.x);
+				l[k + 4] = VecLoadUnaligned(&velocity[k].v.z);
+			}
+
+			// After transposition, the second group of line components holds v.z, m.x, m.y, and m.z, so the last two are moved down.
+
+			VecTranspose4D(&Q[0], &Q[1], &Q[2], &Q[3]);
+			VecTranspose4D(&Q[4], &Q[5], &Q[6], &Q[7]);
+			VecTranspose4D(&l[0], &l[1], &l[2], &l[3]);
+			VecTranspose4D(&l[4], &l[5], &l[6], &l[7]);
+			l[4] = l[6];
+			l[5] = l[7];
+
+			float halfStep = dt * 0.5F;
+			AdvanceMotors(Q, l, VecLoadSmearScalar(&halfStep), method);
+
+			VecTranspose4D(&Q[0], &Q[1], &Q[2], &Q[3]);
+			VecTranspose4D(&Q[4], &Q[5], &Q[6], &Q[7]);
+			for (machine k = 0; k < 4; k++)
+			{
+				VecStoreUnaligned(Q[k], &motor[k].v.x);
+				VecStoreUnaligned(Q[k + 4], &motor[k].m.x);
+			}
+		}
+
+		void IntegrateStreams(int32 count, const float *const *velocity, int32 velocityCount, float *const *state, int32 stateCount, float dt, uint32 method, void (*advance)(vec_float *, const vec_float *, const vec_float&, uint32))
+		{
+			vec_float	v[6], s[8];
+
+			float halfStep = dt * 0.5F;
+			vec_float h = VecLoadSmearScalar(&halfStep);
+
+			int32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				for (machine k = 0; k < velocityCount; k++)
+				{
+					v[k] = VecLoadUnaligned(velocity[k] + i);
+				}
+
+				for (machine k = 0; k < stateCount; k++)
+				{
+					s[k] = VecLoadUnaligned(state[k] + i);
+				}
+
+				(*advance)(s, v, h, method);
+
+				for (machine k = 0; k < stateCount; k++)
+				{
+					VecStoreUnaligned(s[k], state[k] + i);
+				}
+			}
+
+			int32 n = count - i;
+			if (n > 0)
+			{
+				// The final partial group is padded by repeating its last element, and nothing past the end of the range is written.
+
+				alignas(16) float	temp[4];
+
+				for (machine k = 0; k < velocityCount; k++)
+				{
+					for (machine j = 0; j < 4; j++)
+					{
+						temp[j] = velocity[k][i + ((j < n) ? j : n - 1)];
+					}
+
+					v[k] = VecLoad(temp);
+				}
+
+				for (machine k = 0; k < stateCount; k++)
+				{
+					for (machine j = 0; j < 4; j++)
+					{
+						temp[j] = state[k][i + ((j < n) ? j : n - 1)];
+					}
+
+					s[k] = VecLoad(temp);
+				}
+
+				(*advance)(s, v, h, method);
+
+				for (machine k = 0; k < stateCount; k++)
+				{
+					VecStore(s[k], temp);
+					for (machine j = 0; j < n; j++)
+					{
+						state[k][i + j] = temp[j];
+					}
+				}
+			}
+		}
+
+	#else
+
+		enum
+		{
+			kRotationGroupSize = 1
+		};
+
+
+		void BuildEulerMatrix(const float *angle, const EulerOrder& order, float (*m)[3])
+		{
+			float	ca, sa, cb, sb, cc, sc;
+
+			const machine *axis = order.axis;
+			float sign = (order.odd) ? -1.0F : 1.0F;
+
+			CosSin(angle[axis[0]] * sign, &ca, &sa);
+			CosSin(angle[axis[1]] * sign, &cb, &sb);
+			CosSin(angle[axis[2]] * sign, &cc, &sc);
+
+			m[axis[0]][axis[0]] = cb * cc;
+			m[axis[0]][axis[1]] = -cb * sc;
+			m[axis[0]][axis[2]] = sb;
+			m[axis[1]][axis[0]] = sa * sb * cc + ca * sc;
+			m[axis[1]][axis[1]] = ca * cc - sa * sb * sc;
+			m[axis[1]][axis[2]] = -sa * cb;
+			m[axis[2]][axis[0]] = sa * sc - ca * sb * cc;
+			m[axis[2]][axis[1]] = sa * cc + ca * sb * sc;
+			m[axis[2]][axis[2]] = ca * cb;
+		}
+
+		void ExtractEulerAngles(const float (*m)[3], const EulerOrder& order, float *angle)
+		{
+			float	x, z;
+
+			const machine *axis = order.axis;
+			float sign = (order.odd) ? -1.0F : 1.0F;
+
+			float m00 = m[axis[0]][axis[0]];
+			float m01 = m[axis[0]][axis[1]];
+			float m02 = m[axis[0]][axis[2]];
+
+			if (Fabs(m02) < 0.9999995F)
+			{
+				x = -Arctan(m[axis[1]][axis[2]], m[axis[2]][axis[2]]);
+				z = -Arctan(m01, m00);
+			}
+			else
+			{
+				x = 0.0F;
+				z = Arctan(m[axis[1]][axis[0]], m[axis[1]][axis[1]]);
+			}
+
+			angle[axis[0]] = x * sign;
+			angle[axis[1]] = Arctan(m02, Sqrt(m00 * m00 + m01 * m01)) * sign;
+			angle[axis[2]] = z * sign;
+		}
+
+		void EulerToMatrix3D(const Vector3D *angles, Matrix3D *result, const EulerOrder& order)
+		{
+			float	m[3][3];
+
+			BuildEulerMatrix(&angles->x, order, m);
+			result->Set(m[0][0], m[0][1], m[0][2], m[1][0], m[1][1], m[1][2], m[2][0], m[2][1], m[2][2]);
+		}
+
+		void EulerToTransform3D(const Vector3D *angles, Transform3D *result, const EulerOrder& order)
+		{
+			float	m[3][3];
+
+			BuildEulerMatrix(&angles->x, order, m);
+			result->Set(m[0][0], m[0][1], m[0][2], 0.0F, m[1][0], m[1][1], m[1][2], 0.0F, m[2][0], m[2][1], m[2][2], 0.0F);
+		}
+
+		void EulerToQuaternion(const Vector3D *angles, Quaternion *result, const EulerOrder& order)
+		{
+			float	ca, sa, cb, sb, cc, sc;
+			float	q[3];
+
+			const machine *axis = order.axis;
+			float sign = (order.odd) ? -1.0F : 1.0F;
+
+			CosSin(angles->x * sign * 0.5F, &ca, &sa);
+			CosSin(angles->y * sign * 0.5F, &cb, &sb);
+			CosSin(angles->z * sign * 0.5F, &cc, &sc);
+
+			float c[3] = {ca, cb, cc};
+			float s[3] = {sa, sb, sc};
+			ca = c[axis[0]];
+			sa = s[axis[0]];
+			cb = c[axis[1]];
+			sb = s[axis[1]];
+			cc = c[axis[2]];
+			sc = s[axis[2]];
+
+			q[axis[0]] = (sa * cb * cc + ca * sb * sc) * sign;
+			q[axis[1]] = (ca * sb * cc - sa * cb * sc) * sign;
+			q[axis[2]] = (ca * cb * sc + sa * sb * cc) * sign;
+			result->Set(q[0], q[1], q[2], ca * cb * cc - sa * sb * sc);
+		}
+
+		void Matrix3DToEuler(const Matrix3D *matrix, Vector3D *angles, const EulerOrder& order)
+		{
+			const Matrix3D& M = *matrix;
+			float m[3][3] = {{M(0,0), M(0,1), M(0,2)}, {M(1,0), M(1,1), M(1,2)}, {M(2,0), M(2,1), M(2,2)}};
+			ExtractEulerAngles(m, order, &angles->x);
+		}
+
+		void Transform3DToEuler(const Transform3D *transform, Vector3D *angles, const EulerOrder& order)
+		{
+			const Transform3D& M = *transform;
+			float m[3][3] = {{M(0,0), M(0,1), M(0,2)}, {M(1,0), M(1,1), M(1,2)}, {M(2,0), M(2,1), M(2,2)}};
+			ExtractEulerAngles(m, order, &angles->x);
+		}
+
+		void QuaternionToEuler(const Quaternion *quaternion, Vector3D *angles, const EulerOrder& order)
+		{
+			Matrix3D M = quaternion->GetRotationMatrix();
+			Matrix3DToEuler(&M, angles, order);
+		}
+
+		void AxisAngleToMatrix3D(const float *angle, const Bivector3D *axis, Matrix3D *result)
+		{
+			*result = Matrix3D::MakeRotation(*angle, *axis);
+		}
+
+		void AxisAngleToTransform3D(const float *angle, const Bivector3D *axis, Transform3D *result)
+		{
+			*result = Transform3D::MakeRotation(*angle, *axis);
+		}
+
+		void AxisAngleToQuaternion(const float *angle, const Bivector3D *axis, Quaternion *result)
+		{
+			*result = Quaternion::MakeRotation(*angle, *axis);
+		}
+
+		void AxisAngleToMotor3D(const float *angle, const Bivector3D *axis, Motor3D *result)
+		{
+			*result = Motor3D::MakeRotation(*angle, *axis);
+		}
+
+		void RotateVectors(const float *angle, const Bivector3D *axis, const Vector3D *v, Vector3D *result)
+		{
+			Vector3D w = *v;
+			*result = w.RotateAboutAxis(*angle, *axis);
+		}
+
+		void GetExpFactors(float phi2, uint32 method, float *k, float *c, float *g, float *e)
+		{
+			if (method == kRotationIntegrationExact)
+			{
+				if (phi2 < 0.0625F)
+				{
+					*k = 1.0F - phi2 * (0.16666667F - phi2 * (0.0083333333F - phi2 * 1.9841270e-4F));
+					*c = 1.0F - phi2 * (0.5F - phi2 * (0.041666667F - phi2 * (0.0013888889F - phi2 * 2.4801587e-5F)));
+					*g = phi2 * (0.033333333F - phi2 * 0.0011904762F) - 0.33333333F;
+				}
+				else
+				{
+					float	s;
+
+					float r = InverseSqrt(phi2);
+					CosSin(phi2 * r, c, &s);
+					*k = s * r;
+					*g = (*c - *k) * (r * r);
+				}
+
+				*e = *k;
+			}
+			else
+			{
+				bool second = (method == kRotationIntegrationSecondOrder);
+				*k = 1.0F;
+				*c = (second) ? 1.0F - phi2 * 0.5F : 1.0F;
+				*g = 0.0F;
+				*e = (second) ? 1.0F : 0.0F;
+			}
+		}
+
+		void IntegrateQuaternionGroup(const Bivector3D *velocity, float dt, Quaternion *quaternion, uint32 method)
+		{
+			float	k, c, g, e;
+
+			Bivector3D x = *velocity * (dt * 0.5F);
+			GetExpFactors(x.x * x.x + x.y * x.y + x.z * x.z, method, &k, &c, &g, &e);
+
+			Quaternion q = *quaternion * Quaternion(x * k, c);
+			*quaternion = q * InverseSqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+		}
+
+		void IntegrateMotorGroup(const Line3D *velocity, float dt, Motor3D *motor, uint32 method)
+		{
+			float	k, c, g, e;
+
+			Line3D x = *velocity * (dt * 0.5F);
+			float lvlm = x.v.x * x.m.x + x.v.y * x.m.y + x.v.z * x.m.z;
+			GetExpFactors(x.v.x * x.v.x + x.v.y * x.v.y + x.v.z * x.v.z, method, &k, &c, &g, &e);
+
+			float h = g * lvlm;
+			Motor3D Q = *motor * Motor3D(x.v.x * k, x.v.y * k, x.v.z * k, c, x.m.x * k + x.v.x * h, x.m.y * k + x.v.y * h, x.m.z * k + x.v.z * h, -lvlm * e);
+			Q.Unitize();
+
+			float p = Q.v.x * Q.m.x + Q.v.y * Q.m.y + Q.v.z * Q.m.z + Q.v.w * Q.m.w;
+			*motor = Motor3D(Q.v.x, Q.v.y, Q.v.z, Q.v.w, Q.m.x - Q.v.x * p, Q.m.y - Q.v.y * p, Q.m.z - Q.v.z * p, Q.m.w - Q.v.w * p);
+		}
+
+	#endif
+
+
+	template <class input, class output>
+	void ConvertRotationArray(int32 count, const input *in, output *out, uint32 order, void (*convert)(const input *, output *, const EulerOrder&))
+	{
+		const EulerOrder& eulerOrder = eulerOrderTable[(order < kEulerOrderCount) ? order : kEulerOrderXYZ];
+
+		int32 i = 0;
+		for (; i <= count - kRotationGroupSize; i += kRotationGroupSize)
+		{
+			(*convert)(in + i, out + i, eulerOrder);
+		}
+
+		int32 n = count - i;
+		if (n > 0)
+		{
+			// The final partial group is padded by repeating its last object.
+
+			input	tempInput[kRotationGroupSize];
+			output	tempOutput[kRotationGroupSize];
+
+			for (machine k = 0; k < kRotationGroupSize; k++)
+			{
+				tempInput[k] = in[i + ((k < n) ? k : n - 1)];
+			}
+
+			(*convert)(tempInput, tempOutput, eulerOrder);
+
+			for (machine k = 0; k < n; k++)
+			{
+				out[i + k] = tempOutput[k];
+			}
+		}
+	}
+
+	template <class output>
+	void BuildRotationArray(int32 count, const float *angle, const Bivector3D *axis, output *result, void (*build)(const float *, const Bivector3D *, output *))
+	{
+		int32 i = 0;
+		for (; i <= count - kRotationGroupSize; i += kRotationGroupSize)
+		{
+			(*build)(angle + i, axis + i, result + i);
+		}
+
+		int32 n = count - i;
+		if (n > 0)
+		{
+			float			tempAngle[kRotationGroupSize];
+			Bivector3D		tempAxis[kRotationGroupSize];
+			output			tempOutput[kRotationGroupSize];
+
+			for (machine k = 0; k < kRotationGroupSize; k++)
+			{
+				machine j = i + ((k < n) ? k : n - 1);
+				tempAngle[k] = angle[j];
+				tempAxis[k] = axis[j];
+			}
+
+			(*build)(tempAngle, tempAxis, tempOutput);
+
+			for (machine k = 0; k < n; k++)
+			{
+				result[i + k] = tempOutput[k];
+			}
+		}
+	}
+
+	template <class state, class velocity_type>
+	void IntegrateArray(int32 count, const velocity_type *velocity, float dt, state *result, uint32 method, void (*integrate)(const velocity_type *, float, state *, uint32))
+	{
+		int32 i = 0;
+		for (; i <= count - kRotationGroupSize; i += kRotationGroupSize)
+		{
+			(*integrate)(velocity + i, dt, result + i, method);
+		}
+
+		int32 n = count - i;
+		if (n > 0)
+		{
+			velocity_type	tempVelocity[kRotationGroupSize];
+			state			tempState[kRotationGroupSize];
+
+			for (machine k = 0; k < kRotationGroupSize; k++)
+			{
+				machine j = i + ((k < n) ? k : n - 1);
+				tempVelocity[k] = velocity[j];
+				tempState[k] = result[j];
+			}
+
+			(*integrate)(tempVelocity, dt, tempState, method);
+
+			for (machine k = 0; k < n; k++)
+			{
+				result[i + k] = tempState[k];
+			}
+		}
+	}
+}
+
+
+/// @brief Calculates the 3&nbsp;&times;&nbsp;3 rotation matrices corresponding to an array of Euler angle triples.
+/// @param count	The number of angle triples.
+/// @param angles	A pointer to an array of \c count vectors holding the angles of rotation about the <i>x</i>, <i>y</i>, and <i>z</i> axes, in radians.
+/// @param result	A pointer to an array that receives the \c count rotation matrices.
+/// @param order	The order in which the rotations are applied. See \c kEulerOrderXYZ.
+///
+/// For the order \c kEulerOrderXYZ, the results are the same as those produced by the \c Matrix3D::SetEulerAngles() function.
+/// When SIMD is available, four angle triples are converted at once.
+///
+/// @relatedalso Matrix3D
+
+void Terathon::MakeEulerRotation(int32 count, const Vector3D *angles, Matrix3D *result, uint32 order)
+{
+	ConvertRotationArray(count, angles, result, order, &EulerToMatrix3D);
+}
+
+/// @brief Calculates the 3D transforms corresponding to an array of Euler angle triples.
+/// @param count	The number of angle triples.
+/// @param angles	A pointer to an array of \c count vectors holding the angles of rotation about the <i>x</i>, <i>y</i>, and <i>z</i> axes, in radians.
+/// @param result	A pointer to an array that receives the \c count transforms.
+/// @param order	The order in which the rotations are applied. See \c kEulerOrderXYZ.
+///
+/// The translation of each transform is set to zero. For the order \c kEulerOrderXYZ, the results are the same as those produced
+/// by the \c Transform3D::SetEulerAngles() function.
+///
+/// @relatedalso Transform3D
+
+void Terathon::MakeEulerRotation(int32 count, const Vector3D *angles, Transform3D *result, uint32 order)
+{
+	ConvertRotationArray(count, angles, result, order, &EulerToTransform3D);
+}
+
+/// @brief Calculates the unit quaternions corresponding to an array of Euler angle triples.
+/// @param count	The number of angle triples.
+/// @param angles	A pointer to an array of \c count vectors holding the angles of rotation about the <i>x</i>, <i>y</i>, and <i>z</i> axes, in radians.
+/// @param result	A pointer to an array that receives the \c count quaternions.
+/// @param order	The order in which the rotations are applied. See \c kEulerOrderXYZ.
+///
+/// Each quaternion is the product of the quaternions for the three individual rotations, so it represents the same rotation
+/// as the matrix produced by the \c MakeEulerRotation() function for the same order. The <i>w</i> component is not necessarily positive.
+///
+/// @relatedalso Quaternion
+
+void Terathon::MakeEulerRotation(int32 count, const Vector3D *angles, Quaternion *result, uint32 order)
+{
+	ConvertRotationArray(count, angles, result, order, &EulerToQuaternion);
+}
+
+/// @brief Extracts Euler angle triples from an array of 3&nbsp;&times;&nbsp;3 rotation matrices.
+/// @param count	The number of matrices.
+/// @param m		A pointer to an array of \c count matrices. Each matrix must be orthogonal with a determinant of +1.
+/// @param angles	A pointer to an array that receives the \c count angle triples, in radians.
+/// @param order	The order in which the rotations are applied. See \c kEulerOrderXYZ.
+///
+/// The angle for the second rotation in the given order lies in the range [&minus;&tau;/4,&nbsp;&tau;/4], and the other two angles
+/// lie in the range [&minus;&tau;/2,&nbsp;&tau;/2]. When the second angle is &plusmn;&tau;/4, the first and third rotations occur about
+/// the same axis, and the angle of the first rotation is set to zero. This case is handled with masks, so it does not cause
+/// the matrices to be processed any differently. For the order \c kEulerOrderXYZ, the results match those produced by the
+/// \c Matrix3D::GetEulerAngles() function.
+///
+/// @relatedalso Matrix3D
+
+void Terathon::GetEulerAngles(int32 count, const Matrix3D *m, Vector3D *angles, uint32 order)
+{
+	ConvertRotationArray(count, m, angles, order, &Matrix3DToEuler);
+}
+
+/// @brief Extracts Euler angle triples from the upper-left 3&nbsp;&times;&nbsp;3 portions of an array of 3D transforms.
+/// @param count	The number of transforms.
+/// @param m		A pointer to an array of \c count transforms. The upper-left 3&nbsp;&times;&nbsp;3 portion of each transform must be a rotation.
+/// @param angles	A pointer to an array that receives the \c count angle triples, in radians.
+/// @param order	The order in which the rotations are applied. See \c kEulerOrderXYZ.
+///
+/// The ranges of the angles are the same as those described for the \c GetEulerAngles() function that takes an array of matrices.
+///
+/// @relatedalso Transform3D
+
+void Terathon::GetEulerAngles(int32 count, const Transform3D *m, Vector3D *angles, uint32 order)
+{
+	ConvertRotationArray(count, m, angles, order, &Transform3DToEuler);
+}
+
+/// @brief Extracts Euler angle triples from an array of unit quaternions.
+/// @param count	The number of quaternions.
+/// @param q		A pointer to an array of \c count unit quaternions.
+/// @param angles	A pointer to an array that receives the \c count angle triples, in radians.
+/// @param order	The order in which the rotations are applied. See \c kEulerOrderXYZ.
+///
+/// The ranges of the angles are the same as those described for the \c GetEulerAngles() function that takes an array of matrices.
+///
+/// @relatedalso Quaternion
+
+void Terathon::GetEulerAngles(int32 count, const Quaternion *q, Vector3D *angles, uint32 order)
+{
+	ConvertRotationArray(count, q, angles, order, &QuaternionToEuler);
+}
+
+/// @brief Calculates the 3&nbsp;&times;&nbsp;3 matrices representing rotations through an array of angles about an array of axes.
+/// @param count	The number of rotations.
+/// @param angle	A pointer to an array of \c count angles of rotation, in radians.
+/// @param axis		A pointer to an array of \c count axes about which to rotate. These bivectors must have unit magnitude.
+/// @param result	A pointer to an array that receives the \c count rotation matrices.
+///
+/// Each result is the same as the matrix returned by the \c Matrix3D::MakeRotation() function for the corresponding angle and
+/// axis. When SIMD is available, four rotations are calculated at once.
+///
+/// @relatedalso Matrix3D
+
+void Terathon::MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Matrix3D *result)
+{
+	BuildRotationArray(count, angle, axis, result, &AxisAngleToMatrix3D);
+}
+
+/// @brief Calculates the 3D transforms representing rotations through an array of angles about an array of axes through the origin.
+/// @param count	The number of rotations.
+/// @param angle	A pointer to an array of \c count angles of rotation, in radians.
+/// @param axis		A pointer to an array of \c count axes about which to rotate. These bivectors must have unit magnitude.
+/// @param result	A pointer to an array that receives the \c count transforms.
+///
+/// Each result is the same as the transform returned by the \c Transform3D::MakeRotation() function for the corresponding angle and axis.
+///
+/// @relatedalso Transform3D
+
+void Terathon::MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Transform3D *result)
+{
+	BuildRotationArray(count, angle, axis, result, &AxisAngleToTransform3D);
+}
+
+/// @brief Calculates the quaternions representing rotations through an array of angles about an array of axes.
+/// @param count	The number of rotations.
+/// @param angle	A pointer to an array of \c count angles of rotation, in radians.
+/// @param axis		A pointer to an array of \c count axes about which to rotate. These bivectors must have unit magnitude.
+/// @param result	A pointer to an array that receives the \c count unit quaternions.
+///
+/// Each result is the same as the quaternion returned by the \c Quaternion::MakeRotation() function for the corresponding angle and axis.
+///
+/// @relatedalso Quaternion
+
+void Terathon::MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Quaternion *result)
+{
+	BuildRotationArray(count, angle, axis, result, &AxisAngleToQuaternion);
+}
+
+/// @brief Calculates the motors representing rotations through an array of angles about an array of axes through the origin.
+/// @param count	The number of rotations.
+/// @param angle	A pointer to an array of \c count angles of rotation, in radians.
+/// @param axis		A pointer to an array of \c count axes about which to rotate. These bivectors must have unit magnitude.
+/// @param result	A pointer to an array that receives the \c count unitized motors.
+///
+/// Each result is the same as the motor returned by the \c Motor3D::MakeRotation() function for the corresponding angle and axis.
+///
+/// @relatedalso Motor3D
+
+void Terathon::MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Motor3D *result)
+{
+	BuildRotationArray(count, angle, axis, result, &AxisAngleToMotor3D);
+}
+
+/// @brief Rotates an array of vectors through an array of angles about an array of axes.
+/// @param count	The number of vectors.
+/// @param angle	A pointer to an array of \c count angles of rotation, in radians.
+/// @param axis		A pointer to an array of \c count axes about which to rotate. These bivectors must have unit magnitude.
+/// @param v		A pointer to an array of \c count vectors to rotate.
+/// @param result	A pointer to an array that receives the \c count rotated vectors. This may be the same as \c v.
+///
+/// The vector <b>v</b>[<i>i</i>] is rotated through the angle <i>angle</i>[<i>i</i>] about the axis <b>axis</b>[<i>i</i>], giving the same
+/// result as the \c Vector3D::RotateAboutAxis() function. The rotation is applied directly without constructing a matrix, so this function
+/// is faster than calculating the rotations with the \c MakeRotation() function and then transforming the vectors.
+///
+/// @relatedalso Vector3D
+
+void Terathon::RotateAboutAxis(int32 count, const float *angle, const Bivector3D *axis, const Vector3D *v, Vector3D *result)
+{
+	int32 i = 0;
+	for (; i <= count - kRotationGroupSize; i += kRotationGroupSize)
+	{
+		RotateVectors(angle + i, axis + i, v + i, result + i);
+	}
+
+	int32 n = count - i;
+	if (n > 0)
+	{
+		float			tempAngle[kRotationGroupSize];
+		Bivector3D		tempAxis[kRotationGroupSize];
+		Vector3D		tempVector[kRotationGroupSize];
+
+		for (machine k = 0; k < kRotationGroupSize; k++)
+		{
+			machine j = i + ((k < n) ? k : n - 1);
+			tempAngle[k] = angle[j];
+			tempAxis[k] = axis[j];
+			tempVector[k] = v[j];
+		}
+
+		RotateVectors(tempAngle, tempAxis, tempVector, tempVector);
+
+		for (machine k = 0; k < n; k++)
+		{
+			result[i + k] = tempVector[k];
+		}
+	}
+}
+
+
+/// @brief Advances an array of orientations by an array of angular velocities over a time step.
+/// @param count		The number of orientations.
+/// @param velocity		A pointer to an array of \c count angular velocities, expressed in the local coordinate system of each orientation.
+/// @param dt			The time step.
+/// @param q			A pointer to an array of \c count unit quaternions that are advanced in place.
+/// @param method		The approximation used for the exponential map. See \c kRotationIntegrationExact.
+///
+/// Each quaternion is replaced by the product <b>q</b>&nbsp;exp(&frac12;&omega;<i>dt</i>), where &omega; is the bivector holding the angular
+/// velocity, and the result is renormalized. For the exact method, this is the rotation through the angle |&omega;|<i>dt</i> about the axis
+/// of &omega; applied before <b>q</b>. The approximate methods avoid the sine and cosine by truncating the exponential series. After renormalization,
+/// they still rotate about the exact axis, and the error in the angle is proportional to the cube of the angle rotated in one step.
+/// An angular velocity expressed in world space can be used instead by first rotating it into the local coordinate system with the inverse of <b>q</b>.
+///
+/// @relatedalso Quaternion
+
+void Terathon::IntegrateRotation(int32 count, const Bivector3D *velocity, float dt, Quaternion *q, uint32 method)
+{
+	IntegrateArray(count, velocity, dt, q, method, &IntegrateQuaternionGroup);
+}
+
+/// @brief Advances a range of orientations stored in structure-of-arrays layout by angular velocities over a time step.
+/// @param start		The index of the first orientation in the range.
+/// @param count		The number of orientations in the range.
+/// @param velocity		The angular velocities, expressed in the local coordinate system of each orientation.
+/// @param dt			The time step.
+/// @param q			The unit quaternions that are advanced in place.
+/// @param method		The approximation used for the exponential map. See \c kRotationIntegrationExact.
+///
+/// This function performs the same calculation as the array version of \c IntegrateRotation() directly on the component streams. Different ranges
+/// share no data, so disjoint ranges can be advanced on separate threads.
+///
+/// @relatedalso Quaternion
+
+void Terathon::IntegrateRotation(int32 start, int32 count, const Bivector3DArray& velocity, float dt, QuaternionArray *q, uint32 method)
+{
+	#ifndef TERATHON_NO_SIMD
+
+		const float *velocityStream[3] = {velocity.GetX() + start, velocity.GetY() + start, velocity.GetZ() + start};
+		float *stateStream[4] = {q->GetX() + start, q->GetY() + start, q->GetZ() + start, q->GetW() + start};
+		IntegrateStreams(count, velocityStream, 3, stateStream, 4, dt, method, &AdvanceQuaternions);
+
+	#else
+
+		for (machine i = start; i < start + count; i++)
+		{
+			Bivector3D w = velocity.Get(int32(i));
+			Quaternion r = q->Get(int32(i));
+			IntegrateQuaternionGroup(&w, dt, &r, method);
+			q->Set(int32(i), r);
+		}
+
+	#endif
+}
+
+/// @brief Advances an array of rigid motions by an array of velocities over a time step.
+/// @param count		The number of motions.
+/// @param velocity		A pointer to an array of \c count velocity lines, expressed in the local coordinate system of each motion.
+/// @param dt			The time step.
+/// @param Q			A pointer to an array of \c count unitized motors that are advanced in place.
+/// @param method		The approximation used for the exponential map. See \c kRotationIntegrationExact.
+///
+/// The direction of each velocity line is the angular velocity, and its moment is the linear velocity of the local origin. Each motor is
+/// replaced by the product <b>Q</b>&nbsp;exp(&frac12;<b>L</b><i>dt</i>), where <b>L</b> is the velocity line, and the result is unitized.
+/// For the exact method, this is the same screw motion calculated by the \c Exp() function, and a body moving with constant velocity
+/// is advanced without error for any time step. The approximate methods avoid the sine and cosine by truncating the exponential series.
+///
+/// @relatedalso Motor3D
+
+void Terathon::IntegrateMotion(int32 count, const Line3D *velocity, float dt, Motor3D *Q, uint32 method)
+{
+	IntegrateArray(count, velocity, dt, Q, method, &IntegrateMotorGroup);
+}
+
+/// @brief Advances a range of rigid motions stored in structure-of-arrays layout by velocities over a time step.
+/// @param start		The index of the first motion in the range.
+/// @param count		The number of motions in the range.
+/// @param velocity		The velocity lines, expressed in the local coordinate system of each motion.
+/// @param dt			The time step.
+/// @param Q			The unitized motors that are advanced in place.
+/// @param method		The approximation used for the exponential map. See \c kRotationIntegrationExact.
+///
+/// This function performs the same calculation as the array version of \c IntegrateMotion() directly on the component streams. Different ranges
+/// share no data, so disjoint ranges can be advanced on separate threads.
+///
+/// @relatedalso Motor3D
+
+void Terathon::IntegrateMotion(int32 start, int32 count, const Line3DArray& velocity, float dt, Motor3DArray *Q, uint32 method)
+{
+	#ifndef TERATHON_NO_SIMD
+
+		const float	*velocityStream[6];
+		float		*stateStream[8];
+
+		for (machine k = 0; k < 6; k++)
+		{
+			velocityStream[k] = velocity.GetComponent(int32(k)) + start;
+		}
+
+		for (machine k = 0; k < 8; k++)
+		{
+			stateStream[k] = Q->GetComponent(int32(k)) + start;
+		}
+
+		IntegrateStreams(count, velocityStream, 6, stateStream, 8, dt, method, &AdvanceMotors);
+
+	#else
+
+		for (machine i = start; i < start + count; i++)
+		{
+			Line3D l = velocity.Get(int32(i));
+			Motor3D r = Q->Get(int32(i));
+			IntegrateMotorGroup(&l, dt, &r, method);
+			Q->Set(int32(i), r);
+		}
+
+	#endif
+}
@@ -0,0 +1,74 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSRotationArray_h
+#define TSRotationArray_h
+
+
+#include "TSGeometryArray.h"
+
+
+#define TERATHON_ROTATIONARRAY 1
+
+
+namespace Terathon
+{
+	/// @brief Identifies the order in which the rotations about the coordinate axes are applied for a set of Euler angles.
+	///
+	/// The letters give the order in which the rotation matrices are multiplied. For example, \c kEulerOrderXYZ corresponds to the
+	/// product <b>R</b><sub><i>x</i></sub><b>R</b><sub><i>y</i></sub><b>R</b><sub><i>z</i></sub>, which is the convention used by the
+	/// \c Matrix3D::SetEulerAngles() function. When applied to a column vector, the rightmost rotation is performed first.
+	/// In every order, the <i>x</i>, <i>y</i>, and <i>z</i> components of an angle triple are the angles of rotation about
+	/// the <i>x</i>, <i>y</i>, and <i>z</i> axes.
+
+	enum : uint32
+	{
+		kEulerOrderXYZ		= 0,
+		kEulerOrderXZY		= 1,
+		kEulerOrderYXZ		= 2,
+		kEulerOrderYZX		= 3,
+		kEulerOrderZXY		= 4,
+		kEulerOrderZYX		= 5,
+		kEulerOrderCount	= 6
+	};
+
+
+	/// @brief Identifies the approximation used to advance an orientation by an angular velocity.
+
+	enum : uint32
+	{
+		kRotationIntegrationExact,				///< The exact exponential map, which rotates through the full angle |&omega;|<i>dt</i> about the axis of &omega;.
+		kRotationIntegrationFirstOrder,			///< The exponential series truncated after the linear term, followed by renormalization.
+		kRotationIntegrationSecondOrder			///< The exponential series truncated after the quadratic term, followed by renormalization. The angle error is half that of the first-order method.
+	};
+
+
+	TERATHON_API void MakeEulerRotation(int32 count, const Vector3D *angles, Matrix3D *result, uint32 order = kEulerOrderXYZ);
+	TERATHON_API void MakeEulerRotation(int32 count, const Vector3D *angles, Transform3D *result, uint32 order = kEulerOrderXYZ);
+	TERATHON_API void MakeEulerRotation(int32 count, const Vector3D *angles, Quaternion *result, uint32 order = kEulerOrderXYZ);
+
+	TERATHON_API void GetEulerAngles(int32 count, const Matrix3D *m, Vector3D *angles, uint32 order = kEulerOrderXYZ);
+	TERATHON_API void GetEulerAngles(int32 count, const Transform3D *m, Vector3D *angles, uint32 order = kEulerOrderXYZ);
+	TERATHON_API void GetEulerAngles(int32 count, const Quaternion *q, Vector3D *angles, uint32 order = kEulerOrderXYZ);
+
+	TERATHON_API void MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Matrix3D *result);
+	TERATHON_API void MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Transform3D *result);
+	TERATHON_API void MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Quaternion *result);
+	TERATHON_API void MakeRotation(int32 count, const float *angle, const Bivector3D *axis, Motor3D *result);
+
+	TERATHON_API void RotateAboutAxis(int32 count, const float *angle, const Bivector3D *axis, const Vector3D *v, Vector3D *result);
+
+	TERATHON_API void IntegrateRotation(int32 count, const Bivector3D *velocity, float dt, Quaternion *q, uint32 method = kRotationIntegrationExact);
+	TERATHON_API void IntegrateRotation(int32 start, int32 count, const Bivector3DArray& velocity, float dt, QuaternionArray *q, uint32 method = kRotationIntegrationExact);
+	TERATHON_API void IntegrateMotion(int32 count, const Line3D *velocity, float dt, Motor3D *Q, uint32 method = kRotationIntegrationExact);
+	TERATHON_API void IntegrateMotion(int32 start, int32 count, const Line3DArray& velocity, float dt, Motor3DArray *Q, uint32 method = kRotationIntegrationExact);
+}
+
+
+#endif
@@ -124,6 +124,10 @@
 			extern __m128i _mm_cvtps_epi32(__m128);
 			extern __m128i _mm_add_epi32(__m128i, __m128i);
 			extern __m128i _mm_sub_epi32(__m128i, __m128i);
+			extern __m128i _mm_set1_epi8(char);
+			extern __m128i _mm_cmpeq_epi8(__m128i, __m128i);
+			extern __m128i _mm_min_epu8(__m128i, __m128i);
+			extern int _mm_movemask_epi8(__m128i);
 		}
 
 	#endif
@@ -167,9 +171,14 @@
 			extern __m128 __cdecl _mm256_castps256_ps128(__m256);
 			extern __m256 __cdecl _mm256_castps128_ps256(__m128);
 			extern __m256 __cdecl _mm256_setzero_ps(void);
+			extern __m256 __cdecl _mm256_shuffle_ps(__m256, __m256, int);
+			extern __m256 __cdecl _mm256_unpacklo_ps(__m256, __m256);
+			extern __m256 __cdecl _mm256_unpackhi_ps(__m256, __m256);
 			extern __m256 __cdecl _mm256_load_ps(const float *);
+			extern __m256 __cdecl _mm256_loadu_ps(const float *);
 			extern __m256 __cdecl _mm256_broadcast_ss(const float *);
 			extern void __cdecl _mm256_store_ps(float *, __m256);
+			extern void __cdecl _mm256_storeu_ps(float *, __m256);
 		}
 
 	#endif
@@ -1038,6 +1047,20 @@ namespace Terathon
 		#endif
 	}
 
+	inline uint32 VecMaskGetBits(const vec_float& mask)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (uint32(_mm_movemask_ps(mask)));
+
+		#elif defined(TERATHON_NEON)
+
+			alignas(16) static const uint32 bit[4] = {1, 2, 4, 8};
+			return (vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(mask), vld1q_u32(bit))));
+
+		#endif
+	}
+
 	inline bool VecCmpeqScalar(const vec_float& v1, const vec_float& v2)
 	{
 		#if defined(TERATHON_SSE)
@@ -1930,6 +1953,71 @@ namespace Terathon
 		#endif
 	}
 
+	inline void VecTranspose4D(vec_float *a, vec_float *b, vec_float *c, vec_float *d)
+	{
+		#if defined(TERATHON_SSE)
+
+			vec_float t0 = VecShuffle<1, 0, 1, 0>(*a, *b);
+			vec_float t1 = VecShuffle<3, 2, 3, 2>(*a, *b);
+			vec_float t2 = VecShuffle<1, 0, 1, 0>(*c, *d);
+			vec_float t3 = VecShuffle<3, 2, 3, 2>(*c, *d);
+
+			*a = VecShuffle<2, 0, 2, 0>(t0, t2);
+			*b = VecShuffle<3, 1, 3, 1>(t0, t2);
+			*c = VecShuffle<2, 0, 2, 0>(t1, t3);
+			*d = VecShuffle<3, 1, 3, 1>(t1, t3);
+
+		#elif defined(TERATHON_NEON)
+
+			float32x4x2_t p = vtrnq_f32(*a, *b);
+			float32x4x2_t q = vtrnq_f32(*c, *d);
+
+			*a = vcombine_f32(vget_low_f32(p.val[0]), vget_low_f32(q.val[0]));
+			*b = vcombine_f32(vget_low_f32(p.val[1]), vget_low_f32(q.val[1]));
+			*c = vcombine_f32(vget_high_f32(p.val[0]), vget_high_f32(q.val[0]));
+			*d = vcombine_f32(vget_high_f32(p.val[1]), vget_high_f32(q.val[1]));
+
+		#endif
+	}
+
+	inline void VecLoadTranspose3D(const float *ptr, vec_float *x, vec_float *y, vec_float *z)
+	{
+		#if defined(TERATHON_SSE)
+
+			vec_float a = _mm_loadu_ps(ptr);
+			vec_float b = _mm_loadu_ps(ptr + 4);
+			vec_float c = _mm_loadu_ps(ptr + 8);
+
+			*x = VecShuffle<2, 0, 3, 0>(a, VecShuffle<1, 1, 2, 2>(b, c));
+			*y = VecShuffle<2, 0, 2, 0>(VecShuffle<0, 0, 1, 1>(a, b), VecShuffle<2, 2, 3, 3>(b, c));
+			*z = VecShuffle<3, 0, 2, 0>(VecShuffle<1, 1, 2, 2>(a, b), c);
+
+		#elif defined(TERATHON_NEON)
+
+			float32x4x3_t v = vld3q_f32(ptr);
+			*x = v.val[0];
+			*y = v.val[1];
+			*z = v.val[2];
+
+		#endif
+	}
+
+	inline void VecStoreTranspose3D(const vec_float& x, const vec_float& y, const vec_float& z, float *ptr)
+	{
+		#if defined(TERATHON_SSE)
+
+			_mm_storeu_ps(ptr, VecShuffle<2, 0, 2, 0>(VecShuffle<0, 0, 0, 0>(x, y), VecShuffle<1, 1, 0, 0>(z, x)));
+			_mm_storeu_ps(ptr + 4, VecShuffle<2, 0, 2, 0>(VecShuffle<1, 1, 1, 1>(y, z), VecShuffle<2, 2, 2, 2>(x, y)));
+			_mm_storeu_ps(ptr + 8, VecShuffle<2, 0, 2, 0>(VecShuffle<3, 3, 2, 2>(z, x), VecShuffle<3, 3, 3, 3>(y, z)));
+
+		#elif defined(TERATHON_NEON)
+
+			float32x4x3_t v = {{x, y, z}};
+			vst3q_f32(ptr, v);
+
+		#endif
+	}
+
 	inline vec_int8 VecInt8GetZero(void)
 	{
 		#if defined(TERATHON_SSE)
@@ -2087,6 +2175,58 @@ namespace Terathon
 		#endif
 	}
 
+	inline vec_int32 VecInt32Load(const int32 *ptr)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_load_si128(reinterpret_cast<const __m128i *>(ptr)));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vld1q_s32(ptr));
+
+		#endif
+	}
+
+	inline vec_int32 VecInt32LoadUnaligned(const int32 *ptr)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vld1q_s32(ptr));
+
+		#endif
+	}
+
+	inline void VecInt32Store(const vec_int32& v, int32 *ptr)
+	{
+		#if defined(TERATHON_SSE)
+
+			_mm_store_si128(reinterpret_cast<__m128i *>(ptr), v);
+
+		#elif defined(TERATHON_NEON)
+
+			vst1q_s32(ptr, v);
+
+		#endif
+	}
+
+	inline void VecInt32StoreUnaligned(const vec_int32& v, int32 *ptr)
+	{
+		#if defined(TERATHON_SSE)
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(ptr), v);
+
+		#elif defined(TERATHON_NEON)
+
+			vst1q_s32(ptr, v);
+
+		#endif
+	}
+
 	inline void VecInt32StoreX(const vec_int32& v, int32 *ptr)
 	{
 		#if defined(TERATHON_SSE)
@@ -2392,6 +2532,19 @@ namespace Terathon
 		#endif
 	}
 
+	inline vec_int32 VecCastInt32(const vec_float& v)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_castps_si128(v));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vreinterpretq_s32_f32(v));
+
+		#endif
+	}
+
 	inline vec_int32 VecInt32Add(const vec_int32& v1, const vec_int32& v2)
 	{
 		#if defined(TERATHON_SSE)
@@ -2418,6 +2571,127 @@ namespace Terathon
 		#endif
 	}
 
+	template <uint32 value>
+	inline vec_int32 VecInt32LoadConstant(void)
+	{
+		#if defined(TERATHON_SSE)
+
+			alignas(16) static const uint32 k[4] = {value, value, value, value};
+			return (_mm_load_si128(reinterpret_cast<const __m128i *>(k)));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vreinterpretq_s32_u32(vdupq_n_u32(value)));
+
+		#endif
+	}
+
+	inline vec_int32 VecInt32And(const vec_int32& v1, const vec_int32& v2)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_and_si128(v1, v2));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vandq_s32(v1, v2));
+
+		#endif
+	}
+
+	inline vec_int32 VecInt32Andc(const vec_int32& v1, const vec_int32& v2)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_andnot_si128(v2, v1));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vbicq_s32(v1, v2));
+
+		#endif
+	}
+
+	inline vec_int32 VecInt32Or(const vec_int32& v1, const vec_int32& v2)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_or_si128(v1, v2));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vorrq_s32(v1, v2));
+
+		#endif
+	}
+
+	inline vec_int32 VecInt32Xor(const vec_int32& v1, const vec_int32& v2)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_xor_si128(v1, v2));
+
+		#elif defined(TERATHON_NEON)
+
+			return (veorq_s32(v1, v2));
+
+		#endif
+	}
+
+	template <int32 count>
+	inline vec_int32 VecInt32ShiftLeft(const vec_int32& v)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_slli_epi32(v, count));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vshlq_n_s32(v, count));
+
+		#endif
+	}
+
+	template <int32 count>
+	inline vec_int32 VecInt32ShiftRightLogical(const vec_int32& v)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_srli_epi32(v, count));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(v), count)));
+
+		#endif
+	}
+
+	inline vec_int32 VecInt32MaskCmpeq(const vec_int32& v1, const vec_int32& v2)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_cmpeq_epi32(v1, v2));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vreinterpretq_s32_u32(vceqq_s32(v1, v2)));
+
+		#endif
+	}
+
+	inline vec_int32 VecInt32Select(const vec_int32& v1, const vec_int32& v2, const vec_int32& mask)
+	{
+		#if defined(TERATHON_SSE)
+
+			return (_mm_or_si128(_mm_andnot_si128(mask, v1), _mm_and_si128(mask, v2)));
+
+		#elif defined(TERATHON_NEON)
+
+			return (vbslq_s32(vreinterpretq_u32_s32(mask), v2, v1));
+
+		#endif
+	}
+
 	#if defined(TERATHON_AVX)
 
 		inline exv_float ExvFloat(const vec_float& v1, const vec_float& v2)
@@ -2501,6 +2775,62 @@ namespace Terathon
 			_mm_store_ss(ptr, _mm256_castps256_ps128(_mm256_permute_ps(v, 0xFF)));
 		}
 
+		inline exv_float ExvLoadUnaligned(const float *ptr)
+		{
+			return (_mm256_loadu_ps(ptr));
+		}
+
+		inline void ExvStoreUnaligned(const exv_float& v, float *ptr)
+		{
+			_mm256_storeu_ps(ptr, v);
+		}
+
+		template <int p3, int p2, int p1, int p0>
+		inline exv_float ExvShuffle(const exv_float& v1, const exv_float& v2)
+		{
+			return (_mm256_shuffle_ps(v1, v2, _MM_SHUFFLE(p3, p2, p1, p0)));
+		}
+
+		inline exv_float ExvMergeA(const exv_float& v1, const exv_float& v2)
+		{
+			return (_mm256_unpacklo_ps(v1, v2));
+		}
+
+		inline exv_float ExvMergeB(const exv_float& v1, const exv_float& v2)
+		{
+			return (_mm256_unpackhi_ps(v1, v2));
+		}
+
+		inline void ExvTranspose8D(exv_float *v)
+		{
+			exv_float t0 = ExvMergeA(v[0], v[1]);
+			exv_float t1 = ExvMergeB(v[0], v[1]);
+			exv_float t2 = ExvMergeA(v[2], v[3]);
+			exv_float t3 = ExvMergeB(v[2], v[3]);
+			exv_float t4 = ExvMergeA(v[4], v[5]);
+			exv_float t5 = ExvMergeB(v[4], v[5]);
+			exv_float t6 = ExvMergeA(v[6], v[7]);
+			exv_float t7 = ExvMergeB(v[6], v[7]);
+
+			exv_float s0 = ExvShuffle<1, 0, 1, 0>(t0, t2);
+			exv_float s1 = ExvShuffle<3, 2, 3, 2>(t0, t2);
+			exv_float s2 = ExvShuffle<1, 0, 1, 0>(t1, t3);
+			exv_float s3 = ExvShuffle<3, 2, 3, 2>(t1, t3);
+			exv_float s4 = ExvShuffle<1, 0, 1, 0>(t4, t6);
+			exv_float s5 = ExvShuffle<3, 2, 3, 2>(t4, t6);
+			exv_float s6 = ExvShuffle<1, 0, 1, 0>(t5, t7);
+			exv_float s7 = ExvShuffle<3, 2, 3, 2>(t5, t7);
+
+			v[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+			v[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+			v[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+			v[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+			v[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+			v[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+			v[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+			v[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+		}
+
 		inline exv_float ExvMul(const exv_float& v1, const exv_float& v2)
 		{
 			return (_mm256_mul_ps(v1, v2));
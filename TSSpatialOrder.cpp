@@ -0,0 +1,497 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSSpatialOrder.h"
+#include "TSMemory.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	enum : uint32
+	{
+		kRadixDigitBits		= 11,
+		kRadixDigitCount	= 1 << kRadixDigitBits,
+		kRadixPassCount		= 3
+	};
+
+
+	struct QuantizeParams
+	{
+		float		offset[3];
+		float		scale[3];
+
+		QuantizeParams(const Point3D& boundsMin, const Point3D& boundsMax)
+		{
+			// Each axis is scaled independently so that the bounding box fills the full range of quantized coordinates.
+
+			const float kMaxCoord = float(1 << kSpatialKeyAxisBits);
+			for (machine a = 0; a < 3; a++)
+			{
+				float extent = boundsMax[a] - boundsMin[a];
+				offset[a] = boundsMin[a];
+				scale[a] = (extent > Math::min_float) ? kMaxCoord / extent : 0.0F;
+			}
+		}
+
+		int32 Quantize(float x, int32 axis) const
+		{
+			float q = (x - offset[axis]) * scale[axis];
+			return (int32(Fmin(Fmax(q, 0.0F), 1023.0F)));
+		}
+	};
+
+	inline uint32 SpreadBits(uint32 x)
+	{
+		x = (x | (x << 16)) & 0x030000FF;
+		x = (x | (x << 8)) & 0x0300F00F;
+		x = (x | (x << 4)) & 0x030C30C3;
+		x = (x | (x << 2)) & 0x09249249;
+		return (x);
+	}
+
+	void TransposeHilbert(uint32 *X)
+	{
+		// Convert coordinates to the transposed form of the Hilbert index with Skilling's method.
+		// The bits of the index are then obtained by interleaving the three transformed coordinates.
+
+		const uint32 kTopBit = 1 << (kSpatialKeyAxisBits - 1);
+
+		for (uint32 Q = kTopBit; Q > 1; Q >>= 1)
+		{
+			uint32 P = Q - 1;
+			for (machine i = 0; i < 3; i++)
+			{
+				if (X[i] & Q)
+				{
+					X[0] ^= P;
+				}
+				else
+				{
+					uint32 t = (X[0] ^ X[i]) & P;
+					X[0] ^= t;
+					X[i] ^= t;
+				}
+			}
+		}
+
+		X[1] ^= X[0];
+		X[2] ^= X[1];
+
+		uint32 t = 0;
+		for (uint32 Q = kTopBit; Q > 1; Q >>= 1)
+		{
+			if (X[2] & Q)
+			{
+				t ^= Q - 1;
+			}
+		}
+
+		X[0] ^= t;
+		X[1] ^= t;
+		X[2] ^= t;
+	}
+
+	#ifndef TERATHON_NO_SIMD
+
+		inline vec_int32 VecSpreadBits(vec_int32 x)
+		{
+			x = VecInt32And(VecInt32Or(x, VecInt32ShiftLeft<16>(x)), VecInt32LoadConstant<0x030000FF>());
+			x = VecInt32And(VecInt32Or(x, VecInt32ShiftLeft<8>(x)), VecInt32LoadConstant<0x0300F00F>());
+			x = VecInt32And(VecInt32Or(x, VecInt32ShiftLeft<4>(x)), VecInt32LoadConstant<0x030C30C3>());
+			x = VecInt32And(VecInt32Or(x, VecInt32ShiftLeft<2>(x)), VecInt32LoadConstant<0x09249249>());
+			return (x);
+		}
+
+		inline void VecQuantize(const Point3D *point, const QuantizeParams& params, vec_int32 *q)
+		{
+			vec_float	p[3];
+
+			VecLoadTranspose3D(&point->x, &p[0], &p[1], &p[2]);
+
+			vec_float zero = VecFloatGetZero();
+			vec_float limit = VecLoadVectorConstant<0x447FC000>();
+
+			for (machine a = 0; a < 3; a++)
+			{
+				vec_float f = VecMul(VecSub(p[a], VecLoadSmearScalar(&params.offset[a])), VecLoadSmearScalar(&params.scale[a]));
+				q[a] = VecConvertInt32(VecFloor(VecMin(VecMax(f, zero), limit)));
+			}
+		}
+
+		void VecTransposeHilbert(vec_int32 *X)
+		{
+			// This is the same calculation as the TransposeHilbert() function, with each branch
+			// replaced by a selection based on a mask indicating which lanes have the bit clear.
+
+			vec_int32 zero = VecInt32GetZero();
+			vec_int32 one = VecInt32LoadConstant<1>();
+			vec_int32 Q = VecInt32LoadConstant<1 << (kSpatialKeyAxisBits - 1)>();
+
+			for (machine k = 1; k < kSpatialKeyAxisBits; k++)
+			{
+				vec_int32 P = VecInt32Sub(Q, one);
+
+				vec_int32 clear = VecInt32MaskCmpeq(VecInt32And(X[0], Q), zero);
+				X[0] = VecInt32Xor(X[0], VecInt32Andc(P, clear));
+
+				for (machine i = 1; i < 3; i++)
+				{
+					clear = VecInt32MaskCmpeq(VecInt32And(X[i], Q), zero);
+					vec_int32 t = VecInt32And(VecInt32And(VecInt32Xor(X[0], X[i]), P), clear);
+					X[0] = VecInt32Xor(X[0], VecInt32Select(P, t, clear));
+					X[i] = VecInt32Xor(X[i], t);
+				}
+
+				Q = VecInt32ShiftRightLogical<1>(Q);
+			}
+
+			X[1] = VecInt32Xor(X[1], X[0]);
+			X[2] = VecInt32Xor(X[2], X[1]);
+
+			vec_int32 t = zero;
+			Q = VecInt32LoadConstant<1 << (kSpatialKeyAxisBits - 1)>();
+
+			for (machine k = 1; k < kSpatialKeyAxisBits; k++)
+			{
+				vec_int32 P = VecInt32Sub(Q, one);
+				t = VecInt32Xor(t, VecInt32Andc(P, VecInt32MaskCmpeq(VecInt32And(X[2], Q), zero)));
+				Q = VecInt32ShiftRightLogical<1>(Q);
+			}
+
+			X[0] = VecInt32Xor(X[0], t);
+			X[1] = VecInt32Xor(X[1], t);
+			X[2] = VecInt32Xor(X[2], t);
+		}
+
+	#endif
+}
+
+
+/// @brief Calculates the axis-aligned bounding box of an array of points.
+/// @param count		The number of points. This must be at least one.
+/// @param point		A pointer to an array of \c count points.
+/// @param boundsMin	A pointer to a location that receives the minimum coordinates.
+/// @param boundsMax	A pointer to a location that receives the maximum coordinates.
+
+void Terathon::CalculatePointBounds(int32 count, const Point3D *point, Point3D *boundsMin, Point3D *boundsMax)
+{
+	float xmin = point->x, ymin = point->y, zmin = point->z;
+	float xmax = xmin, ymax = ymin, zmax = zmin;
+
+	int32 i = 1;
+
+	#ifndef TERATHON_NO_SIMD
+
+		if (count >= 5)
+		{
+			vec_float	x, y, z;
+
+			VecLoadTranspose3D(&point[1].x, &x, &y, &z);
+			vec_float vxmin = x, vymin = y, vzmin = z;
+			vec_float vxmax = x, vymax = y, vzmax = z;
+
+			for (i = 5; i <= count - 4; i += 4)
+			{
+				VecLoadTranspose3D(&point[i].x, &x, &y, &z);
+				vxmin = VecMin(vxmin, x);
+				vymin = VecMin(vymin, y);
+				vzmin = VecMin(vzmin, z);
+				vxmax = VecMax(vxmax, x);
+				vymax = VecMax(vymax, y);
+				vzmax = VecMax(vzmax, z);
+			}
+
+			alignas(16) float	f[6][4];
+
+			VecStore(vxmin, f[0]);
+			VecStore(vymin, f[1]);
+			VecStore(vzmin, f[2]);
+			VecStore(vxmax, f[3]);
+			VecStore(vymax, f[4]);
+			VecStore(vzmax, f[5]);
+
+			for (machine a = 0; a < 4; a++)
+			{
+				xmin = Fmin(xmin, f[0][a]);
+				ymin = Fmin(ymin, f[1][a]);
+				zmin = Fmin(zmin, f[2][a]);
+				xmax = Fmax(xmax, f[3][a]);
+				ymax = Fmax(ymax, f[4][a]);
+				zmax = Fmax(zmax, f[5][a]);
+			}
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		const Point3D& p = point[i];
+		xmin = Fmin(xmin, p.x);
+		ymin = Fmin(ymin, p.y);
+		zmin = Fmin(zmin, p.z);
+		xmax = Fmax(xmax, p.x);
+		ymax = Fmax(ymax, p.y);
+		zmax = Fmax(zmax, p.z);
+	}
+
+	boundsMin->Set(xmin, ymin, zmin);
+	boundsMax->Set(xmax, ymax, zmax);
+}
+
+/// @brief Calculates Morton codes for an array of points.
+/// @param count		The number of points.
+/// @param point		A pointer to an array of \c count points.
+/// @param boundsMin	The minimum coordinates of the box in which the points are quantized.
+/// @param boundsMax	The maximum coordinates of the box in which the points are quantized.
+/// @param code			A pointer to an array of \c count entries that receives the codes.
+///
+/// Each coordinate is quantized to \c kSpatialKeyAxisBits bits relative to the box, with points outside the box
+/// clamped to its boundary, and the bits of the three coordinates are interleaved with <i>x</i> in the lowest position.
+///
+/// @sa CalculateHilbertCodes()
+
+void Terathon::CalculateMortonCodes(int32 count, const Point3D *point, const Point3D& boundsMin, const Point3D& boundsMax, uint32 *code)
+{
+	QuantizeParams params(boundsMin, boundsMax);
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		for (; i <= count - 4; i += 4)
+		{
+			vec_int32	q[3];
+
+			VecQuantize(point + i, params, q);
+			vec_int32 c = VecInt32Or(VecSpreadBits(q[0]), VecInt32ShiftLeft<1>(VecSpreadBits(q[1])));
+			c = VecInt32Or(c, VecInt32ShiftLeft<2>(VecSpreadBits(q[2])));
+			VecInt32StoreUnaligned(c, reinterpret_cast<int32 *>(code + i));
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		const Point3D& p = point[i];
+		uint32 x = SpreadBits(params.Quantize(p.x, 0));
+		uint32 y = SpreadBits(params.Quantize(p.y, 1));
+		uint32 z = SpreadBits(params.Quantize(p.z, 2));
+		code[i] = x | (y << 1) | (z << 2);
+	}
+}
+
+/// @brief Calculates Hilbert codes for an array of points.
+/// @param count		The number of points.
+/// @param point		A pointer to an array of \c count points.
+/// @param boundsMin	The minimum coordinates of the box in which the points are quantized.
+/// @param boundsMax	The maximum coordinates of the box in which the points are quantized.
+/// @param code			A pointer to an array of \c count entries that receives the codes.
+///
+/// The points are quantized in the same way as they are by the \c CalculateMortonCodes() function, and each code is the
+/// distance along a 3D Hilbert curve passing through all cells of the quantized grid.
+///
+/// @sa CalculateMortonCodes()
+
+void Terathon::CalculateHilbertCodes(int32 count, const Point3D *point, const Point3D& boundsMin, const Point3D& boundsMax, uint32 *code)
+{
+	QuantizeParams params(boundsMin, boundsMax);
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		for (; i <= count - 4; i += 4)
+		{
+			vec_int32	X[3];
+
+			VecQuantize(point + i, params, X);
+			VecTransposeHilbert(X);
+
+			vec_int32 c = VecInt32Or(VecInt32ShiftLeft<2>(VecSpreadBits(X[0])), VecInt32ShiftLeft<1>(VecSpreadBits(X[1])));
+			c = VecInt32Or(c, VecSpreadBits(X[2]));
+			VecInt32StoreUnaligned(c, reinterpret_cast<int32 *>(code + i));
+		}
+
+	#endif
+
+	for (; i < count; i++)
+	{
+		uint32	X[3];
+
+		const Point3D& p = point[i];
+		X[0] = params.Quantize(p.x, 0);
+		X[1] = params.Quantize(p.y, 1);
+		X[2] = params.Quantize(p.z, 2);
+		TransposeHilbert(X);
+
+		code[i] = (SpreadBits(X[0]) << 2) | (SpreadBits(X[1]) << 1) | SpreadBits(X[2]);
+	}
+}
+
+/// @brief Calculates the permutation that sorts an array of spatial codes.
+/// @param count			The number of codes.
+/// @param code				A pointer to an array of \c count codes.
+/// @param permutation		A pointer to an array of \c count entries that receives the permutation. Entry \c i is the index of the code that belongs at position \c i in sorted order.
+///
+/// @param arena			A memory arena from which temporary storage is allocated. This can be \c nullptr.
+///
+/// The codes are sorted with a stable least-significant-digit radix sort, so codes that are equal remain in their original
+/// order. Passes for digits that are the same in every code are skipped. The sort needs temporary storage for two more keys
+/// and one more index per code, and it is taken from \c arena when one is supplied.
+///
+/// @return Returns \c true if the codes were sorted, and \c false if the temporary storage could not be allocated, in which case the contents of the permutation are undefined.
+
+bool Terathon::SortSpatialCodes(int32 count, const uint32 *code, int32 *permutation, MemoryArena *arena)
+{
+	int32	histogram[kRadixPassCount][kRadixDigitCount];
+
+	if (count <= 0)
+	{
+		return (true);
+	}
+
+	ScratchStorage scratch(count * sizeof(uint32) * 3, arena);
+	uint32 *storage = static_cast<uint32 *>(scratch.GetStorage());
+	if (!storage)
+	{
+		return (false);
+	}
+
+	// Build the histograms for all passes in a single scan.
+
+	ClearMemory(histogram, sizeof(histogram));
+	for (machine i = 0; i < count; i++)
+	{
+		uint32 c = code[i];
+		for (machine k = 0; k < kRadixPassCount; k++)
+		{
+			histogram[k][(c >> (k * kRadixDigitBits)) & (kRadixDigitCount - 1)]++;
+		}
+	}
+
+	uint32 *key[2] = {storage, storage + count};
+	int32 *index[2] = {reinterpret_cast<int32 *>(storage + count * 2), permutation};
+
+	// The passes alternate between the two buffers. The initial buffer is chosen so that the final pass
+	// writes into the permutation array, and skipped passes leave it unchanged.
+
+	int32 passCount = 0;
+	for (machine k = 0; k < kRadixPassCount; k++)
+	{
+		passCount += (histogram[k][(code[0] >> (k * kRadixDigitBits)) & (kRadixDigitCount - 1)] != count);
+	}
+
+	int32 current = (passCount & 1) ^ 1;
+	for (machine i = 0; i < count; i++)
+	{
+		key[current][i] = code[i];
+		index[current][i] = int32(i);
+	}
+
+	for (machine k = 0; k < kRadixPassCount; k++)
+	{
+		int32 *h = histogram[k];
+		uint32 shift = uint32(k * kRadixDigitBits);
+		if (h[(code[0] >> shift) & (kRadixDigitCount - 1)] == count)
+		{
+			continue;
+		}
+
+		int32 sum = 0;
+		for (machine d = 0; d < kRadixDigitCount; d++)
+		{
+			int32 n = h[d];
+			h[d] = sum;
+			sum += n;
+		}
+
+		const uint32 *sourceKey = key[current];
+		const int32 *sourceIndex = index[current];
+		uint32 *destKey = key[current ^ 1];
+		int32 *destIndex = index[current ^ 1];
+
+		for (machine i = 0; i < count; i++)
+		{
+			uint32 c = sourceKey[i];
+			int32 j = h[(c >> shift) & (kRadixDigitCount - 1)]++;
+			destKey[j] = c;
+			destIndex[j] = sourceIndex[i];
+		}
+
+		current ^= 1;
+	}
+
+	return (true);
+}
+
+/// @brief Reorders an array of points along a space-filling curve.
+/// @param count			The number of points.
+/// @param point			A pointer to an array of \c count points, which is reordered in place.
+/// @param permutation		A pointer to an array of \c count entries that receives the original index of each reordered point. This can be \c nullptr.
+/// @param order			The space-filling curve. This can be \c kSpatialOrderMorton or \c kSpatialOrderHilbert.
+/// @param arena			A memory arena from which temporary storage is allocated. This can be \c nullptr.
+///
+/// The points are quantized relative to their own bounding box. Arrays of attributes associated with the points can
+/// be reordered to match by using the permutation, where entry \c i is the index of the original point now at position \c i.
+/// The codes, the sort, and a copy of the points use temporary storage taken from \c arena when one is supplied.
+///
+/// @return Returns \c true if the points were reordered, and \c false if the temporary storage could not be allocated, in which case the points are not modified.
+
+bool Terathon::SortPointsSpatially(int32 count, Point3D *point, int32 *permutation, uint32 order, MemoryArena *arena)
+{
+	Point3D		boundsMin, boundsMax;
+
+	if (count <= 1)
+	{
+		if ((count == 1) && (permutation))
+		{
+			permutation[0] = 0;
+		}
+
+		return (true);
+	}
+
+	CalculatePointBounds(count, point, &boundsMin, &boundsMax);
+
+	umachine codeSize = AlignSize(count * sizeof(uint32));
+	umachine indexSize = AlignSize(count * sizeof(int32));
+	ScratchStorage scratch(codeSize + indexSize + count * sizeof(Point3D), arena);
+	char *storage = static_cast<char *>(scratch.GetStorage());
+	if (!storage)
+	{
+		return (false);
+	}
+
+	uint32 *code = reinterpret_cast<uint32 *>(storage);
+	int32 *index = (permutation) ? permutation : reinterpret_cast<int32 *>(storage + codeSize);
+	Point3D *copy = reinterpret_cast<Point3D *>(storage + codeSize + indexSize);
+
+	if (order == kSpatialOrderHilbert)
+	{
+		CalculateHilbertCodes(count, point, boundsMin, boundsMax, code);
+	}
+	else
+	{
+		CalculateMortonCodes(count, point, boundsMin, boundsMax, code);
+	}
+
+	if (!SortSpatialCodes(count, code, index, arena))
+	{
+		return (false);
+	}
+
+	CopyMemory(point, copy, count * sizeof(Point3D));
+	for (machine i = 0; i < count; i++)
+	{
+		point[i] = copy[index[i]];
+	}
+
+	return (true);
+}
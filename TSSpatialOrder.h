@@ -0,0 +1,53 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSSpatialOrder_h
+#define TSSpatialOrder_h
+
+
+#include "TSVector3D.h"
+#include "TSMemory.h"
+
+
+#define TERATHON_SPATIALORDER 1
+
+
+namespace Terathon
+{
+	/// @brief Identifies the space-filling curve used to order points.
+
+	enum : uint32
+	{
+		kSpatialOrderMorton			= 0,		///< Z-order curve. Keys are cheaper to calculate, but the curve jumps between distant cells at power-of-two boundaries.
+		kSpatialOrderHilbert		= 1			///< Hilbert curve. Consecutive cells along the curve are always adjacent, giving somewhat better locality.
+	};
+
+
+	/// @brief The number of bits per coordinate in a spatial key.
+	///
+	/// Each coordinate is quantized to an integer in the range [0,&nbsp;1023] relative to a bounding box, and the three
+	/// quantized coordinates are combined into a 30-bit key.
+
+	enum : uint32
+	{
+		kSpatialKeyAxisBits			= 10
+	};
+
+
+	TERATHON_API void CalculatePointBounds(int32 count, const Point3D *point, Point3D *boundsMin, Point3D *boundsMax);
+
+	TERATHON_API void CalculateMortonCodes(int32 count, const Point3D *point, const Point3D& boundsMin, const Point3D& boundsMax, uint32 *code);
+	TERATHON_API void CalculateHilbertCodes(int32 count, const Point3D *point, const Point3D& boundsMin, const Point3D& boundsMax, uint32 *code);
+
+	TERATHON_API bool SortSpatialCodes(int32 count, const uint32 *code, int32 *permutation, MemoryArena *arena = nullptr);
+	TERATHON_API bool SortPointsSpatially(int32 count, Point3D *point, int32 *permutation, uint32 order = kSpatialOrderHilbert, MemoryArena *arena = nullptr);
+}
+
+
+#endif
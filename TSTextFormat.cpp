@@ -0,0 +1,782 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSTextFormat.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	const float floatPow10[11] =
+	{
+		1.0F, 1.0e1F, 1.0e2F, 1.0e3F, 1.0e4F, 1.0e5F, 1.0e6F, 1.0e7F, 1.0e8F, 1.0e9F, 1.0e10F
+	};
+
+	const double doublePow10[23] =
+	{
+		1.0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9, 1.0e10, 1.0e11,
+		1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22
+	};
+
+	const uint64 integerPow10[10] =
+	{
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+	};
+
+	const uint8 firstBitTable[64] =
+	{
+		0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4, 62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+		63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11, 46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+	};
+
+
+	inline int32 FindFirstBit(uint64 mask)
+	{
+		// De Bruijn multiplication gives the index of the lowest set bit without
+		// depending on compiler intrinsics.
+
+		return (firstBitTable[((mask & (0 - mask)) * 0x03F79D71B4CB0A89ULL) >> 58]);
+	}
+
+	inline bool IsDigit(char c)
+	{
+		return (uint32(c - '0') < 10U);
+	}
+
+	inline bool IsDelimiter(char c)
+	{
+		return ((uint8(c) <= 32) || (c == ',') || (c == ';') || (c == '(') || (c == ')') || (c == '[') || (c == ']') || (c == '{') || (c == '}'));
+	}
+
+	inline bool IsEightDigits(uint64 v)
+	{
+		return ((((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL));
+	}
+
+	inline uint32 ParseEightDigits(uint64 v)
+	{
+		// Combine adjacent digits into pairs, then pairs into groups of four, and finally
+		// both groups of four into a single value, all within one 64-bit register.
+
+		v -= 0x3030303030303030ULL;
+		v = (v * 10) + (v >> 8);
+		v = (((v & 0x000000FF000000FFULL) * 0x000F424000000064ULL) + (((v >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >> 32;
+		return (uint32(v));
+	}
+
+	inline uint64 LoadEightCharacters(const char *text)
+	{
+		uint64 v;
+		CopyMemory(text, &v, 8);
+		return (v);
+	}
+
+	double GetDoublePow10(int32 exponent)
+	{
+		double result = 1.0;
+		if (exponent >= 0)
+		{
+			while (exponent > 22)
+			{
+				result *= 1.0e22;
+				exponent -= 22;
+			}
+
+			return (result * doublePow10[exponent]);
+		}
+
+		exponent = -exponent;
+		while (exponent > 22)
+		{
+			result *= 1.0e22;
+			exponent -= 22;
+		}
+
+		return (1.0 / (result * doublePow10[exponent]));
+	}
+
+	float MakeFloat(uint64 mantissa, int32 exponent)
+	{
+		// Use single-precision arithmetic when the mantissa and power of ten are both exactly
+		// representable so that the result is correctly rounded with a single operation.
+
+		if (mantissa < (1ULL << 24))
+		{
+			if (uint32(exponent + 10) <= 20U)
+			{
+				float m = float(int32(mantissa));
+				return ((exponent >= 0) ? m * floatPow10[exponent] : m / floatPow10[-exponent]);
+			}
+		}
+
+		if (mantissa == 0)
+		{
+			return (0.0F);
+		}
+
+		// Values whose decimal exponent lies far outside the range of a float are clamped
+		// before any arithmetic is performed.
+
+		int32 digitCount = 1;
+		for (uint64 m = mantissa; m >= 10; m /= 10)
+		{
+			digitCount++;
+		}
+
+		int32 magnitude = exponent + digitCount;
+		if (magnitude > 40)
+		{
+			return (asfloat(0x7F800000U));
+		}
+
+		if (magnitude < -46)
+		{
+			return (0.0F);
+		}
+
+		double m = double(mantissa);
+		if ((mantissa < (1ULL << 53)) && (uint32(exponent + 22) <= 44U))
+		{
+			return (float((exponent >= 0) ? m * doublePow10[exponent] : m / doublePow10[-exponent]));
+		}
+
+		if (exponent < -300)
+		{
+			return (float(m * GetDoublePow10(exponent + 30) * 1.0e-30));
+		}
+
+		return (float(m * GetDoublePow10(exponent)));
+	}
+
+	bool MatchWord(const char *text, const char *end, const char *word)
+	{
+		for (; *word != 0; text++, word++)
+		{
+			if ((text >= end) || ((*text | 0x20) != *word))
+			{
+				return (false);
+			}
+		}
+
+		return (true);
+	}
+}
+
+
+/// @brief Returns a pointer to the next newline character in a range of text.
+/// @param text		A pointer to the first character of the text.
+/// @param end		A pointer to the character immediately following the end of the text.
+///
+/// If there is no newline character, then the return value is \c end. The search examines 16 characters at a time.
+
+const char *Terathon::FindLineEnd(const char *text, const char *end)
+{
+	#if defined(TERATHON_SSE)
+
+		__m128i newline = _mm_set1_epi8('\n');
+		while (end - text >= 16)
+		{
+			uint32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(text)), newline));
+			if (mask != 0)
+			{
+				return (text + FindFirstBit(mask));
+			}
+
+			text += 16;
+		}
+
+	#elif defined(TERATHON_NEON)
+
+		uint8x16_t newline = vdupq_n_u8('\n');
+		while (end - text >= 16)
+		{
+			uint8x16_t c = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8 *>(text)), newline);
+			uint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(c), 4)), 0);
+			if (mask != 0)
+			{
+				return (text + (FindFirstBit(mask) >> 2));
+			}
+
+			text += 16;
+		}
+
+	#endif
+
+	while ((text < end) && (*text != '\n'))
+	{
+		text++;
+	}
+
+	return (text);
+}
+
+/// @brief Skips spaces, tabs, and line breaks.
+/// @param text		A pointer to the first character of the text.
+/// @param end		A pointer to the character immediately following the end of the text.
+///
+/// Every character with a code no greater than 32 is treated as whitespace. The return value is a pointer to the first
+/// character that is not whitespace, or \c end if there is no such character. The search examines 16 characters at a time.
+
+const char *Terathon::SkipWhitespace(const char *text, const char *end)
+{
+	#if defined(TERATHON_SSE)
+
+		__m128i space = _mm_set1_epi8(32);
+		while (end - text >= 16)
+		{
+			__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+			uint32 mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(c, space), c)) & 0xFFFF;
+			if (mask != 0)
+			{
+				return (text + FindFirstBit(mask));
+			}
+
+			text += 16;
+		}
+
+	#elif defined(TERATHON_NEON)
+
+		uint8x16_t space = vdupq_n_u8(32);
+		while (end - text >= 16)
+		{
+			uint8x16_t c = vcgtq_u8(vld1q_u8(reinterpret_cast<const uint8 *>(text)), space);
+			uint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(c), 4)), 0);
+			if (mask != 0)
+			{
+				return (text + (FindFirstBit(mask) >> 2));
+			}
+
+			text += 16;
+		}
+
+	#endif
+
+	while ((text < end) && (uint8(*text) <= 32))
+	{
+		text++;
+	}
+
+	return (text);
+}
+
+/// @brief Skips whitespace and the punctuation that commonly separates numbers.
+/// @param text		A pointer to the first character of the text.
+/// @param end		A pointer to the character immediately following the end of the text.
+///
+/// In addition to whitespace, the characters <tt>, ; ( ) [ ] { }</tt> are skipped.
+/// The return value is a pointer to the first character that is not a delimiter, or \c end if there is no such character.
+
+const char *Terathon::SkipDelimiters(const char *text, const char *end)
+{
+	for (;;)
+	{
+		text = SkipWhitespace(text, end);
+		if ((text >= end) || (!IsDelimiter(*text)))
+		{
+			break;
+		}
+
+		text++;
+	}
+
+	return (text);
+}
+
+/// @brief Parses a floating-point number from text.
+/// @param text		A pointer to the first character of the number.
+/// @param end		A pointer to the character immediately following the end of the text.
+/// @param value	A pointer to the location that receives the number.
+///
+/// The \c ParseFloat() function accepts an optional sign followed by decimal digits with an optional decimal point and an
+/// optional exponent, as well as the case-insensitive words <tt>inf</tt>, <tt>infinity</tt>, and <tt>nan</tt>. It does not depend on
+/// the current locale, it never reads past \c end, and it does not skip leading whitespace. The result is correctly rounded
+/// whenever the number has no more than 15 significant digits and an exponent within &plusmn;22, which covers every number
+/// produced by the \c FormatFloat() function. Otherwise, it is within one unit in the last place.
+///
+/// The return value is a pointer to the first character following the number, or \c nullptr if no number could be parsed.
+
+const char *Terathon::ParseFloat(const char *text, const char *end, float *value)
+{
+	const char *s = text;
+	bool negative = false;
+
+	if (s < end)
+	{
+		if (*s == '-')
+		{
+			negative = true;
+			s++;
+		}
+		else if (*s == '+')
+		{
+			s++;
+		}
+	}
+
+	if ((s < end) && (!IsDigit(*s)) && (*s != '.'))
+	{
+		if (MatchWord(s, end, "inf"))
+		{
+			s += (MatchWord(s, end, "infinity")) ? 8 : 3;
+			*value = asfloat((negative) ? 0xFF800000U : 0x7F800000U);
+			return (s);
+		}
+
+		if (MatchWord(s, end, "nan"))
+		{
+			*value = asfloat((negative) ? 0xFFC00000U : 0x7FC00000U);
+			return (s + 3);
+		}
+
+		return (nullptr);
+	}
+
+	uint64 mantissa = 0;
+	int32 digitCount = 0;
+	int32 exponent = 0;
+	bool anyDigit = false;
+
+	// Read the integer part. Leading zeros are not significant, and digits beyond the
+	// nineteenth only contribute to the exponent.
+
+	while ((s < end) && (*s == '0'))
+	{
+		anyDigit = true;
+		s++;
+	}
+
+	for (;;)
+	{
+		if ((end - s >= 8) && (digitCount <= 11))
+		{
+			uint64 v = LoadEightCharacters(s);
+			if (IsEightDigits(v))
+			{
+				mantissa = mantissa * 100000000 + ParseEightDigits(v);
+				digitCount += (mantissa != 0) ? 8 : 0;
+				anyDigit = true;
+				s += 8;
+				continue;
+			}
+		}
+
+		if ((s >= end) || (!IsDigit(*s)))
+		{
+			break;
+		}
+
+		if (digitCount < 19)
+		{
+			mantissa = mantissa * 10 + (*s - '0');
+			digitCount += (mantissa != 0);
+		}
+		else
+		{
+			exponent++;
+		}
+
+		anyDigit = true;
+		s++;
+	}
+
+	if ((s < end) && (*s == '.'))
+	{
+		s++;
+
+		if (mantissa == 0)
+		{
+			while ((s < end) && (*s == '0'))
+			{
+				exponent--;
+				anyDigit = true;
+				s++;
+			}
+		}
+
+		for (;;)
+		{
+			if ((end - s >= 8) && (digitCount <= 11))
+			{
+				uint64 v = LoadEightCharacters(s);
+				if (IsEightDigits(v))
+				{
+					mantissa = mantissa * 100000000 + ParseEightDigits(v);
+					digitCount += 8;
+					exponent -= 8;
+					anyDigit = true;
+					s += 8;
+					continue;
+				}
+			}
+
+			if ((s >= end) || (!IsDigit(*s)))
+			{
+				break;
+			}
+
+			if (digitCount < 19)
+			{
+				mantissa = mantissa * 10 + (*s - '0');
+				digitCount++;
+				exponent--;
+			}
+
+			anyDigit = true;
+			s++;
+		}
+	}
+
+	if (!anyDigit)
+	{
+		return (nullptr);
+	}
+
+	if ((s < end) && ((*s | 0x20) == 'e'))
+	{
+		const char *t = s + 1;
+		bool negativeExponent = false;
+		if (t < end)
+		{
+			if (*t == '-')
+			{
+				negativeExponent = true;
+				t++;
+			}
+			else if (*t == '+')
+			{
+				t++;
+			}
+		}
+
+		if ((t < end) && (IsDigit(*t)))
+		{
+			int32 e = 0;
+			do
+			{
+				if (e < 100000)
+				{
+					e = e * 10 + (*t - '0');
+				}
+
+				t++;
+			} while ((t < end) && (IsDigit(*t)));
+
+			exponent += (negativeExponent) ? -e : e;
+			s = t;
+		}
+	}
+
+	float f = MakeFloat(mantissa, exponent);
+	*value = (negative) ? -f : f;
+	return (s);
+}
+
+/// @brief Parses a sequence of floating-point numbers separated by delimiters.
+/// @param text		A pointer to the first character of the text.
+/// @param end		A pointer to the character immediately following the end of the text.
+/// @param count	The number of values to parse.
+/// @param value	A pointer to an array that receives \c count values.
+///
+/// Delimiters, as defined by the \c SkipDelimiters() function, are skipped before each number.
+/// The return value is a pointer to the first character following the last number, or \c nullptr if fewer than \c count numbers could be parsed.
+
+const char *Terathon::ParseFloatArray(const char *text, const char *end, int32 count, float *value)
+{
+	for (machine a = 0; a < count; a++)
+	{
+		text = ParseFloat(SkipDelimiters(text, end), end, &value[a]);
+		if (!text)
+		{
+			break;
+		}
+	}
+
+	return (text);
+}
+
+/// @brief Parses the first three rows of a 3D transform from text.
+/// @param text			A pointer to the first character of the text.
+/// @param end			A pointer to the character immediately following the end of the text.
+/// @param transform	A pointer to the transform that receives the result.
+///
+/// The twelve entries are read in row-major order, which matches the order of the parameters of the \c Transform3D constructor.
+/// The return value is a pointer to the first character following the last entry, or \c nullptr if twelve numbers could not be parsed.
+///
+/// @relatedalso Transform3D
+
+const char *Terathon::ParseValue(const char *text, const char *end, Transform3D *transform)
+{
+	float n[12];
+	text = ParseFloatArray(text, end, 12, n);
+	if (text)
+	{
+		transform->Set(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]);
+	}
+
+	return (text);
+}
+
+/// @brief Parses as many 3D points as possible from text directly into a structure-of-arrays container.
+/// @param text			A pointer to the first character of the text.
+/// @param end			A pointer to the character immediately following the end of the text.
+/// @param start		The index of the first element of the array to overwrite.
+/// @param maxCount		The maximum number of points to parse.
+/// @param array		The array that receives the points. It must have room for at least \c start&nbsp;+&nbsp;\c maxCount elements.
+/// @param next			A pointer to a location that receives a pointer to the first character following the last parsed point. This can be \c nullptr.
+///
+/// The return value is the number of points that were parsed.
+///
+/// @relatedalso Point3DArray
+
+int32 Terathon::ParsePoint3DArray(const char *text, const char *end, int32 start, int32 maxCount, Point3DArray *array, const char **next)
+{
+	float *x = array->GetX() + start;
+	float *y = array->GetY() + start;
+	float *z = array->GetZ() + start;
+
+	int32 count = 0;
+	while (count < maxCount)
+	{
+		float p[3];
+		const char *s = ParseFloatArray(text, end, 3, p);
+		if (!s)
+		{
+			break;
+		}
+
+		x[count] = p[0];
+		y[count] = p[1];
+		z[count] = p[2];
+
+		text = s;
+		count++;
+	}
+
+	if (next)
+	{
+		*next = text;
+	}
+
+	return (count);
+}
+
+/// @brief Formats a floating-point number as the shortest text that parses back to the same value.
+/// @param value	The number to format.
+/// @param text		A pointer to a buffer that receives at least \c kMaxFloatTextLength characters.
+///
+/// The \c FormatFloat() function finds the fewest significant digits, between one and nine, for which the \c ParseFloat()
+/// function reproduces exactly the same value. Numbers whose decimal exponent lies in the range [&minus;5,&nbsp;8] are written
+/// in positional notation, and all other numbers are written in scientific notation. Infinities and NaNs are written as
+/// <tt>inf</tt>, <tt>-inf</tt>, and <tt>nan</tt>. The output does not depend on the current locale, and it is null-terminated.
+///
+/// The return value is the number of characters written, excluding the null terminator.
+
+int32 Terathon::FormatFloat(float value, char *text)
+{
+	char *s = text;
+	uint32 bits = asuint(value);
+
+	if (bits & 0x80000000U)
+	{
+		*s++ = '-';
+	}
+
+	if ((bits & 0x7F800000U) == 0x7F800000U)
+	{
+		if (bits & 0x007FFFFFU)
+		{
+			s = text;
+			*s++ = 'n';
+			*s++ = 'a';
+			*s++ = 'n';
+		}
+		else
+		{
+			*s++ = 'i';
+			*s++ = 'n';
+			*s++ = 'f';
+		}
+
+		*s = 0;
+		return (int32(s - text));
+	}
+
+	uint32 magnitudeBits = bits & 0x7FFFFFFFU;
+	if (magnitudeBits == 0)
+	{
+		*s++ = '0';
+		*s = 0;
+		return (int32(s - text));
+	}
+
+	// Estimate the decimal exponent from the binary exponent, and then correct it so that
+	// 10^exponent <= |value| < 10^(exponent + 1).
+
+	float magnitude = asfloat(magnitudeBits);
+	double a = magnitude;
+	int32 exponent = int32(double(int32(magnitudeBits >> 23) - 127) * 0.30103);
+	while (a >= GetDoublePow10(exponent + 1))
+	{
+		exponent++;
+	}
+
+	while (a < GetDoublePow10(exponent))
+	{
+		exponent--;
+	}
+
+	// Try each precision in turn until the rounded digits parse back to the original value.
+	// Nine significant digits are always sufficient for a float.
+
+	uint64 digits = 0;
+	int32 precision = 0;
+	int32 baseExponent = exponent;
+	while (precision < 9)
+	{
+		precision++;
+		exponent = baseExponent;
+
+		digits = uint64(a * GetDoublePow10(precision - 1 - exponent) + 0.5);
+		if (digits >= integerPow10[precision])
+		{
+			digits /= 10;
+			exponent++;
+		}
+
+		if (MakeFloat(digits, exponent - precision + 1) == magnitude)
+		{
+			break;
+		}
+	}
+
+	while ((precision > 1) && (digits % 10 == 0))
+	{
+		digits /= 10;
+		precision--;
+	}
+
+	char digitText[10];
+	for (machine k = precision - 1; k >= 0; k--)
+	{
+		digitText[k] = char('0' + digits % 10);
+		digits /= 10;
+	}
+
+	if ((exponent >= -5) && (exponent < 0))
+	{
+		*s++ = '0';
+		*s++ = '.';
+		for (machine k = -1; k > exponent; k--)
+		{
+			*s++ = '0';
+		}
+
+		for (machine k = 0; k < precision; k++)
+		{
+			*s++ = digitText[k];
+		}
+	}
+	else if ((exponent >= 0) && (exponent <= 8))
+	{
+		for (machine k = 0; k <= exponent; k++)
+		{
+			*s++ = (k < precision) ? digitText[k] : '0';
+		}
+
+		if (precision > exponent + 1)
+		{
+			*s++ = '.';
+			for (machine k = exponent + 1; k < precision; k++)
+			{
+				*s++ = digitText[k];
+			}
+		}
+	}
+	else
+	{
+		*s++ = digitText[0];
+		if (precision > 1)
+		{
+			*s++ = '.';
+			for (machine k = 1; k < precision; k++)
+			{
+				*s++ = digitText[k];
+			}
+		}
+
+		*s++ = 'e';
+		if (exponent < 0)
+		{
+			*s++ = '-';
+			exponent = -exponent;
+		}
+
+		if (exponent >= 10)
+		{
+			*s++ = char('0' + exponent / 10);
+		}
+
+		*s++ = char('0' + exponent % 10);
+	}
+
+	*s = 0;
+	return (int32(s - text));
+}
+
+/// @brief Formats an array of floating-point numbers as text.
+/// @param count		The number of values to format.
+/// @param value		A pointer to an array of \c count values.
+/// @param text			A pointer to a buffer that receives at least \c count&nbsp;&times;&nbsp;\c kMaxFloatTextLength characters.
+/// @param separator	The character written between consecutive values.
+///
+/// Each value is formatted with the \c FormatFloat() function. The output is null-terminated.
+/// The return value is the number of characters written, excluding the null terminator.
+
+int32 Terathon::FormatFloatArray(int32 count, const float *value, char *text, char separator)
+{
+	char *s = text;
+	*s = 0;
+
+	for (machine a = 0; a < count; a++)
+	{
+		if (a != 0)
+		{
+			*s++ = separator;
+		}
+
+		s += FormatFloat(value[a], s);
+	}
+
+	return (int32(s - text));
+}
+
+/// @brief Formats the first three rows of a 3D transform as text separated by spaces.
+/// @param transform	The transform to format.
+/// @param text			A pointer to a buffer that receives at least 12&nbsp;&times;&nbsp;\c kMaxFloatTextLength characters.
+///
+/// The twelve entries are written in row-major order, which is the same order read by the corresponding \c ParseValue() function.
+/// The return value is the number of characters written, excluding the null terminator.
+///
+/// @relatedalso Transform3D
+
+int32 Terathon::FormatValue(const Transform3D& transform, char *text)
+{
+	float n[12];
+	for (machine i = 0; i < 3; i++)
+	{
+		for (machine j = 0; j < 4; j++)
+		{
+			n[i * 4 + j] = transform(int32(i), int32(j));
+		}
+	}
+
+	return (FormatFloatArray(12, n, text));
+}
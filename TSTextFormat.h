@@ -0,0 +1,166 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSTextFormat_h
+#define TSTextFormat_h
+
+
+#include "TSGeometryArray.h"
+
+
+#define TERATHON_TEXTFORMAT 1
+
+
+namespace Terathon
+{
+	enum
+	{
+		kMaxFloatTextLength		= 17		///< The maximum number of characters written by the \c FormatFloat() function, including the null terminator.
+	};
+
+
+	TERATHON_API const char *FindLineEnd(const char *text, const char *end);
+	TERATHON_API const char *SkipWhitespace(const char *text, const char *end);
+	TERATHON_API const char *SkipDelimiters(const char *text, const char *end);
+
+	TERATHON_API const char *ParseFloat(const char *text, const char *end, float *value);
+	TERATHON_API const char *ParseFloatArray(const char *text, const char *end, int32 count, float *value);
+
+	TERATHON_API int32 FormatFloat(float value, char *text);
+	TERATHON_API int32 FormatFloatArray(int32 count, const float *value, char *text, char separator = ' ');
+
+
+	/// @brief Parses the three components of a 3D vector from text.
+	/// @param text		A pointer to the first character of the text.
+	/// @param end		A pointer to the character immediately following the end of the text.
+	/// @param v		A pointer to the vector that receives the result.
+	///
+	/// Leading delimiters are skipped before each component. The return value is a pointer to the first character following
+	/// the last component, or \c nullptr if three numbers could not be parsed.
+	///
+	/// @relatedalso Vector3D
+
+	inline const char *ParseValue(const char *text, const char *end, Vector3D *v)
+	{
+		return (ParseFloatArray(text, end, 3, &v->x));
+	}
+
+	/// @brief Parses the three coordinates of a 3D point from text.
+	/// @param text		A pointer to the first character of the text.
+	/// @param end		A pointer to the character immediately following the end of the text.
+	/// @param p		A pointer to the point that receives the result.
+	///
+	/// Leading delimiters are skipped before each coordinate. The return value is a pointer to the first character following
+	/// the last coordinate, or \c nullptr if three numbers could not be parsed.
+	///
+	/// @relatedalso Point3D
+
+	inline const char *ParseValue(const char *text, const char *end, Point3D *p)
+	{
+		return (ParseFloatArray(text, end, 3, &p->x));
+	}
+
+	/// @brief Parses the four components of a quaternion from text in the order <i>x</i>, <i>y</i>, <i>z</i>, <i>w</i>.
+	/// @param text		A pointer to the first character of the text.
+	/// @param end		A pointer to the character immediately following the end of the text.
+	/// @param q		A pointer to the quaternion that receives the result.
+	///
+	/// Leading delimiters are skipped before each component. The return value is a pointer to the first character following
+	/// the last component, or \c nullptr if four numbers could not be parsed.
+	///
+	/// @relatedalso Quaternion
+
+	inline const char *ParseValue(const char *text, const char *end, Quaternion *q)
+	{
+		return (ParseFloatArray(text, end, 4, reinterpret_cast<float *>(q)));
+	}
+
+	TERATHON_API const char *ParseValue(const char *text, const char *end, Transform3D *transform);
+
+	TERATHON_API int32 ParsePoint3DArray(const char *text, const char *end, int32 start, int32 maxCount, Point3DArray *array, const char **next = nullptr);
+
+
+	/// @brief Parses as many objects as possible from text into an array.
+	/// @param text			A pointer to the first character of the text.
+	/// @param end			A pointer to the character immediately following the end of the text.
+	/// @param maxCount		The maximum number of objects to parse.
+	/// @param object		A pointer to an array that receives up to \c maxCount objects.
+	/// @param next			A pointer to a location that receives a pointer to the first character following the last parsed object. This can be \c nullptr.
+	///
+	/// The return value is the number of objects that were parsed.
+
+	template <class type>
+	int32 ParseValueArray(const char *text, const char *end, int32 maxCount, type *object, const char **next = nullptr)
+	{
+		int32 count = 0;
+		while (count < maxCount)
+		{
+			const char *s = ParseValue(text, end, &object[count]);
+			if (!s)
+			{
+				break;
+			}
+
+			text = s;
+			count++;
+		}
+
+		if (next)
+		{
+			*next = text;
+		}
+
+		return (count);
+	}
+
+
+	/// @brief Formats the components of a 3D vector as text separated by spaces.
+	/// @param v		The vector to format.
+	/// @param text		A pointer to a buffer that receives at least 3&nbsp;&times;&nbsp;\c kMaxFloatTextLength characters.
+	///
+	/// The return value is the number of characters written, excluding the null terminator.
+	///
+	/// @relatedalso Vector3D
+
+	inline int32 FormatValue(const Vector3D& v, char *text)
+	{
+		return (FormatFloatArray(3, &v.x, text));
+	}
+
+	/// @brief Formats the coordinates of a 3D point as text separated by spaces.
+	/// @param p		The point to format.
+	/// @param text		A pointer to a buffer that receives at least 3&nbsp;&times;&nbsp;\c kMaxFloatTextLength characters.
+	///
+	/// The return value is the number of characters written, excluding the null terminator.
+	///
+	/// @relatedalso Point3D
+
+	inline int32 FormatValue(const Point3D& p, char *text)
+	{
+		return (FormatFloatArray(3, &p.x, text));
+	}
+
+	/// @brief Formats the components of a quaternion as text separated by spaces in the order <i>x</i>, <i>y</i>, <i>z</i>, <i>w</i>.
+	/// @param q		The quaternion to format.
+	/// @param text		A pointer to a buffer that receives at least 4&nbsp;&times;&nbsp;\c kMaxFloatTextLength characters.
+	///
+	/// The return value is the number of characters written, excluding the null terminator.
+	///
+	/// @relatedalso Quaternion
+
+	inline int32 FormatValue(const Quaternion& q, char *text)
+	{
+		return (FormatFloatArray(4, reinterpret_cast<const float *>(&q), text));
+	}
+
+	TERATHON_API int32 FormatValue(const Transform3D& transform, char *text);
+}
+
+
+#endif
@@ -0,0 +1,375 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#include "TSTriangleIntersection.h"
+
+
+using namespace Terathon;
+
+
+namespace
+{
+	#ifndef TERATHON_NO_SIMD
+
+		alignas(16) const uint32 laneMask[5][4] =
+		{
+			{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000},
+			{0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF}
+		};
+
+
+		struct TriangleVector
+		{
+			vec_float		q0;
+			vec_float		q1;
+			vec_float		q2;
+			vec_float		param;
+			vec_float		reject;
+		};
+
+
+		// The side of an edge line on which a ray passes is given by the antiwedge product of the two lines,
+		// which is -(vr . me + mr . ve). The negation is omitted because only the relative signs of the three
+		// products and their ratios matter. The ray hits the triangle when all three products have the same sign,
+		// and it hits the plane at the parameter where the weighted distance from p + tv to the plane is zero.
+
+		inline void IntersectTriangleVector(const vec_float *ray, const vec_float *edge0, const vec_float *edge1, const vec_float *edge2, const vec_float *plane, TriangleVector *result)
+		{
+			vec_float q0 = VecMadd(ray[0], edge0[3], VecMadd(ray[1], edge0[4], VecMadd(ray[2], edge0[5], VecMadd(ray[3], edge0[0], VecMadd(ray[4], edge0[1], VecMul(ray[5], edge0[2]))))));
+			vec_float q1 = VecMadd(ray[0], edge1[3], VecMadd(ray[1], edge1[4], VecMadd(ray[2], edge1[5], VecMadd(ray[3], edge1[0], VecMadd(ray[4], edge1[1], VecMul(ray[5], edge1[2]))))));
+			vec_float q2 = VecMadd(ray[0], edge2[3], VecMadd(ray[1], edge2[4], VecMadd(ray[2], edge2[5], VecMadd(ray[3], edge2[0], VecMadd(ray[4], edge2[1], VecMul(ray[5], edge2[2]))))));
+
+			vec_float den = VecMadd(plane[0], ray[0], VecMadd(plane[1], ray[1], VecMul(plane[2], ray[2])));
+			vec_float num = VecMadd(plane[0], ray[6], VecMadd(plane[1], ray[7], VecMadd(plane[2], ray[8], plane[3])));
+
+			const vec_float zero = VecFloatGetZero();
+			vec_float negative = VecOr(VecMaskCmplt(q0, zero), VecOr(VecMaskCmplt(q1, zero), VecMaskCmplt(q2, zero)));
+			vec_float positive = VecOr(VecMaskCmpgt(q0, zero), VecOr(VecMaskCmpgt(q1, zero), VecMaskCmpgt(q2, zero)));
+
+			// A zero denominator means that the ray is parallel to the plane or that the triangle is
+			// degenerate, and it is replaced by one to avoid a division by zero in a rejected lane.
+
+			vec_float parallel = VecMaskCmpeq(den, zero);
+			vec_float t = VecDiv(VecNegate(num), VecSelect(den, VecLoadVectorConstant<0x3F800000>(), parallel));
+
+			result->q0 = q0;
+			result->q1 = q1;
+			result->q2 = q2;
+			result->param = t;
+			result->reject = VecOr(VecOr(VecAnd(negative, positive), parallel), VecMaskCmplt(t, zero));
+		}
+
+	#endif
+
+
+	void FinishHit(const TriangleArray& triangle, int32 index, const Line3D& ray, float param, TriangleHit *hit)
+	{
+		float q0 = ray ^ triangle.GetEdgeLine(index, 0);
+		float q1 = ray ^ triangle.GetEdgeLine(index, 1);
+		float q2 = ray ^ triangle.GetEdgeLine(index, 2);
+		float f = 1.0F / (q0 + q1 + q2);
+
+		hit->param = param;
+		hit->u = q1 * f;
+		hit->v = q2 * f;
+		hit->index = index;
+	}
+}
+
+
+/// @brief Stores a single triangle in the array.
+/// @param index		The index of the triangle.
+/// @param p0,p1,p2		The vertices of the triangle.
+
+void TriangleArray::Set(int32 index, const Point3D& p0, const Point3D& p1, const Point3D& p2)
+{
+	Line3D edge[3] = {Wedge(p1, p2), Wedge(p2, p0), Wedge(p0, p1)};
+	Plane3D plane(p0, p1, p2);
+
+	int32 stride = GetComponentStride();
+	float *data = GetComponent(0) + index;
+	for (machine k = 0; k < 3; k++)
+	{
+		data[0] = edge[k].v.x;
+		data[stride] = edge[k].v.y;
+		data[stride * 2] = edge[k].v.z;
+		data[stride * 3] = edge[k].m.x;
+		data[stride * 4] = edge[k].m.y;
+		data[stride * 5] = edge[k].m.z;
+		data += stride * 6;
+	}
+
+	data[0] = plane.x;
+	data[stride] = plane.y;
+	data[stride * 2] = plane.z;
+	data[stride * 3] = plane.w;
+}
+
+/// @brief Stores a range of triangles in the array.
+/// @param start			The index of the first triangle to store.
+/// @param count			The number of triangles to store.
+/// @param vertex			A pointer to an array of vertex positions.
+/// @param triangleIndex	A pointer to an array of 3&nbsp;&times;&nbsp;\c count vertex indices. If this is \c nullptr, then the vertices of
+///							triangle <i>k</i> are the three consecutive entries of the \c vertex array beginning at 3<i>k</i>.
+
+void TriangleArray::SetTriangles(int32 start, int32 count, const Point3D *vertex, const int32 *triangleIndex)
+{
+	if (triangleIndex)
+	{
+		for (machine k = 0; k < count; k++)
+		{
+			const int32 *i = triangleIndex + k * 3;
+			Set(int32(start + k), vertex[i[0]], vertex[i[1]], vertex[i[2]]);
+		}
+	}
+	else
+	{
+		for (machine k = 0; k < count; k++)
+		{
+			const Point3D *p = vertex + k * 3;
+			Set(int32(start + k), p[0], p[1], p[2]);
+		}
+	}
+}
+
+
+/// @brief Intersects a ray with a range of triangles and records the closest hit.
+///
+/// The ray consists of the points <b>p</b>&nbsp;+&nbsp;<i>t</i><b>r</b><sub>v</sub> for 0&nbsp;&le;&nbsp;<i>t</i>&nbsp;&lt;&nbsp;<c>hit->param</c>,
+/// where <b>r</b><sub>v</sub> is the direction of the line \c ray. The ray is tested against each edge line of a triangle with
+/// the antiwedge product, which is the Pl&uuml;cker side test, and it hits the triangle when it passes on the same side of all three
+/// edges. Triangles are hit from either side. The triangles are processed four at a time with SIMD instructions.
+///
+/// @param p			The origin of the ray. This must lie on the line \c ray.
+/// @param ray			The line containing the ray, as would be returned by <c>Wedge(p, v)</c> for a direction <b>v</b>.
+/// @param triangle		The array containing the triangles.
+/// @param start		The index of the first triangle to test.
+/// @param count		The number of triangles to test.
+/// @param hit			A pointer to a \c TriangleHit structure that holds the closest hit found so far.
+/// @return \c true if a hit closer than <c>hit->param</c> was found, in which case the contents of \c hit are replaced.
+/// @relatedalso TriangleArray
+
+bool Terathon::IntersectTriangles(const Point3D& p, const Line3D& ray, const TriangleArray& triangle, int32 start, int32 count, TriangleHit *hit)
+{
+	int32 end = start + count;
+	int32 bestIndex = -1;
+	float bestParam = hit->param;
+
+	#ifndef TERATHON_NO_SIMD
+
+		const float *stream[TriangleArray::kComponentCount];
+		for (machine k = 0; k < TriangleArray::kComponentCount; k++)
+		{
+			stream[k] = triangle.GetComponent(int32(k));
+		}
+
+		float r[9] = {ray.v.x, ray.v.y, ray.v.z, ray.m.x, ray.m.y, ray.m.z, p.x, p.y, p.z};
+		vec_float vray[9];
+		for (machine k = 0; k < 9; k++)
+		{
+			vray[k] = VecLoadSmearScalar(&r[k]);
+		}
+
+		// Blocks begin at multiples of four so that every load is aligned and lies inside the padded streams.
+		// Lanes outside the range [start, end) are masked off in the first and last blocks.
+
+		int32 base = start & ~3;
+		alignas(16) int32 lane[4] = {base, base + 1, base + 2, base + 3};
+
+		vec_int32 index = VecInt32Load(lane);
+		vec_int32 vindex = VecInt32LoadConstant<0xFFFFFFFF>();
+		vec_float vparam = VecLoadSmearScalar(&bestParam);
+
+		for (; base < end; base += 4)
+		{
+			vec_float	component[TriangleArray::kComponentCount];
+			TriangleVector	result;
+
+			for (machine k = 0; k < TriangleArray::kComponentCount; k++)
+			{
+				component[k] = VecLoad(stream[k] + base);
+			}
+
+			IntersectTriangleVector(vray, &component[0], &component[6], &component[12], &component[18], &result);
+
+			int32 lo = start - base;
+			int32 hi = end - base;
+			vec_float range = VecAndc(VecLoad(reinterpret_cast<const float *>(laneMask[(hi < 4) ? hi : 4])), VecLoad(reinterpret_cast<const float *>(laneMask[(lo > 0) ? lo : 0])));
+
+			vec_float accept = VecAnd(VecAndc(VecMaskCmplt(result.param, vparam), result.reject), range);
+			vparam = VecSelect(vparam, result.param, accept);
+			vindex = VecInt32Select(vindex, index, VecCastInt32(accept));
+			index = VecInt32Add(index, VecInt32LoadConstant<4>());
+		}
+
+		alignas(16) float	param[4];
+		alignas(16) int32	candidate[4];
+
+		VecStore(vparam, param);
+		VecInt32Store(vindex, candidate);
+
+		for (machine i = 0; i < 4; i++)
+		{
+			if ((candidate[i] >= 0) && (param[i] < bestParam))
+			{
+				bestParam = param[i];
+				bestIndex = candidate[i];
+			}
+		}
+
+	#else
+
+		for (machine k = start; k < end; k++)
+		{
+			float q0 = ray ^ triangle.GetEdgeLine(int32(k), 0);
+			float q1 = ray ^ triangle.GetEdgeLine(int32(k), 1);
+			float q2 = ray ^ triangle.GetEdgeLine(int32(k), 2);
+
+			if (((q0 < 0.0F) || (q1 < 0.0F) || (q2 < 0.0F)) && ((q0 > 0.0F) || (q1 > 0.0F) || (q2 > 0.0F)))
+			{
+				continue;
+			}
+
+			Plane3D plane = triangle.GetPlane(int32(k));
+			float den = plane.x * ray.v.x + plane.y * ray.v.y + plane.z * ray.v.z;
+			if (den != 0.0F)
+			{
+				float t = -(p ^ plane) / den;
+				if ((t >= 0.0F) && (t < bestParam))
+				{
+					bestParam = t;
+					bestIndex = int32(k);
+				}
+			}
+		}
+
+	#endif
+
+	if (bestIndex >= 0)
+	{
+		FinishHit(triangle, bestIndex, ray, bestParam, hit);
+		return (true);
+	}
+
+	return (false);
+}
+
+/// @brief Intersects a ray with a range of triangles and records the closest hit.
+///
+/// This function calculates the line <b>p</b>&nbsp;&and;&nbsp;<b>v</b> and then intersects the ray with the triangles
+/// as described for the other \c IntersectTriangles() function.
+///
+/// @param p			The origin of the ray.
+/// @param v			The direction of the ray.
+/// @param triangle		The array containing the triangles.
+/// @param start		The index of the first triangle to test.
+/// @param count		The number of triangles to test.
+/// @param hit			A pointer to a \c TriangleHit structure that holds the closest hit found so far.
+/// @return \c true if a hit closer than <c>hit->param</c> was found, in which case the contents of \c hit are replaced.
+/// @relatedalso TriangleArray
+
+bool Terathon::IntersectTriangles(const Point3D& p, const Vector3D& v, const TriangleArray& triangle, int32 start, int32 count, TriangleHit *hit)
+{
+	return (IntersectTriangles(p, Wedge(p, v), triangle, start, count, hit));
+}
+
+/// @brief Intersects a set of rays with a range of triangles and records the closest hit for each ray.
+///
+/// The rays are processed four at a time with SIMD instructions, and each triangle is tested against all four rays
+/// together. This is most efficient for coherent rays that hit the same triangles, such as primary rays belonging to
+/// neighboring pixels. The triangles are tested as described for the single-ray \c IntersectTriangles() function.
+///
+/// @param rayCount		The number of rays.
+/// @param p			A pointer to an array of \c rayCount ray origins.
+/// @param v			A pointer to an array of \c rayCount ray directions.
+/// @param triangle		The array containing the triangles.
+/// @param start		The index of the first triangle to test.
+/// @param count		The number of triangles to test.
+/// @param hit			A pointer to an array of \c rayCount \c TriangleHit structures that hold the closest hits found so far.
+/// @return The number of rays for which a closer hit was found.
+/// @relatedalso TriangleArray
+
+int32 Terathon::IntersectTriangles(int32 rayCount, const Point3D *p, const Vector3D *v, const TriangleArray& triangle, int32 start, int32 count, TriangleHit *hit)
+{
+	int32 hitCount = 0;
+	int32 i = 0;
+
+	#ifndef TERATHON_NO_SIMD
+
+		const float *stream[TriangleArray::kComponentCount];
+		for (machine k = 0; k < TriangleArray::kComponentCount; k++)
+		{
+			stream[k] = triangle.GetComponent(int32(k)) + start;
+		}
+
+		for (; i + 4 <= rayCount; i += 4)
+		{
+			vec_float	vray[9];
+
+			VecLoadTranspose3D(&v[i].x, &vray[0], &vray[1], &vray[2]);
+			VecLoadTranspose3D(&p[i].x, &vray[6], &vray[7], &vray[8]);
+			vray[3] = VecNmsub(vray[8], vray[1], VecMul(vray[7], vray[2]));
+			vray[4] = VecNmsub(vray[6], vray[2], VecMul(vray[8], vray[0]));
+			vray[5] = VecNmsub(vray[7], vray[0], VecMul(vray[6], vray[1]));
+
+			alignas(16) float	param[4];
+			alignas(16) int32	candidate[4] = {start, start, start, start};
+
+			for (machine j = 0; j < 4; j++)
+			{
+				param[j] = hit[i + j].param;
+			}
+
+			vec_float vparam = VecLoad(param);
+			vec_int32 index = VecInt32Load(candidate);
+			vec_int32 vindex = VecInt32LoadConstant<0xFFFFFFFF>();
+
+			for (machine k = 0; k < count; k++)
+			{
+				vec_float	component[TriangleArray::kComponentCount];
+				TriangleVector	result;
+
+				for (machine c = 0; c < TriangleArray::kComponentCount; c++)
+				{
+					component[c] = VecLoadSmearScalar(stream[c] + k);
+				}
+
+				IntersectTriangleVector(vray, &component[0], &component[6], &component[12], &component[18], &result);
+
+				vec_float accept = VecAndc(VecMaskCmplt(result.param, vparam), result.reject);
+				vparam = VecSelect(vparam, result.param, accept);
+				vindex = VecInt32Select(vindex, index, VecCastInt32(accept));
+				index = VecInt32Add(index, VecInt32LoadConstant<1>());
+			}
+
+			VecStore(vparam, param);
+			VecInt32Store(vindex, candidate);
+
+			for (machine j = 0; j < 4; j++)
+			{
+				if (candidate[j] >= 0)
+				{
+					FinishHit(triangle, candidate[j], Wedge(p[i + j], v[i + j]), param[j], &hit[i + j]);
+					hitCount++;
+				}
+			}
+		}
+
+	#endif
+
+	for (; i < rayCount; i++)
+	{
+		hitCount += IntersectTriangles(p[i], v[i], triangle, start, count, &hit[i]);
+	}
+
+	return (hitCount);
+}
@@ -0,0 +1,105 @@
+//
+// This file is part of the Terathon Math Library, by Eric Lengyel.
+// Copyright 1999-2024, Terathon Software LLC
+//
+// This software is distributed under the MIT License.
+// Separate proprietary licenses are available from Terathon Software.
+//
+
+
+#ifndef TSTriangleIntersection_h
+#define TSTriangleIntersection_h
+
+
+#include "TSGeometryArray.h"
+
+
+#define TERATHON_TRIANGLEINTERSECTION 1
+
+
+namespace Terathon
+{
+	// ==============================================
+	//	TriangleArray
+	// ==============================================
+
+	/// @brief Stores an array of 3D triangles in structure-of-arrays layout for ray intersection.
+	///
+	/// The \c TriangleArray class stores each triangle as the three lines containing its edges and the plane containing
+	/// the triangle, which is the form needed by the Pl&uuml;cker-coordinate intersection tests. The edge line opposite
+	/// vertex <i>k</i> is the wedge product of the other two vertices taken in cyclic order, so for a triangle with
+	/// vertices <b>p</b><sub>0</sub>, <b>p</b><sub>1</sub>, and <b>p</b><sub>2</sub>, the edge lines are
+	/// <b>p</b><sub>1</sub>&nbsp;&and;&nbsp;<b>p</b><sub>2</sub>, <b>p</b><sub>2</sub>&nbsp;&and;&nbsp;<b>p</b><sub>0</sub>,
+	/// and <b>p</b><sub>0</sub>&nbsp;&and;&nbsp;<b>p</b><sub>1</sub>.
+	///
+	/// Streams 0&ndash;5, 6&ndash;11, and 12&ndash;17 hold the direction and moment components of the three edge lines,
+	/// and streams 18&ndash;21 hold the components of the plane. Padding entries are zero, which corresponds to a degenerate
+	/// triangle that no ray can hit.
+	///
+	/// @sa GeometryArray
+
+	class TriangleArray : public GeometryArray
+	{
+		public:
+
+			enum {kComponentCount = 22};
+
+			TriangleArray() : GeometryArray(kComponentCount) {}
+			explicit TriangleArray(int32 count) : GeometryArray(kComponentCount, count) {}
+			TriangleArray(int32 count, void *storage) : GeometryArray(kComponentCount, count, storage) {}
+			TriangleArray(int32 count, MemoryArena *arena) : GeometryArray(kComponentCount, count, arena) {}
+
+			static umachine GetStorageSize(int32 count)
+			{
+				return (GeometryArray::GetStorageSize(kComponentCount, count));
+			}
+
+			/// @brief Returns one of the edge lines of a triangle stored in the array.
+			/// @param index	The index of the triangle.
+			/// @param edge		The index of the vertex opposite the edge, in the range [0,&nbsp;2].
+
+			Line3D GetEdgeLine(int32 index, int32 edge) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(edge * 6) + index;
+				return (Line3D(data[0], data[stride], data[stride * 2], data[stride * 3], data[stride * 4], data[stride * 5]));
+			}
+
+			/// @brief Returns the plane containing a triangle stored in the array.
+			/// @param index	The index of the triangle.
+
+			Plane3D GetPlane(int32 index) const
+			{
+				int32 stride = GetComponentStride();
+				const float *data = GetComponent(18) + index;
+				return (Plane3D(data[0], data[stride], data[stride * 2], data[stride * 3]));
+			}
+
+			TERATHON_API void Set(int32 index, const Point3D& p0, const Point3D& p1, const Point3D& p2);
+			TERATHON_API void SetTriangles(int32 start, int32 count, const Point3D *vertex, const int32 *triangleIndex = nullptr);
+	};
+
+
+	/// @brief Records the closest intersection found between a ray and a set of triangles.
+	///
+	/// Before the first intersection function is called for a ray, \c param should be set to the maximum ray parameter and
+	/// \c index should be set to &minus;1. Each intersection function replaces the contents of the structure only when it finds
+	/// a hit closer than \c param, so the same structure can be passed to successive calls for different batches of triangles.
+	/// The point of intersection is (1&nbsp;&minus;&nbsp;<i>u</i>&nbsp;&minus;&nbsp;<i>v</i>)<b>p</b><sub>0</sub>&nbsp;+&nbsp;<i>u</i><b>p</b><sub>1</sub>&nbsp;+&nbsp;<i>v</i><b>p</b><sub>2</sub>.
+
+	struct TriangleHit
+	{
+		float		param;			///< The ray parameter at the point of intersection.
+		float		u;				///< The barycentric coordinate corresponding to the vertex <b>p</b><sub>1</sub>.
+		float		v;				///< The barycentric coordinate corresponding to the vertex <b>p</b><sub>2</sub>.
+		int32		index;			///< The index of the triangle that was hit.
+	};
+
+
+	TERATHON_API bool IntersectTriangles(const Point3D& p, const Line3D& ray, const TriangleArray& triangle, int32 start, int32 count, TriangleHit *hit);
+	TERATHON_API bool IntersectTriangles(const Point3D& p, const Vector3D& v, const TriangleArray& triangle, int32 start, int32 count, TriangleHit *hit);
+	TERATHON_API int32 IntersectTriangles(int32 rayCount, const Point3D *p, const Vector3D *v, const TriangleArray& triangle, int32 start, int32 count, TriangleHit *hit);
+}
+
+
+#endif